@@ -2,6 +2,7 @@
 
 #include <hex.hpp>
 #include <hex/helpers/concepts.hpp>
+#include <hex/helpers/crypto.hpp>
 #include <hex/helpers/fs.hpp>
 
 #include <pl/pattern_language.hpp>
@@ -10,6 +11,7 @@
 
 #include <functional>
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <string>
 #include <string_view>
@@ -440,15 +442,24 @@ namespace hex {
                 class Function {
                 public:
                     using Callback = std::function<std::vector<u8>(const Region&, prv::Provider *)>;
+                    using ContextFactory = std::function<std::unique_ptr<crypt::HashContext>()>;
 
-                    Function(const Hash *type, std::string name, Callback callback)
-                        : m_type(type), m_name(std::move(name)), m_callback(std::move(callback)) {
+                    Function(const Hash *type, std::string name, Callback callback, ContextFactory contextFactory = nullptr)
+                        : m_type(type), m_name(std::move(name)), m_callback(std::move(callback)), m_contextFactory(std::move(contextFactory)) {
 
                     }
 
                     [[nodiscard]] const Hash *getType() const { return this->m_type; }
                     [[nodiscard]] const std::string &getName() const { return this->m_name; }
 
+                    // Returns a context the data can be streamed into or nullptr if the hash can only be calculated through get()
+                    [[nodiscard]] std::unique_ptr<crypt::HashContext> createContext() const {
+                        if (this->m_contextFactory)
+                            return this->m_contextFactory();
+                        else
+                            return nullptr;
+                    }
+
                     const std::vector<u8>& get(const Region& region, prv::Provider *provider) {
                         if (this->m_cache.empty()) {
                             this->m_cache = this->m_callback(region, provider);
@@ -465,6 +476,7 @@ namespace hex {
                     const Hash *m_type;
                     std::string m_name;
                     Callback m_callback;
+                    ContextFactory m_contextFactory;
 
                     std::vector<u8> m_cache;
                 };
@@ -472,6 +484,11 @@ namespace hex {
                 virtual void draw() { }
                 [[nodiscard]] virtual Function create(std::string name) = 0;
 
+                // Turns a result into the text that's shown for it, hex by default
+                [[nodiscard]] virtual std::string format(const std::vector<u8> &result) const {
+                    return crypt::encode16(result);
+                }
+
                 [[nodiscard]] const std::string &getUnlocalizedName() const {
                     return this->m_unlocalizedName;
                 }
@@ -481,6 +498,8 @@ namespace hex {
                     return { this, name, callback };
                 }
 
+                [[nodiscard]] Function create(const std::string &name, const Function::ContextFactory &contextFactory) const;
+
             private:
                 std::string m_unlocalizedName;
             };
@@ -103,7 +103,7 @@ namespace hex {
 
     /* Default Events */
     EVENT_DEF(EventFileLoaded, std::fs::path);
-    EVENT_DEF(EventDataChanged);
+    EVENT_DEF(EventDataChanged, prv::Provider *, Region);
     EVENT_DEF(EventHighlightingChanged);
     EVENT_DEF(EventWindowClosing, GLFWwindow *);
     EVENT_DEF(EventRegionSelected, Region);
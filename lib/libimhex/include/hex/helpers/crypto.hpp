@@ -3,10 +3,18 @@
 #include <hex.hpp>
 
 #include <array>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+namespace hex {
+    class Task;
+}
+
 namespace hex::prv {
     class Provider;
 }
@@ -27,6 +35,18 @@ namespace hex::crypt {
     std::array<u8, 48> sha384(prv::Provider *&data, u64 offset, size_t size);
     std::array<u8, 64> sha512(prv::Provider *&data, u64 offset, size_t size);
 
+    // Same as above but the progress is reported to the task and interrupting it cancels the calculation
+    u16 crc8(prv::Provider *&data, u64 offset, size_t size, u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut, Task &task);
+    u16 crc16(prv::Provider *&data, u64 offset, size_t size, u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut, Task &task);
+    u32 crc32(prv::Provider *&data, u64 offset, size_t size, u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut, Task &task);
+
+    std::array<u8, 16> md5(prv::Provider *&data, u64 offset, size_t size, Task &task);
+    std::array<u8, 20> sha1(prv::Provider *&data, u64 offset, size_t size, Task &task);
+    std::array<u8, 28> sha224(prv::Provider *&data, u64 offset, size_t size, Task &task);
+    std::array<u8, 32> sha256(prv::Provider *&data, u64 offset, size_t size, Task &task);
+    std::array<u8, 48> sha384(prv::Provider *&data, u64 offset, size_t size, Task &task);
+    std::array<u8, 64> sha512(prv::Provider *&data, u64 offset, size_t size, Task &task);
+
     std::array<u8, 16> md5(const std::vector<u8> &data);
     std::array<u8, 20> sha1(const std::vector<u8> &data);
     std::array<u8, 28> sha224(const std::vector<u8> &data);
@@ -34,11 +54,54 @@ namespace hex::crypt {
     std::array<u8, 48> sha384(const std::vector<u8> &data);
     std::array<u8, 64> sha512(const std::vector<u8> &data);
 
+    // Incrementally computed hash. Data can be fed in in any number of parts, the result is the same as hashing all of it at once
+    class HashContext {
+    public:
+        virtual ~HashContext() = default;
+
+        virtual void update(std::span<const u8> data) = 0;
+        [[nodiscard]] virtual std::vector<u8> finish() = 0;
+    };
+
+    std::unique_ptr<HashContext> createMD5Context();
+    std::unique_ptr<HashContext> createSHA1Context();
+    std::unique_ptr<HashContext> createSHA224Context();
+    std::unique_ptr<HashContext> createSHA256Context();
+    std::unique_ptr<HashContext> createSHA384Context();
+    std::unique_ptr<HashContext> createSHA512Context();
+
+    // The result of CRCs is stored in native byte order, sizeof(u16) bytes for CRC8 and CRC16 and sizeof(u32) bytes for CRC32
+    std::unique_ptr<HashContext> createCRC8Context(u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut);
+    std::unique_ptr<HashContext> createCRC16Context(u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut);
+    std::unique_ptr<HashContext> createCRC32Context(u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut);
+
+    using ReadFunction = std::function<void(u64 offset, std::span<u8> buffer)>;
+    using ProgressCallback = std::function<void(u64 processedBytes)>;
+
+    // Reads `size` bytes starting at `offset` only once and feeds them into all contexts. Every context runs on a thread of its own,
+    // reading and the progress callback happen on the calling thread. If either of them throws, the threads are stopped and the exception is rethrown
+    void updateAll(const std::vector<HashContext *> &contexts, u64 offset, u64 size, const ReadFunction &read, const ProgressCallback &progress = { });
+
+    using ContextFactory = std::function<std::unique_ptr<HashContext>()>;
+
+    // Splits `size` bytes starting at `offset` into blocks of `blockSize` bytes and returns the hash of every block, the last one may be shorter.
+    // The blocks are hashed on all available cores while the next part of the data is read on the calling thread
+    std::vector<std::vector<u8>> hashBlocks(const ContextFactory &createContext, u64 offset, u64 size, u64 blockSize, const ReadFunction &read, const ProgressCallback &progress = { });
+
+    // Whitespace is skipped when decoding base64. Invalid input decodes to nothing
     std::vector<u8> decode64(const std::vector<u8> &input);
     std::vector<u8> encode64(const std::vector<u8> &input);
     std::vector<u8> decode16(const std::string &input);
     std::string encode16(const std::vector<u8> &input);
 
+    // Same as above but writing into `output` without allocating, the number of bytes written is returned. Encoding takes two characters per byte
+    // for base16 and four characters for every started group of three bytes for base64, decoding takes half and at most three quarters of the input size.
+    // Decoding is strict, odd base16 lengths, characters outside of the alphabet, whitespace and misplaced base64 padding throw std::invalid_argument
+    size_t encode16(std::span<const u8> input, std::span<char> output);
+    size_t decode16(std::string_view input, std::span<u8> output);
+    size_t encode64(std::span<const u8> input, std::span<char> output);
+    size_t decode64(std::string_view input, std::span<u8> output);
+
     i128 decodeSleb128(const std::vector<u8> &bytes);
     u128 decodeUleb128(const std::vector<u8> &bytes);
     std::vector<u8> encodeSleb128(i128 value);
@@ -62,4 +125,46 @@ namespace hex::crypt {
     };
 
     std::vector<u8> aesDecrypt(AESMode mode, KeyLength keyLength, const std::vector<u8> &key, std::array<u8, 8> nonce, std::array<u8, 8> iv, const std::vector<u8> &input);
+
+    using WriteFunction = std::function<void(u64 offset, std::span<const u8> buffer)>;
+
+    // Decrypts data encrypted with one of the modes where every block can be decrypted on its own, ECB, CTR and XTS. Any part of the data can
+    // be decrypted without touching the rest of it, so large amounts of data are split up and decrypted on all available cores.
+    // CTR uses the nonce followed by the IV as initial big endian counter block. XTS takes two keys, the data key followed by the tweak key.
+    // The tweak of the first data unit is the nonce followed by the IV as little endian number and increases by one for every data unit after it
+    class AESDecryptor {
+    public:
+        AESDecryptor(AESMode mode, KeyLength keyLength, std::span<const u8> key, std::array<u8, 8> nonce, std::array<u8, 8> iv, u64 dataUnitSize = 512);
+        ~AESDecryptor();
+
+        AESDecryptor(AESDecryptor &&) noexcept;
+        AESDecryptor &operator=(AESDecryptor &&) noexcept;
+
+        // Decrypts `input`, which starts `position` bytes into the encrypted data, into `output` of the same size on all available cores.
+        // ECB data has to be aligned to whole blocks and XTS data has to start at a data unit, the last XTS data unit may be shorter
+        void decrypt(u64 position, std::span<const u8> input, std::span<u8> output) const;
+
+        // Reads `size` bytes of encrypted data starting at `offset` in large chunks and passes the decrypted chunks to `write` in order, using
+        // the same offsets they were read from. Reading and writing happen on the calling thread while the next chunk is being decrypted
+        void decrypt(u64 offset, u64 size, const ReadFunction &read, const WriteFunction &write, const ProgressCallback &progress = { }) const;
+
+        [[nodiscard]] AESMode getMode() const { return this->m_mode; }
+        [[nodiscard]] u64 getDataUnitSize() const { return this->m_dataUnitSize; }
+
+    private:
+        class Cipher;
+
+        void validate(u64 position, u64 size) const;
+        [[nodiscard]] u64 getChunkSize(u64 targetSize) const;
+        void decryptChunk(u64 position, std::span<const u8> input, std::span<u8> output) const;
+        void decryptCTR(u64 position, std::span<const u8> input, std::span<u8> output) const;
+        void decryptXTS(u64 position, std::span<const u8> input, std::span<u8> output) const;
+
+    private:
+        AESMode m_mode;
+        u64 m_dataUnitSize;
+        std::array<u8, 16> m_initialValue;
+
+        std::unique_ptr<Cipher> m_cipher, m_tweakCipher;
+    };
 }
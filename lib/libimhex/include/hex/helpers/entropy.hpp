@@ -0,0 +1,117 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/helpers/crypto.hpp>
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace hex::entropy {
+
+    // Number of occurrences of every byte value
+    using Histogram = std::array<u64, 256>;
+
+    // Adds the number of occurrences of every byte value in data to the histogram
+    void countValues(std::span<const u8> data, Histogram &histogram);
+
+    // Shannon entropy of `size` bytes with the given value counts, divided by 8 so it ranges from 0 for constant data to 1 for uniformly distributed data
+    [[nodiscard]] float calculateEntropy(const Histogram &histogram, u64 size);
+
+    struct Analysis {
+        u64 blockSize = 0;
+
+        // Value counts of the entire data and the entropy of every block. The last block may be shorter than the others
+        Histogram valueCounts = { };
+        std::vector<float> blockEntropy;
+    };
+
+    // Calculates the byte distribution of `size` bytes starting at `offset` together with the entropy of every block of `blockSize` bytes.
+    // Data is read in batches on the calling thread while the previous batch is split into ranges of blocks that get analyzed on all available cores
+    [[nodiscard]] Analysis analyze(u64 offset, u64 size, u64 blockSize, const crypt::ReadFunction &read, const crypt::ProgressCallback &progress = { });
+
+    // Summary of a range of the data. Values are stored as fixed point numbers so even the finest levels of a pyramid stay small
+    struct Node {
+        u16 entropy;
+        u8 zeros, printable;
+
+        [[nodiscard]] float getEntropy() const { return this->entropy / 65535.0F; }
+
+        // Share of 0x00 bytes and of printable ASCII characters including tabs and line breaks
+        [[nodiscard]] float getZeros() const { return this->zeros / 255.0F; }
+        [[nodiscard]] float getPrintable() const { return this->printable / 255.0F; }
+
+        [[nodiscard]] bool operator==(const Node &other) const = default;
+    };
+
+    // Entropy and byte classes of some data at multiple resolutions. Level 0 summarizes blocks of getLeafSize() bytes and every level above
+    // combines four nodes of the level below it, up to a single node covering all of the data. Nodes are calculated from the combined value
+    // counts of their children, not from the children's summaries, so every level is exact
+    class Pyramid {
+    public:
+        constexpr static u64 Fanout = 4;
+        constexpr static u64 MinimumLeafSize = 256;
+
+        // Leaves grow by the fanout for very large data so there are never more than this many of them
+        constexpr static u64 MaximumLeafCount = 8 * 1024 * 1024;
+
+        // Nodes of at least 64 KiB keep their value counts so changes to the data only require the counted nodes they touch to be analyzed again.
+        // Counted nodes grow by the fanout for very large data so there are never more than this many of them
+        constexpr static u64 MaximumCountedNodeCount = 16 * 1024;
+
+        // Analyzes `size` bytes starting at `offset`. Data is read in batches on the calling thread, the previous batch gets analyzed on all available cores meanwhile
+        void build(u64 offset, u64 size, const crypt::ReadFunction &read, const crypt::ProgressCallback &progress = { });
+
+        // Counted nodes that have been analyzed again together with all nodes below them
+        struct Changes {
+            u64 firstNode = 0;
+            std::vector<Histogram> counts;
+            std::vector<std::vector<Node>> levels;
+        };
+
+        // Analyzes the counted nodes that `size` bytes starting at `offset` lie in again and updates all nodes above them.
+        // Only the contents of the data may have changed since the pyramid was built, not its size
+        void update(u64 offset, u64 size, const crypt::ReadFunction &read);
+
+        // Same as update() split in two steps. Analyzing the changes doesn't modify the pyramid so it can happen on another thread while
+        // the pyramid is still being used, as long as it doesn't get built again. Applying them replaces the nodes and updates all nodes above them
+        [[nodiscard]] Changes analyzeChanges(u64 offset, u64 size, const crypt::ReadFunction &read) const;
+        void apply(const Changes &changes);
+
+        [[nodiscard]] bool isBuilt() const { return !this->m_levels.empty(); }
+
+        [[nodiscard]] u64 getDataOffset() const { return this->m_offset; }
+        [[nodiscard]] u64 getDataSize() const { return this->m_size; }
+        [[nodiscard]] u64 getLeafSize() const { return this->m_leafSize; }
+        [[nodiscard]] u64 getCountedNodeSize() const { return this->getNodeSize(this->m_countedLevel); }
+
+        [[nodiscard]] u32 getLevelCount() const { return this->m_levels.size(); }
+        [[nodiscard]] u64 getNodeSize(u32 level) const;
+        [[nodiscard]] std::span<const Node> getLevel(u32 level) const { return this->m_levels[level]; }
+
+        // Finest level that splits `size` bytes into at most `maxNodes` nodes
+        [[nodiscard]] u32 findLevel(u64 size, u64 maxNodes) const;
+
+        [[nodiscard]] const Histogram &getValueCounts() const { return this->m_valueCounts; }
+        [[nodiscard]] float getEntropy() const { return calculateEntropy(this->m_valueCounts, this->m_size); }
+
+    private:
+        using Counts = std::array<u32, 256>;
+
+        // Writes the node and all nodes below it to `levels`, which start at node `firstIndex` of `level`
+        void analyzeNode(std::span<std::vector<Node>> levels, u32 level, u64 index, u64 firstIndex, std::span<const u8> data, Counts &counts) const;
+        void collect(u32 level, u64 index, const Histogram &counts, std::vector<Histogram> &pending);
+
+        u64 m_offset = 0, m_size = 0;
+        u64 m_leafSize = MinimumLeafSize;
+        u32 m_countedLevel = 0;
+
+        std::vector<std::vector<Node>> m_levels;
+
+        // Value counts of every node on the counted level and above
+        std::vector<std::vector<Histogram>> m_counts;
+        Histogram m_valueCounts = { };
+    };
+
+}
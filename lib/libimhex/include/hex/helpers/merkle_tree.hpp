@@ -0,0 +1,59 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/literals.hpp>
+
+#include <vector>
+
+namespace hex::crypt {
+
+    using namespace hex::literals;
+
+    // Hash tree over fixed size blocks of some data. Leaves are the hashes of the blocks, every other node is the hash of its two children.
+    // A node without a sibling is moved up a level unchanged. Leaves and inner nodes are prefixed with 0x00 and 0x01 before hashing so
+    // they can't be confused with each other. After parts of the data changed, only the blocks containing them and the nodes above those
+    // have to be hashed again to get the new root hash
+    class MerkleTree {
+    public:
+        explicit MerkleTree(ContextFactory createContext, u64 blockSize = 1_MiB);
+
+        // Hashes all blocks of the data on all available cores and builds the tree on top of them
+        void build(u64 size, const ReadFunction &read, const ProgressCallback &progress = { });
+
+        // Marks the blocks containing the changed bytes as outdated. Changes past the end of the data are picked up by the next update
+        void invalidate(u64 offset, u64 size);
+
+        // Hashes all outdated blocks again and updates the nodes above them. `size` is the current size of the data
+        void update(u64 size, const ReadFunction &read);
+
+        [[nodiscard]] bool isBuilt() const { return this->m_built; }
+        [[nodiscard]] bool isOutdated() const { return !this->m_outdatedLeaves.empty(); }
+
+        [[nodiscard]] u64 getDataSize() const { return this->m_dataSize; }
+        [[nodiscard]] u64 getBlockSize() const { return this->m_blockSize; }
+        [[nodiscard]] u64 getLeafCount() const { return this->m_levels.empty() ? 0 : this->m_levels.front().size(); }
+
+        [[nodiscard]] std::vector<u8> getRootHash() const;
+
+    private:
+        void hashLeaves(u64 firstLeaf, u64 leafCount, const ReadFunction &read, const ProgressCallback &progress = { });
+        void buildLevels();
+        [[nodiscard]] std::vector<u8> hashNode(const std::vector<u8> &left, const std::vector<u8> &right) const;
+
+    private:
+        ContextFactory m_createContext;
+        u64 m_blockSize;
+
+        u64 m_dataSize = 0;
+        bool m_built = false;
+
+        // All levels of the tree, starting with the leaves. The last level only contains the root
+        std::vector<std::vector<std::vector<u8>>> m_levels;
+
+        // Sorted, unique indices of leaves whose blocks changed since they were hashed
+        std::vector<u64> m_outdatedLeaves;
+    };
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/helpers/literals.hpp>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace hex::search {
+
+    using namespace hex::literals;
+
+    namespace impl {
+
+        struct RegexProgram;
+        class RegexDfa;
+
+    }
+
+    // Regular expression engine operating on raw bytes instead of characters. Patterns are compiled into an NFA which is then lazily
+    // turned into a DFA while scanning, so every input byte costs a single table lookup once the relevant states have been built.
+    //
+    // Supported syntax: literals, `.` (any byte), `[...]` classes with ranges and negation, `\xNN`, `\n`, `\r`, `\t`, `\f`, `\v`, `\0`,
+    // `\d`, `\w`, `\s` and their negations, groups, alternations and the `*`, `+`, `?` and `{n,m}` quantifiers including their lazy versions.
+    //
+    // Matches are found with leftmost-first semantics and never overlap. A match is at most `maxMatchLength` bytes long, counted from
+    // where it starts. Longer matches are cut off after the last end within that length and scanning resumes right after them.
+    // Matches without any end within `maxMatchLength` bytes of their start are cut off at their start instead
+    class Regex {
+    public:
+        struct Match {
+            u64 offset;
+            size_t size;
+        };
+
+        using Callback = std::function<void(const Match &)>;
+
+        // Throws a std::runtime_error if the pattern is invalid or could match empty data
+        explicit Regex(const std::string &pattern, size_t maxMatchLength = 4_KiB);
+        ~Regex();
+
+        Regex(const Regex&) = delete;
+        Regex(Regex &&) noexcept;
+        Regex& operator=(const Regex&) = delete;
+        Regex& operator=(Regex &&) noexcept;
+
+        // Feeds the next part of the data into the engine. Matches are reported with their offset relative to the start of the
+        // first call to process(). Matches that end close to the end of the data passed in are only reported by the next call or by finish()
+        void process(std::span<const u8> data, const Callback &callback);
+
+        // Reports the match that's still pending at the end of the data and resets the engine so it can be used on new data
+        void finish(const Callback &callback);
+
+        [[nodiscard]] size_t getMaxMatchLength() const { return this->m_maxMatchLength; }
+
+    private:
+        void scan(const Callback &callback);
+        void reportMatch(const Callback &callback);
+        [[nodiscard]] u64 findMatchStart(u64 end);
+        void reset();
+
+    private:
+        size_t m_maxMatchLength;
+
+        std::unique_ptr<impl::RegexProgram> m_forwardProgram, m_reverseProgram;
+        std::unique_ptr<impl::RegexDfa> m_forward, m_reverse;
+
+        // Bytes that are still needed to find the start of a match or to resume scanning after one
+        std::vector<u8> m_buffer;
+        u64 m_bufferOffset = 0;
+
+        u32 m_state = 0;
+        u64 m_position = 0, m_searchStart = 0;
+        std::optional<u64> m_matchStart, m_matchEnd;
+    };
+
+}
@@ -0,0 +1,581 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace hex::search {
+
+    class SequenceSearcher {
+    public:
+        explicit SequenceSearcher(std::vector<u8> needle);
+
+        // Returns the offset of the first occurrence of the needle in the haystack that starts at or after `offset`
+        [[nodiscard]] std::optional<size_t> find(std::span<const u8> haystack, size_t offset = 0) const;
+
+        // Calls the callback with the offset of every occurrence of the needle in the haystack.
+        // In non-overlapping mode, searching continues after the end of each match instead of after its first byte
+        template<std::invocable<size_t> Callback>
+        void findAll(std::span<const u8> haystack, bool overlapping, Callback &&callback) const {
+            size_t offset = 0;
+            while (auto match = this->find(haystack, offset)) {
+                callback(*match);
+                offset = *match + (overlapping ? 1 : this->m_needle.size());
+            }
+        }
+
+        [[nodiscard]] const std::vector<u8> &getNeedle() const { return this->m_needle; }
+
+    private:
+        [[nodiscard]] bool matchesAt(const u8 *data) const;
+
+        std::vector<u8> m_needle;
+
+        // Indices of the two least common bytes of the needle. These are used to filter out candidate positions before comparing the entire needle
+        size_t m_rareIndex1 = 0, m_rareIndex2 = 0;
+    };
+
+    struct MaskedByte {
+        u8 mask, value;
+    };
+
+    // Bit-parallel Shift-And matcher for patterns with wildcard bits. Every input byte is looked at exactly once so
+    // scanning is linear in the size of the data regardless of the pattern. State is kept between calls to process()
+    // so data can be fed in chunks without any overlap
+    class PatternMatcher {
+    public:
+        explicit PatternMatcher(const std::vector<MaskedByte> &pattern);
+
+        void reset();
+
+        // Calls the callback with the offset of the last byte of every match that ends inside of data
+        template<std::invocable<size_t> Callback>
+        void process(std::span<const u8> data, Callback &&callback) {
+            if (this->m_patternSize == 0)
+                return;
+
+            if (this->m_state.size() == 1)
+                this->processSingleWord(data, callback);
+            else
+                this->processMultiWord(data, callback);
+        }
+
+        [[nodiscard]] size_t getPatternSize() const { return this->m_patternSize; }
+
+    private:
+        template<typename Callback>
+        void processSingleWord(std::span<const u8> data, Callback &callback) {
+            const u64 *table = this->m_table.data();
+            const u64 matchBit = this->m_matchBit;
+            u64 state = this->m_state[0];
+
+            for (size_t i = 0; i < data.size(); i++) {
+                // Nothing is partially matched, skip straight to the next byte that can start a match
+                if (state == 0 && this->m_firstByte.has_value()) {
+                    auto next = static_cast<const u8 *>(std::memchr(data.data() + i, *this->m_firstByte, data.size() - i));
+                    if (next == nullptr)
+                        break;
+
+                    i = next - data.data();
+                }
+
+                state = ((state << 1) | 1) & table[data[i]];
+                if (state & matchBit) [[unlikely]]
+                    callback(i);
+            }
+
+            this->m_state[0] = state;
+        }
+
+        template<typename Callback>
+        void processMultiWord(std::span<const u8> data, Callback &callback) {
+            const size_t words = this->m_state.size();
+            u64 *state = this->m_state.data();
+
+            for (size_t i = 0; i < data.size(); i++) {
+                const u64 *mask = &this->m_table[data[i] * words];
+
+                u64 carry = 1;
+                for (size_t word = 0; word < words; word++) {
+                    const u64 shifted = (state[word] << 1) | carry;
+                    carry = state[word] >> 63;
+                    state[word] = shifted & mask[word];
+                }
+
+                if (state[words - 1] & this->m_matchBit) [[unlikely]]
+                    callback(i);
+            }
+        }
+
+    private:
+        size_t m_patternSize = 0;
+        u64 m_matchBit = 0;
+
+        // Byte every match has to start with, if the first pattern element doesn't contain any wildcard bits
+        std::optional<u8> m_firstByte;
+
+        // For every possible byte value, a bit set of the pattern positions that byte satisfies
+        std::vector<u64> m_table;
+        std::vector<u64> m_state;
+    };
+
+    // Aho-Corasick automaton that finds all occurrences of a set of needles in a single pass. The automaton is stored as a full
+    // transition table over the byte values used by the needles so every input byte costs a single lookup. State is kept between
+    // calls to process() so data can be fed in chunks without any overlap
+    class MultiSequenceSearcher {
+    public:
+        explicit MultiSequenceSearcher(const std::vector<std::vector<u8>> &needles);
+
+        void reset();
+
+        // Calls the callback with the index of the needle and the offset of its last byte for every occurrence that ends inside of data
+        template<std::invocable<size_t, size_t> Callback>
+        void process(std::span<const u8> data, Callback &&callback) {
+            const u32 *transitions = this->m_transitions.data();
+            const u16 *classes = this->m_classes.data();
+            u32 state = this->m_state;
+
+            for (size_t i = 0; i < data.size(); i++) {
+                state = transitions[(state & ~OutputBit) + classes[data[i]]];
+
+                if (state & OutputBit) [[unlikely]] {
+                    const auto node = (state & ~OutputBit) / this->m_classCount;
+                    for (u32 output = this->m_outputOffsets[node]; output < this->m_outputOffsets[node + 1]; output++)
+                        callback(this->m_outputs[output], i);
+                }
+            }
+
+            this->m_state = state;
+        }
+
+        [[nodiscard]] size_t getNeedleCount() const { return this->m_needleCount; }
+
+    private:
+        // States are identified by their offset in the transition table. States at which a needle ends have this bit set
+        constexpr static u32 OutputBit = 0x8000'0000;
+
+        size_t m_needleCount = 0;
+
+        std::array<u16, 256> m_classes = { };
+        u32 m_classCount = 0;
+
+        std::vector<u32> m_transitions;
+
+        // Indices of the needles ending at each state, including the ones reachable through suffix links
+        std::vector<u32> m_outputOffsets, m_outputs;
+
+        u32 m_state = 0;
+    };
+
+    // Finds approximate occurrences of a pattern of up to 64 bytes. With substitutions only, the Hamming distance of every
+    // position is computed with Wu and Manber's extension of Shift-And, keeping one state per number of allowed substitutions.
+    // With insertions and deletions, Myers' bit-vector algorithm computes the edit distance of the best match ending at every
+    // position. Of neighbouring positions that match with the same error, only the best one is reported
+    class ApproximateMatcher {
+    public:
+        enum class Metric : u8 { Hamming, Levenshtein };
+
+        struct Match {
+            u64 offset;
+            size_t size;
+            u32 distance;
+
+            bool operator==(const Match &) const = default;
+        };
+
+        using Callback = std::function<void(const Match &)>;
+
+        constexpr static size_t MaxPatternSize = 64;
+
+        // Throws a std::runtime_error if the pattern is empty, too long or the distance is big enough to match anything
+        ApproximateMatcher(std::vector<u8> pattern, u32 maxDistance, Metric metric);
+
+        // Feeds the next part of the data into the matcher. Matches are reported with their offset relative to the start of the
+        // first call to process(). With insertions and deletions, a match ending at the end of the data is only reported by the next call or by finish()
+        void process(std::span<const u8> data, const Callback &callback);
+
+        // Reports the match that's still pending at the end of the data and resets the matcher so it can be used on new data
+        void finish(const Callback &callback);
+
+        // Number of bytes a match can span. Parts of the data that are searched independently need to overlap by this much
+        [[nodiscard]] size_t getMaxMatchSize() const { return this->m_pattern.size() + (this->m_metric == Metric::Levenshtein ? this->m_maxDistance : 0); }
+
+    private:
+        void reset();
+        void reportEdit(u64 end, u32 distance, std::span<const u8> data, u64 dataOffset, const Callback &callback) const;
+        [[nodiscard]] size_t findMatchSize(const std::vector<u8> &window, u32 distance) const;
+
+    private:
+        std::vector<u8> m_pattern;
+        u32 m_maxDistance;
+        Metric m_metric;
+
+        std::array<u64, 256> m_masks = { };
+        u64 m_highBit = 0;
+
+        // Hamming distance: bit i of state d is set if the first i + 1 bytes of the pattern match with at most d substitutions
+        std::vector<u64> m_states;
+
+        // Edit distance: vertical delta vectors of Myers' algorithm and the distance of the last two positions
+        u64 m_positive = 0, m_negative = 0;
+        u32 m_score = 0, m_previousScore = 0, m_olderScore = 0;
+
+        u64 m_position = 0;
+
+        // Last bytes seen, needed to find the start of edit distance matches that end shortly after the start of the data passed in
+        std::vector<u8> m_history;
+    };
+
+    // Finds numeric values matching a condition and narrows the set down on later scans. The first scan goes over all of the data,
+    // rescans only read the values at the addresses that survived the previous scan and compare them to what they were back then
+    class ValueScanner {
+    public:
+        enum class Type : u8 { U8, I8, U16, I16, U32, I32, U64, I64, Float, Double };
+        enum class Predicate : u8 { Equal, Range, Changed, Unchanged, Increased, Decreased };
+
+        struct Settings {
+            Type type = Type::U32;
+            std::endian endian = std::endian::little;
+
+            // Only consider values whose address is a multiple of their size
+            bool aligned = true;
+        };
+
+        // Values are stored as the bit pattern of the native representation of the type, zero extended to 64 bits
+        struct Condition {
+            Predicate predicate = Predicate::Equal;
+            u64 minimum = 0, maximum = 0;
+        };
+
+        struct Candidate {
+            u64 address;
+            u64 value;
+
+            bool operator==(const Candidate &) const = default;
+        };
+
+        using ReadFunction = std::function<void(u64 address, std::span<u8> buffer)>;
+        using ProgressCallback = std::function<void(size_t checkedCandidates)>;
+
+        ValueScanner(Settings settings, size_t limit);
+
+        // Feeds the next part of the data into the first scan. Chunks need to overlap by one byte less than the size of the type and
+        // only values that fit entirely into a chunk are checked. Only Equal and Range can be used here, throws a std::runtime_error otherwise.
+        // Returns false once the candidate limit has been reached
+        bool scan(std::span<const u8> data, u64 address, const Condition &condition);
+
+        // Reads the current values of all candidates and keeps the ones matching the condition. Relative predicates compare against
+        // the value a candidate had during the previous scan. The candidates are left untouched if reading throws
+        void rescan(const Condition &condition, const ReadFunction &read, const ProgressCallback &progress = { });
+
+        [[nodiscard]] const std::vector<Candidate> &getCandidates() const { return this->m_candidates; }
+        [[nodiscard]] const Settings &getSettings() const { return this->m_settings; }
+        [[nodiscard]] bool isFull() const { return this->m_candidates.size() >= this->m_limit; }
+
+        [[nodiscard]] static size_t getTypeSize(Type type);
+
+        // Parses a decimal or 0x prefixed hexadecimal number, returns std::nullopt if it doesn't fit into the type
+        [[nodiscard]] static std::optional<u64> parseValue(Type type, const std::string &string);
+        [[nodiscard]] static std::string formatValue(Type type, u64 value);
+
+        // Converts the bytes of a value in the given byte order to the representation used by conditions
+        [[nodiscard]] static u64 loadValue(std::span<const u8> bytes, std::endian endian);
+
+    private:
+        Settings m_settings;
+        size_t m_limit;
+
+        std::vector<Candidate> m_candidates;
+    };
+
+    // Extracts runs of printable characters from a stream of data in a single pass. Data is classified in blocks of 64 bytes
+    // into bit masks which are then used to find the strings of all requested encodings at once
+    class StringExtractor {
+    public:
+        enum class Encoding : u8 { ASCII, UTF8, UTF16LE, UTF16BE };
+
+        struct Settings {
+            // Bytes that count as characters. Only the lower half of the table is used, non-ASCII characters are handled by the UTF-8 decoder
+            std::array<bool, 256> validCharacters = { };
+            size_t minLength = 1;
+            bool nullTermination = false;
+
+            bool ascii = true, utf8 = false, utf16le = false, utf16be = false;
+        };
+
+        struct String {
+            u64 offset;
+            size_t size;
+            Encoding encoding;
+
+            bool operator==(const String &) const = default;
+        };
+
+        using Callback = std::function<void(const String &)>;
+
+        explicit StringExtractor(const Settings &settings);
+
+        // Feeds the next part of the data into the extractor. Strings are reported with their offset relative to the start of the first
+        // call to process(). Strings that end close to the end of the data passed in are only reported by the next call or by finish()
+        void process(std::span<const u8> data, const Callback &callback);
+
+        // Reports all strings that are still pending at the end of the data
+        void finish(const Callback &callback);
+
+    private:
+        struct Block {
+            std::array<u8, 64> bytes = { };
+            size_t size = 0;
+            u64 offset = 0;
+
+            u64 valid = 0, zero = 0, high = 0;
+        };
+
+        struct Run {
+            bool active = false;
+            bool multiByte = false;
+            u64 start = 0;
+            size_t characters = 0;
+        };
+
+        void classify(Block &block) const;
+        void pushBlock(const Callback &callback);
+        void finalize(const Block &block, const Block &next, const Callback &callback);
+        void track(Run &run, const Block &block, const Block &next, u64 covered, u64 starts, u64 multiByteStarts, Encoding encoding, const Callback &callback) const;
+        void emit(const Run &run, u64 end, bool terminated, Encoding encoding, const Callback &callback) const;
+
+    private:
+        Settings m_settings;
+
+        // Ranges of valid characters, used to classify 16 bytes at once
+        std::vector<std::pair<u8, u8>> m_ranges;
+
+        Block m_staging, m_previous;
+        bool m_hasPrevious = false;
+        u64 m_offset = 0;
+
+        Run m_asciiRun, m_utf8Run, m_utf16leRun, m_utf16beRun;
+
+        // Bits of the next block that are covered by characters that started in the previous one
+        u64 m_utf8Carry = 0, m_utf16leCarry = 0, m_utf16beCarry = 0;
+    };
+
+    // Append-only buffer that's filled by one thread while others read from it. Elements are stored in segments of doubling size
+    // that never move once they have been allocated, so readers can access every element below getSize() without any locking
+    template<typename T>
+    class ResultBuffer {
+    public:
+        ResultBuffer() = default;
+
+        ResultBuffer(const ResultBuffer&) = delete;
+        ResultBuffer& operator=(const ResultBuffer&) = delete;
+
+        // Must only be called by the writing thread
+        void push(const T &value) {
+            const auto size = this->m_size.load(std::memory_order_relaxed);
+            const auto [segment, offset] = locate(size);
+
+            if (this->m_segments[segment] == nullptr)
+                this->m_segments[segment] = std::make_unique<T[]>(FirstSegmentSize << segment);
+
+            this->m_segments[segment][offset] = value;
+
+            // Publishes the element together with its segment
+            this->m_size.store(size + 1, std::memory_order_release);
+        }
+
+        [[nodiscard]] size_t getSize() const {
+            return this->m_size.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] const T &operator[](size_t index) const {
+            const auto [segment, offset] = locate(index);
+
+            return this->m_segments[segment][offset];
+        }
+
+    private:
+        constexpr static size_t FirstSegmentSize = 1024;
+
+        static std::pair<size_t, size_t> locate(size_t index) {
+            const auto biased = index + FirstSegmentSize;
+            const auto segment = size_t(std::bit_width(biased) - std::bit_width(FirstSegmentSize));
+
+            return { segment, biased - (FirstSegmentSize << segment) };
+        }
+
+        std::array<std::unique_ptr<T[]>, 48> m_segments;
+        std::atomic<size_t> m_size = 0;
+    };
+
+    // Columnar store for search results that's filled by one thread while others read from it. Addresses are delta encoded
+    // against the first address of every block of entries. Sizes are only stored per entry if they aren't the same for all of
+    // them or can't be derived from the tag of the entry. Tags are stored with as few bytes as their largest value needs
+    class OccurrenceStore {
+    public:
+        struct Entry {
+            u64 address;
+            u64 size;
+            u32 tag;
+        };
+
+        struct Layout {
+            // Size shared by all entries
+            std::optional<u64> fixedSize;
+
+            // Size of the entries with a given tag, used if there's no fixed size
+            std::vector<u64> tagSizes;
+
+            u32 maxTag = 0;
+        };
+
+        explicit OccurrenceStore(Layout layout);
+
+        OccurrenceStore(const OccurrenceStore&) = delete;
+        OccurrenceStore& operator=(const OccurrenceStore&) = delete;
+
+        // Must only be called by the writing thread
+        void push(const Entry &entry);
+
+        [[nodiscard]] size_t getSize() const {
+            return this->m_size.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] Entry operator[](size_t index) const {
+            return { this->getAddress(index), this->getEntrySize(index), this->getTag(index) };
+        }
+
+        [[nodiscard]] u64 getAddress(size_t index) const {
+            const auto delta = this->m_addressDeltas[index];
+            if (delta == OverflowMarker) [[unlikely]]
+                return findOverflow(this->m_addressOverflows, index);
+
+            return this->m_blockAddresses[index / BlockSize] + i64(delta);
+        }
+
+        [[nodiscard]] u64 getEntrySize(size_t index) const {
+            if (this->m_layout.fixedSize.has_value())
+                return *this->m_layout.fixedSize;
+            if (!this->m_layout.tagSizes.empty())
+                return this->m_layout.tagSizes[this->getTag(index)];
+
+            const auto size = this->m_sizes[index];
+            if (size == u32(OverflowMarker)) [[unlikely]]
+                return findOverflow(this->m_sizeOverflows, index);
+
+            return size;
+        }
+
+        [[nodiscard]] u32 getTag(size_t index) const {
+            u32 tag = 0;
+            for (size_t i = 0; i < this->m_tagWidth; i++)
+                tag |= u32(this->m_tags[index * this->m_tagWidth + i]) << (i * 8);
+
+            return tag;
+        }
+
+    private:
+        constexpr static size_t BlockSize = 256;
+        constexpr static i32 OverflowMarker = std::numeric_limits<i32>::min();
+
+        using Overflows = ResultBuffer<std::pair<u64, u64>>;
+        static u64 findOverflow(const Overflows &overflows, size_t index);
+
+        Layout m_layout;
+        size_t m_tagWidth = 0;
+
+        ResultBuffer<u64> m_blockAddresses;
+        ResultBuffer<i32> m_addressDeltas;
+        ResultBuffer<u32> m_sizes;
+        ResultBuffer<u8> m_tags;
+
+        // Values that didn't fit into their column, sorted by the index of their entry
+        Overflows m_addressOverflows, m_sizeOverflows;
+
+        std::atomic<size_t> m_size = 0;
+    };
+
+    // Index over closed intervals that can be queried while more intervals keep getting added. The index only stores the ids
+    // of the intervals and looks up their bounds when needed. Ids are kept in a few runs sorted by start address whose sizes
+    // grow geometrically, adding intervals merges the smaller runs so insertion is amortized O(log n)
+    class IntervalIndex {
+    public:
+        struct Interval {
+            u64 start, end;
+        };
+
+        using Lookup = std::function<Interval(u32)>;
+
+        explicit IntervalIndex(Lookup lookup) : m_lookup(std::move(lookup)) { }
+
+        // Adds the intervals with the given ids to the index, they don't need to be sorted
+        void insert(const std::vector<u32> &ids);
+        void clear();
+
+        [[nodiscard]] bool overlaps(u64 address) const;
+
+        // Calls the callback with the id of every interval that contains the address
+        template<std::invocable<u32> Callback>
+        void findOverlapping(u64 address, Callback &&callback) const {
+            for (const auto &run : this->m_runs) {
+                this->forEachCandidate(run, address, [&](u32 id, const Interval &interval) {
+                    if (interval.end >= address)
+                        callback(id);
+
+                    return true;
+                });
+            }
+        }
+
+        [[nodiscard]] size_t getSize() const { return this->m_size; }
+
+    private:
+        constexpr static size_t BlockSize = 16;
+
+        struct Run {
+            std::vector<u32> ids;
+
+            // Largest end address of all intervals up to and including each block of ids
+            std::vector<u64> blockMaxEnd;
+        };
+
+        // Walks backwards over the intervals starting at or before the address until none of the remaining ones can reach it anymore
+        template<typename Callback>
+        void forEachCandidate(const Run &run, u64 address, Callback &&callback) const {
+            size_t low = 0, high = run.ids.size();
+            while (low < high) {
+                const auto mid = low + (high - low) / 2;
+                if (this->m_lookup(run.ids[mid]).start <= address)
+                    low = mid + 1;
+                else
+                    high = mid;
+            }
+
+            for (size_t index = low; index > 0; index--) {
+                if (run.blockMaxEnd[(index - 1) / BlockSize] < address)
+                    break;
+
+                const auto id = run.ids[index - 1];
+                if (!callback(id, this->m_lookup(id)))
+                    break;
+            }
+        }
+
+        Lookup m_lookup;
+        std::vector<Run> m_runs;
+        size_t m_size = 0;
+    };
+
+}
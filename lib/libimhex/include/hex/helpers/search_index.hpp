@@ -0,0 +1,59 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/helpers/literals.hpp>
+#include <hex/helpers/search.hpp>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace hex::search {
+
+    using namespace hex::literals;
+
+    // Index that records which 3-grams occur in every block of some data. A search can use it to find the blocks a pattern could
+    // start in and only scan those. Every block gets a signature with one bit per hashed 3-gram. Blocks where nearly all bits are
+    // set, like ones containing compressed or encrypted data, don't get a signature and are always considered candidates
+    class NGramIndex {
+    public:
+        constexpr static size_t BlockSize = 128_KiB;
+        constexpr static size_t SignatureBits = 64 * 1024;
+
+        // Feeds the next part of the data into the index
+        void process(std::span<const u8> data);
+
+        // Completes the signature of the last block. The index can be queried afterwards
+        void finish();
+
+        // Returns for every block whether a match of the pattern could start inside of it. Patterns without three consecutive
+        // bytes that don't contain any wildcard bits can't be filtered and match in every block
+        [[nodiscard]] std::vector<bool> findCandidateBlocks(const std::vector<MaskedByte> &pattern) const;
+
+        [[nodiscard]] u64 getDataSize() const { return this->m_dataSize; }
+        [[nodiscard]] size_t getBlockCount() const { return this->m_blockSignatures.size(); }
+
+        [[nodiscard]] std::vector<u8> serialize() const;
+        [[nodiscard]] static std::optional<NGramIndex> deserialize(std::span<const u8> data);
+
+    private:
+        constexpr static u32 NoSignature = 0xFFFF'FFFF;
+        constexpr static size_t SignatureWords = SignatureBits / 64;
+
+        [[nodiscard]] static u32 hash(u8 a, u8 b, u8 c);
+        [[nodiscard]] bool containsAll(size_t block, const std::vector<u32> &hashes) const;
+        void completeBlock();
+
+    private:
+        u64 m_dataSize = 0;
+
+        // Index of each block's signature in m_signatures or NoSignature if every gram should be considered present
+        std::vector<u32> m_blockSignatures;
+        std::vector<u64> m_signatures;
+
+        std::array<u64, SignatureWords> m_currentSignature = { };
+        u8 m_history[2] = { };
+    };
+
+}
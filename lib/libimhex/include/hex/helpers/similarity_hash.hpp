@@ -0,0 +1,30 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/helpers/crypto.hpp>
+
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace hex::crypt {
+
+    // Context triggered piecewise hash as calculated by ssdeep. The digest is the textual "blocksize:hash:hash" representation.
+    // The block size normally depends on the length of the data, so the hash is calculated for all block sizes at once and the
+    // ones that can't be picked anymore are dropped along the way
+    std::unique_ptr<HashContext> createSsdeepContext();
+
+    // Returns how similar the data of two ssdeep digests is, from 0 for nothing in common to 100 for a perfect match.
+    // Digests that can't be parsed yield nothing
+    std::optional<u32> compareSsdeep(std::string_view left, std::string_view right);
+
+    // Locality sensitive hash following TLSH with 128 buckets and a one byte checksum. The digest is the textual "T1" representation.
+    // Data that is shorter than 50 bytes or too uniform doesn't get a hash, the digest is empty then
+    std::unique_ptr<HashContext> createTlshContext();
+
+    // Returns the distance between the data of two TLSH digests, 0 for identical data and growing the more the data differs.
+    // Digests that can't be parsed yield nothing
+    std::optional<u32> compareTlsh(std::string_view left, std::string_view right);
+
+}
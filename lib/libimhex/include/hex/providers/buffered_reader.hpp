@@ -1,6 +1,8 @@
 #pragma once
 
+#include <concepts>
 #include <span>
+#include <type_traits>
 #include <vector>
 
 #include <hex/providers/provider.hpp>
@@ -61,6 +63,37 @@ namespace hex::prv {
             return { result, result + std::min(size, this->m_buffer.size()) };
         }
 
+        // Calls the callback with consecutive contiguous chunks of the data between the start and end address.
+        // Neighbouring chunks overlap by `overlap` bytes so sequences crossing a chunk boundary are still seen in one piece.
+        // If the callback returns a bool, returning false stops the iteration early
+        template<std::invocable<u64, std::span<const u8>> Callback>
+        void forEachChunk(size_t overlap, Callback &&callback) {
+            if (this->m_startAddress > this->m_endAddress)
+                return;
+
+            u64 address = this->m_startAddress;
+            while (true) {
+                const auto chunkSize = std::min<u64>(this->m_maxBufferSize, (this->m_endAddress - address) + 1);
+
+                this->m_buffer.resize(chunkSize);
+                this->m_provider->read(address, this->m_buffer.data(), this->m_buffer.size());
+                this->m_bufferAddress = address;
+                this->m_bufferValid = true;
+
+                if constexpr (std::same_as<std::invoke_result_t<Callback, u64, std::span<const u8>>, bool>) {
+                    if (!callback(address, std::span<const u8>(this->m_buffer)))
+                        break;
+                } else {
+                    callback(address, std::span<const u8>(this->m_buffer));
+                }
+
+                if (address + chunkSize > this->m_endAddress)
+                    break;
+
+                address += chunkSize > overlap ? chunkSize - overlap : chunkSize;
+            }
+        }
+
         class Iterator {
         public:
             using iterator_category = std::forward_iterator_tag;
@@ -2,9 +2,13 @@
 
 #include <hex.hpp>
 
+#include <atomic>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -52,6 +56,8 @@ namespace hex::prv {
         [[nodiscard]] Overlay *newOverlay();
         void deleteOverlay(Overlay *overlay);
         [[nodiscard]] const std::list<Overlay *> &getOverlays();
+        // Overlays are applied on top of all reads, so changing one has to be reported like any other data change. Doesn't mark the provider as dirty
+        void markOverlayChanged(const Region &region);
 
         [[nodiscard]] u32 getPageCount() const;
         [[nodiscard]] u32 getCurrentPage() const;
@@ -70,6 +76,15 @@ namespace hex::prv {
         virtual void close() = 0;
 
         void addPatch(u64 offset, const void *buffer, size_t size, bool createUndo = false);
+
+        // Adds patches sorted by address, all of them share a single undo point
+        void addPatches(const std::vector<std::pair<u64, u8>> &patches, bool createUndo = true);
+
+        // Replaces `size` bytes at every one of the sorted, non-overlapping offsets with the same data. Replacements of the same size
+        // are added as patches with a single undo point. Other ones resize the data, moving everything in between the replaced regions once.
+        // Those are written to the data directly and undoing them moves the data back
+        void replace(const std::vector<u64> &offsets, size_t size, std::span<const u8> data);
+
         void createUndoPoint();
 
         void undo();
@@ -78,6 +93,10 @@ namespace hex::prv {
         [[nodiscard]] bool canUndo() const;
         [[nodiscard]] bool canRedo() const;
 
+        // Data that can change on its own without going through the provider, e.g. the memory of a debugged process. Results calculated from
+        // such data may be outdated even if no EventDataChanged has been posted in the meantime
+        [[nodiscard]] virtual bool isDataVolatile() const;
+
         [[nodiscard]] virtual bool hasFilePicker() const;
         virtual bool handleFilePicker();
 
@@ -98,11 +117,37 @@ namespace hex::prv {
         void markDirty(bool dirty = true) { this->m_dirty = dirty; }
         [[nodiscard]] bool isDirty() const { return this->m_dirty; }
 
+        // Counter that changes once with every EventDataChanged posted for this provider
+        [[nodiscard]] u64 getDataVersion() const { return this->m_dataVersion; }
+
         virtual std::pair<Region, bool> getRegionValidity(u64 address) const;
 
         void skipLoadInterface() { this->m_skipLoadInterface = true; }
         [[nodiscard]] bool shouldSkipLoadInterface() const { return this->m_skipLoadInterface; }
 
+    private:
+        // A replacement that changed the size of the data. It has been written to the data directly instead of being added as patches
+        struct ResizingReplacement {
+            std::vector<u64> offsets;
+            size_t size;
+            std::vector<u8> data;
+
+            // Bytes that were replaced at every offset, one after another
+            std::vector<u8> originalData;
+        };
+
+        void discardRedoHistory();
+        [[nodiscard]] size_t getUndoStateIndex() const;
+        void replaceData(const std::vector<u64> &offsets, size_t size, size_t newSize, std::span<const u8> data);
+        void markPatchesChanged(const std::map<u64, u8> &before, const std::map<u64, u8> &after);
+        void queueDataChanged(u64 offset, size_t size);
+        void postDataChanged();
+
+    protected:
+        // Has to be called whenever the data in the given region changed. Marks the provider as dirty and posts EventDataChanged on the main thread
+        // during the next frame. All changes made until then are combined into a single event covering all of them
+        void markDataChanged(u64 offset, size_t size);
+
     protected:
         u32 m_currPage    = 0;
         u64 m_baseAddress = 0;
@@ -115,9 +160,19 @@ namespace hex::prv {
 
         bool m_dirty = false;
         bool m_skipLoadInterface = false;
+        std::atomic<u64> m_dataVersion = 0;
 
     private:
         static u32 s_idCounter;
+
+        // Resizing replacements by the index of the undo state they created
+        std::map<size_t, ResizingReplacement> m_resizingReplacements;
+
+        std::mutex m_dataChangeMutex;
+        std::optional<Region> m_pendingDataChange;
+
+        // Expires together with the provider so deferred calls can tell if it still exists
+        std::shared_ptr<bool> m_aliveToken = std::make_shared<bool>(true);
     };
 
 }
\ No newline at end of file
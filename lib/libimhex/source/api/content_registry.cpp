@@ -5,6 +5,7 @@
 #include <hex/helpers/logger.hpp>
 
 #include <hex/ui/view.hpp>
+#include <hex/providers/provider.hpp>
 
 #include <filesystem>
 #include <fstream>
@@ -613,6 +614,20 @@ namespace hex {
             getHashes().push_back(hash);
         }
 
+        Hash::Function Hash::create(const std::string &name, const Function::ContextFactory &contextFactory) const {
+            auto callback = [contextFactory](const Region &region, prv::Provider *provider) {
+                auto context = contextFactory();
+
+                crypt::updateAll({ context.get() }, region.getStartAddress(), region.getSize(), [provider](u64 offset, std::span<u8> buffer) {
+                    provider->read(offset, buffer.data(), buffer.size());
+                });
+
+                return context->finish();
+            };
+
+            return { this, name, callback, contextFactory };
+        }
+
     }
 
 }
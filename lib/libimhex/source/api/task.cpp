@@ -180,12 +180,15 @@ namespace hex {
     }
 
     void TaskManager::runDeferredCalls() {
-        std::scoped_lock lock(s_deferredCallsMutex);
-
-        for (const auto &call : s_deferredCalls)
+        // Deferred calls may defer further calls themselves, those run in the next frame
+        std::list<std::function<void()>> calls;
+        {
+            std::scoped_lock lock(s_deferredCallsMutex);
+            std::swap(calls, s_deferredCalls);
+        }
+
+        for (const auto &call : calls)
             call();
-
-        s_deferredCalls.clear();
     }
 
 }
\ No newline at end of file
@@ -1,12 +1,13 @@
 #include <hex/helpers/crypto.hpp>
 
+#include <hex/api/task.hpp>
 #include <hex/providers/provider.hpp>
+#include <hex/providers/buffered_reader.hpp>
 #include <hex/helpers/utils.hpp>
 #include <hex/helpers/concepts.hpp>
+#include <hex/helpers/fmt.hpp>
 
 #include <mbedtls/version.h>
-#include <mbedtls/base64.h>
-#include <mbedtls/bignum.h>
 #include <mbedtls/md5.h>
 #include <mbedtls/sha1.h>
 #include <mbedtls/sha256.h>
@@ -15,12 +16,33 @@
 #include <mbedtls/cipher.h>
 
 #include <array>
+#include <map>
+#include <memory>
 #include <span>
+#include <tuple>
+#include <utility>
 #include <functional>
 #include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <cstddef>
 #include <cstdint>
 #include <bit>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+// Instruction set extensions beyond the x86-64 baseline are compiled for their own target and only used if the CPU supports them
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define CRYPTO_X86_64_DISPATCH
+#endif
+
+#if defined(__SSE2__) || defined(CRYPTO_X86_64_DISPATCH)
+    #include <immintrin.h>
+#endif
 
 #if MBEDTLS_VERSION_MAJOR <= 2
 
@@ -45,14 +67,25 @@
 namespace hex::crypt {
     using namespace std::placeholders;
 
-    template<std::invocable<unsigned char *, size_t> Func>
-    void processDataByChunks(prv::Provider *data, u64 offset, size_t size, Func func) {
-        std::array<u8, 512> buffer = { 0 };
-        for (size_t bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const auto readSize = std::min(buffer.size(), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            func(buffer.data(), readSize);
-        }
+    constexpr static size_t ProviderChunkSize = 4 * 1024 * 1024;
+
+    // Reads the data in large chunks and hands them to the function without any further copies. If a task is given, its progress is
+    // updated after every chunk. Interrupting the task stops the processing by throwing out of this function
+    template<std::invocable<const u8 *, size_t> Func>
+    void processDataByChunks(prv::Provider *data, u64 offset, size_t size, Func func, Task *task = nullptr) {
+        if (size == 0)
+            return;
+
+        prv::BufferedReader reader(data, std::min(size, ProviderChunkSize));
+        reader.seek(offset);
+        reader.setEndAddress(offset + size - 1);
+
+        reader.forEachChunk(0, [&](u64 address, std::span<const u8> chunk) {
+            func(chunk.data(), chunk.size());
+
+            if (task != nullptr)
+                task->update(address + chunk.size() - offset);
+        });
     }
 
     template<typename T>
@@ -83,341 +116,1185 @@ namespace hex::crypt {
         }
     }
 
-    template<size_t NumBits> requires (std::has_single_bit(NumBits))
-    class Crc {
-        // use reflected algorithm, so we reflect only if refin / refout is FALSE
-        // mask values, 0b1 << 64 is UB, so use 0b10 << 63
+    namespace {
 
-    public:
-        constexpr Crc(u64 polynomial, u64 init, u64 xorOut, bool reflectInput, bool reflectOutput)
-            : m_value(0x00), m_init(init & ((0b10ull << (NumBits - 1)) - 1)), m_xorOut(xorOut & ((0b10ull << (NumBits - 1)) - 1)),
-              m_reflectInput(reflectInput), m_reflectOutput(reflectOutput),
-              m_table([polynomial]() {
-                auto reflectedPoly = reflect(polynomial & ((0b10ull << (NumBits - 1)) - 1), NumBits);
-                std::array<uint64_t, 256> table = { 0 };
-
-                for (uint32_t i = 0; i < 256; i++) {
-                    uint64_t c = i;
-                    for (std::size_t j = 0; j < 8; j++) {
-                        if (c & 0b1)
-                            c = reflectedPoly ^ (c >> 1);
-                        else
-                            c >>= 1;
-                    }
-                    table[i] = c;
+        // Lookup tables for slicing-by-8. tables[k][b] is the register after processing byte b followed by k zero bytes.
+        // Registers are 32 bits wide for all widths, reflected CRCs keep their value in the low bits, non-reflected ones in the high bits
+        struct CrcTables {
+            std::array<std::array<u32, 256>, 8> tables;
+
+            // Folding constants for reflected 32 bit CRCs, see "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction"
+            u64 k1, k2, k3, k4, k5, polynomial, mu;
+        };
+
+        // x^n mod P in normal bit order
+        u32 xPowModP(u32 n, u32 polynomial) {
+            u64 result = 1;
+            for (u32 i = 0; i < n; i++) {
+                result <<= 1;
+                if (result & (u64(1) << 32))
+                    result ^= (u64(1) << 32) | polynomial;
+            }
+
+            return u32(result);
+        }
+
+        // floor(x^64 / P) in normal bit order
+        u64 barrettMu(u32 polynomial) {
+            const auto divisor = (u64(1) << 32) | polynomial;
+
+            u64 quotient = 0, remainder = u64(1) << 32;
+            for (u32 bit = 33; bit > 0; bit--) {
+                if (remainder & (u64(1) << 32)) {
+                    quotient |= u64(1) << (bit - 1);
+                    remainder ^= divisor;
+                }
+                remainder <<= 1;
+            }
+
+            return quotient;
+        }
+
+        CrcTables generateCrcTables(u32 polynomial, size_t numBits, bool reflected) {
+            CrcTables result = { };
+            auto &tables = result.tables;
+
+            if (reflected) {
+                const auto reflectedPolynomial = reflect(polynomial, numBits);
+                for (u32 i = 0; i < 256; i++) {
+                    u32 value = i;
+                    for (u32 j = 0; j < 8; j++)
+                        value = (value & 1) ? (value >> 1) ^ reflectedPolynomial : value >> 1;
+                    tables[0][i] = value;
+                }
+
+                for (size_t k = 1; k < tables.size(); k++) {
+                    for (u32 i = 0; i < 256; i++)
+                        tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+                }
+            } else {
+                const auto alignedPolynomial = polynomial << (32 - numBits);
+                for (u32 i = 0; i < 256; i++) {
+                    u32 value = i << 24;
+                    for (u32 j = 0; j < 8; j++)
+                        value = (value & 0x8000'0000) ? (value << 1) ^ alignedPolynomial : value << 1;
+                    tables[0][i] = value;
+                }
+
+                for (size_t k = 1; k < tables.size(); k++) {
+                    for (u32 i = 0; i < 256; i++)
+                        tables[k][i] = (tables[k - 1][i] << 8) ^ tables[0][tables[k - 1][i] >> 24];
+                }
+            }
+
+            if (reflected && numBits == 32) {
+                auto constant = [&](u32 n) { return u64(reflect(xPowModP(n, polynomial), 32)) << 1; };
+
+                result.k1 = constant(4 * 128 + 32);
+                result.k2 = constant(4 * 128 - 32);
+                result.k3 = constant(128 + 32);
+                result.k4 = constant(128 - 32);
+                result.k5 = constant(64);
+                result.polynomial = (u64(reflect(polynomial, 32)) << 1) | 1;
+                result.mu = reflect(barrettMu(polynomial), 33);
+            }
+
+            return result;
+        }
+
+        // Tables only depend on the polynomial, the width and the input bit order so they're shared between all CRCs using the same ones
+        std::shared_ptr<const CrcTables> getCrcTables(u32 polynomial, size_t numBits, bool reflected) {
+            static std::mutex mutex;
+            static std::map<std::tuple<u32, size_t, bool>, std::shared_ptr<const CrcTables>> cache;
+
+            std::scoped_lock lock(mutex);
+
+            auto &tables = cache[{ polynomial, numBits, reflected }];
+            if (tables == nullptr)
+                tables = std::make_shared<const CrcTables>(generateCrcTables(polynomial, numBits, reflected));
+
+            return tables;
+        }
+
+        u32 loadLE32(const u8 *data) {
+            return u32(data[0]) | (u32(data[1]) << 8) | (u32(data[2]) << 16) | (u32(data[3]) << 24);
+        }
+
+        u32 loadBE32(const u8 *data) {
+            return (u32(data[0]) << 24) | (u32(data[1]) << 16) | (u32(data[2]) << 8) | u32(data[3]);
+        }
+
+        #if defined(CRYPTO_X86_64_DISPATCH)
+
+            bool hasCarrylessMultiply() {
+                static const bool supported = __builtin_cpu_supports("pclmul");
+                return supported;
+            }
+
+            [[gnu::target("pclmul")]]
+            __m128i foldBlock(__m128i value, __m128i constants, __m128i next) {
+                return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(value, constants, 0x00), _mm_clmulepi64_si128(value, constants, 0x11)), next);
+            }
+
+            // Folds all complete 16 byte blocks into the register. Requires at least 64 bytes of data
+            [[gnu::target("pclmul")]]
+            u32 foldCrc32(u32 crc, const u8 *&data, size_t &size, const CrcTables &tables) {
+                auto load = [&data] { auto value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)); data += 16; return value; };
+
+                __m128i x1 = _mm_xor_si128(load(), _mm_cvtsi32_si128(int(crc)));
+                __m128i x2 = load(), x3 = load(), x4 = load();
+                size -= 64;
+
+                const auto k1k2 = _mm_set_epi64x(i64(tables.k2), i64(tables.k1));
+                while (size >= 64) {
+                    x1 = foldBlock(x1, k1k2, load());
+                    x2 = foldBlock(x2, k1k2, load());
+                    x3 = foldBlock(x3, k1k2, load());
+                    x4 = foldBlock(x4, k1k2, load());
+                    size -= 64;
                 }
 
-                return table;
-         }()) {
+                const auto k3k4 = _mm_set_epi64x(i64(tables.k4), i64(tables.k3));
+                x1 = foldBlock(x1, k3k4, x2);
+                x1 = foldBlock(x1, k3k4, x3);
+                x1 = foldBlock(x1, k3k4, x4);
+
+                while (size >= 16) {
+                    x1 = foldBlock(x1, k3k4, load());
+                    size -= 16;
+                }
+
+                // Fold 128 bits down to 64 and then 32 bits
+                const auto mask32 = _mm_setr_epi32(-1, 0, 0, 0);
+                x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x10), _mm_srli_si128(x1, 8));
+                x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), _mm_set_epi64x(0, i64(tables.k5)), 0x00), _mm_srli_si128(x1, 4));
+
+                // Barrett reduction
+                const auto polynomialMu = _mm_set_epi64x(i64(tables.mu), i64(tables.polynomial));
+                auto reduced = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), polynomialMu, 0x10);
+                reduced = _mm_clmulepi64_si128(_mm_and_si128(reduced, mask32), polynomialMu, 0x00);
+                x1 = _mm_xor_si128(x1, reduced);
+
+                return u32(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+            }
+
+        #endif
+
+    }
+
+    template<size_t NumBits> requires (std::has_single_bit(NumBits) && NumBits <= 32)
+    class Crc {
+    public:
+        Crc(u32 polynomial, u32 init, u32 xorOut, bool reflectInput, bool reflectOutput)
+            : m_init(init & Mask), m_xorOut(xorOut & Mask), m_reflectInput(reflectInput), m_reflectOutput(reflectOutput),
+              m_tables(getCrcTables(polynomial & Mask, NumBits, reflectInput)) {
             reset();
         };
 
-        constexpr void reset() {
-            this->m_value = reflect(m_init, NumBits);
+        void reset() {
+            if (this->m_reflectInput)
+                this->m_value = reflect(this->m_init, NumBits);
+            else
+                this->m_value = this->m_init << (32 - NumBits);
         }
 
-        constexpr void processBytes(const unsigned char *data, std::size_t size) {
-            for (std::size_t i = 0; i < size; i++) {
-                u8 byte;
-                if (this->m_reflectInput)
-                    byte = data[i];
-                else
-                    byte = reflect(data[i]);
+        void processBytes(const unsigned char *data, std::size_t size) {
+            const auto &tables = this->m_tables->tables;
+            u32 value = this->m_value;
+
+            if (this->m_reflectInput) {
+                #if defined(CRYPTO_X86_64_DISPATCH)
+                    if (NumBits == 32 && size >= 64 && hasCarrylessMultiply())
+                        value = foldCrc32(value, data, size, *this->m_tables);
+                #endif
+
+                for (; size >= 8; data += 8, size -= 8) {
+                    const u32 low = value ^ loadLE32(data), high = loadLE32(data + 4);
+
+                    value = tables[7][low & 0xFF]  ^ tables[6][(low >> 8) & 0xFF]  ^ tables[5][(low >> 16) & 0xFF]  ^ tables[4][low >> 24] ^
+                            tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+                }
+
+                for (; size > 0; data++, size--)
+                    value = tables[0][(value ^ *data) & 0xFF] ^ (value >> 8);
+            } else {
+                for (; size >= 8; data += 8, size -= 8) {
+                    const u32 high = value ^ loadBE32(data), low = loadBE32(data + 4);
 
-                this->m_value = this->m_table[(this->m_value ^ byte) & 0xFFL] ^ (this->m_value >> 8);
+                    value = tables[7][high >> 24] ^ tables[6][(high >> 16) & 0xFF] ^ tables[5][(high >> 8) & 0xFF] ^ tables[4][high & 0xFF] ^
+                            tables[3][low >> 24]  ^ tables[2][(low >> 16) & 0xFF]  ^ tables[1][(low >> 8) & 0xFF]  ^ tables[0][low & 0xFF];
+                }
+
+                for (; size > 0; data++, size--)
+                    value = (value << 8) ^ tables[0][(value >> 24) ^ *data];
             }
+
+            this->m_value = value;
         }
 
         [[nodiscard]]
-        constexpr u64 checksum() const {
+        u32 checksum() const {
+            const u32 value = this->m_reflectInput ? reflect(this->m_value, NumBits) : (this->m_value >> (32 - NumBits));
+
             if (this->m_reflectOutput)
-                return this->m_value ^ m_xorOut;
+                return reflect(value, NumBits) ^ this->m_xorOut;
             else
-                return reflect(this->m_value, NumBits) ^ m_xorOut;
+                return value ^ this->m_xorOut;
         }
 
     private:
-        u64 m_value;
+        constexpr static u32 Mask = u32((u64(1) << NumBits) - 1);
 
-        u64 m_init;
-        u64 m_xorOut;
+        u32 m_value = 0;
+
+        u32 m_init;
+        u32 m_xorOut;
         bool m_reflectInput;
         bool m_reflectOutput;
 
-        std::array<uint64_t, 256> m_table;
+        std::shared_ptr<const CrcTables> m_tables;
     };
 
     template<size_t NumBits>
-    auto calcCrc(prv::Provider *data, u64 offset, std::size_t size, u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut) {
+    auto calcCrc(prv::Provider *data, u64 offset, std::size_t size, u32 polynomial, u32 init, u32 xorout, bool reflectIn, bool reflectOut, Task *task) {
         using Crc = Crc<NumBits>;
         Crc crc(polynomial, init, xorout, reflectIn, reflectOut);
 
-        processDataByChunks(data, offset, size, std::bind(&Crc::processBytes, &crc, _1, _2));
+        processDataByChunks(data, offset, size, std::bind(&Crc::processBytes, &crc, _1, _2), task);
 
         return crc.checksum();
     }
 
     u16 crc8(prv::Provider *&data, u64 offset, size_t size, u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut) {
-        return calcCrc<8>(data, offset, size, polynomial, init, xorOut, reflectIn, reflectOut);
+        return calcCrc<8>(data, offset, size, polynomial, init, xorOut, reflectIn, reflectOut, nullptr);
+    }
+
+    u16 crc8(prv::Provider *&data, u64 offset, size_t size, u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut, Task &task) {
+        return calcCrc<8>(data, offset, size, polynomial, init, xorOut, reflectIn, reflectOut, &task);
     }
 
     u16 crc16(prv::Provider *&data, u64 offset, size_t size, u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut) {
-        return calcCrc<16>(data, offset, size, polynomial, init, xorOut, reflectIn, reflectOut);
+        return calcCrc<16>(data, offset, size, polynomial, init, xorOut, reflectIn, reflectOut, nullptr);
+    }
+
+    u16 crc16(prv::Provider *&data, u64 offset, size_t size, u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut, Task &task) {
+        return calcCrc<16>(data, offset, size, polynomial, init, xorOut, reflectIn, reflectOut, &task);
     }
 
     u32 crc32(prv::Provider *&data, u64 offset, size_t size, u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut) {
-        return calcCrc<32>(data, offset, size, polynomial, init, xorOut, reflectIn, reflectOut);
+        return calcCrc<32>(data, offset, size, polynomial, init, xorOut, reflectIn, reflectOut, nullptr);
     }
 
+    u32 crc32(prv::Provider *&data, u64 offset, size_t size, u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut, Task &task) {
+        return calcCrc<32>(data, offset, size, polynomial, init, xorOut, reflectIn, reflectOut, &task);
+    }
 
-    std::array<u8, 16> md5(prv::Provider *&data, u64 offset, size_t size) {
-        std::array<u8, 16> result = { 0 };
+    namespace {
 
-        mbedtls_md5_context ctx;
-        mbedtls_md5_init(&ctx);
+        template<typename Context, auto Init, auto Starts, auto Update, auto Finish, auto Free, size_t DigestSize, auto ... StartsArgs>
+        class MbedTLSHashContext : public HashContext {
+        public:
+            MbedTLSHashContext() {
+                Init(&this->m_context);
+                Starts(&this->m_context, StartsArgs...);
+            }
 
-        mbedtls_md5_starts(&ctx);
+            ~MbedTLSHashContext() override {
+                Free(&this->m_context);
+            }
 
-        processDataByChunks(data, offset, size, std::bind(mbedtls_md5_update, &ctx, _1, _2));
+            MbedTLSHashContext(const MbedTLSHashContext &) = delete;
+            MbedTLSHashContext &operator=(const MbedTLSHashContext &) = delete;
 
-        mbedtls_md5_finish(&ctx, result.data());
+            void update(std::span<const u8> data) override {
+                Update(&this->m_context, data.data(), data.size());
+            }
 
-        mbedtls_md5_free(&ctx);
+            std::vector<u8> finish() override {
+                std::array<u8, 64> result = { };
+                Finish(&this->m_context, result.data());
 
-        return result;
-    }
+                return { result.begin(), result.begin() + DigestSize };
+            }
 
-    std::array<u8, 16> md5(const std::vector<u8> &data) {
-        std::array<u8, 16> result = { 0 };
+        private:
+            Context m_context;
+        };
 
-        mbedtls_md5_context ctx;
-        mbedtls_md5_init(&ctx);
+        template<size_t NumBits, typename Result>
+        class CrcHashContext : public HashContext {
+        public:
+            CrcHashContext(u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut)
+                : m_crc(polynomial, init, xorOut, reflectIn, reflectOut) { }
 
-        mbedtls_md5_starts(&ctx);
-        mbedtls_md5_update(&ctx, data.data(), data.size());
-        mbedtls_md5_finish(&ctx, result.data());
+            void update(std::span<const u8> data) override {
+                this->m_crc.processBytes(data.data(), data.size());
+            }
 
-        mbedtls_md5_free(&ctx);
+            std::vector<u8> finish() override {
+                const auto checksum = Result(this->m_crc.checksum());
 
-        return result;
-    }
+                std::vector<u8> bytes(sizeof(checksum));
+                std::memcpy(bytes.data(), &checksum, bytes.size());
 
-    std::array<u8, 20> sha1(prv::Provider *&data, u64 offset, size_t size) {
-        std::array<u8, 20> result = { 0 };
+                return bytes;
+            }
 
-        mbedtls_sha1_context ctx;
-        mbedtls_sha1_init(&ctx);
+        private:
+            Crc<NumBits> m_crc;
+        };
 
-        mbedtls_sha1_starts(&ctx);
+        #if defined(CRYPTO_X86_64_DISPATCH)
 
-        processDataByChunks(data, offset, size, std::bind(mbedtls_sha1_update, &ctx, _1, _2));
+            bool hasShaExtensions() {
+                static const bool supported = __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+                return supported;
+            }
 
-        mbedtls_sha1_finish(&ctx, result.data());
+            // SHA-1 and SHA-256 using the SHA extensions. The round structure follows Intel's "New Instructions Supporting the Secure Hash Algorithm on Intel Architecture Processors"
+            struct Sha1Block {
+                const u8 *data;
+                __m128i byteSwapMask, abcd;
+                __m128i message[4], e[2];
+            };
+
+            // Every step runs four rounds. The message schedule of later steps is calculated in between
+            template<size_t Step>
+            [[gnu::target("sha,sse4.1")]]
+            void sha1Step(Sha1Block &block) {
+                auto &message = block.message;
+                auto &current = message[Step % 4];
+
+                if constexpr (Step < 4)
+                    current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block.data + Step * 16)), block.byteSwapMask);
+
+                auto &input = block.e[Step % 2], &output = block.e[(Step + 1) % 2];
+                if constexpr (Step == 0)
+                    input = _mm_add_epi32(input, current);
+                else
+                    input = _mm_sha1nexte_epu32(input, current);
+                output = block.abcd;
 
-        mbedtls_sha1_free(&ctx);
+                if constexpr (Step >= 3 && Step <= 18)
+                    message[(Step + 1) % 4] = _mm_sha1msg2_epu32(message[(Step + 1) % 4], current);
+
+                block.abcd = _mm_sha1rnds4_epu32(block.abcd, input, Step / 5);
+
+                if constexpr (Step >= 1 && Step <= 16)
+                    message[(Step + 3) % 4] = _mm_sha1msg1_epu32(message[(Step + 3) % 4], current);
+                if constexpr (Step >= 2 && Step <= 17)
+                    message[(Step + 2) % 4] = _mm_xor_si128(message[(Step + 2) % 4], current);
+            }
+
+            template<size_t ... Steps>
+            [[gnu::target("sha,sse4.1")]]
+            void sha1Steps(Sha1Block &block, std::index_sequence<Steps...>) {
+                (sha1Step<Steps>(block), ...);
+            }
+
+            [[gnu::target("sha,sse4.1")]]
+            void sha1Compress(std::array<u32, 5> &state, const u8 *data, size_t blockCount) {
+                Sha1Block block = { };
+                block.byteSwapMask = _mm_set_epi64x(0x0001'0203'0405'0607, 0x0809'0A0B'0C0D'0E0F);
+                block.abcd         = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state.data())), 0x1B);
+
+                auto e0 = _mm_set_epi32(int(state[4]), 0, 0, 0);
+
+                for (; blockCount > 0; blockCount--, data += 64) {
+                    const auto savedAbcd = block.abcd, savedE = e0;
+
+                    block.data = data;
+                    block.e[0] = e0;
+                    block.e[1] = _mm_setzero_si128();
+
+                    sha1Steps(block, std::make_index_sequence<20>());
+
+                    e0         = _mm_sha1nexte_epu32(block.e[0], savedE);
+                    block.abcd = _mm_add_epi32(block.abcd, savedAbcd);
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(state.data()), _mm_shuffle_epi32(block.abcd, 0x1B));
+                state[4] = u32(_mm_extract_epi32(e0, 3));
+            }
+
+            constexpr static std::array<u32, 64> Sha256RoundConstants = {
+                0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+                0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+                0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+                0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+                0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+                0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+                0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+                0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+            };
+
+            struct Sha256Block {
+                const u8 *data;
+                __m128i byteSwapMask, abef, cdgh;
+                __m128i message[4];
+            };
+
+            template<size_t Step>
+            [[gnu::target("sha,sse4.1")]]
+            void sha256Step(Sha256Block &block) {
+                auto &message = block.message;
+                auto &current = message[Step % 4];
+
+                if constexpr (Step < 4)
+                    current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block.data + Step * 16)), block.byteSwapMask);
+
+                auto words = _mm_add_epi32(current, _mm_loadu_si128(reinterpret_cast<const __m128i *>(&Sha256RoundConstants[Step * 4])));
+                block.cdgh = _mm_sha256rnds2_epu32(block.cdgh, block.abef, words);
+
+                if constexpr (Step >= 3 && Step <= 14) {
+                    auto &next = message[(Step + 1) % 4];
+                    next = _mm_add_epi32(next, _mm_alignr_epi8(current, message[(Step + 3) % 4], 4));
+                    next = _mm_sha256msg2_epu32(next, current);
+                }
+
+                words      = _mm_shuffle_epi32(words, 0x0E);
+                block.abef = _mm_sha256rnds2_epu32(block.abef, block.cdgh, words);
+
+                if constexpr (Step >= 1 && Step <= 12)
+                    message[(Step + 3) % 4] = _mm_sha256msg1_epu32(message[(Step + 3) % 4], current);
+            }
+
+            template<size_t ... Steps>
+            [[gnu::target("sha,sse4.1")]]
+            void sha256Steps(Sha256Block &block, std::index_sequence<Steps...>) {
+                (sha256Step<Steps>(block), ...);
+            }
+
+            [[gnu::target("sha,sse4.1")]]
+            void sha256Compress(std::array<u32, 8> &state, const u8 *data, size_t blockCount) {
+                Sha256Block block = { };
+                block.byteSwapMask = _mm_set_epi64x(0x0C0D'0E0F'0809'0A0B, 0x0405'0607'0001'0203);
+
+                // The instructions expect the state as ABEF and CDGH
+                const auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&state[0])), 0xB1);
+                const auto efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&state[4])), 0x1B);
+                block.abef = _mm_alignr_epi8(dcba, efgh, 8);
+                block.cdgh = _mm_blend_epi16(efgh, dcba, 0xF0);
+
+                for (; blockCount > 0; blockCount--, data += 64) {
+                    const auto savedAbef = block.abef, savedCdgh = block.cdgh;
+
+                    block.data = data;
+                    sha256Steps(block, std::make_index_sequence<16>());
+
+                    block.abef = _mm_add_epi32(block.abef, savedAbef);
+                    block.cdgh = _mm_add_epi32(block.cdgh, savedCdgh);
+                }
+
+                const auto feba = _mm_shuffle_epi32(block.abef, 0x1B);
+                const auto dchg = _mm_shuffle_epi32(block.cdgh, 0xB1);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&state[0]), _mm_blend_epi16(feba, dchg, 0xF0));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+            }
+
+            // Merkle-Damgard construction shared by SHA-1 and SHA-256, both use 64 byte blocks and big endian lengths and results
+            template<size_t StateSize, auto Compress, size_t DigestSize>
+            class ShaExtensionsHashContext : public HashContext {
+            public:
+                explicit ShaExtensionsHashContext(const std::array<u32, StateSize> &initialState) : m_state(initialState) { }
+
+                void update(std::span<const u8> data) override {
+                    this->m_processedBytes += data.size();
+
+                    if (this->m_bufferSize > 0) {
+                        const auto copySize = std::min(data.size(), BlockSize - this->m_bufferSize);
+                        std::copy_n(data.begin(), copySize, this->m_buffer.begin() + this->m_bufferSize);
+                        this->m_bufferSize += copySize;
+                        data = data.subspan(copySize);
+
+                        if (this->m_bufferSize < BlockSize)
+                            return;
+
+                        Compress(this->m_state, this->m_buffer.data(), 1);
+                        this->m_bufferSize = 0;
+                    }
+
+                    const auto blockCount = data.size() / BlockSize;
+                    Compress(this->m_state, data.data(), blockCount);
+
+                    data = data.subspan(blockCount * BlockSize);
+                    std::copy(data.begin(), data.end(), this->m_buffer.begin());
+                    this->m_bufferSize = data.size();
+                }
+
+                std::vector<u8> finish() override {
+                    const u64 bitCount = this->m_processedBytes * 8;
+
+                    std::array<u8, BlockSize * 2> padding = { 0x80 };
+                    const auto paddingSize = ((this->m_bufferSize < BlockSize - 8) ? BlockSize : BlockSize * 2) - this->m_bufferSize;
+                    for (u32 i = 0; i < 8; i++)
+                        padding[paddingSize - 1 - i] = u8(bitCount >> (i * 8));
+
+                    this->update(std::span(padding).first(paddingSize));
+
+                    std::vector<u8> result(DigestSize);
+                    for (size_t i = 0; i < DigestSize; i++)
+                        result[i] = u8(this->m_state[i / 4] >> (24 - (i % 4) * 8));
+
+                    return result;
+                }
+
+            private:
+                constexpr static size_t BlockSize = 64;
+
+                std::array<u32, StateSize> m_state;
+                std::array<u8, BlockSize> m_buffer = { };
+                size_t m_bufferSize = 0;
+                u64 m_processedBytes = 0;
+            };
+
+        #endif
 
-        return result;
     }
 
-    std::array<u8, 20> sha1(const std::vector<u8> &data) {
-        std::array<u8, 20> result = { 0 };
+    std::unique_ptr<HashContext> createMD5Context() {
+        return std::make_unique<MbedTLSHashContext<mbedtls_md5_context, mbedtls_md5_init, mbedtls_md5_starts, mbedtls_md5_update, mbedtls_md5_finish, mbedtls_md5_free, 16>>();
+    }
 
-        mbedtls_sha1_context ctx;
-        mbedtls_sha1_init(&ctx);
+    std::unique_ptr<HashContext> createSHA1Context() {
+        #if defined(CRYPTO_X86_64_DISPATCH)
+            if (hasShaExtensions())
+                return std::make_unique<ShaExtensionsHashContext<5, sha1Compress, 20>>(std::array<u32, 5> { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 });
+        #endif
 
-        mbedtls_sha1_starts(&ctx);
-        mbedtls_sha1_update(&ctx, data.data(), data.size());
-        mbedtls_sha1_finish(&ctx, result.data());
+        return std::make_unique<MbedTLSHashContext<mbedtls_sha1_context, mbedtls_sha1_init, mbedtls_sha1_starts, mbedtls_sha1_update, mbedtls_sha1_finish, mbedtls_sha1_free, 20>>();
+    }
 
-        mbedtls_sha1_free(&ctx);
+    std::unique_ptr<HashContext> createSHA224Context() {
+        #if defined(CRYPTO_X86_64_DISPATCH)
+            if (hasShaExtensions())
+                return std::make_unique<ShaExtensionsHashContext<8, sha256Compress, 28>>(std::array<u32, 8> { 0xC1059ED8, 0x367CD507, 0x3070DD17, 0xF70E5939, 0xFFC00B31, 0x68581511, 0x64F98FA7, 0xBEFA4FA4 });
+        #endif
 
-        return result;
+        return std::make_unique<MbedTLSHashContext<mbedtls_sha256_context, mbedtls_sha256_init, mbedtls_sha256_starts, mbedtls_sha256_update, mbedtls_sha256_finish, mbedtls_sha256_free, 28, true>>();
     }
 
-    std::array<u8, 28> sha224(prv::Provider *&data, u64 offset, size_t size) {
-        std::array<u8, 28> result = { 0 };
+    std::unique_ptr<HashContext> createSHA256Context() {
+        #if defined(CRYPTO_X86_64_DISPATCH)
+            if (hasShaExtensions())
+                return std::make_unique<ShaExtensionsHashContext<8, sha256Compress, 32>>(std::array<u32, 8> { 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 });
+        #endif
 
-        mbedtls_sha256_context ctx;
-        mbedtls_sha256_init(&ctx);
+        return std::make_unique<MbedTLSHashContext<mbedtls_sha256_context, mbedtls_sha256_init, mbedtls_sha256_starts, mbedtls_sha256_update, mbedtls_sha256_finish, mbedtls_sha256_free, 32, false>>();
+    }
+
+    std::unique_ptr<HashContext> createSHA384Context() {
+        return std::make_unique<MbedTLSHashContext<mbedtls_sha512_context, mbedtls_sha512_init, mbedtls_sha512_starts, mbedtls_sha512_update, mbedtls_sha512_finish, mbedtls_sha512_free, 48, true>>();
+    }
+
+    std::unique_ptr<HashContext> createSHA512Context() {
+        return std::make_unique<MbedTLSHashContext<mbedtls_sha512_context, mbedtls_sha512_init, mbedtls_sha512_starts, mbedtls_sha512_update, mbedtls_sha512_finish, mbedtls_sha512_free, 64, false>>();
+    }
+
+    std::unique_ptr<HashContext> createCRC8Context(u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut) {
+        return std::make_unique<CrcHashContext<8, u16>>(polynomial, init, xorOut, reflectIn, reflectOut);
+    }
 
-        mbedtls_sha256_starts(&ctx, true);
+    std::unique_ptr<HashContext> createCRC16Context(u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut) {
+        return std::make_unique<CrcHashContext<16, u16>>(polynomial, init, xorOut, reflectIn, reflectOut);
+    }
 
-        processDataByChunks(data, offset, size, std::bind(mbedtls_sha256_update, &ctx, _1, _2));
+    std::unique_ptr<HashContext> createCRC32Context(u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut) {
+        return std::make_unique<CrcHashContext<32, u32>>(polynomial, init, xorOut, reflectIn, reflectOut);
+    }
 
-        mbedtls_sha256_finish(&ctx, result.data());
+    template<size_t Size>
+    std::array<u8, Size> finishHash(HashContext &context) {
+        const auto digest = context.finish();
 
-        mbedtls_sha256_free(&ctx);
+        std::array<u8, Size> result = { };
+        std::copy_n(digest.begin(), std::min(digest.size(), Size), result.begin());
 
         return result;
     }
 
-    std::array<u8, 28> sha224(const std::vector<u8> &data) {
-        std::array<u8, 28> result = { 0 };
+    template<size_t Size>
+    std::array<u8, Size> hashProvider(const std::unique_ptr<HashContext> &context, prv::Provider *data, u64 offset, size_t size, Task *task) {
+        processDataByChunks(data, offset, size, [&context](const u8 *buffer, size_t bufferSize) {
+            context->update({ buffer, bufferSize });
+        }, task);
 
-        mbedtls_sha256_context ctx;
-        mbedtls_sha256_init(&ctx);
+        return finishHash<Size>(*context);
+    }
 
-        mbedtls_sha256_starts(&ctx, true);
-        mbedtls_sha256_update(&ctx, data.data(), data.size());
-        mbedtls_sha256_finish(&ctx, result.data());
+    template<size_t Size>
+    std::array<u8, Size> hashVector(const std::unique_ptr<HashContext> &context, const std::vector<u8> &data) {
+        context->update(data);
 
-        mbedtls_sha256_free(&ctx);
+        return finishHash<Size>(*context);
+    }
 
-        return result;
+    std::array<u8, 16> md5(prv::Provider *&data, u64 offset, size_t size) {
+        return hashProvider<16>(createMD5Context(), data, offset, size, nullptr);
     }
 
-    std::array<u8, 32> sha256(prv::Provider *&data, u64 offset, size_t size) {
-        std::array<u8, 32> result = { 0 };
+    std::array<u8, 16> md5(prv::Provider *&data, u64 offset, size_t size, Task &task) {
+        return hashProvider<16>(createMD5Context(), data, offset, size, &task);
+    }
+
+    std::array<u8, 16> md5(const std::vector<u8> &data) {
+        return hashVector<16>(createMD5Context(), data);
+    }
+
+    std::array<u8, 20> sha1(prv::Provider *&data, u64 offset, size_t size) {
+        return hashProvider<20>(createSHA1Context(), data, offset, size, nullptr);
+    }
+
+    std::array<u8, 20> sha1(prv::Provider *&data, u64 offset, size_t size, Task &task) {
+        return hashProvider<20>(createSHA1Context(), data, offset, size, &task);
+    }
 
-        mbedtls_sha256_context ctx;
-        mbedtls_sha256_init(&ctx);
+    std::array<u8, 20> sha1(const std::vector<u8> &data) {
+        return hashVector<20>(createSHA1Context(), data);
+    }
 
-        mbedtls_sha256_starts(&ctx, false);
+    std::array<u8, 28> sha224(prv::Provider *&data, u64 offset, size_t size) {
+        return hashProvider<28>(createSHA224Context(), data, offset, size, nullptr);
+    }
 
-        processDataByChunks(data, offset, size, std::bind(mbedtls_sha256_update, &ctx, _1, _2));
+    std::array<u8, 28> sha224(prv::Provider *&data, u64 offset, size_t size, Task &task) {
+        return hashProvider<28>(createSHA224Context(), data, offset, size, &task);
+    }
 
-        mbedtls_sha256_finish(&ctx, result.data());
+    std::array<u8, 28> sha224(const std::vector<u8> &data) {
+        return hashVector<28>(createSHA224Context(), data);
+    }
 
-        mbedtls_sha256_free(&ctx);
+    std::array<u8, 32> sha256(prv::Provider *&data, u64 offset, size_t size) {
+        return hashProvider<32>(createSHA256Context(), data, offset, size, nullptr);
+    }
 
-        return result;
+    std::array<u8, 32> sha256(prv::Provider *&data, u64 offset, size_t size, Task &task) {
+        return hashProvider<32>(createSHA256Context(), data, offset, size, &task);
     }
 
     std::array<u8, 32> sha256(const std::vector<u8> &data) {
-        std::array<u8, 32> result = { 0 };
+        return hashVector<32>(createSHA256Context(), data);
+    }
 
-        mbedtls_sha256_context ctx;
-        mbedtls_sha256_init(&ctx);
+    std::array<u8, 48> sha384(prv::Provider *&data, u64 offset, size_t size) {
+        return hashProvider<48>(createSHA384Context(), data, offset, size, nullptr);
+    }
 
-        mbedtls_sha256_starts(&ctx, false);
-        mbedtls_sha256_update(&ctx, data.data(), data.size());
-        mbedtls_sha256_finish(&ctx, result.data());
+    std::array<u8, 48> sha384(prv::Provider *&data, u64 offset, size_t size, Task &task) {
+        return hashProvider<48>(createSHA384Context(), data, offset, size, &task);
+    }
 
-        mbedtls_sha256_free(&ctx);
+    std::array<u8, 48> sha384(const std::vector<u8> &data) {
+        return hashVector<48>(createSHA384Context(), data);
+    }
 
-        return result;
+    std::array<u8, 64> sha512(prv::Provider *&data, u64 offset, size_t size) {
+        return hashProvider<64>(createSHA512Context(), data, offset, size, nullptr);
     }
 
-    std::array<u8, 48> sha384(prv::Provider *&data, u64 offset, size_t size) {
-        std::array<u8, 48> result = { 0 };
+    std::array<u8, 64> sha512(prv::Provider *&data, u64 offset, size_t size, Task &task) {
+        return hashProvider<64>(createSHA512Context(), data, offset, size, &task);
+    }
 
-        mbedtls_sha512_context ctx;
-        mbedtls_sha512_init(&ctx);
+    std::array<u8, 64> sha512(const std::vector<u8> &data) {
+        return hashVector<64>(createSHA512Context(), data);
+    }
 
-        mbedtls_sha512_starts(&ctx, true);
+    void updateAll(const std::vector<HashContext *> &contexts, u64 offset, u64 size, const ReadFunction &read, const ProgressCallback &progress) {
+        constexpr static size_t ChunkSize   = 4 * 1024 * 1024;
+        constexpr static size_t BufferCount = 4;
 
-        processDataByChunks(data, offset, size, std::bind(mbedtls_sha512_update, &ctx, _1, _2));
+        if (contexts.empty())
+            return;
 
-        mbedtls_sha512_finish(&ctx, result.data());
+        // A single context doesn't need any synchronisation, just read and hash in turns
+        if (contexts.size() == 1) {
+            std::vector<u8> buffer(std::min<u64>(ChunkSize, size));
+            for (u64 position = 0; position < size;) {
+                const auto chunkSize = std::min<u64>(ChunkSize, size - position);
+                read(offset + position, std::span(buffer).first(chunkSize));
+                contexts.front()->update(std::span(buffer).first(chunkSize));
 
-        mbedtls_sha512_free(&ctx);
+                position += chunkSize;
+                if (progress)
+                    progress(position);
+            }
 
-        return result;
+            return;
+        }
+
+        // Chunks are read into a ring of buffers. A buffer can be reused once every context has processed the chunk in it
+        struct Buffer {
+            std::vector<u8> data;
+            size_t size = 0;
+            size_t pendingContexts = 0;
+        };
+
+        std::array<Buffer, BufferCount> buffers;
+        std::mutex mutex;
+        std::condition_variable condition;
+        u64 publishedChunks = 0;
+        bool done = false, stopped = false;
+
+        std::vector<std::thread> threads;
+        ON_SCOPE_EXIT {
+            {
+                std::scoped_lock lock(mutex);
+                stopped = !done;
+                done = true;
+            }
+            condition.notify_all();
+
+            for (auto &thread : threads)
+                thread.join();
+        };
+
+        for (auto context : contexts) {
+            threads.emplace_back([&, context] {
+                for (u64 chunk = 0; ; chunk++) {
+                    auto &buffer = buffers[chunk % BufferCount];
+
+                    {
+                        std::unique_lock lock(mutex);
+                        condition.wait(lock, [&] { return publishedChunks > chunk || done; });
+
+                        if (stopped || publishedChunks <= chunk)
+                            return;
+                    }
+
+                    context->update(std::span(buffer.data).first(buffer.size));
+
+                    {
+                        std::scoped_lock lock(mutex);
+                        buffer.pendingContexts -= 1;
+                    }
+                    condition.notify_all();
+                }
+            });
+        }
+
+        for (u64 position = 0, chunk = 0; position < size; chunk++) {
+            auto &buffer = buffers[chunk % BufferCount];
+
+            {
+                std::unique_lock lock(mutex);
+                condition.wait(lock, [&] { return buffer.pendingContexts == 0; });
+            }
+
+            buffer.size = std::min<u64>(ChunkSize, size - position);
+            buffer.data.resize(buffer.size);
+            read(offset + position, buffer.data);
+
+            {
+                std::scoped_lock lock(mutex);
+                buffer.pendingContexts = contexts.size();
+                publishedChunks = chunk + 1;
+            }
+            condition.notify_all();
+
+            position += buffer.size;
+            if (progress)
+                progress(position);
+        }
+
+        // Let the threads finish processing all published chunks before they return
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [&] { return std::all_of(buffers.begin(), buffers.end(), [](const auto &buffer) { return buffer.pendingContexts == 0; }); });
+            done = true;
+        }
+        condition.notify_all();
     }
 
-    std::array<u8, 48> sha384(const std::vector<u8> &data) {
-        std::array<u8, 48> result = { 0 };
+    std::vector<std::vector<u8>> hashBlocks(const ContextFactory &createContext, u64 offset, u64 size, u64 blockSize, const ReadFunction &read, const ProgressCallback &progress) {
+        constexpr static size_t BatchSize = 32 * 1024 * 1024;
 
-        mbedtls_sha512_context ctx;
-        mbedtls_sha512_init(&ctx);
+        if (blockSize == 0)
+            throw std::invalid_argument("Block size cannot be zero");
 
-        mbedtls_sha512_starts(&ctx, true);
-        mbedtls_sha512_update(&ctx, data.data(), data.size());
-        mbedtls_sha512_finish(&ctx, result.data());
+        std::vector<std::vector<u8>> results((size + blockSize - 1) / blockSize);
 
-        mbedtls_sha512_free(&ctx);
+        // Blocks that don't fit into a batch are streamed through a single context each
+        if (blockSize > BatchSize) {
+            for (u64 block = 0; block < results.size(); block++) {
+                const auto blockOffset = block * blockSize;
+                auto context = createContext();
 
-        return result;
+                updateAll({ context.get() }, offset + blockOffset, std::min(blockSize, size - blockOffset), read, [&](u64 processedBytes) {
+                    if (progress)
+                        progress(blockOffset + processedBytes);
+                });
+
+                results[block] = context->finish();
+            }
+
+            return results;
+        }
+
+        // Data is read in batches of whole blocks. While one batch gets hashed by the workers, the next one is read into the other buffer
+        const u64 blocksPerBatch = BatchSize / blockSize;
+        const u32 threadCount    = std::max(1U, std::thread::hardware_concurrency());
+
+        std::array<std::vector<u8>, 2> buffers;
+        std::vector<std::jthread> workers;
+
+        for (u64 position = 0, batch = 0; position < size; batch++) {
+            auto &buffer = buffers[batch % buffers.size()];
+            buffer.resize(std::min(blocksPerBatch * blockSize, size - position));
+            read(offset + position, buffer);
+
+            // Wait for the previous batch to be done before starting this one
+            workers.clear();
+            if (progress && position > 0)
+                progress(position);
+
+            const u64 firstBlock = position / blockSize;
+            const u64 blockCount = (buffer.size() + blockSize - 1) / blockSize;
+
+            auto nextBlock = std::make_shared<std::atomic<u64>>(0);
+            for (u32 i = 0; i < std::min<u64>(threadCount, blockCount); i++) {
+                workers.emplace_back([&, data = std::span<const u8>(buffer), nextBlock, firstBlock, blockCount] {
+                    for (u64 block = (*nextBlock)++; block < blockCount; block = (*nextBlock)++) {
+                        auto context = createContext();
+                        context->update(data.subspan(block * blockSize, std::min<u64>(blockSize, data.size() - block * blockSize)));
+
+                        results[firstBlock + block] = context->finish();
+                    }
+                });
+            }
+
+            position += buffer.size();
+        }
+
+        workers.clear();
+        if (progress)
+            progress(size);
+
+        return results;
     }
 
-    std::array<u8, 64> sha512(prv::Provider *&data, u64 offset, size_t size) {
-        std::array<u8, 64> result = { 0 };
+    namespace {
 
-        mbedtls_sha512_context ctx;
-        mbedtls_sha512_init(&ctx);
+        constexpr static std::string_view Base16Alphabet = "0123456789ABCDEF";
+        constexpr static std::string_view Base64Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-        mbedtls_sha512_starts(&ctx, false);
+        constexpr static u8 InvalidCharacter = 0xFF;
 
-        processDataByChunks(data, offset, size, std::bind(mbedtls_sha512_update, &ctx, _1, _2));
+        constexpr auto Base16Encoding = [] {
+            std::array<std::array<char, 2>, 256> table = { };
+            for (u32 byte = 0; byte < table.size(); byte++)
+                table[byte] = { Base16Alphabet[byte >> 4], Base16Alphabet[byte & 0x0F] };
 
-        mbedtls_sha512_finish(&ctx, result.data());
+            return table;
+        }();
 
-        mbedtls_sha512_free(&ctx);
+        constexpr auto Base16Decoding = [] {
+            std::array<u8, 256> table = { };
+            table.fill(InvalidCharacter);
+            for (u8 value = 0; value < 16; value++) {
+                table[u8(Base16Alphabet[value])] = value;
+                table[u8(Base16Alphabet[value] | 0x20)] = value;
+            }
+
+            return table;
+        }();
+
+        constexpr auto Base64Decoding = [] {
+            std::array<u8, 256> table = { };
+            table.fill(InvalidCharacter);
+            for (u8 value = 0; value < Base64Alphabet.size(); value++)
+                table[u8(Base64Alphabet[value])] = value;
+
+            return table;
+        }();
+
+        [[noreturn]] void throwInvalidCharacter(std::string_view encoding, size_t position) {
+            throw std::invalid_argument(hex::format("Invalid {} character at position {}", encoding, position));
+        }
+
+        #if defined(__SSE2__)
+
+            // Turns 16 nibbles into upper case hex characters
+            __m128i nibblesToHex(__m128i nibbles) {
+                const auto letterOffset = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('A' - '0' - 10));
+                return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letterOffset);
+            }
+
+            // Turns 16 hex characters into their values. Invalid characters clear the corresponding bits in `valid`
+            __m128i hexToNibbles(__m128i characters, int &valid) {
+                const auto isBelowOrEqual = [](__m128i values, u8 limit) {
+                    return _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(char(limit))), values);
+                };
+
+                const auto digits  = _mm_sub_epi8(characters, _mm_set1_epi8('0'));
+                const auto letters = _mm_sub_epi8(_mm_or_si128(characters, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+
+                const auto isDigit  = isBelowOrEqual(digits, 9);
+                const auto isLetter = isBelowOrEqual(letters, 5);
+
+                valid &= _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter));
+
+                return _mm_or_si128(_mm_and_si128(isDigit, digits), _mm_and_si128(isLetter, _mm_add_epi8(letters, _mm_set1_epi8(10))));
+            }
+
+        #endif
+
+        #if defined(__SSSE3__)
+
+            // Spreads 12 bytes over 16 six bit values and turns them into base64 characters
+            __m128i encodeBase64Block(__m128i input) {
+                // Every group of three bytes gets shuffled into two big endian 16 bit words, the first holding the first two bytes and the second holding the last two.
+                // The four indices are then moved into their own bytes with multiplications
+                input = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+                const auto firstAndThird  = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+                const auto secondAndForth = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+                const auto indices = _mm_or_si128(firstAndThird, secondAndForth);
+
+                // Every range of the alphabet gets a class, indices below 26 get 13, 26 to 51 get 0 and everything above gets its distance to 51.
+                // The class then selects the offset from the index to the character
+                auto classes = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+                classes = _mm_or_si128(classes, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+
+                const auto offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+                return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, classes));
+            }
+
+            // Turns 16 base64 characters into 12 bytes in the lower part of the result. Invalid characters clear the corresponding bits in `valid`
+            __m128i decodeBase64Block(__m128i characters, int &valid) {
+                const auto inRange = [&](char first, char last) {
+                    return _mm_and_si128(_mm_cmpgt_epi8(characters, _mm_set1_epi8(char(first - 1))), _mm_cmpgt_epi8(_mm_set1_epi8(char(last + 1)), characters));
+                };
+
+                const auto isUpper = inRange('A', 'Z');
+                const auto isLower = inRange('a', 'z');
+                const auto isDigit = inRange('0', '9');
+                const auto isPlus  = _mm_cmpeq_epi8(characters, _mm_set1_epi8('+'));
+                const auto isSlash = _mm_cmpeq_epi8(characters, _mm_set1_epi8('/'));
+
+                valid &= _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_or_si128(isUpper, isLower), _mm_or_si128(isDigit, isPlus)), isSlash));
+
+                auto offsets = _mm_and_si128(isUpper, _mm_set1_epi8(-'A'));
+                offsets = _mm_or_si128(offsets, _mm_and_si128(isLower, _mm_set1_epi8(26 - 'a')));
+                offsets = _mm_or_si128(offsets, _mm_and_si128(isDigit, _mm_set1_epi8(52 - '0')));
+                offsets = _mm_or_si128(offsets, _mm_and_si128(isPlus, _mm_set1_epi8(62 - '+')));
+                offsets = _mm_or_si128(offsets, _mm_and_si128(isSlash, _mm_set1_epi8(63 - '/')));
+
+                const auto values = _mm_add_epi8(characters, offsets);
+
+                // Merges the four six bit values of every group into a 24 bit number and moves its bytes to the front in big endian order
+                const auto pairs  = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+                const auto groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+
+                return _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            }
+
+        #endif
 
-        return result;
     }
 
-    std::array<u8, 64> sha512(const std::vector<u8> &data) {
-        std::array<u8, 64> result = { 0 };
+    size_t encode16(std::span<const u8> input, std::span<char> output) {
+        if (output.size() < input.size() * 2)
+            throw std::invalid_argument("Output buffer is too small");
 
-        mbedtls_sha512_context ctx;
-        mbedtls_sha512_init(&ctx);
+        size_t position = 0;
 
-        mbedtls_sha512_starts(&ctx, false);
-        mbedtls_sha512_update(&ctx, data.data(), data.size());
-        mbedtls_sha512_finish(&ctx, result.data());
+        #if defined(__SSE2__)
+            for (; position + 16 <= input.size(); position += 16) {
+                const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&input[position]));
+                const auto high  = _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F));
+                const auto low   = _mm_and_si128(bytes, _mm_set1_epi8(0x0F));
 
-        mbedtls_sha512_free(&ctx);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&output[position * 2]), nibblesToHex(_mm_unpacklo_epi8(high, low)));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&output[position * 2 + 16]), nibblesToHex(_mm_unpackhi_epi8(high, low)));
+            }
+        #endif
 
-        return result;
+        for (; position < input.size(); position++) {
+            const auto &characters = Base16Encoding[input[position]];
+            output[position * 2 + 0] = characters[0];
+            output[position * 2 + 1] = characters[1];
+        }
+
+        return input.size() * 2;
     }
 
+    size_t decode16(std::string_view input, std::span<u8> output) {
+        if (input.size() % 2 != 0)
+            throw std::invalid_argument("Base16 input needs to have an even length");
+        if (output.size() < input.size() / 2)
+            throw std::invalid_argument("Output buffer is too small");
 
-    std::vector<u8> decode64(const std::vector<u8> &input) {
+        size_t position = 0;
 
-        size_t written = 0;
-        mbedtls_base64_decode(nullptr, 0, &written, reinterpret_cast<const unsigned char *>(input.data()), input.size());
-        std::vector<u8> output(written, 0x00);
-        if (mbedtls_base64_decode(output.data(), output.size(), &written, reinterpret_cast<const unsigned char *>(input.data()), input.size()))
-            return {};
+        #if defined(__SSE2__)
+            for (; position + 32 <= input.size(); position += 32) {
+                int valid = 0xFFFF;
+                const auto first  = hexToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&input[position])), valid);
+                const auto second = hexToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&input[position + 16])), valid);
+
+                // Leave finding the exact position of the invalid character to the scalar code below
+                if (valid != 0xFFFF)
+                    break;
 
-        output.resize(written);
+                // Every 16 bit word holds the high nibble in its lower byte and the low nibble in its upper byte
+                const auto combine = [](__m128i nibbles) {
+                    return _mm_and_si128(_mm_or_si128(_mm_slli_epi16(nibbles, 4), _mm_srli_epi16(nibbles, 8)), _mm_set1_epi16(0x00FF));
+                };
 
-        return output;
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&output[position / 2]), _mm_packus_epi16(combine(first), combine(second)));
+            }
+        #endif
+
+        for (; position < input.size(); position += 2) {
+            const auto high = Base16Decoding[u8(input[position])];
+            const auto low  = Base16Decoding[u8(input[position + 1])];
+
+            if (high == InvalidCharacter)
+                throwInvalidCharacter("base16", position);
+            if (low == InvalidCharacter)
+                throwInvalidCharacter("base16", position + 1);
+
+            output[position / 2] = (high << 4) | low;
+        }
+
+        return input.size() / 2;
     }
 
-    std::vector<u8> encode64(const std::vector<u8> &input) {
+    size_t encode64(std::span<const u8> input, std::span<char> output) {
+        const size_t encodedSize = (input.size() + 2) / 3 * 4;
+        if (output.size() < encodedSize)
+            throw std::invalid_argument("Output buffer is too small");
 
-        size_t written = 0;
-        mbedtls_base64_encode(nullptr, 0, &written, reinterpret_cast<const unsigned char *>(input.data()), input.size());
+        size_t inputPosition = 0, outputPosition = 0;
 
-        std::vector<u8> output(written, 0x00);
-        if (mbedtls_base64_encode(output.data(), output.size(), &written, reinterpret_cast<const unsigned char *>(input.data()), input.size()))
-            return {};
+        #if defined(__SSSE3__)
+            // Every block uses 12 bytes but loads 16 of them
+            for (; inputPosition + 16 <= input.size(); inputPosition += 12, outputPosition += 16) {
+                const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&input[inputPosition]));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&output[outputPosition]), encodeBase64Block(block));
+            }
+        #endif
 
-        output.resize(written);
+        for (; inputPosition + 3 <= input.size(); inputPosition += 3, outputPosition += 4) {
+            const u32 group = (u32(input[inputPosition]) << 16) | (u32(input[inputPosition + 1]) << 8) | input[inputPosition + 2];
 
-        return output;
+            output[outputPosition + 0] = Base64Alphabet[(group >> 18) & 0x3F];
+            output[outputPosition + 1] = Base64Alphabet[(group >> 12) & 0x3F];
+            output[outputPosition + 2] = Base64Alphabet[(group >> 6) & 0x3F];
+            output[outputPosition + 3] = Base64Alphabet[group & 0x3F];
+        }
+
+        if (const auto remaining = input.size() - inputPosition; remaining > 0) {
+            const u32 group = (u32(input[inputPosition]) << 16) | (remaining > 1 ? u32(input[inputPosition + 1]) << 8 : 0);
+
+            output[outputPosition + 0] = Base64Alphabet[(group >> 18) & 0x3F];
+            output[outputPosition + 1] = Base64Alphabet[(group >> 12) & 0x3F];
+            output[outputPosition + 2] = remaining > 1 ? Base64Alphabet[(group >> 6) & 0x3F] : '=';
+            output[outputPosition + 3] = '=';
+        }
+
+        return encodedSize;
     }
 
-    std::vector<u8> decode16(const std::string &input) {
-        std::vector<u8> output(input.length() / 2, 0x00);
+    size_t decode64(std::string_view input, std::span<u8> output) {
+        if (input.size() % 4 != 0)
+            throw std::invalid_argument("Base64 input length needs to be a multiple of four");
 
-        mbedtls_mpi ctx;
-        mbedtls_mpi_init(&ctx);
+        // Up to two padding characters are allowed at the very end
+        size_t padding = 0;
+        while (padding < 2 && padding < input.size() && input[input.size() - 1 - padding] == '=')
+            padding++;
 
-        ON_SCOPE_EXIT { mbedtls_mpi_free(&ctx); };
+        const size_t decodedSize = input.size() / 4 * 3 - padding;
+        if (output.size() < decodedSize)
+            throw std::invalid_argument("Output buffer is too small");
 
-        if (mbedtls_mpi_read_string(&ctx, 16, input.c_str()))
-            return {};
+        // The last group is handled separately since it may contain padding
+        const size_t fullGroupsSize = input.empty() ? 0 : input.size() - 4;
+        size_t inputPosition = 0, outputPosition = 0;
+
+        #if defined(__SSSE3__)
+            // Every block produces 12 bytes but stores 16 of them
+            for (; inputPosition + 16 <= fullGroupsSize && outputPosition + 16 <= output.size(); inputPosition += 16, outputPosition += 12) {
+                int valid = 0xFFFF;
+                const auto block = decodeBase64Block(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&input[inputPosition])), valid);
+
+                // Leave finding the exact position of the invalid character to the scalar code below
+                if (valid != 0xFFFF)
+                    break;
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&output[outputPosition]), block);
+            }
+        #endif
+
+        const auto decodeGroup = [&](size_t characterCount) {
+            u32 group = 0;
+            for (size_t i = 0; i < 4; i++) {
+                u8 value = 0;
+                if (i < characterCount) {
+                    value = Base64Decoding[u8(input[inputPosition + i])];
+                    if (value == InvalidCharacter)
+                        throwInvalidCharacter("base64", inputPosition + i);
+                }
+
+                group = (group << 6) | value;
+            }
+
+            for (size_t i = 0; i < characterCount - 1; i++)
+                output[outputPosition + i] = u8(group >> (16 - 8 * i));
+
+            inputPosition  += 4;
+            outputPosition += characterCount - 1;
+        };
+
+        while (inputPosition < fullGroupsSize)
+            decodeGroup(4);
+
+        if (!input.empty())
+            decodeGroup(4 - padding);
 
-        if (mbedtls_mpi_write_binary(&ctx, output.data(), output.size()))
+        return decodedSize;
+    }
+
+    std::vector<u8> decode64(const std::vector<u8> &input) {
+        // Line breaks and other whitespace are commonly found in base64 files, so they're skipped here
+        std::string string(input.begin(), input.end());
+        std::erase_if(string, [](char c) { return std::isspace(u8(c)); });
+
+        std::vector<u8> output(string.size() / 4 * 3);
+        try {
+            output.resize(decode64(string, output));
+        } catch (const std::invalid_argument &) {
             return {};
+        }
 
         return output;
     }
 
-    std::string encode16(const std::vector<u8> &input) {
+    std::vector<u8> encode64(const std::vector<u8> &input) {
+        std::vector<u8> output((input.size() + 2) / 3 * 4);
+        encode64(input, { reinterpret_cast<char *>(output.data()), output.size() });
 
-        if (input.empty())
+        return output;
+    }
+
+    std::vector<u8> decode16(const std::string &input) {
+        std::vector<u8> output(input.size() / 2);
+        try {
+            decode16(input, output);
+        } catch (const std::invalid_argument &) {
             return {};
+        }
 
-        std::string output(input.size() * 2, '\0');
+        return output;
+    }
 
-        for (size_t i = 0; i < input.size(); i++) {
-            output[2 * i + 0] = "0123456789ABCDEF"[input[i] / 16];
-            output[2 * i + 1] = "0123456789ABCDEF"[input[i] % 16];
-        }
+    std::string encode16(const std::vector<u8> &input) {
+        std::string output(input.size() * 2, '\0');
+        encode16(input, output);
 
         return output;
     }
@@ -524,6 +1401,17 @@ namespace hex::crypt {
     }
 
     std::vector<u8> aesDecrypt(AESMode mode, KeyLength keyLength, const std::vector<u8> &key, std::array<u8, 8> nonce, std::array<u8, 8> iv, const std::vector<u8> &input) {
+        if (mode == AESMode::ECB || mode == AESMode::CTR || mode == AESMode::XTS) {
+            try {
+                std::vector<u8> output(input.size());
+                AESDecryptor(mode, keyLength, key, nonce, iv).decrypt(0, input, output);
+
+                return output;
+            } catch (const std::invalid_argument &) {
+                return {};
+            }
+        }
+
         switch (keyLength) {
             case KeyLength::Key128Bits:
                 if (key.size() != 128 / 8) return {};
@@ -540,18 +1428,12 @@ namespace hex::crypt {
 
         mbedtls_cipher_type_t type;
         switch (mode) {
-            case AESMode::ECB:
-                type = MBEDTLS_CIPHER_AES_128_ECB;
-                break;
             case AESMode::CBC:
                 type = MBEDTLS_CIPHER_AES_128_CBC;
                 break;
             case AESMode::CFB128:
                 type = MBEDTLS_CIPHER_AES_128_CFB128;
                 break;
-            case AESMode::CTR:
-                type = MBEDTLS_CIPHER_AES_128_CTR;
-                break;
             case AESMode::GCM:
                 type = MBEDTLS_CIPHER_AES_128_GCM;
                 break;
@@ -561,9 +1443,6 @@ namespace hex::crypt {
             case AESMode::OFB:
                 type = MBEDTLS_CIPHER_AES_128_OFB;
                 break;
-            case AESMode::XTS:
-                type = MBEDTLS_CIPHER_AES_128_XTS;
-                break;
             default:
                 return {};
         }
@@ -573,4 +1452,455 @@ namespace hex::crypt {
         return aes(type, MBEDTLS_DECRYPT, key, nonce, iv, input);
     }
 
+    namespace {
+
+        constexpr static u64 AESBlockSize = 16;
+
+        void storeBigEndian(u64 value, u8 *bytes) {
+            for (u32 i = 0; i < sizeof(value); i++)
+                bytes[i] = u8(value >> (8 * (sizeof(value) - 1 - i)));
+        }
+
+        u64 loadBigEndian(const u8 *bytes) {
+            u64 value = 0;
+            for (u32 i = 0; i < sizeof(value); i++)
+                value = (value << 8) | bytes[i];
+
+            return value;
+        }
+
+        // Multiplies an XTS tweak by the primitive element of GF(2^128), the tweak is stored in little endian
+        void multiplyTweak(std::array<u8, AESBlockSize> &tweak) {
+            u8 carry = 0;
+            for (auto &byte : tweak) {
+                const u8 nextCarry = byte >> 7;
+                byte = u8(byte << 1) | carry;
+                carry = nextCarry;
+            }
+
+            if (carry != 0)
+                tweak[0] ^= 0x87;
+        }
+
+        #if defined(CRYPTO_X86_64_DISPATCH)
+
+            bool hasAesInstructions() {
+                static const bool supported = __builtin_cpu_supports("aes");
+                return supported;
+            }
+
+            [[gnu::target("aes")]]
+            u32 aesSubWord(u32 word) {
+                return u32(_mm_cvtsi128_si32(_mm_aeskeygenassist_si128(_mm_set_epi32(0, 0, int(word), 0), 0)));
+            }
+
+            // Multiple blocks are processed at once to hide the latency of the AES instructions
+            template<bool Encrypt, size_t Count>
+            [[gnu::target("aes")]]
+            void aesProcessBlocks(const __m128i *keys, u32 rounds, const u8 *input, u8 *output) {
+                __m128i blocks[Count];
+                for (size_t i = 0; i < Count; i++)
+                    blocks[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i * AESBlockSize)), keys[0]);
+
+                for (u32 round = 1; round < rounds; round++) {
+                    for (auto &block : blocks)
+                        block = Encrypt ? _mm_aesenc_si128(block, keys[round]) : _mm_aesdec_si128(block, keys[round]);
+                }
+
+                for (size_t i = 0; i < Count; i++) {
+                    const auto block = Encrypt ? _mm_aesenclast_si128(blocks[i], keys[rounds]) : _mm_aesdeclast_si128(blocks[i], keys[rounds]);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i * AESBlockSize), block);
+                }
+            }
+
+        #endif
+
+    }
+
+    // Plain AES block cipher, en- and decrypts any number of independent blocks. It's never modified after construction, so all threads can share it
+    class AESDecryptor::Cipher {
+    public:
+        explicit Cipher(std::span<const u8> key) {
+            mbedtls_aes_init(&this->m_encryptionContext);
+            mbedtls_aes_init(&this->m_decryptionContext);
+
+            #if defined(CRYPTO_X86_64_DISPATCH)
+                if (hasAesInstructions()) {
+                    this->m_useAesInstructions = true;
+                    this->expandKeys(key);
+                    return;
+                }
+            #endif
+
+            mbedtls_aes_setkey_enc(&this->m_encryptionContext, key.data(), key.size() * 8);
+            mbedtls_aes_setkey_dec(&this->m_decryptionContext, key.data(), key.size() * 8);
+        }
+
+        ~Cipher() {
+            mbedtls_aes_free(&this->m_encryptionContext);
+            mbedtls_aes_free(&this->m_decryptionContext);
+        }
+
+        Cipher(const Cipher &) = delete;
+        Cipher &operator=(const Cipher &) = delete;
+
+        void encrypt(const u8 *input, u8 *output, size_t blockCount) const {
+            #if defined(CRYPTO_X86_64_DISPATCH)
+                if (this->m_useAesInstructions)
+                    return this->process<true>(input, output, blockCount);
+            #endif
+
+            for (size_t block = 0; block < blockCount; block++)
+                mbedtls_aes_crypt_ecb(&this->m_encryptionContext, MBEDTLS_AES_ENCRYPT, input + block * AESBlockSize, output + block * AESBlockSize);
+        }
+
+        void decrypt(const u8 *input, u8 *output, size_t blockCount) const {
+            #if defined(CRYPTO_X86_64_DISPATCH)
+                if (this->m_useAesInstructions)
+                    return this->process<false>(input, output, blockCount);
+            #endif
+
+            for (size_t block = 0; block < blockCount; block++)
+                mbedtls_aes_crypt_ecb(&this->m_decryptionContext, MBEDTLS_AES_DECRYPT, input + block * AESBlockSize, output + block * AESBlockSize);
+        }
+
+    private:
+        #if defined(CRYPTO_X86_64_DISPATCH)
+
+            [[gnu::target("aes")]]
+            void expandKeys(std::span<const u8> key) {
+                this->m_rounds = key.size() / 4 + 6;
+
+                // Key expansion as described in FIPS-197 on little endian words, AESKEYGENASSIST takes care of the S-box lookups
+                const u32 keyWords = key.size() / 4;
+                std::array<u32, 4 * 15> words = { };
+                std::memcpy(words.data(), key.data(), key.size());
+
+                u32 roundConstant = 0x01;
+                for (u32 i = keyWords; i < 4 * (this->m_rounds + 1); i++) {
+                    auto word = words[i - 1];
+                    if (i % keyWords == 0) {
+                        word = std::rotr(aesSubWord(word), 8) ^ roundConstant;
+                        roundConstant = (roundConstant << 1) ^ ((roundConstant & 0x80) != 0 ? 0x11B : 0x00);
+                    } else if (keyWords > 6 && i % keyWords == 4) {
+                        word = aesSubWord(word);
+                    }
+
+                    words[i] = words[i - keyWords] ^ word;
+                }
+
+                for (u32 round = 0; round <= this->m_rounds; round++)
+                    this->m_encryptionKeys[round] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&words[round * 4]));
+
+                // The equivalent inverse cipher uses the encryption keys in reverse order with InvMixColumns applied to all but the first and last one
+                this->m_decryptionKeys[0] = this->m_encryptionKeys[this->m_rounds];
+                for (u32 round = 1; round < this->m_rounds; round++)
+                    this->m_decryptionKeys[round] = _mm_aesimc_si128(this->m_encryptionKeys[this->m_rounds - round]);
+                this->m_decryptionKeys[this->m_rounds] = this->m_encryptionKeys[0];
+            }
+
+            template<bool Encrypt>
+            [[gnu::target("aes")]]
+            void process(const u8 *input, u8 *output, size_t blockCount) const {
+                const auto keys = Encrypt ? this->m_encryptionKeys : this->m_decryptionKeys;
+
+                constexpr static size_t Interleave = 8;
+
+                size_t block = 0;
+                for (; block + Interleave <= blockCount; block += Interleave)
+                    aesProcessBlocks<Encrypt, Interleave>(keys, this->m_rounds, input + block * AESBlockSize, output + block * AESBlockSize);
+                for (; block < blockCount; block++)
+                    aesProcessBlocks<Encrypt, 1>(keys, this->m_rounds, input + block * AESBlockSize, output + block * AESBlockSize);
+            }
+
+            bool m_useAesInstructions = false;
+            u32 m_rounds = 0;
+            __m128i m_encryptionKeys[15], m_decryptionKeys[15];
+
+        #endif
+
+        // mbedtls only reads the round keys while en- or decrypting, the contexts just aren't declared const
+        mutable mbedtls_aes_context m_encryptionContext, m_decryptionContext;
+    };
+
+    AESDecryptor::AESDecryptor(AESMode mode, KeyLength keyLength, std::span<const u8> key, std::array<u8, 8> nonce, std::array<u8, 8> iv, u64 dataUnitSize) : m_mode(mode), m_dataUnitSize(dataUnitSize) {
+        size_t keySize;
+        switch (keyLength) {
+            case KeyLength::Key128Bits:
+                keySize = 128 / 8;
+                break;
+            case KeyLength::Key192Bits:
+                keySize = 192 / 8;
+                break;
+            case KeyLength::Key256Bits:
+                keySize = 256 / 8;
+                break;
+            default:
+                throw std::invalid_argument("Invalid key length");
+        }
+
+        switch (mode) {
+            case AESMode::ECB:
+            case AESMode::CTR:
+                if (key.size() != keySize)
+                    throw std::invalid_argument("Key doesn't match the key length");
+
+                this->m_cipher = std::make_unique<Cipher>(key);
+                break;
+            case AESMode::XTS:
+                if (key.size() != keySize * 2)
+                    throw std::invalid_argument("XTS key needs to consist of a data key and a tweak key of the key length");
+                if (dataUnitSize == 0 || dataUnitSize % AESBlockSize != 0)
+                    throw std::invalid_argument("XTS data unit size needs to be a multiple of the block size");
+
+                this->m_cipher      = std::make_unique<Cipher>(key.first(keySize));
+                this->m_tweakCipher = std::make_unique<Cipher>(key.subspan(keySize));
+                break;
+            default:
+                throw std::invalid_argument("Only ECB, CTR and XTS can be decrypted in parallel");
+        }
+
+        std::copy(nonce.begin(), nonce.end(), this->m_initialValue.begin());
+        std::copy(iv.begin(), iv.end(), this->m_initialValue.begin() + nonce.size());
+    }
+
+    AESDecryptor::~AESDecryptor() = default;
+
+    AESDecryptor::AESDecryptor(AESDecryptor &&) noexcept = default;
+    AESDecryptor &AESDecryptor::operator=(AESDecryptor &&) noexcept = default;
+
+    void AESDecryptor::decrypt(u64 position, std::span<const u8> input, std::span<u8> output) const {
+        constexpr static u64 TargetChunkSize = 1024 * 1024;
+
+        if (input.size() != output.size())
+            throw std::invalid_argument("Input and output need to be the same size");
+
+        this->validate(position, input.size());
+
+        const u64 chunkSize   = this->getChunkSize(TargetChunkSize);
+        const u64 chunkCount  = (input.size() + chunkSize - 1) / chunkSize;
+        const u32 threadCount = std::min<u64>(std::max(1U, std::thread::hardware_concurrency()), chunkCount);
+
+        if (threadCount <= 1) {
+            this->decryptChunk(position, input, output);
+            return;
+        }
+
+        std::atomic<u64> nextChunk = 0;
+        std::vector<std::jthread> workers;
+        for (u32 i = 0; i < threadCount; i++) {
+            workers.emplace_back([&] {
+                for (u64 chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+                    const auto chunkOffset = chunk * chunkSize;
+                    const auto size = std::min(chunkSize, input.size() - chunkOffset);
+
+                    this->decryptChunk(position + chunkOffset, input.subspan(chunkOffset, size), output.subspan(chunkOffset, size));
+                }
+            });
+        }
+    }
+
+    void AESDecryptor::decrypt(u64 offset, u64 size, const ReadFunction &read, const WriteFunction &write, const ProgressCallback &progress) const {
+        constexpr static u64 TargetBatchSize = 32 * 1024 * 1024;
+
+        this->validate(0, size);
+
+        const u64 batchSize = this->getChunkSize(TargetBatchSize);
+
+        // While one batch gets decrypted, the next one is read and the previous one is written out
+        std::array<std::vector<u8>, 2> inputs, outputs;
+        std::jthread worker;
+
+        u64 previousPosition = 0, previousSize = 0;
+        const auto writePrevious = [&](u64 batch) {
+            if (previousSize == 0)
+                return;
+
+            write(offset + previousPosition, std::span(outputs[batch % outputs.size()]).first(previousSize));
+            if (progress)
+                progress(previousPosition + previousSize);
+        };
+
+        u64 batch = 0;
+        for (u64 position = 0; position < size; batch++) {
+            auto &input = inputs[batch % inputs.size()];
+            input.resize(std::min(batchSize, size - position));
+            read(offset + position, input);
+
+            if (worker.joinable())
+                worker.join();
+
+            auto &output = outputs[batch % outputs.size()];
+            output.resize(input.size());
+            worker = std::jthread([this, position, &input, &output] {
+                this->decrypt(position, input, output);
+            });
+
+            if (batch > 0)
+                writePrevious(batch - 1);
+
+            previousPosition = position;
+            previousSize     = input.size();
+            position += input.size();
+        }
+
+        if (worker.joinable())
+            worker.join();
+
+        if (batch > 0)
+            writePrevious(batch - 1);
+    }
+
+    void AESDecryptor::validate(u64 position, u64 size) const {
+        switch (this->m_mode) {
+            case AESMode::ECB:
+                if (position % AESBlockSize != 0 || size % AESBlockSize != 0)
+                    throw std::invalid_argument("ECB data needs to consist of whole blocks");
+                break;
+            case AESMode::XTS:
+                if (position % this->m_dataUnitSize != 0)
+                    throw std::invalid_argument("XTS data needs to start at a data unit");
+                if (size % this->m_dataUnitSize != 0 && size % this->m_dataUnitSize < AESBlockSize)
+                    throw std::invalid_argument("Last XTS data unit needs to be at least one block long");
+                break;
+            default:
+                break;
+        }
+    }
+
+    u64 AESDecryptor::getChunkSize(u64 targetSize) const {
+        // Chunks may only be split up where the mode allows starting again
+        const u64 granularity = this->m_mode == AESMode::XTS ? this->m_dataUnitSize : AESBlockSize;
+
+        return std::max(granularity, targetSize / granularity * granularity);
+    }
+
+    void AESDecryptor::decryptChunk(u64 position, std::span<const u8> input, std::span<u8> output) const {
+        switch (this->m_mode) {
+            case AESMode::ECB:
+                this->m_cipher->decrypt(input.data(), output.data(), input.size() / AESBlockSize);
+                break;
+            case AESMode::CTR:
+                this->decryptCTR(position, input, output);
+                break;
+            case AESMode::XTS:
+                this->decryptXTS(position, input, output);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void AESDecryptor::decryptCTR(u64 position, std::span<const u8> input, std::span<u8> output) const {
+        constexpr static size_t BatchBlocks = 64;
+
+        // Counter block of the block `position` is in, the whole block is incremented as one 128 bit big endian number
+        u64 counterHigh = loadBigEndian(&this->m_initialValue[0]);
+        u64 counterLow  = loadBigEndian(&this->m_initialValue[8]);
+
+        const u64 firstBlock = position / AESBlockSize;
+        counterLow += firstBlock;
+        if (counterLow < firstBlock)
+            counterHigh += 1;
+
+        std::array<u8, BatchBlocks * AESBlockSize> counters, keyStream;
+        u64 skippedBytes = position % AESBlockSize;
+
+        for (size_t processed = 0; processed < input.size();) {
+            const size_t blockCount = std::min<u64>(BatchBlocks, (skippedBytes + input.size() - processed + AESBlockSize - 1) / AESBlockSize);
+            for (size_t block = 0; block < blockCount; block++) {
+                storeBigEndian(counterHigh, &counters[block * AESBlockSize]);
+                storeBigEndian(counterLow, &counters[block * AESBlockSize + 8]);
+
+                counterLow += 1;
+                if (counterLow == 0)
+                    counterHigh += 1;
+            }
+
+            this->m_cipher->encrypt(counters.data(), keyStream.data(), blockCount);
+
+            const size_t size = std::min<u64>(blockCount * AESBlockSize - skippedBytes, input.size() - processed);
+            for (size_t i = 0; i < size; i++)
+                output[processed + i] = input[processed + i] ^ keyStream[skippedBytes + i];
+
+            processed += size;
+            skippedBytes = 0;
+        }
+    }
+
+    void AESDecryptor::decryptXTS(u64 position, std::span<const u8> input, std::span<u8> output) const {
+        constexpr static size_t BatchBlocks = 64;
+
+        std::array<u8, BatchBlocks * AESBlockSize> tweaks, buffer;
+
+        // Decrypts `blockCount` whole blocks starting at `offset` and advances the tweak past them
+        const auto decryptBlocks = [&](size_t offset, size_t blockCount, std::array<u8, AESBlockSize> &tweak) {
+            while (blockCount > 0) {
+                const auto batchBlocks = std::min(blockCount, BatchBlocks);
+                const auto batchSize   = batchBlocks * AESBlockSize;
+
+                for (size_t block = 0; block < batchBlocks; block++) {
+                    std::copy(tweak.begin(), tweak.end(), tweaks.begin() + block * AESBlockSize);
+                    multiplyTweak(tweak);
+                }
+
+                for (size_t i = 0; i < batchSize; i++)
+                    buffer[i] = input[offset + i] ^ tweaks[i];
+
+                this->m_cipher->decrypt(buffer.data(), buffer.data(), batchBlocks);
+
+                for (size_t i = 0; i < batchSize; i++)
+                    output[offset + i] = buffer[i] ^ tweaks[i];
+
+                offset     += batchSize;
+                blockCount -= batchBlocks;
+            }
+        };
+
+        u64 unit = position / this->m_dataUnitSize;
+        for (size_t unitOffset = 0; unitOffset < input.size(); unitOffset += this->m_dataUnitSize, unit++) {
+            const size_t unitSize = std::min<u64>(this->m_dataUnitSize, input.size() - unitOffset);
+
+            // Tweak of the data unit is its number added to the initial value, encrypted with the tweak key
+            std::array<u8, AESBlockSize> tweak = this->m_initialValue;
+            for (u32 i = 0, carry = 0; i < tweak.size(); i++) {
+                const u32 sum = tweak[i] + ((i < sizeof(unit) ? u8(unit >> (8 * i)) : 0)) + carry;
+                tweak[i] = u8(sum);
+                carry = sum >> 8;
+            }
+
+            this->m_tweakCipher->encrypt(tweak.data(), tweak.data(), 1);
+
+            const size_t remainingBytes = unitSize % AESBlockSize;
+            if (remainingBytes == 0) {
+                decryptBlocks(unitOffset, unitSize / AESBlockSize, tweak);
+                continue;
+            }
+
+            // Ciphertext stealing. The last whole block is decrypted with the tweak of the partial block following it, the ciphertext
+            // missing from the partial block is taken from the result. The completed partial block is then decrypted with the skipped tweak
+            const size_t lastBlockOffset = unitOffset + (unitSize / AESBlockSize - 1) * AESBlockSize;
+            decryptBlocks(unitOffset, unitSize / AESBlockSize - 1, tweak);
+
+            const auto lastTweak = tweak;
+            multiplyTweak(tweak);
+
+            std::array<u8, AESBlockSize> stolen, completed;
+            for (size_t i = 0; i < AESBlockSize; i++)
+                stolen[i] = input[lastBlockOffset + i] ^ tweak[i];
+            this->m_cipher->decrypt(stolen.data(), stolen.data(), 1);
+            for (size_t i = 0; i < AESBlockSize; i++)
+                stolen[i] ^= tweak[i];
+
+            for (size_t i = 0; i < AESBlockSize; i++)
+                completed[i] = (i < remainingBytes ? input[lastBlockOffset + AESBlockSize + i] : stolen[i]) ^ lastTweak[i];
+            this->m_cipher->decrypt(completed.data(), completed.data(), 1);
+
+            for (size_t i = 0; i < AESBlockSize; i++)
+                output[lastBlockOffset + i] = completed[i] ^ lastTweak[i];
+            for (size_t i = 0; i < remainingBytes; i++)
+                output[lastBlockOffset + AESBlockSize + i] = stolen[i];
+        }
+    }
+
 }
@@ -0,0 +1,512 @@
+#include <hex/helpers/entropy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace hex::entropy {
+
+    namespace {
+
+        template<typename T, typename U>
+        void addCounts(std::array<T, 256> &histogram, const std::array<U, 256> &counts) {
+            for (u32 value = 0; value < histogram.size(); value++)
+                histogram[value] += counts[value];
+        }
+
+        // count * log2(count) for small counts, so the entropy of small blocks doesn't need a logarithm for every value
+        const auto &getCountTerms() {
+            static const auto terms = [] {
+                std::array<float, 16 * 1024 + 1> result = { };
+                for (u32 count = 1; count < result.size(); count++)
+                    result[count] = count * std::log2(double(count));
+
+                return result;
+            }();
+
+            return terms;
+        }
+
+        constexpr auto PrintableMask = [] {
+            std::array<u32, 256> result = { };
+            for (u32 value = 0x20; value < 0x7F; value++)
+                result[value] = 0xFFFF'FFFF;
+            result['\t'] = result['\n'] = result['\r'] = 0xFFFF'FFFF;
+
+            return result;
+        }();
+
+        // `sum` is the sum of count * log2(count) over all values
+        Node createNode(double sum, u64 zeros, u64 printable, u64 size) {
+            if (size == 0)
+                return { 0, 0, 0 };
+
+            // Entropy in bits is log2(size) - sum(count * log2(count)) / size
+            const double entropy = std::clamp((std::log2(double(size)) - sum / size) / 8, 0.0, 1.0);
+            const auto share = [size](u64 count) { return u8(std::lround(double(count) * 0xFF / size)); };
+
+            return { u16(std::lround(entropy * 0xFFFF)), share(zeros), share(printable) };
+        }
+
+        template<typename T>
+        Node createNode(const std::array<T, 256> &counts, u64 size) {
+            const auto &terms = getCountTerms();
+
+            double sum = 0;
+            u64 printable = 0;
+            for (u32 value = 0; value < counts.size(); value++) {
+                const auto count = counts[value];
+
+                sum += count < terms.size() ? terms[count] : count * std::log2(double(count));
+                printable += count & PrintableMask[value];
+            }
+
+            return createNode(sum, counts[0x00], printable, size);
+        }
+
+    }
+
+    void countValues(std::span<const u8> data, Histogram &histogram) {
+        // Counting into a single table makes every increment in a run of the same byte value wait for the previous one to be written back.
+        // Spreading neighbouring bytes over four tables keeps those increments independent of each other
+        std::array<std::array<u32, 256>, 4> counts;
+
+        // Every table gets a quarter of the data, so the 32 bit counters can't overflow
+        constexpr static size_t ChunkSize = std::numeric_limits<u32>::max();
+
+        for (size_t offset = 0; offset < data.size(); offset += ChunkSize) {
+            const auto chunk = data.subspan(offset, std::min(ChunkSize, data.size() - offset));
+            counts = { };
+
+            size_t i = 0;
+            for (; i + sizeof(u64) <= chunk.size(); i += sizeof(u64)) {
+                u64 word;
+                std::memcpy(&word, chunk.data() + i, sizeof(word));
+
+                counts[0][u8(word >>  0)]++;
+                counts[1][u8(word >>  8)]++;
+                counts[2][u8(word >> 16)]++;
+                counts[3][u8(word >> 24)]++;
+                counts[0][u8(word >> 32)]++;
+                counts[1][u8(word >> 40)]++;
+                counts[2][u8(word >> 48)]++;
+                counts[3][u8(word >> 56)]++;
+            }
+
+            for (; i < chunk.size(); i++)
+                counts[i % counts.size()][chunk[i]]++;
+
+            for (u32 value = 0; value < histogram.size(); value++)
+                histogram[value] += u64(counts[0][value]) + counts[1][value] + counts[2][value] + counts[3][value];
+        }
+    }
+
+    float calculateEntropy(const Histogram &histogram, u64 size) {
+        if (size == 0)
+            return 0;
+
+        double entropy = 0;
+        for (auto count : histogram) {
+            if (count == 0) continue;
+
+            const double probability = double(count) / size;
+
+            entropy -= probability * std::log2(probability);
+        }
+
+        return float(entropy / 8);    // log2(256) = 8
+    }
+
+    Analysis analyze(u64 offset, u64 size, u64 blockSize, const crypt::ReadFunction &read, const crypt::ProgressCallback &progress) {
+        constexpr static u64 BatchSize = 32 * 1024 * 1024;
+
+        if (blockSize == 0)
+            throw std::invalid_argument("Block size cannot be zero");
+
+        Analysis result;
+        result.blockSize = blockSize;
+        result.blockEntropy.resize((size + blockSize - 1) / blockSize);
+
+        const u32 threadCount = std::max(1U, std::thread::hardware_concurrency());
+
+        // Every thread adds the counts of the blocks it analyzed to a histogram of its own, they're only merged at the very end
+        std::vector<Histogram> threadValueCounts(threadCount);
+
+        // Blocks larger than a batch are read in multiple parts. Each part is split up between all threads and their counts get merged once the whole block is done
+        std::vector<Histogram> threadBlockCounts(threadCount);
+        constexpr static u64 NoBlock = std::numeric_limits<u64>::max();
+        u64 completedBlock = NoBlock;
+
+        const auto finishBlock = [&] {
+            if (completedBlock == NoBlock)
+                return;
+
+            Histogram blockCounts = { };
+            for (auto &counts : threadBlockCounts) {
+                addCounts(blockCounts, counts);
+                counts = { };
+            }
+
+            result.blockEntropy[completedBlock] = calculateEntropy(blockCounts, std::min(blockSize, size - completedBlock * blockSize));
+            addCounts(result.valueCounts, blockCounts);
+
+            completedBlock = NoBlock;
+        };
+
+        // While one batch gets analyzed by the workers, the next one is read into the other buffer
+        std::array<std::vector<u8>, 2> buffers;
+        std::vector<std::jthread> workers;
+
+        for (u64 position = 0, batch = 0; position < size; batch++) {
+            const u64 block    = position / blockSize;
+            const u64 blockEnd = std::min((block + 1) * blockSize, size);
+
+            auto &buffer = buffers[batch % buffers.size()];
+            if (blockSize <= BatchSize)
+                buffer.resize(std::min(BatchSize / blockSize * blockSize, size - position));
+            else
+                buffer.resize(std::min(BatchSize, blockEnd - position));
+
+            read(offset + position, buffer);
+
+            // Wait for the previous batch to be done before starting this one
+            workers.clear();
+            finishBlock();
+            if (progress && position > 0)
+                progress(position);
+
+            const std::span<const u8> data = buffer;
+            if (blockSize <= BatchSize) {
+                // Every thread gets a consecutive range of whole blocks and writes their entropy straight into their slots
+                const u64 blockCount = (data.size() + blockSize - 1) / blockSize;
+                const u64 threads    = std::min<u64>(threadCount, blockCount);
+
+                for (u64 thread = 0; thread < threads; thread++) {
+                    workers.emplace_back([&, data, thread, threads, blockCount, firstBlock = block] {
+                        auto &valueCounts = threadValueCounts[thread];
+
+                        for (u64 i = blockCount * thread / threads; i < blockCount * (thread + 1) / threads; i++) {
+                            const auto blockData = data.subspan(i * blockSize, std::min<u64>(blockSize, data.size() - i * blockSize));
+
+                            Histogram blockCounts = { };
+                            countValues(blockData, blockCounts);
+
+                            result.blockEntropy[firstBlock + i] = calculateEntropy(blockCounts, blockData.size());
+                            addCounts(valueCounts, blockCounts);
+                        }
+                    });
+                }
+            } else {
+                for (u64 thread = 0; thread < threadCount; thread++) {
+                    workers.emplace_back([&, data, thread] {
+                        const auto start = data.size() * thread / threadCount;
+                        const auto end   = data.size() * (thread + 1) / threadCount;
+
+                        countValues(data.subspan(start, end - start), threadBlockCounts[thread]);
+                    });
+                }
+
+                if (position + data.size() == blockEnd)
+                    completedBlock = block;
+            }
+
+            position += data.size();
+        }
+
+        workers.clear();
+        finishBlock();
+
+        for (const auto &counts : threadValueCounts)
+            addCounts(result.valueCounts, counts);
+
+        if (progress)
+            progress(size);
+
+        return result;
+    }
+
+    u64 Pyramid::getNodeSize(u32 level) const {
+        u64 size = this->m_leafSize;
+        for (u32 i = 0; i < level; i++)
+            size *= Fanout;
+
+        return size;
+    }
+
+    u32 Pyramid::findLevel(u64 size, u64 maxNodes) const {
+        for (u32 level = 0; level < this->getLevelCount(); level++) {
+            const auto nodeSize = this->getNodeSize(level);
+            if ((size + nodeSize - 1) / nodeSize <= maxNodes)
+                return level;
+        }
+
+        return this->getLevelCount() - 1;
+    }
+
+    void Pyramid::build(u64 offset, u64 size, const crypt::ReadFunction &read, const crypt::ProgressCallback &progress) {
+        // Amount of data every thread analyzes at once and amount of data read at once
+        constexpr static u64 UnitSize  = 64 * 1024;
+        constexpr static u64 BatchSize = 16 * 1024 * 1024;
+
+        this->m_offset = offset;
+        this->m_size   = size;
+        this->m_valueCounts = { };
+
+        this->m_leafSize = MinimumLeafSize;
+        while ((size + this->m_leafSize - 1) / this->m_leafSize > MaximumLeafCount)
+            this->m_leafSize *= Fanout;
+
+        this->m_levels.clear();
+        for (u64 nodeSize = this->m_leafSize;; nodeSize *= Fanout) {
+            this->m_levels.emplace_back((size + nodeSize - 1) / nodeSize);
+
+            if (this->m_levels.back().size() <= 1)
+                break;
+        }
+
+        // Threads analyze whole nodes of the unit level, the levels above it are combined from their counts on the calling thread
+        u32 unitLevel = 0;
+        while (unitLevel + 1 < this->getLevelCount() && this->getNodeSize(unitLevel) < UnitSize)
+            unitLevel++;
+
+        this->m_countedLevel = unitLevel;
+        while (this->m_countedLevel + 1 < this->getLevelCount() && this->m_levels[this->m_countedLevel].size() > MaximumCountedNodeCount)
+            this->m_countedLevel++;
+
+        this->m_counts.clear();
+        for (u32 level = this->m_countedLevel; level < this->getLevelCount(); level++)
+            this->m_counts.emplace_back(this->m_levels[level].size());
+
+        const u64 unitSize      = this->getNodeSize(unitLevel);
+        const u64 unitsPerBatch = std::max<u64>(1, BatchSize / unitSize);
+        const u32 threadCount   = std::max(1U, std::thread::hardware_concurrency());
+
+        std::vector<Histogram> pending(this->getLevelCount());
+
+        // While one batch gets analyzed by the workers, the next one is read into the other buffer
+        std::array<std::vector<u8>, 2> buffers;
+        std::array<std::vector<Counts>, 2> unitCounts;
+        std::optional<std::pair<u64, u64>> previousBatch;
+        std::vector<std::jthread> workers;
+
+        const auto collectPreviousBatch = [&] {
+            if (!previousBatch.has_value())
+                return;
+
+            const auto [batch, firstUnit] = *previousBatch;
+            for (u64 unit = 0; unit < unitCounts[batch % 2].size(); unit++) {
+                Histogram counts = { };
+                addCounts(counts, unitCounts[batch % 2][unit]);
+
+                this->collect(unitLevel, firstUnit + unit, counts, pending);
+            }
+
+            previousBatch.reset();
+        };
+
+        for (u64 position = 0, batch = 0; position < size; batch++) {
+            auto &buffer = buffers[batch % 2];
+            buffer.resize(std::min(unitsPerBatch * unitSize, size - position));
+            read(offset + position, buffer);
+
+            // Wait for the previous batch to be done before starting this one
+            workers.clear();
+            collectPreviousBatch();
+            if (progress && position > 0)
+                progress(position);
+
+            const std::span<const u8> data = buffer;
+            const u64 firstUnit = position / unitSize;
+            const u64 unitCount = (data.size() + unitSize - 1) / unitSize;
+            const u64 threads   = std::min<u64>(threadCount, unitCount);
+
+            auto &counts = unitCounts[batch % 2];
+            counts.assign(unitCount, Counts { });
+
+            // Every thread gets a consecutive range of units and writes the nodes inside of them straight into their slots
+            for (u64 thread = 0; thread < threads; thread++) {
+                workers.emplace_back([&, data, thread, threads, unitCount, firstUnit] {
+                    for (u64 unit = unitCount * thread / threads; unit < unitCount * (thread + 1) / threads; unit++) {
+                        const auto unitData = data.subspan(unit * unitSize, std::min<u64>(unitSize, data.size() - unit * unitSize));
+
+                        this->analyzeNode(this->m_levels, unitLevel, firstUnit + unit, 0, unitData, counts[unit]);
+                    }
+                });
+            }
+
+            previousBatch = { batch, firstUnit };
+            position += data.size();
+        }
+
+        workers.clear();
+        collectPreviousBatch();
+
+        if (progress)
+            progress(size);
+    }
+
+    void Pyramid::analyzeNode(std::span<std::vector<Node>> levels, u32 level, u64 index, u64 firstIndex, std::span<const u8> data, Counts &parentCounts) const {
+        // Leaves are counted the same way as in countValues() but with 8 bit tables that are cheap enough to clear for every leaf.
+        // Every table gets a quarter of the data, so they can't overflow
+        constexpr static size_t SmallLeafSize = 1016;
+
+        if (level == 0 && data.size() <= SmallLeafSize) {
+            std::array<std::array<u8, 256>, 4> tables = { };
+
+            size_t i = 0;
+            for (; i + sizeof(u64) <= data.size(); i += sizeof(u64)) {
+                u64 word;
+                std::memcpy(&word, data.data() + i, sizeof(word));
+
+                tables[0][u8(word >>  0)]++;
+                tables[1][u8(word >>  8)]++;
+                tables[2][u8(word >> 16)]++;
+                tables[3][u8(word >> 24)]++;
+                tables[0][u8(word >> 32)]++;
+                tables[1][u8(word >> 40)]++;
+                tables[2][u8(word >> 48)]++;
+                tables[3][u8(word >> 56)]++;
+            }
+
+            for (; i < data.size(); i++)
+                tables[i % tables.size()][data[i]]++;
+
+            // Summarizing the leaf and passing its counts on to the parent happens in a single pass over the tables.
+            // Four independent sums keep the additions from waiting on each other
+            const auto &terms = getCountTerms();
+            std::array<float, 4> sums = { };
+            u32 printable = 0;
+
+            for (u32 value = 0; value < 256; value += sums.size()) {
+                for (u32 j = 0; j < sums.size(); j++) {
+                    const u32 count = u32(tables[0][value + j]) + tables[1][value + j] + tables[2][value + j] + tables[3][value + j];
+
+                    sums[j] += terms[count];
+                    printable += count & PrintableMask[value + j];
+                    parentCounts[value + j] += count;
+                }
+            }
+
+            const u32 zeros = u32(tables[0][0x00]) + tables[1][0x00] + tables[2][0x00] + tables[3][0x00];
+            levels[level][index - firstIndex] = createNode(double(sums[0]) + sums[1] + sums[2] + sums[3], zeros, printable, data.size());
+        } else {
+            Counts counts = { };
+
+            if (level == 0) {
+                for (u8 byte : data)
+                    counts[byte]++;
+            } else {
+                const u64 childSize = this->getNodeSize(level - 1);
+
+                for (u64 child = 0; child * childSize < data.size(); child++)
+                    this->analyzeNode(levels, level - 1, index * Fanout + child, firstIndex * Fanout, data.subspan(child * childSize, std::min<u64>(childSize, data.size() - child * childSize)), counts);
+            }
+
+            levels[level][index - firstIndex] = createNode(counts, data.size());
+            addCounts(parentCounts, counts);
+        }
+    }
+
+    void Pyramid::update(u64 offset, u64 size, const crypt::ReadFunction &read) {
+        this->apply(this->analyzeChanges(offset, size, read));
+    }
+
+    Pyramid::Changes Pyramid::analyzeChanges(u64 offset, u64 size, const crypt::ReadFunction &read) const {
+        Changes changes;
+        if (size == 0 || offset >= this->m_offset + this->m_size || offset + size <= this->m_offset)
+            return changes;
+
+        const u64 start    = std::max(offset, this->m_offset) - this->m_offset;
+        const u64 end      = std::min(offset + size, this->m_offset + this->m_size) - this->m_offset;
+        const u64 nodeSize = this->getCountedNodeSize();
+
+        const u64 firstNode = start / nodeSize;
+        const u64 endNode   = (end + nodeSize - 1) / nodeSize;
+
+        changes.firstNode = firstNode;
+        changes.counts.resize(endNode - firstNode);
+        changes.levels.resize(this->m_countedLevel + 1);
+        for (u32 level = 0; level <= this->m_countedLevel; level++) {
+            const u64 nodesPerCountedNode = nodeSize / this->getNodeSize(level);
+            changes.levels[level].resize(std::min<u64>(endNode * nodesPerCountedNode, this->m_levels[level].size()) - firstNode * nodesPerCountedNode);
+        }
+
+        std::vector<u8> buffer;
+        for (u64 index = firstNode; index < endNode; index++) {
+            buffer.resize(std::min(nodeSize, this->m_size - index * nodeSize));
+            read(this->m_offset + index * nodeSize, buffer);
+
+            Counts nodeCounts = { };
+            this->analyzeNode(changes.levels, this->m_countedLevel, index, firstNode, buffer, nodeCounts);
+
+            addCounts(changes.counts[index - firstNode], nodeCounts);
+        }
+
+        return changes;
+    }
+
+    void Pyramid::apply(const Changes &changes) {
+        for (u32 level = 0; level < changes.levels.size(); level++) {
+            const u64 firstNode = changes.firstNode * (this->getCountedNodeSize() / this->getNodeSize(level));
+            std::copy(changes.levels[level].begin(), changes.levels[level].end(), this->m_levels[level].begin() + firstNode);
+        }
+
+        for (u64 node = 0; node < changes.counts.size(); node++) {
+            const u64 index    = changes.firstNode + node;
+            const auto &counts = changes.counts[node];
+
+            // The old counts of the node get replaced by the new ones in every node above it as well
+            const auto previousCounts = std::exchange(this->m_counts[0][index], counts);
+
+            const auto replaceCounts = [&](Histogram &histogram) {
+                for (u32 value = 0; value < histogram.size(); value++)
+                    histogram[value] = histogram[value] - previousCounts[value] + counts[value];
+            };
+
+            u64 parentIndex = index;
+            for (u32 level = this->m_countedLevel + 1; level < this->getLevelCount(); level++) {
+                parentIndex /= Fanout;
+
+                auto &parentCounts = this->m_counts[level - this->m_countedLevel][parentIndex];
+                replaceCounts(parentCounts);
+
+                const u64 parentSize = this->getNodeSize(level);
+                this->m_levels[level][parentIndex] = createNode(parentCounts, std::min(parentSize, this->m_size - parentIndex * parentSize));
+            }
+
+            replaceCounts(this->m_valueCounts);
+        }
+    }
+
+    void Pyramid::collect(u32 level, u64 index, const Histogram &counts, std::vector<Histogram> &pending) {
+        if (level >= this->m_countedLevel)
+            this->m_counts[level - this->m_countedLevel][index] = counts;
+
+        if (level + 1 == this->getLevelCount()) {
+            this->m_valueCounts = counts;
+            return;
+        }
+
+        // Once the last child of a node is done, the node itself is complete and can be passed on to its own parent
+        auto &parentCounts = pending[level + 1];
+        addCounts(parentCounts, counts);
+
+        if (index % Fanout == Fanout - 1 || index + 1 == this->m_levels[level].size()) {
+            const u64 parentIndex = index / Fanout;
+            const u64 parentSize  = this->getNodeSize(level + 1);
+
+            this->m_levels[level + 1][parentIndex] = createNode(parentCounts, std::min(parentSize, this->m_size - parentIndex * parentSize));
+
+            const auto completedCounts = parentCounts;
+            parentCounts = { };
+
+            this->collect(level + 1, parentIndex, completedCounts, pending);
+        }
+    }
+
+}
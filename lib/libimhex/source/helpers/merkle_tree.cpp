@@ -0,0 +1,155 @@
+#include <hex/helpers/merkle_tree.hpp>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+namespace hex::crypt {
+
+    namespace {
+
+        constexpr std::array<u8, 1> LeafPrefix = { 0x00 };
+        constexpr std::array<u8, 1> NodePrefix = { 0x01 };
+
+    }
+
+    MerkleTree::MerkleTree(ContextFactory createContext, u64 blockSize) : m_createContext(std::move(createContext)), m_blockSize(blockSize) {
+        if (blockSize == 0)
+            throw std::invalid_argument("Block size cannot be zero");
+    }
+
+    void MerkleTree::build(u64 size, const ReadFunction &read, const ProgressCallback &progress) {
+        this->m_built    = false;
+        this->m_dataSize = size;
+        this->m_levels.assign(1, std::vector<std::vector<u8>>((size + this->m_blockSize - 1) / this->m_blockSize));
+        this->m_outdatedLeaves.clear();
+
+        this->hashLeaves(0, this->getLeafCount(), read, progress);
+        this->buildLevels();
+
+        this->m_built = true;
+    }
+
+    void MerkleTree::invalidate(u64 offset, u64 size) {
+        if (size == 0 || offset >= this->m_dataSize)
+            return;
+
+        const auto lastLeaf = std::min((offset + std::min(size, this->m_dataSize - offset) - 1) / this->m_blockSize, this->getLeafCount() - 1);
+        for (u64 leaf = offset / this->m_blockSize; leaf <= lastLeaf; leaf++)
+            this->m_outdatedLeaves.push_back(leaf);
+    }
+
+    void MerkleTree::update(u64 size, const ReadFunction &read) {
+        if (!this->m_built) {
+            this->build(size, read);
+            return;
+        }
+
+        auto &leaves = this->m_levels.front();
+        const u64 leafCount = (size + this->m_blockSize - 1) / this->m_blockSize;
+        const bool leafCountChanged = leafCount != leaves.size();
+
+        // The last block that exists both before and after the resize might have been extended or cut off, all blocks after it are new
+        if (size != this->m_dataSize) {
+            const auto commonLeafCount = std::min<u64>(leaves.size(), leafCount);
+            for (u64 leaf = commonLeafCount == 0 ? 0 : commonLeafCount - 1; leaf < leafCount; leaf++)
+                this->m_outdatedLeaves.push_back(leaf);
+
+            leaves.resize(leafCount);
+            this->m_dataSize = size;
+        }
+
+        auto &outdated = this->m_outdatedLeaves;
+        std::sort(outdated.begin(), outdated.end());
+        outdated.erase(std::unique(outdated.begin(), outdated.end()), outdated.end());
+        outdated.erase(std::lower_bound(outdated.begin(), outdated.end(), leafCount), outdated.end());
+
+        // Consecutive blocks are hashed together so larger changes get spread over all cores
+        for (auto runStart = outdated.begin(); runStart != outdated.end();) {
+            auto runEnd = runStart + 1;
+            while (runEnd != outdated.end() && *runEnd == *(runEnd - 1) + 1)
+                ++runEnd;
+
+            this->hashLeaves(*runStart, *(runEnd - 1) - *runStart + 1, read);
+            runStart = runEnd;
+        }
+
+        // The shape of the tree changes with the number of leaves, nodes are cheap to hash so just rebuild all of them
+        if (leafCountChanged) {
+            this->buildLevels();
+        } else {
+            std::vector<u64> changedNodes = std::move(outdated);
+            for (u32 level = 1; level < this->m_levels.size(); level++) {
+                const auto &children = this->m_levels[level - 1];
+                auto &nodes = this->m_levels[level];
+
+                for (auto &node : changedNodes)
+                    node /= 2;
+                changedNodes.erase(std::unique(changedNodes.begin(), changedNodes.end()), changedNodes.end());
+
+                for (auto node : changedNodes) {
+                    if (node * 2 + 1 < children.size())
+                        nodes[node] = this->hashNode(children[node * 2], children[node * 2 + 1]);
+                    else
+                        nodes[node] = children[node * 2];
+                }
+            }
+        }
+
+        this->m_outdatedLeaves.clear();
+    }
+
+    std::vector<u8> MerkleTree::getRootHash() const {
+        if (this->getLeafCount() == 0)
+            return this->m_createContext()->finish();
+        else
+            return this->m_levels.back().front();
+    }
+
+    void MerkleTree::hashLeaves(u64 firstLeaf, u64 leafCount, const ReadFunction &read, const ProgressCallback &progress) {
+        if (leafCount == 0)
+            return;
+
+        const auto offset = firstLeaf * this->m_blockSize;
+        const auto size   = std::min(leafCount * this->m_blockSize, this->m_dataSize - offset);
+
+        auto hashes = hashBlocks([this] {
+            auto context = this->m_createContext();
+            context->update(LeafPrefix);
+
+            return context;
+        }, offset, size, this->m_blockSize, read, progress);
+
+        std::move(hashes.begin(), hashes.end(), this->m_levels.front().begin() + firstLeaf);
+    }
+
+    void MerkleTree::buildLevels() {
+        this->m_levels.resize(1);
+
+        while (this->m_levels.back().size() > 1) {
+            const auto &children = this->m_levels.back();
+
+            std::vector<std::vector<u8>> nodes;
+            nodes.reserve((children.size() + 1) / 2);
+            for (u64 i = 0; i < children.size(); i += 2) {
+                if (i + 1 < children.size())
+                    nodes.push_back(this->hashNode(children[i], children[i + 1]));
+                else
+                    nodes.push_back(children[i]);
+            }
+
+            this->m_levels.push_back(std::move(nodes));
+        }
+    }
+
+    std::vector<u8> MerkleTree::hashNode(const std::vector<u8> &left, const std::vector<u8> &right) const {
+        auto context = this->m_createContext();
+        context->update(NodePrefix);
+        context->update(left);
+        context->update(right);
+
+        return context->finish();
+    }
+
+}
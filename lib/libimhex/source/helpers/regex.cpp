@@ -0,0 +1,784 @@
+#include <hex/helpers/regex.hpp>
+
+#include <hex/helpers/fmt.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace hex::search {
+
+    namespace {
+
+        using ByteSet = std::bitset<256>;
+
+        constexpr u32 Infinite = std::numeric_limits<u32>::max();
+        constexpr u32 MaxRepetitions = 1000;
+        constexpr size_t MaxProgramSize = 100'000;
+
+        struct Node {
+            enum class Type { Bytes, Concatenation, Alternation, Repetition } type;
+
+            ByteSet bytes = { };
+            std::vector<Node> children = { };
+            u32 min = 0, max = 0;
+            bool greedy = true;
+        };
+
+        ByteSet makeByteSet(u8 from, u8 to) {
+            ByteSet result;
+            for (u32 byte = from; byte <= to; byte++)
+                result.set(byte);
+
+            return result;
+        }
+
+        class Parser {
+        public:
+            explicit Parser(const std::string &pattern) : m_pattern(pattern) { }
+
+            Node parse() {
+                auto node = this->parseAlternation();
+                if (!this->atEnd())
+                    this->error("Unmatched ')'");
+
+                return node;
+            }
+
+        private:
+            [[nodiscard]] bool atEnd() const { return this->m_position >= this->m_pattern.size(); }
+            [[nodiscard]] char peek() const { return this->m_pattern[this->m_position]; }
+            char get() { return this->m_pattern[this->m_position++]; }
+
+            [[noreturn]] void error(const std::string &message) const {
+                throw std::runtime_error(hex::format("{} at position {}", message, this->m_position));
+            }
+
+            Node parseAlternation() {
+                auto node = this->parseConcatenation();
+                if (this->atEnd() || this->peek() != '|')
+                    return node;
+
+                Node alternation = { .type = Node::Type::Alternation };
+                alternation.children.push_back(std::move(node));
+                while (!this->atEnd() && this->peek() == '|') {
+                    this->get();
+                    alternation.children.push_back(this->parseConcatenation());
+                }
+
+                return alternation;
+            }
+
+            Node parseConcatenation() {
+                Node node = { .type = Node::Type::Concatenation };
+                while (!this->atEnd() && this->peek() != '|' && this->peek() != ')')
+                    node.children.push_back(this->parseRepetition());
+
+                return node;
+            }
+
+            Node parseRepetition() {
+                auto node = this->parseAtom();
+
+                bool quantified = false;
+                while (!this->atEnd()) {
+                    u32 min = 0, max = 0;
+                    switch (this->peek()) {
+                        case '*': min = 0; max = Infinite; this->get(); break;
+                        case '+': min = 1; max = Infinite; this->get(); break;
+                        case '?': min = 0; max = 1;        this->get(); break;
+                        case '{':
+                            if (!this->parseBounds(min, max))
+                                return node;
+                            break;
+                        default:
+                            return node;
+                    }
+
+                    if (quantified)
+                        this->error("Nested quantifier");
+                    quantified = true;
+
+                    bool greedy = true;
+                    if (!this->atEnd() && this->peek() == '?') {
+                        this->get();
+                        greedy = false;
+                    }
+
+                    node = Node { .type = Node::Type::Repetition, .children = { std::move(node) }, .min = min, .max = max, .greedy = greedy };
+                }
+
+                return node;
+            }
+
+            // Parses {n}, {n,} and {n,m}. Braces that don't form a valid quantifier are treated as literals
+            bool parseBounds(u32 &min, u32 &max) {
+                auto position = this->m_position + 1;
+
+                auto parseNumber = [&]() -> std::optional<u32> {
+                    u64 value = 0;
+                    const auto start = position;
+                    while (position < this->m_pattern.size() && std::isdigit(u8(this->m_pattern[position]))) {
+                        value = std::min<u64>(value * 10 + (this->m_pattern[position] - '0'), MaxRepetitions + 1);
+                        position++;
+                    }
+
+                    if (position == start)
+                        return std::nullopt;
+                    else
+                        return u32(value);
+                };
+
+                auto lower = parseNumber();
+                if (!lower.has_value() || position >= this->m_pattern.size())
+                    return false;
+
+                std::optional<u32> upper = lower;
+                if (this->m_pattern[position] == ',') {
+                    position++;
+                    upper = parseNumber();
+                    if (!upper.has_value())
+                        upper = Infinite;
+                }
+
+                if (position >= this->m_pattern.size() || this->m_pattern[position] != '}')
+                    return false;
+
+                this->m_position = position + 1;
+
+                if (*lower > MaxRepetitions || (*upper != Infinite && *upper > MaxRepetitions))
+                    this->error(hex::format("Repetition count larger than {}", MaxRepetitions));
+                if (*lower > *upper)
+                    this->error("Invalid repetition range");
+
+                min = *lower;
+                max = *upper;
+
+                return true;
+            }
+
+            Node parseAtom() {
+                const char c = this->get();
+                switch (c) {
+                    case '(': {
+                        if (!this->atEnd() && this->peek() == '?') {
+                            if (this->m_position + 1 < this->m_pattern.size() && this->m_pattern[this->m_position + 1] == ':')
+                                this->m_position += 2;
+                            else
+                                this->error("Unsupported group type");
+                        }
+
+                        auto node = this->parseAlternation();
+                        if (this->atEnd() || this->get() != ')')
+                            this->error("Missing ')'");
+
+                        return node;
+                    }
+                    case '[':
+                        return { .type = Node::Type::Bytes, .bytes = this->parseClass() };
+                    case '.':
+                        return { .type = Node::Type::Bytes, .bytes = ByteSet().set() };
+                    case '\\':
+                        return { .type = Node::Type::Bytes, .bytes = this->parseEscape() };
+                    case '*':
+                    case '+':
+                    case '?':
+                        this->error("Nothing to repeat");
+                    case '^':
+                    case '$':
+                        this->error("Anchors are not supported");
+                    default:
+                        return { .type = Node::Type::Bytes, .bytes = makeByteSet(u8(c), u8(c)) };
+                }
+            }
+
+            ByteSet parseEscape() {
+                if (this->atEnd())
+                    this->error("Incomplete escape sequence");
+
+                const char c = this->get();
+                switch (c) {
+                    case 'x': {
+                        if (this->m_position + 2 > this->m_pattern.size() || !std::isxdigit(u8(this->m_pattern[this->m_position])) || !std::isxdigit(u8(this->m_pattern[this->m_position + 1])))
+                            this->error("Expected two hex digits after \\x");
+
+                        const auto value = u8(std::stoul(this->m_pattern.substr(this->m_position, 2), nullptr, 16));
+                        this->m_position += 2;
+
+                        return makeByteSet(value, value);
+                    }
+                    case 'n': return makeByteSet('\n', '\n');
+                    case 'r': return makeByteSet('\r', '\r');
+                    case 't': return makeByteSet('\t', '\t');
+                    case 'f': return makeByteSet('\f', '\f');
+                    case 'v': return makeByteSet('\v', '\v');
+                    case 'a': return makeByteSet('\a', '\a');
+                    case 'e': return makeByteSet(0x1B, 0x1B);
+                    case '0': return makeByteSet(0x00, 0x00);
+                    case 'd': return makeByteSet('0', '9');
+                    case 'D': return ~makeByteSet('0', '9');
+                    case 'w': return makeByteSet('a', 'z') | makeByteSet('A', 'Z') | makeByteSet('0', '9') | makeByteSet('_', '_');
+                    case 'W': return ~(makeByteSet('a', 'z') | makeByteSet('A', 'Z') | makeByteSet('0', '9') | makeByteSet('_', '_'));
+                    case 's': return makeByteSet('\t', '\r') | makeByteSet(' ', ' ');
+                    case 'S': return ~(makeByteSet('\t', '\r') | makeByteSet(' ', ' '));
+                    default:
+                        if (std::isalnum(u8(c)))
+                            this->error(hex::format("Unknown escape sequence '\\{}'", c));
+
+                        return makeByteSet(u8(c), u8(c));
+                }
+            }
+
+            ByteSet parseClass() {
+                ByteSet result;
+
+                bool negated = false;
+                if (!this->atEnd() && this->peek() == '^') {
+                    this->get();
+                    negated = true;
+                }
+
+                // Parses a single class member, returns the byte it stands for if it's not a set of multiple bytes
+                auto parseMember = [this](ByteSet &bytes) -> std::optional<u8> {
+                    const char c = this->get();
+                    bytes = c == '\\' ? this->parseEscape() : makeByteSet(u8(c), u8(c));
+
+                    if (bytes.count() != 1)
+                        return std::nullopt;
+
+                    for (u32 byte = 0; byte < 256; byte++) {
+                        if (bytes[byte])
+                            return u8(byte);
+                    }
+
+                    return std::nullopt;
+                };
+
+                bool first = true;
+                while (true) {
+                    if (this->atEnd())
+                        this->error("Missing ']'");
+
+                    if (this->peek() == ']' && !first) {
+                        this->get();
+                        break;
+                    }
+                    first = false;
+
+                    ByteSet bytes;
+                    auto from = parseMember(bytes);
+
+                    const bool isRange = from.has_value() && this->m_position + 1 < this->m_pattern.size() && this->peek() == '-' && this->m_pattern[this->m_position + 1] != ']';
+                    if (isRange) {
+                        this->get();
+
+                        ByteSet toBytes;
+                        auto to = parseMember(toBytes);
+                        if (!to.has_value() || *to < *from)
+                            this->error("Invalid range in character class");
+
+                        result |= makeByteSet(*from, *to);
+                    } else {
+                        result |= bytes;
+                    }
+                }
+
+                if (negated)
+                    result.flip();
+
+                return result;
+            }
+
+        private:
+            const std::string &m_pattern;
+            size_t m_position = 0;
+        };
+
+    }
+
+    namespace impl {
+
+        struct RegexProgram {
+            struct Instruction {
+                enum class Type : u8 { Bytes, Split, Match } type;
+
+                // Bytes: the state to go to after a byte in the set. Split: the preferred state
+                u32 next = 0;
+                // Split: the state tried after the preferred one
+                u32 alternative = 0;
+                // Bytes: index into the byte sets
+                u32 bytes = 0;
+            };
+
+            std::vector<Instruction> instructions;
+            std::vector<ByteSet> byteSets;
+            u32 start = 0;
+        };
+
+    }
+
+    namespace {
+
+        using Program = impl::RegexProgram;
+
+        class Compiler {
+        public:
+            using Instruction = Program::Instruction;
+
+            Compiler(Program &program, bool reverse) : m_program(program), m_reverse(reverse) { }
+
+            u32 add(const Instruction &instruction) {
+                if (this->m_program.instructions.size() >= MaxProgramSize)
+                    throw std::runtime_error("Pattern is too large");
+
+                this->m_program.instructions.push_back(instruction);
+                return this->m_program.instructions.size() - 1;
+            }
+
+            u32 addBytes(const ByteSet &bytes, u32 next) {
+                this->m_program.byteSets.push_back(bytes);
+                return this->add({ .type = Instruction::Type::Bytes, .next = next, .bytes = u32(this->m_program.byteSets.size() - 1) });
+            }
+
+            u32 addSplit(u32 preferred, u32 alternative) {
+                return this->add({ .type = Instruction::Type::Split, .next = preferred, .alternative = alternative });
+            }
+
+            // Instructions are generated back to front so the instruction following a node is always known while compiling it
+            u32 compile(const Node &node, u32 next) {
+                switch (node.type) {
+                    using enum Node::Type;
+
+                    case Bytes:
+                        return this->addBytes(node.bytes, next);
+                    case Concatenation:
+                        if (this->m_reverse) {
+                            for (const auto &child : node.children)
+                                next = this->compile(child, next);
+                        } else {
+                            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it)
+                                next = this->compile(*it, next);
+                        }
+
+                        return next;
+                    case Alternation: {
+                        u32 result = this->compile(node.children.back(), next);
+                        for (auto it = node.children.rbegin() + 1; it != node.children.rend(); ++it)
+                            result = this->addSplit(this->compile(*it, next), result);
+
+                        return result;
+                    }
+                    case Repetition: {
+                        const auto &child = node.children.front();
+
+                        u32 start;
+                        if (node.max == Infinite) {
+                            const auto split = this->addSplit(0, 0);
+                            const auto body  = this->compile(child, split);
+
+                            auto &instruction = this->m_program.instructions[split];
+                            instruction.next        = node.greedy ? body : next;
+                            instruction.alternative = node.greedy ? next : body;
+
+                            start = split;
+                        } else {
+                            // x{0,n} is compiled as (x(x(x)?)?)?
+                            start = next;
+                            for (u32 i = node.min; i < node.max; i++) {
+                                const auto body = this->compile(child, start);
+                                start = node.greedy ? this->addSplit(body, next) : this->addSplit(next, body);
+                            }
+                        }
+
+                        for (u32 i = 0; i < node.min; i++)
+                            start = this->compile(child, start);
+
+                        return start;
+                    }
+                }
+
+                return next;
+            }
+
+        private:
+            Program &m_program;
+            bool m_reverse;
+        };
+
+        Program compileProgram(const Node &node, bool reverse, bool unanchored) {
+            Program program;
+            Compiler compiler(program, reverse);
+
+            const auto match = compiler.add({ .type = Program::Instruction::Type::Match });
+            program.start = compiler.compile(node, match);
+
+            // Prefix the pattern with a lazy .*? so matches can start anywhere. Being the lowest priority path, it stops starting
+            // new matches as soon as one has been found which gives leftmost-first semantics
+            if (unanchored) {
+                const auto split = compiler.addSplit(program.start, 0);
+                program.instructions[split].alternative = compiler.addBytes(ByteSet().set(), split);
+                program.start = split;
+            }
+
+            return program;
+        }
+
+    }
+
+    namespace impl {
+
+        class RegexDfa {
+        public:
+            // State ids are offsets into the transition table. Ids of match and dead states have an extra bit set so the scanning
+            // loop only needs a single check to find out if anything interesting happened
+            constexpr static u32 StartState = 0;
+            constexpr static u32 SpecialBit = 0x8000'0000;
+            constexpr static u8 MatchFlag = 0x01, DeadFlag = 0x02;
+
+            // In leftmost-first mode, threads with a lower priority than a match are dropped. Otherwise all threads are kept which
+            // makes it possible to find the longest match
+            RegexDfa(const Program &program, bool leftmostFirst) : m_program(program), m_leftmostFirst(leftmostFirst) {
+                // Split the byte values into classes that behave the same for every instruction
+                ByteSet boundaries;
+                for (const auto &bytes : program.byteSets) {
+                    for (u32 byte = 1; byte < 256; byte++) {
+                        if (bytes[byte] != bytes[byte - 1])
+                            boundaries.set(byte);
+                    }
+                }
+
+                u32 byteClass = 0;
+                for (u32 byte = 0; byte < 256; byte++) {
+                    if (boundaries[byte])
+                        byteClass++;
+                    this->m_classes[byte] = byteClass;
+                }
+                this->m_classCount = byteClass + 1;
+
+                this->m_visited.resize(program.instructions.size(), 0);
+
+                this->m_startSet.clear();
+                bool matched = false;
+                this->addClosure(program.start, this->m_startSet, matched);
+                this->normalize(this->m_startSet);
+
+                this->clear();
+            }
+
+            [[nodiscard]] u32 next(u32 state, u8 byte) {
+                const auto result = this->m_transitions[(state & ~SpecialBit) + this->m_classes[byte]];
+                if (result != Unknown) [[likely]]
+                    return result;
+
+                return this->computeNext(state, byte);
+            }
+
+            // Runs through the data until a match or dead state is reached or the end of the data is hit
+            [[nodiscard]] u32 advance(u32 state, const u8 *data, size_t &position, size_t end) {
+                const u32 *transitions = this->m_transitions.data();
+
+                while (position < end) {
+                    const auto byte = data[position];
+                    auto next = transitions[(state & ~SpecialBit) + this->m_classes[byte]];
+                    if (next == Unknown) [[unlikely]] {
+                        next = this->computeNext(state, byte);
+                        transitions = this->m_transitions.data();
+                    }
+
+                    position++;
+                    state = next;
+
+                    if (state & SpecialBit) [[unlikely]]
+                        break;
+                }
+
+                return state;
+            }
+
+            [[nodiscard]] bool matchesEmpty() const {
+                return this->m_flags[0] & MatchFlag;
+            }
+
+            [[nodiscard]] u8 getFlags(u32 state) const {
+                if ((state & SpecialBit) == 0)
+                    return 0x00;
+
+                return this->m_flags[(state & ~SpecialBit) / this->m_classCount];
+            }
+
+        private:
+            constexpr static u32 Unknown = std::numeric_limits<u32>::max();
+
+            // Upper limit for the number of cached states. Once it's reached, the cache is thrown away and built up again
+            constexpr static size_t MaxStates = 4096;
+
+            struct SetHash {
+                size_t operator()(const std::vector<u32> &set) const {
+                    size_t hash = 0xCBF29CE484222325;
+                    for (auto value : set)
+                        hash = (hash ^ value) * 0x100000001B3;
+
+                    return hash;
+                }
+            };
+
+            void clear() {
+                this->m_states.clear();
+                this->m_cache.clear();
+                this->m_transitions.clear();
+                this->m_flags.clear();
+
+                this->intern(this->m_startSet);
+                this->intern({ });
+            }
+
+            void nextGeneration() {
+                this->m_generation++;
+                if (this->m_generation == 0) {
+                    std::fill(this->m_visited.begin(), this->m_visited.end(), 0);
+                    this->m_generation = 1;
+                }
+            }
+
+            // Adds all Bytes and Match instructions reachable from the given instruction to the set, in order of their priority
+            void addClosure(u32 instruction, std::vector<u32> &set, bool &matched) {
+                using enum Program::Instruction::Type;
+
+                this->m_stack.push_back(instruction);
+                while (!this->m_stack.empty()) {
+                    const auto id = this->m_stack.back();
+                    this->m_stack.pop_back();
+
+                    if (this->m_visited[id] == this->m_generation)
+                        continue;
+                    this->m_visited[id] = this->m_generation;
+
+                    const auto &current = this->m_program.instructions[id];
+                    switch (current.type) {
+                        case Split:
+                            this->m_stack.push_back(current.alternative);
+                            this->m_stack.push_back(current.next);
+                            break;
+                        case Bytes:
+                            set.push_back(id);
+                            break;
+                        case Match:
+                            set.push_back(id);
+                            if (this->m_leftmostFirst) {
+                                this->m_stack.clear();
+                                matched = true;
+                            }
+                            break;
+                    }
+                }
+            }
+
+            void normalize(std::vector<u32> &set) const {
+                // Without priorities the order doesn't matter, sorting it makes equivalent states share the same cache entry
+                if (!this->m_leftmostFirst)
+                    std::sort(set.begin(), set.end());
+            }
+
+            u32 computeNext(u32 state, u8 byte) {
+                this->nextGeneration();
+
+                this->m_scratch.clear();
+                bool matched = false;
+                for (const auto id : this->m_states[(state & ~SpecialBit) / this->m_classCount]) {
+                    if (matched)
+                        break;
+
+                    const auto &instruction = this->m_program.instructions[id];
+                    if (instruction.type == Program::Instruction::Type::Bytes && this->m_program.byteSets[instruction.bytes][byte])
+                        this->addClosure(instruction.next, this->m_scratch, matched);
+                }
+                this->normalize(this->m_scratch);
+
+                if (this->m_states.size() >= MaxStates) {
+                    this->clear();
+                    return this->intern(this->m_scratch);
+                }
+
+                const auto result = this->intern(this->m_scratch);
+                this->m_transitions[(state & ~SpecialBit) + this->m_classes[byte]] = result;
+
+                return result;
+            }
+
+            u32 intern(const std::vector<u32> &set) {
+                if (auto it = this->m_cache.find(set); it != this->m_cache.end())
+                    return it->second;
+
+                const bool isMatch = std::any_of(set.begin(), set.end(), [this](u32 id) {
+                    return this->m_program.instructions[id].type == Program::Instruction::Type::Match;
+                });
+
+                const u8 flags = set.empty() ? DeadFlag : (isMatch ? MatchFlag : 0x00);
+                const u32 id = u32(this->m_transitions.size()) | (flags != 0x00 ? SpecialBit : 0x00);
+
+                this->m_states.push_back(set);
+                this->m_cache.emplace(set, id);
+                this->m_transitions.resize(this->m_transitions.size() + this->m_classCount, Unknown);
+                this->m_flags.push_back(flags);
+
+                return id;
+            }
+
+        private:
+            const Program &m_program;
+            bool m_leftmostFirst;
+
+            std::array<u8, 256> m_classes = { };
+            u32 m_classCount = 0;
+
+            std::vector<u32> m_startSet;
+            std::vector<std::vector<u32>> m_states;
+            std::unordered_map<std::vector<u32>, u32, SetHash> m_cache;
+            std::vector<u32> m_transitions;
+            std::vector<u8> m_flags;
+
+            std::vector<u32> m_stack, m_scratch, m_visited;
+            u32 m_generation = 1;
+        };
+
+    }
+
+    namespace {
+
+        using Dfa = impl::RegexDfa;
+
+    }
+
+    Regex::Regex(const std::string &pattern, size_t maxMatchLength) : m_maxMatchLength(std::max<size_t>(maxMatchLength, 1)) {
+        const auto ast = Parser(pattern).parse();
+
+        this->m_forwardProgram = std::make_unique<Program>(compileProgram(ast, false, true));
+        this->m_reverseProgram = std::make_unique<Program>(compileProgram(ast, true, false));
+
+        this->m_forward = std::make_unique<Dfa>(*this->m_forwardProgram, true);
+        this->m_reverse = std::make_unique<Dfa>(*this->m_reverseProgram, false);
+
+        if (this->m_forward->matchesEmpty())
+            throw std::runtime_error("Pattern matches empty data");
+    }
+
+    Regex::~Regex() = default;
+    Regex::Regex(Regex &&) noexcept = default;
+    Regex& Regex::operator=(Regex &&) noexcept = default;
+
+    void Regex::process(std::span<const u8> data, const Callback &callback) {
+        // Only keep the bytes that may still be part of a match that hasn't been reported yet
+        const u64 bufferEnd = this->m_bufferOffset + this->m_buffer.size();
+        const u64 keepFrom  = std::max({ this->m_bufferOffset, this->m_searchStart, bufferEnd - std::min<u64>(bufferEnd, 2 * this->m_maxMatchLength) });
+        if (keepFrom > this->m_bufferOffset) {
+            this->m_buffer.erase(this->m_buffer.begin(), this->m_buffer.begin() + std::min<u64>(keepFrom - this->m_bufferOffset, this->m_buffer.size()));
+            this->m_bufferOffset = keepFrom;
+        }
+
+        this->m_buffer.insert(this->m_buffer.end(), data.begin(), data.end());
+
+        this->scan(callback);
+    }
+
+    void Regex::finish(const Callback &callback) {
+        // Bytes after a reported match may have already been scanned, so scan them again for further matches
+        while (this->m_matchEnd.has_value()) {
+            this->reportMatch(callback);
+            this->scan(callback);
+        }
+
+        this->reset();
+    }
+
+    void Regex::scan(const Callback &callback) {
+        const u8 *data = this->m_buffer.data();
+        const u64 bufferEnd = this->m_bufferOffset + this->m_buffer.size();
+
+        while (this->m_position < bufferEnd) {
+            if (!this->m_matchEnd.has_value()) {
+                // Nothing matched yet, run through the data until something interesting happens
+                size_t position = this->m_position - this->m_bufferOffset;
+                this->m_state = this->m_forward->advance(this->m_state, data, position, this->m_buffer.size());
+                this->m_position = this->m_bufferOffset + position;
+
+                const auto flags = this->m_forward->getFlags(this->m_state);
+
+                if (flags & Dfa::MatchFlag) {
+                    this->m_matchEnd   = this->m_position;
+                    this->m_matchStart = this->findMatchStart(this->m_position);
+                } else if (flags & Dfa::DeadFlag) {
+                    this->m_state = Dfa::StartState;
+                }
+            } else {
+                // A match has been found, keep going to see if it can be extended
+                this->m_state = this->m_forward->next(this->m_state, data[this->m_position - this->m_bufferOffset]);
+                this->m_position++;
+
+                const auto flags = this->m_forward->getFlags(this->m_state);
+                if (flags & Dfa::MatchFlag) {
+                    this->m_matchEnd = this->m_position;
+                } else if (flags & Dfa::DeadFlag) {
+                    this->reportMatch(callback);
+                    continue;
+                }
+            }
+
+            // The match can't be extended any further without getting longer than the maximum match length
+            if (this->m_matchEnd.has_value() && this->m_position - *this->m_matchStart >= this->m_maxMatchLength)
+                this->reportMatch(callback);
+        }
+    }
+
+    u64 Regex::findMatchStart(u64 end) {
+        const u64 lowerBound = std::max(this->m_searchStart, end - std::min<u64>(end, this->m_maxMatchLength));
+
+        // Run the reversed pattern backwards from the end of the match to find where it starts
+        u64 start = end;
+        u32 state = Dfa::StartState;
+        for (u64 position = end; position > lowerBound; position--) {
+            state = this->m_reverse->next(state, this->m_buffer[(position - 1) - this->m_bufferOffset]);
+
+            const auto flags = this->m_reverse->getFlags(state);
+            if (flags & Dfa::DeadFlag)
+                break;
+            if (flags & Dfa::MatchFlag)
+                start = position - 1;
+        }
+
+        // The match is longer than the maximum match length, cut it off
+        if (start == end)
+            start = lowerBound;
+
+        return start;
+    }
+
+    void Regex::reportMatch(const Callback &callback) {
+        // Extending the match may have moved its start further to the front
+        const u64 end   = *this->m_matchEnd;
+        const u64 start = this->findMatchStart(end);
+
+        callback(Match { start, size_t(end - start) });
+
+        this->m_searchStart = end;
+        this->m_position = end;
+        this->m_state = Dfa::StartState;
+        this->m_matchEnd.reset();
+        this->m_matchStart.reset();
+    }
+
+    void Regex::reset() {
+        this->m_buffer.clear();
+        this->m_bufferOffset = 0;
+
+        this->m_state = Dfa::StartState;
+        this->m_position = 0;
+        this->m_searchStart = 0;
+        this->m_matchEnd.reset();
+        this->m_matchStart.reset();
+    }
+
+}
@@ -0,0 +1,1077 @@
+#include <hex/helpers/search.hpp>
+
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace hex::search {
+
+    namespace {
+
+        // Rough estimate of how common a byte value is in typical binary data. Higher values are more common.
+        // Used to pick the bytes of a needle that will produce the fewest false candidates
+        constexpr std::array<u8, 256> ByteFrequencyRanks = [] {
+            std::array<u8, 256> ranks = { };
+
+            for (u32 i = 0; i < 256; i++) {
+                const auto c = u8(i);
+
+                if (c == 0x00)
+                    ranks[i] = 255;
+                else if (c == 0xFF)
+                    ranks[i] = 240;
+                else if (c == ' ' || c == 'e' || c == 't' || c == 'a' || c == 'o' || c == 'i' || c == 'n' || c == 's' || c == 'r')
+                    ranks[i] = 200;
+                else if (c >= 'a' && c <= 'z')
+                    ranks[i] = 160;
+                else if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+                    ranks[i] = 140;
+                else if (c > 0x20 && c < 0x7F)
+                    ranks[i] = 120;
+                else if (c < 0x20)
+                    ranks[i] = c <= 0x08 ? 150 : 110;
+                else
+                    ranks[i] = 60;
+            }
+
+            // Common x86 opcodes and padding bytes
+            ranks[0xCC] = 180;
+            ranks[0x90] = 150;
+            ranks[0x48] = 170;
+            ranks[0x89] = 130;
+            ranks[0x8B] = 130;
+            ranks[0xE8] = 110;
+
+            return ranks;
+        }();
+
+    }
+
+    SequenceSearcher::SequenceSearcher(std::vector<u8> needle) : m_needle(std::move(needle)) {
+        if (this->m_needle.empty())
+            return;
+
+        auto rank = [this](size_t index) { return ByteFrequencyRanks[this->m_needle[index]]; };
+
+        this->m_rareIndex1 = 0;
+        for (size_t i = 1; i < this->m_needle.size(); i++) {
+            if (rank(i) < rank(this->m_rareIndex1))
+                this->m_rareIndex1 = i;
+        }
+
+        // Prefer a second byte with a different value, comparing the same byte value twice doesn't filter anything
+        std::optional<size_t> secondIndex;
+        for (size_t i = 0; i < this->m_needle.size(); i++) {
+            if (i == this->m_rareIndex1)
+                continue;
+
+            if (!secondIndex.has_value()) {
+                secondIndex = i;
+                continue;
+            }
+
+            const bool currDifferent = this->m_needle[i] != this->m_needle[this->m_rareIndex1];
+            const bool bestDifferent = this->m_needle[*secondIndex] != this->m_needle[this->m_rareIndex1];
+
+            if ((currDifferent && !bestDifferent) || (currDifferent == bestDifferent && rank(i) < rank(*secondIndex)))
+                secondIndex = i;
+        }
+
+        this->m_rareIndex2 = secondIndex.value_or(this->m_rareIndex1);
+    }
+
+    bool SequenceSearcher::matchesAt(const u8 *data) const {
+        return std::memcmp(data, this->m_needle.data(), this->m_needle.size()) == 0;
+    }
+
+    std::optional<size_t> SequenceSearcher::find(std::span<const u8> haystack, size_t offset) const {
+        const auto needleSize = this->m_needle.size();
+        if (needleSize == 0 || haystack.size() < needleSize || offset > haystack.size() - needleSize)
+            return std::nullopt;
+
+        const u8 *data = haystack.data();
+        const size_t lastPosition = haystack.size() - needleSize;
+
+        const u8 rareByte1 = this->m_needle[this->m_rareIndex1];
+        const u8 rareByte2 = this->m_needle[this->m_rareIndex2];
+
+        size_t position = offset;
+
+        #if defined(__SSE2__)
+            const auto rareBytes1 = _mm_set1_epi8(char(rareByte1));
+            const auto rareBytes2 = _mm_set1_epi8(char(rareByte2));
+
+            // Check 16 candidate positions at once. The loads never go past the end of the haystack since
+            // every candidate position is at most lastPosition and both rare indices are inside the needle
+            while (position <= lastPosition && lastPosition - position >= 15) {
+                const auto block1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + position + this->m_rareIndex1));
+                const auto block2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + position + this->m_rareIndex2));
+
+                auto mask = u32(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block1, rareBytes1), _mm_cmpeq_epi8(block2, rareBytes2))));
+                while (mask != 0) {
+                    const auto candidate = position + std::countr_zero(mask);
+                    if (this->matchesAt(data + candidate))
+                        return candidate;
+
+                    mask &= mask - 1;
+                }
+
+                position += 16;
+            }
+        #else
+            // Use memchr to skip ahead to the next occurrence of the rarest byte
+            while (position <= lastPosition) {
+                auto next = static_cast<const u8 *>(std::memchr(data + position + this->m_rareIndex1, rareByte1, lastPosition - position + 1));
+                if (next == nullptr)
+                    return std::nullopt;
+
+                const auto candidate = size_t(next - data) - this->m_rareIndex1;
+                if (data[candidate + this->m_rareIndex2] == rareByte2 && this->matchesAt(data + candidate))
+                    return candidate;
+
+                position = candidate + 1;
+            }
+        #endif
+
+        for (; position <= lastPosition; position++) {
+            if (data[position + this->m_rareIndex1] == rareByte1 && data[position + this->m_rareIndex2] == rareByte2 && this->matchesAt(data + position))
+                return position;
+        }
+
+        return std::nullopt;
+    }
+
+    PatternMatcher::PatternMatcher(const std::vector<MaskedByte> &pattern) : m_patternSize(pattern.size()) {
+        if (pattern.empty())
+            return;
+
+        const size_t words = (pattern.size() + 63) / 64;
+
+        this->m_table.resize(256 * words, 0x00);
+        this->m_state.resize(words, 0x00);
+        this->m_matchBit = u64(1) << ((pattern.size() - 1) % 64);
+
+        if (pattern.front().mask == 0xFF)
+            this->m_firstByte = pattern.front().value;
+
+        for (size_t position = 0; position < pattern.size(); position++) {
+            const auto [mask, value] = pattern[position];
+
+            for (u32 byte = 0; byte < 256; byte++) {
+                if ((byte & mask) == (value & mask))
+                    this->m_table[byte * words + position / 64] |= u64(1) << (position % 64);
+            }
+        }
+    }
+
+    void PatternMatcher::reset() {
+        std::fill(this->m_state.begin(), this->m_state.end(), 0x00);
+    }
+
+    MultiSequenceSearcher::MultiSequenceSearcher(const std::vector<std::vector<u8>> &needles) : m_needleCount(needles.size()) {
+        // Bytes that don't appear in any needle all behave the same way and share class 0
+        for (const auto &needle : needles) {
+            for (u8 byte : needle) {
+                if (this->m_classes[byte] == 0)
+                    this->m_classes[byte] = ++this->m_classCount;
+            }
+        }
+        this->m_classCount++;
+
+        size_t totalSize = 1;
+        for (const auto &needle : needles)
+            totalSize += needle.size();
+
+        if (totalSize * this->m_classCount >= OutputBit)
+            throw std::runtime_error("Too many needles");
+
+        const u32 classCount = this->m_classCount;
+        constexpr u32 NoTransition = std::numeric_limits<u32>::max();
+
+        // Build the trie. Nodes are referred to by their index while building the automaton
+        std::vector<u32> transitions(classCount, NoTransition);
+        std::vector<std::vector<u32>> outputs(1);
+
+        for (u32 index = 0; index < needles.size(); index++) {
+            const auto &needle = needles[index];
+            if (needle.empty())
+                continue;
+
+            u32 node = 0;
+            for (u8 byte : needle) {
+                auto &next = transitions[node * classCount + this->m_classes[byte]];
+                if (next == NoTransition) {
+                    next = outputs.size();
+                    outputs.emplace_back();
+                    transitions.resize(transitions.size() + classCount, NoTransition);
+                }
+
+                node = transitions[node * classCount + this->m_classes[byte]];
+            }
+
+            outputs[node].push_back(index);
+        }
+
+        // Turn the trie into a full automaton by resolving every missing transition through the failure links in breadth-first order
+        const u32 nodeCount = outputs.size();
+        std::vector<u32> failure(nodeCount, 0), queue;
+        queue.reserve(nodeCount);
+
+        for (u32 byteClass = 0; byteClass < classCount; byteClass++) {
+            auto &next = transitions[byteClass];
+            if (next == NoTransition) {
+                next = 0;
+            } else {
+                failure[next] = 0;
+                queue.push_back(next);
+            }
+        }
+
+        for (size_t i = 0; i < queue.size(); i++) {
+            const auto node = queue[i];
+
+            auto &nodeOutputs = outputs[node];
+            const auto &failureOutputs = outputs[failure[node]];
+            nodeOutputs.insert(nodeOutputs.end(), failureOutputs.begin(), failureOutputs.end());
+
+            for (u32 byteClass = 0; byteClass < classCount; byteClass++) {
+                auto &next = transitions[node * classCount + byteClass];
+                const auto failureNext = transitions[failure[node] * classCount + byteClass];
+
+                if (next == NoTransition) {
+                    next = failureNext;
+                } else {
+                    failure[next] = failureNext;
+                    queue.push_back(next);
+                }
+            }
+        }
+
+        // Store the final table with pre-multiplied state offsets and flatten the output lists
+        auto stateId = [&](u32 node) { return (node * classCount) | (outputs[node].empty() ? 0x00 : OutputBit); };
+
+        this->m_transitions.resize(transitions.size());
+        for (size_t i = 0; i < transitions.size(); i++)
+            this->m_transitions[i] = stateId(transitions[i]);
+
+        this->m_outputOffsets.reserve(nodeCount + 1);
+        for (const auto &nodeOutputs : outputs) {
+            this->m_outputOffsets.push_back(this->m_outputs.size());
+            this->m_outputs.insert(this->m_outputs.end(), nodeOutputs.begin(), nodeOutputs.end());
+        }
+        this->m_outputOffsets.push_back(this->m_outputs.size());
+    }
+
+    void MultiSequenceSearcher::reset() {
+        this->m_state = 0;
+    }
+
+    namespace {
+
+        // With more ranges than this, looking up every byte in the table is faster than comparing against all the ranges
+        constexpr size_t MaxVectorRanges = 8;
+
+        constexpr u64 bitsBetween(size_t from, size_t to) {
+            const u64 upper = to >= 64 ? ~u64(0) : (u64(1) << to) - 1;
+            const u64 lower = (u64(1) << from) - 1;
+
+            return upper & ~lower;
+        }
+
+        i32 byteAt(const auto &block, const auto &next, size_t index) {
+            if (index < block.size)
+                return block.bytes[index];
+            else if (block.size == block.bytes.size() && index - block.size < next.size)
+                return next.bytes[index - block.size];
+            else
+                return -1;
+        }
+
+    }
+
+    ApproximateMatcher::ApproximateMatcher(std::vector<u8> pattern, u32 maxDistance, Metric metric)
+        : m_pattern(std::move(pattern)), m_maxDistance(maxDistance), m_metric(metric) {
+        if (this->m_pattern.empty())
+            throw std::runtime_error("Empty pattern");
+        if (this->m_pattern.size() > MaxPatternSize)
+            throw std::runtime_error("Pattern too long");
+        if (this->m_maxDistance >= this->m_pattern.size())
+            throw std::runtime_error("Maximum distance has to be smaller than the pattern size");
+
+        for (size_t i = 0; i < this->m_pattern.size(); i++)
+            this->m_masks[this->m_pattern[i]] |= u64(1) << i;
+
+        this->m_highBit = u64(1) << (this->m_pattern.size() - 1);
+        this->reset();
+    }
+
+    void ApproximateMatcher::reset() {
+        this->m_states.assign(this->m_maxDistance + 1, 0);
+
+        this->m_positive = ~u64(0);
+        this->m_negative = 0;
+        this->m_score = this->m_previousScore = this->m_olderScore = this->m_pattern.size();
+
+        this->m_position = 0;
+        this->m_history.clear();
+    }
+
+    void ApproximateMatcher::process(std::span<const u8> data, const Callback &callback) {
+        const auto patternSize = this->m_pattern.size();
+        const auto maxDistance = this->m_maxDistance;
+        const u64 dataOffset = this->m_position;
+
+        if (this->m_metric == Metric::Hamming) {
+            u64 *states = this->m_states.data();
+
+            for (size_t i = 0; i < data.size(); i++) {
+                const u64 mask = this->m_masks[data[i]];
+
+                // A prefix matches with d substitutions if it did so one byte earlier and the current byte matches,
+                // or if it matched with d - 1 substitutions one byte earlier and the current byte is substituted
+                for (u32 distance = maxDistance; distance > 0; distance--)
+                    states[distance] = (((states[distance] << 1) | 1) & mask) | ((states[distance - 1] << 1) | 1);
+                states[0] = ((states[0] << 1) | 1) & mask;
+
+                if (states[maxDistance] & this->m_highBit) [[unlikely]] {
+                    u32 distance = 0;
+                    while ((states[distance] & this->m_highBit) == 0)
+                        distance++;
+
+                    callback(Match { (dataOffset + i) - (patternSize - 1), patternSize, distance });
+                }
+            }
+        } else {
+            // Distances above the maximum are all treated the same when looking for the best of neighbouring matches
+            const auto clamp = [maxDistance](u32 score) { return std::min(score, maxDistance + 1); };
+
+            u64 positive = this->m_positive, negative = this->m_negative;
+            u32 score = this->m_score;
+
+            for (size_t i = 0; i < data.size(); i++) {
+                const u64 equal = this->m_masks[data[i]];
+                const u64 verticalChange = equal | negative;
+                const u64 horizontalChange = (((equal & positive) + positive) ^ positive) | equal;
+
+                u64 horizontalPositive = negative | ~(horizontalChange | positive);
+                u64 horizontalNegative = positive & horizontalChange;
+
+                if (horizontalPositive & this->m_highBit)
+                    score++;
+                else if (horizontalNegative & this->m_highBit)
+                    score--;
+
+                // Matches can start anywhere in the data so the first row stays zero
+                horizontalPositive <<= 1;
+                horizontalNegative <<= 1;
+
+                positive = horizontalNegative | ~(verticalChange | horizontalPositive);
+                negative = horizontalPositive & verticalChange;
+
+                // Report the previous position if it's better than the one before and not worse than the current one
+                const auto previous = clamp(this->m_previousScore);
+                if (previous <= maxDistance && previous < clamp(this->m_olderScore) && previous <= clamp(score)) [[unlikely]]
+                    this->reportEdit(dataOffset + i - 1, previous, data, dataOffset, callback);
+
+                this->m_olderScore = this->m_previousScore;
+                this->m_previousScore = score;
+            }
+
+            this->m_positive = positive;
+            this->m_negative = negative;
+            this->m_score = score;
+        }
+
+        this->m_position += data.size();
+
+        // Keep enough data around to find the start of matches that are only reported by the next call
+        const auto historySize = this->getMaxMatchSize();
+        if (data.size() >= historySize) {
+            this->m_history.assign(data.end() - historySize, data.end());
+        } else {
+            this->m_history.insert(this->m_history.end(), data.begin(), data.end());
+            if (this->m_history.size() > historySize)
+                this->m_history.erase(this->m_history.begin(), this->m_history.end() - historySize);
+        }
+    }
+
+    void ApproximateMatcher::finish(const Callback &callback) {
+        if (this->m_metric == Metric::Levenshtein && this->m_position > 0) {
+            const auto previous = std::min(this->m_previousScore, this->m_maxDistance + 1);
+            if (previous <= this->m_maxDistance && previous < std::min(this->m_olderScore, this->m_maxDistance + 1))
+                this->reportEdit(this->m_position - 1, previous, { }, this->m_position, callback);
+        }
+
+        this->reset();
+    }
+
+    void ApproximateMatcher::reportEdit(u64 end, u32 distance, std::span<const u8> data, u64 dataOffset, const Callback &callback) const {
+        const auto windowSize = std::min<u64>(this->getMaxMatchSize(), end + 1);
+        const auto historyOffset = dataOffset - this->m_history.size();
+
+        std::vector<u8> window(windowSize);
+        for (u64 i = 0; i < windowSize; i++) {
+            const auto position = end + 1 - windowSize + i;
+            window[i] = position >= dataOffset ? data[position - dataOffset] : this->m_history[position - historyOffset];
+        }
+
+        const auto size = this->findMatchSize(window, distance);
+        callback(Match { end + 1 - size, size, distance });
+    }
+
+    size_t ApproximateMatcher::findMatchSize(const std::vector<u8> &window, u32 distance) const {
+        const auto patternSize = this->m_pattern.size();
+        const auto windowSize = window.size();
+
+        // Edit distances between the pattern and all suffixes of the window, computed backwards from the end of the match
+        std::vector<u32> column(windowSize + 1);
+        std::iota(column.begin(), column.end(), 0);
+
+        for (size_t i = 1; i <= patternSize; i++) {
+            u32 diagonal = column[0];
+            column[0] = i;
+
+            const u8 patternByte = this->m_pattern[patternSize - i];
+            for (size_t j = 1; j <= windowSize; j++) {
+                const u32 above = column[j];
+                column[j] = std::min({ column[j] + 1, column[j - 1] + 1, diagonal + (patternByte != window[windowSize - j] ? 1 : 0) });
+                diagonal = above;
+            }
+        }
+
+        // Of all the matches with the reported distance, pick the one closest to the size of the pattern
+        size_t bestSize = std::min(patternSize, windowSize);
+        std::optional<size_t> bestDifference;
+        for (size_t size = 1; size <= windowSize; size++) {
+            if (column[size] != distance)
+                continue;
+
+            const auto difference = size > patternSize ? size - patternSize : patternSize - size;
+            if (!bestDifference.has_value() || difference <= *bestDifference) {
+                bestSize = size;
+                bestDifference = difference;
+            }
+        }
+
+        return bestSize;
+    }
+
+    namespace {
+
+        template<typename T>
+        T fromRaw(u64 value) {
+            if constexpr (std::same_as<T, float>)
+                return std::bit_cast<float>(u32(value));
+            else if constexpr (std::same_as<T, double>)
+                return std::bit_cast<double>(value);
+            else
+                return static_cast<T>(value);
+        }
+
+        template<typename T>
+        u64 toRaw(T value) {
+            if constexpr (std::floating_point<T>)
+                return std::bit_cast<SizeType<sizeof(T)>>(value);
+            else
+                return static_cast<std::make_unsigned_t<T>>(value);
+        }
+
+        template<typename T>
+        T loadTyped(const u8 *data, std::endian endian) {
+            SizeType<sizeof(T)> value;
+            std::memcpy(&value, data, sizeof(T));
+
+            return std::bit_cast<T>(hex::changeEndianess(value, endian));
+        }
+
+        template<typename T>
+        bool matchesCondition(const ValueScanner::Condition &condition, T value, u64 rawValue, u64 previousRawValue) {
+            switch (condition.predicate) {
+                using enum ValueScanner::Predicate;
+                case Equal:
+                    return value == fromRaw<T>(condition.minimum);
+                case Range:
+                    return fromRaw<T>(condition.minimum) <= value && value <= fromRaw<T>(condition.maximum);
+                // Changes are detected on the bytes themselves so a NaN that stays the same counts as unchanged
+                case Changed:
+                    return rawValue != previousRawValue;
+                case Unchanged:
+                    return rawValue == previousRawValue;
+                case Increased:
+                    return value > fromRaw<T>(previousRawValue);
+                case Decreased:
+                    return value < fromRaw<T>(previousRawValue);
+            }
+
+            return false;
+        }
+
+        template<typename T>
+        bool scanValues(std::span<const u8> data, u64 address, const ValueScanner::Settings &settings, const ValueScanner::Condition &condition, std::vector<ValueScanner::Candidate> &candidates, size_t limit) {
+            constexpr size_t Size = sizeof(T);
+            if (data.size() < Size)
+                return true;
+
+            const u8 *bytes = data.data();
+            const size_t lastPosition = data.size() - Size;
+            const size_t step = settings.aligned ? Size : 1;
+            size_t position = settings.aligned ? (Size - address % Size) % Size : 0;
+
+            if constexpr (std::integral<T>) {
+                // Integers are equal exactly if their bytes are, so this is a search for a short sequence
+                if (condition.predicate == ValueScanner::Predicate::Equal) {
+                    const auto value = fromRaw<T>(condition.minimum);
+                    const auto rawValue = toRaw(value);
+
+                    std::array<u8, Size> pattern = { };
+                    const auto stored = hex::changeEndianess(SizeType<Size>(rawValue), settings.endian);
+                    std::memcpy(pattern.data(), &stored, Size);
+
+                    auto addCandidate = [&](size_t candidate) {
+                        candidates.push_back({ address + candidate, rawValue });
+                        return candidates.size() < limit;
+                    };
+
+                    #if defined(__SSE2__)
+                        const auto firstBytes = _mm_set1_epi8(char(pattern.front()));
+                        const auto lastBytes  = _mm_set1_epi8(char(pattern.back()));
+
+                        // Positions are aligned at the start of every block of 16, so the aligned ones are at the same bits each time
+                        constexpr std::array<u32, 9> AlignmentMasks = { 0, 0xFFFF, 0x5555, 0, 0x1111, 0, 0, 0, 0x0101 };
+                        const u32 alignmentMask = settings.aligned ? AlignmentMasks[Size] : 0xFFFF;
+
+                        while (position <= lastPosition && lastPosition - position >= 15) {
+                            const auto first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + position));
+                            const auto last  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + position + Size - 1));
+
+                            auto mask = u32(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, firstBytes), _mm_cmpeq_epi8(last, lastBytes)))) & alignmentMask;
+                            while (mask != 0) {
+                                const auto candidate = position + std::countr_zero(mask);
+                                if (std::memcmp(bytes + candidate, pattern.data(), Size) == 0 && !addCandidate(candidate))
+                                    return false;
+
+                                mask &= mask - 1;
+                            }
+
+                            position += 16;
+                        }
+                    #endif
+
+                    for (; position <= lastPosition; position += step) {
+                        if (std::memcmp(bytes + position, pattern.data(), Size) == 0 && !addCandidate(position))
+                            return false;
+                    }
+
+                    return true;
+                }
+            }
+
+            // Ranges and floating point values need to be compared as numbers. The loop is simple enough to be vectorized by the compiler
+            const auto minimum = fromRaw<T>(condition.minimum);
+            const auto maximum = fromRaw<T>(condition.predicate == ValueScanner::Predicate::Equal ? condition.minimum : condition.maximum);
+            for (; position <= lastPosition; position += step) {
+                const auto value = loadTyped<T>(bytes + position, settings.endian);
+                if (minimum <= value && value <= maximum) [[unlikely]] {
+                    candidates.push_back({ address + position, toRaw(value) });
+                    if (candidates.size() >= limit)
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        template<typename T>
+        std::vector<ValueScanner::Candidate> rescanValues(const std::vector<ValueScanner::Candidate> &candidates, const ValueScanner::Settings &settings, const ValueScanner::Condition &condition, const ValueScanner::ReadFunction &read, const ValueScanner::ProgressCallback &progress) {
+            constexpr size_t Size = sizeof(T);
+            constexpr u64 WindowSize = 64 * 1024;
+
+            std::vector<ValueScanner::Candidate> result;
+            std::vector<u8> buffer;
+
+            for (size_t i = 0; i < candidates.size();) {
+                // Candidates close to each other are read in one go, the scan found them in order so they're sorted by address
+                const auto windowStart = candidates[i].address;
+                size_t windowEnd = i + 1;
+                while (windowEnd < candidates.size() && candidates[windowEnd].address + Size - windowStart <= WindowSize)
+                    windowEnd++;
+
+                buffer.resize(candidates[windowEnd - 1].address + Size - windowStart);
+                read(windowStart, buffer);
+
+                for (; i < windowEnd; i++) {
+                    const auto &candidate = candidates[i];
+                    const auto value = loadTyped<T>(buffer.data() + (candidate.address - windowStart), settings.endian);
+                    const auto rawValue = toRaw(value);
+
+                    if (matchesCondition(condition, value, rawValue, candidate.value))
+                        result.push_back({ candidate.address, rawValue });
+                }
+
+                if (progress)
+                    progress(i);
+            }
+
+            return result;
+        }
+
+        template<typename Function>
+        decltype(auto) withValueType(ValueScanner::Type type, Function &&function) {
+            switch (type) {
+                using enum ValueScanner::Type;
+                case U8:     return function(u8{ });
+                case I8:     return function(i8{ });
+                case U16:    return function(u16{ });
+                case I16:    return function(i16{ });
+                case U32:    return function(u32{ });
+                case I32:    return function(i32{ });
+                case U64:    return function(u64{ });
+                case I64:    return function(i64{ });
+                case Float:  return function(float{ });
+                case Double: return function(double{ });
+            }
+
+            throw std::runtime_error("Invalid value type");
+        }
+
+    }
+
+    ValueScanner::ValueScanner(Settings settings, size_t limit) : m_settings(settings), m_limit(limit) { }
+
+    bool ValueScanner::scan(std::span<const u8> data, u64 address, const Condition &condition) {
+        if (condition.predicate != Predicate::Equal && condition.predicate != Predicate::Range)
+            throw std::runtime_error("Relative conditions require a previous scan");
+
+        if (this->isFull())
+            return false;
+
+        return withValueType(this->m_settings.type, [&]<typename T>(T) {
+            return scanValues<T>(data, address, this->m_settings, condition, this->m_candidates, this->m_limit);
+        });
+    }
+
+    void ValueScanner::rescan(const Condition &condition, const ReadFunction &read, const ProgressCallback &progress) {
+        this->m_candidates = withValueType(this->m_settings.type, [&]<typename T>(T) {
+            return rescanValues<T>(this->m_candidates, this->m_settings, condition, read, progress);
+        });
+    }
+
+    size_t ValueScanner::getTypeSize(Type type) {
+        return withValueType(type, []<typename T>(T) { return sizeof(T); });
+    }
+
+    std::optional<u64> ValueScanner::parseValue(Type type, const std::string &string) {
+        auto begin = string.find_first_not_of(" \t");
+        auto end = string.find_last_not_of(" \t");
+        if (begin == std::string::npos)
+            return std::nullopt;
+
+        const auto text = string.substr(begin, end - begin + 1);
+
+        return withValueType(type, [&]<typename T>(T) -> std::optional<u64> {
+            if constexpr (std::floating_point<T>) {
+                char *parseEnd = nullptr;
+                const auto value = std::strtod(text.c_str(), &parseEnd);
+                if (parseEnd != text.c_str() + text.size())
+                    return std::nullopt;
+
+                return toRaw(T(value));
+            } else {
+                const bool negative = text.starts_with('-');
+                if (negative && std::unsigned_integral<T>)
+                    return std::nullopt;
+
+                auto digits = std::string_view(text).substr(negative ? 1 : 0);
+                int base = 10;
+                if (digits.starts_with("0x") || digits.starts_with("0X")) {
+                    digits.remove_prefix(2);
+                    base = 16;
+                }
+
+                u64 magnitude = 0;
+                const auto [parseEnd, error] = std::from_chars(digits.data(), digits.data() + digits.size(), magnitude, base);
+                if (digits.empty() || error != std::errc() || parseEnd != digits.data() + digits.size())
+                    return std::nullopt;
+
+                // The most negative value has a magnitude one bigger than the maximum
+                const u64 maximum = u64(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+                if (magnitude > maximum)
+                    return std::nullopt;
+
+                return toRaw(negative ? T(u64(0) - magnitude) : T(magnitude));
+            }
+        });
+    }
+
+    std::string ValueScanner::formatValue(Type type, u64 value) {
+        return withValueType(type, [&]<typename T>(T) {
+            return hex::format("{}", fromRaw<T>(value));
+        });
+    }
+
+    u64 ValueScanner::loadValue(std::span<const u8> bytes, std::endian endian) {
+        u64 value = 0;
+        std::memcpy(&value, bytes.data(), std::min(bytes.size(), sizeof(value)));
+
+        if (endian != std::endian::native)
+            value = hex::changeEndianess(value, bytes.size(), endian);
+
+        return value;
+    }
+
+    StringExtractor::StringExtractor(const Settings &settings) : m_settings(settings) {
+        for (u32 c = 0; c < 0x80; c++) {
+            if (!this->m_settings.validCharacters[c])
+                continue;
+
+            if (!this->m_ranges.empty() && this->m_ranges.back().second == c - 1)
+                this->m_ranges.back().second = c;
+            else
+                this->m_ranges.emplace_back(c, c);
+        }
+    }
+
+    void StringExtractor::process(std::span<const u8> data, const Callback &callback) {
+        while (!data.empty()) {
+            const auto size = std::min(data.size(), this->m_staging.bytes.size() - this->m_staging.size);
+            std::memcpy(this->m_staging.bytes.data() + this->m_staging.size, data.data(), size);
+
+            this->m_staging.size += size;
+            data = data.subspan(size);
+
+            if (this->m_staging.size == this->m_staging.bytes.size())
+                this->pushBlock(callback);
+        }
+    }
+
+    void StringExtractor::finish(const Callback &callback) {
+        if (this->m_staging.size > 0)
+            this->pushBlock(callback);
+
+        if (this->m_hasPrevious) {
+            this->finalize(this->m_previous, Block { }, callback);
+            this->m_hasPrevious = false;
+        }
+
+        // Strings running until the end of the data are never null terminated
+        for (auto [run, encoding] : { std::pair { &this->m_asciiRun, Encoding::ASCII }, { &this->m_utf8Run, Encoding::UTF8 }, { &this->m_utf16leRun, Encoding::UTF16LE }, { &this->m_utf16beRun, Encoding::UTF16BE } }) {
+            if (run->active)
+                this->emit(*run, this->m_offset, false, encoding, callback);
+
+            *run = { };
+        }
+    }
+
+    void StringExtractor::classify(Block &block) const {
+        const u8 *bytes = block.bytes.data();
+        u64 valid = 0, zero = 0, high = 0;
+
+        #if defined(__SSE2__)
+            const bool useRanges = this->m_ranges.size() <= MaxVectorRanges;
+            const auto zeroes = _mm_setzero_si128();
+
+            for (size_t i = 0; i < block.bytes.size(); i += 16) {
+                const auto data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+
+                zero |= u64(u16(_mm_movemask_epi8(_mm_cmpeq_epi8(data, zeroes)))) << i;
+                high |= u64(u16(_mm_movemask_epi8(data))) << i;
+
+                if (useRanges) {
+                    // A byte is inside of a range if (byte - start) <= (end - start), compared as unsigned values
+                    auto inRange = zeroes;
+                    for (const auto &[start, end] : this->m_ranges) {
+                        const auto offset = _mm_sub_epi8(data, _mm_set1_epi8(char(start)));
+                        inRange = _mm_or_si128(inRange, _mm_cmpeq_epi8(_mm_subs_epu8(offset, _mm_set1_epi8(char(end - start))), zeroes));
+                    }
+
+                    valid |= u64(u16(_mm_movemask_epi8(inRange))) << i;
+                }
+            }
+
+            if (!useRanges) {
+                for (size_t i = 0; i < block.bytes.size(); i++)
+                    valid |= u64(this->m_settings.validCharacters[bytes[i]]) << i;
+            }
+        #else
+            for (size_t i = 0; i < block.bytes.size(); i++) {
+                valid |= u64(this->m_settings.validCharacters[bytes[i]]) << i;
+                zero  |= u64(bytes[i] == 0x00) << i;
+                high  |= u64(bytes[i] >> 7) << i;
+            }
+        #endif
+
+        const auto sizeMask = bitsBetween(0, block.size);
+        block.valid = valid & ~high & sizeMask;
+        block.zero  = zero & sizeMask;
+        block.high  = high & sizeMask;
+    }
+
+    void StringExtractor::pushBlock(const Callback &callback) {
+        this->m_staging.offset = this->m_offset;
+        this->m_offset += this->m_staging.size;
+        this->classify(this->m_staging);
+
+        // A block can only be searched once the next one is known, characters and terminators may continue into it
+        if (this->m_hasPrevious)
+            this->finalize(this->m_previous, this->m_staging, callback);
+
+        this->m_previous = this->m_staging;
+        this->m_hasPrevious = true;
+        this->m_staging = { };
+    }
+
+    void StringExtractor::finalize(const Block &block, const Block &next, const Callback &callback) {
+        if (this->m_settings.ascii && !this->m_settings.utf8)
+            this->track(this->m_asciiRun, block, next, block.valid, block.valid, 0, Encoding::ASCII, callback);
+
+        // UTF-8 strings include all ASCII strings so they're reported through here if both encodings are requested
+        if (this->m_settings.utf8) {
+            u64 covered = this->m_utf8Carry, leads = 0;
+            this->m_utf8Carry = 0;
+
+            u64 candidates = block.high & ~covered;
+            while (candidates != 0) {
+                const size_t position = std::countr_zero(candidates);
+                const u8 lead = block.bytes[position];
+
+                size_t length = 0;
+                u32 codePoint = 0;
+                if (lead >= 0xC2 && lead <= 0xDF) {
+                    length = 2;
+                    codePoint = lead & 0x1F;
+                } else if (lead >= 0xE0 && lead <= 0xEF) {
+                    length = 3;
+                    codePoint = lead & 0x0F;
+                } else if (lead >= 0xF0 && lead <= 0xF4) {
+                    length = 4;
+                    codePoint = lead & 0x07;
+                }
+
+                bool validSequence = length != 0;
+                for (size_t i = 1; i < length && validSequence; i++) {
+                    const auto byte = byteAt(block, next, position + i);
+                    if (byte < 0 || (byte & 0xC0) != 0x80)
+                        validSequence = false;
+                    else
+                        codePoint = (codePoint << 6) | (byte & 0x3F);
+                }
+
+                // Reject overlong encodings, C1 control characters, surrogates and code points past the end of Unicode
+                const u32 minCodePoint = length == 4 ? 0x10000 : length == 3 ? 0x800 : 0xA0;
+                if (validSequence && codePoint >= minCodePoint && codePoint <= 0x10FFFF && !(codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+                    leads |= u64(1) << position;
+
+                    for (size_t i = position; i < position + length; i++) {
+                        if (i < 64)
+                            covered |= u64(1) << i;
+                        else
+                            this->m_utf8Carry |= u64(1) << (i - 64);
+                    }
+
+                    candidates &= ~covered;
+                } else {
+                    candidates &= candidates - 1;
+                }
+            }
+
+            this->track(this->m_utf8Run, block, next, block.valid | covered, block.valid | leads, leads, Encoding::UTF8, callback);
+        }
+
+        // A UTF-16 character can't start at two neighbouring bytes since that would need a byte that's both zero and a valid character.
+        // This makes every run of covered bytes a run of correctly aligned characters
+        if (this->m_settings.utf16le) {
+            const u64 units = block.valid & ((block.zero >> 1) | ((next.zero & 1) << 63));
+            const u64 covered = units | (units << 1) | this->m_utf16leCarry;
+            this->m_utf16leCarry = units >> 63;
+
+            this->track(this->m_utf16leRun, block, next, covered, units, 0, Encoding::UTF16LE, callback);
+        }
+
+        if (this->m_settings.utf16be) {
+            const u64 units = block.zero & ((block.valid >> 1) | ((next.valid & 1) << 63));
+            const u64 covered = units | (units << 1) | this->m_utf16beCarry;
+            this->m_utf16beCarry = units >> 63;
+
+            this->track(this->m_utf16beRun, block, next, covered, units, 0, Encoding::UTF16BE, callback);
+        }
+    }
+
+    void StringExtractor::track(Run &run, const Block &block, const Block &next, u64 covered, u64 starts, u64 multiByteStarts, Encoding encoding, const Callback &callback) const {
+        const auto sizeMask = bitsBetween(0, block.size);
+        const bool wideCharacters = encoding == Encoding::UTF16LE || encoding == Encoding::UTF16BE;
+
+        // Every set bit marks a position where a run starts or ends
+        u64 edges = (covered ^ ((covered << 1) | u64(run.active))) & sizeMask;
+
+        size_t from = 0;
+        while (edges != 0) {
+            const size_t position = std::countr_zero(edges);
+
+            if ((covered >> position) & 1) {
+                run = Run { .active = true, .start = block.offset + position };
+                from = position;
+            } else {
+                const auto range = bitsBetween(from, position);
+                run.characters += std::popcount(starts & range);
+                run.multiByte  |= (multiByteStarts & range) != 0;
+
+                bool terminated = byteAt(block, next, position) == 0x00;
+                if (wideCharacters)
+                    terminated = terminated && byteAt(block, next, position + 1) == 0x00;
+
+                this->emit(run, block.offset + position, terminated, encoding, callback);
+                run.active = false;
+            }
+
+            edges &= edges - 1;
+        }
+
+        if (run.active) {
+            const auto range = bitsBetween(from, 64) & sizeMask;
+            run.characters += std::popcount(starts & range);
+            run.multiByte  |= (multiByteStarts & range) != 0;
+        }
+    }
+
+    void StringExtractor::emit(const Run &run, u64 end, bool terminated, Encoding encoding, const Callback &callback) const {
+        if (run.characters < this->m_settings.minLength)
+            return;
+        if (this->m_settings.nullTermination && !terminated)
+            return;
+
+        if (encoding == Encoding::UTF8 && !run.multiByte)
+            encoding = Encoding::ASCII;
+
+        callback(String { run.start, size_t(end - run.start), encoding });
+    }
+
+    OccurrenceStore::OccurrenceStore(Layout layout) : m_layout(std::move(layout)) {
+        if (this->m_layout.maxTag > 0xFFFF)
+            this->m_tagWidth = 4;
+        else if (this->m_layout.maxTag > 0xFF)
+            this->m_tagWidth = 2;
+        else if (this->m_layout.maxTag > 0)
+            this->m_tagWidth = 1;
+    }
+
+    void OccurrenceStore::push(const Entry &entry) {
+        const auto index = this->m_size.load(std::memory_order_relaxed);
+
+        if (index % BlockSize == 0)
+            this->m_blockAddresses.push(entry.address);
+
+        // Results are mostly found in order so the distance to the start of the block is small. Addresses that are too far away are stored separately
+        const auto delta = i64(entry.address - this->m_blockAddresses[index / BlockSize]);
+        if (delta > std::numeric_limits<i32>::max() || delta <= OverflowMarker) {
+            this->m_addressOverflows.push({ index, entry.address });
+            this->m_addressDeltas.push(OverflowMarker);
+        } else {
+            this->m_addressDeltas.push(i32(delta));
+        }
+
+        if (!this->m_layout.fixedSize.has_value() && this->m_layout.tagSizes.empty()) {
+            if (entry.size >= u32(OverflowMarker)) {
+                this->m_sizeOverflows.push({ index, entry.size });
+                this->m_sizes.push(u32(OverflowMarker));
+            } else {
+                this->m_sizes.push(u32(entry.size));
+            }
+        }
+
+        for (size_t i = 0; i < this->m_tagWidth; i++)
+            this->m_tags.push(u8(entry.tag >> (i * 8)));
+
+        // Publishes the entry once all of its columns have been written
+        this->m_size.store(index + 1, std::memory_order_release);
+    }
+
+    u64 OccurrenceStore::findOverflow(const Overflows &overflows, size_t index) {
+        size_t low = 0, high = overflows.getSize();
+        while (low < high) {
+            const auto mid = low + (high - low) / 2;
+            if (overflows[mid].first < index)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+
+        return overflows[low].second;
+    }
+
+    void IntervalIndex::insert(const std::vector<u32> &ids) {
+        if (ids.empty())
+            return;
+
+        this->m_size += ids.size();
+
+        std::vector<std::pair<u64, u32>> sorted;
+        sorted.reserve(ids.size());
+        for (auto id : ids)
+            sorted.emplace_back(this->m_lookup(id).start, id);
+        std::stable_sort(sorted.begin(), sorted.end(), [](const auto &left, const auto &right) { return left.first < right.first; });
+
+        Run newRun;
+        newRun.ids.reserve(sorted.size());
+        for (const auto &[start, id] : sorted)
+            newRun.ids.push_back(id);
+        this->m_runs.push_back(std::move(newRun));
+
+        // Merge runs until every run is at least twice as big as the one after it, this keeps the number of runs logarithmic
+        while (this->m_runs.size() > 1 && this->m_runs[this->m_runs.size() - 2].ids.size() <= this->m_runs.back().ids.size() * 2) {
+            auto &first = this->m_runs[this->m_runs.size() - 2];
+            auto &second = this->m_runs.back();
+
+            std::vector<u32> merged(first.ids.size() + second.ids.size());
+            std::merge(first.ids.begin(), first.ids.end(), second.ids.begin(), second.ids.end(), merged.begin(), [this](u32 left, u32 right) {
+                return this->m_lookup(left).start < this->m_lookup(right).start;
+            });
+
+            first.ids = std::move(merged);
+            this->m_runs.pop_back();
+        }
+
+        auto &run = this->m_runs.back();
+        run.blockMaxEnd.resize((run.ids.size() + BlockSize - 1) / BlockSize);
+
+        u64 maxEnd = 0;
+        for (size_t i = 0; i < run.ids.size(); i++) {
+            maxEnd = std::max(maxEnd, this->m_lookup(run.ids[i]).end);
+            run.blockMaxEnd[i / BlockSize] = maxEnd;
+        }
+    }
+
+    void IntervalIndex::clear() {
+        this->m_runs.clear();
+        this->m_size = 0;
+    }
+
+    bool IntervalIndex::overlaps(u64 address) const {
+        bool found = false;
+        for (const auto &run : this->m_runs) {
+            this->forEachCandidate(run, address, [&](u32, const Interval &interval) {
+                found = interval.end >= address;
+
+                return !found;
+            });
+
+            if (found)
+                return true;
+        }
+
+        return false;
+    }
+
+}
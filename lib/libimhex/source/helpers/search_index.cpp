@@ -0,0 +1,179 @@
+#include <hex/helpers/search_index.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace hex::search {
+
+    namespace {
+
+        constexpr u64 Magic   = 0x4D52'474E'5848'4D49;   // "IMHXNGRM"
+        constexpr u32 Version = 1;
+
+        // Blocks with more bits set than this match almost every pattern, there's no point in storing their signature
+        constexpr size_t SaturationLimit = NGramIndex::SignatureBits * 3 / 4;
+
+        template<typename T>
+        void append(std::vector<u8> &data, const T &value) {
+            const auto bytes = reinterpret_cast<const u8 *>(&value);
+            data.insert(data.end(), bytes, bytes + sizeof(T));
+        }
+
+        template<typename T>
+        bool extract(std::span<const u8> &data, T &value) {
+            if (data.size() < sizeof(T))
+                return false;
+
+            std::memcpy(&value, data.data(), sizeof(T));
+            data = data.subspan(sizeof(T));
+
+            return true;
+        }
+
+    }
+
+    u32 NGramIndex::hash(u8 a, u8 b, u8 c) {
+        const u32 gram = u32(a) | (u32(b) << 8) | (u32(c) << 16);
+
+        return (gram * 0x9E37'79B1) >> (32 - std::countr_zero(SignatureBits));
+    }
+
+    void NGramIndex::process(std::span<const u8> data) {
+        u64 position = this->m_dataSize;
+        u8 first = this->m_history[0], second = this->m_history[1];
+
+        for (u8 byte : data) {
+            // Every gram belongs to the block it starts in, so a block is done once the first gram of the next one has been read
+            if (position >= 2) {
+                const auto start = position - 2;
+                if (start % BlockSize == 0 && start > 0) [[unlikely]]
+                    this->completeBlock();
+
+                const auto bit = hash(first, second, byte);
+                this->m_currentSignature[bit / 64] |= u64(1) << (bit % 64);
+            }
+
+            first  = second;
+            second = byte;
+            position++;
+        }
+
+        this->m_history[0] = first;
+        this->m_history[1] = second;
+        this->m_dataSize   = position;
+    }
+
+    void NGramIndex::finish() {
+        const auto blockCount = (this->m_dataSize + BlockSize - 1) / BlockSize;
+        while (this->m_blockSignatures.size() < blockCount)
+            this->completeBlock();
+    }
+
+    void NGramIndex::completeBlock() {
+        size_t bitCount = 0;
+        for (auto word : this->m_currentSignature)
+            bitCount += std::popcount(word);
+
+        if (bitCount > SaturationLimit) {
+            this->m_blockSignatures.push_back(NoSignature);
+        } else {
+            this->m_blockSignatures.push_back(this->m_signatures.size() / SignatureWords);
+            this->m_signatures.insert(this->m_signatures.end(), this->m_currentSignature.begin(), this->m_currentSignature.end());
+        }
+
+        this->m_currentSignature = { };
+    }
+
+    bool NGramIndex::containsAll(size_t block, const std::vector<u32> &hashes) const {
+        // A match starting in this block can have grams that start in the next block
+        const u64 *signatures[2] = { nullptr, nullptr };
+        for (size_t i = 0; i < 2 && block + i < this->m_blockSignatures.size(); i++) {
+            const auto slot = this->m_blockSignatures[block + i];
+            if (slot == NoSignature)
+                return true;
+
+            signatures[i] = &this->m_signatures[size_t(slot) * SignatureWords];
+        }
+
+        return std::all_of(hashes.begin(), hashes.end(), [&](u32 bit) {
+            const auto mask = u64(1) << (bit % 64);
+
+            return (signatures[0] != nullptr && (signatures[0][bit / 64] & mask) != 0) ||
+                   (signatures[1] != nullptr && (signatures[1][bit / 64] & mask) != 0);
+        });
+    }
+
+    std::vector<bool> NGramIndex::findCandidateBlocks(const std::vector<MaskedByte> &pattern) const {
+        std::vector<u32> hashes;
+        for (size_t i = 0; i + 2 < pattern.size(); i++) {
+            if (pattern[i].mask == 0xFF && pattern[i + 1].mask == 0xFF && pattern[i + 2].mask == 0xFF)
+                hashes.push_back(hash(pattern[i].value, pattern[i + 1].value, pattern[i + 2].value));
+        }
+
+        std::sort(hashes.begin(), hashes.end());
+        hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+        // Matches longer than a block can have grams in blocks that aren't checked
+        if (hashes.empty() || pattern.size() > BlockSize)
+            return std::vector<bool>(this->m_blockSignatures.size(), true);
+
+        std::vector<bool> result(this->m_blockSignatures.size());
+        for (size_t block = 0; block < result.size(); block++)
+            result[block] = this->containsAll(block, hashes);
+
+        return result;
+    }
+
+    std::vector<u8> NGramIndex::serialize() const {
+        std::vector<u8> result;
+
+        append(result, Magic);
+        append(result, Version);
+        append(result, u32(BlockSize));
+        append(result, u32(SignatureBits));
+        append(result, this->m_dataSize);
+        append(result, u64(this->m_blockSignatures.size()));
+        append(result, u64(this->m_signatures.size()));
+
+        for (auto slot : this->m_blockSignatures)
+            append(result, slot);
+        for (auto word : this->m_signatures)
+            append(result, word);
+
+        return result;
+    }
+
+    std::optional<NGramIndex> NGramIndex::deserialize(std::span<const u8> data) {
+        u64 magic = 0, dataSize = 0, blockCount = 0, signatureWords = 0;
+        u32 version = 0, blockSize = 0, signatureBits = 0;
+
+        if (!extract(data, magic) || !extract(data, version) || !extract(data, blockSize) || !extract(data, signatureBits) ||
+            !extract(data, dataSize) || !extract(data, blockCount) || !extract(data, signatureWords))
+            return std::nullopt;
+
+        if (magic != Magic || version != Version || blockSize != BlockSize || signatureBits != SignatureBits)
+            return std::nullopt;
+
+        if (blockCount != (dataSize + BlockSize - 1) / BlockSize || signatureWords % SignatureWords != 0)
+            return std::nullopt;
+
+        if (data.size() != blockCount * sizeof(u32) + signatureWords * sizeof(u64))
+            return std::nullopt;
+
+        NGramIndex index;
+        index.m_dataSize = dataSize;
+        index.m_blockSignatures.resize(blockCount);
+        index.m_signatures.resize(signatureWords);
+
+        for (auto &slot : index.m_blockSignatures) {
+            if (!extract(data, slot) || (slot != NoSignature && slot >= signatureWords / SignatureWords))
+                return std::nullopt;
+        }
+        for (auto &word : index.m_signatures)
+            extract(data, word);
+
+        return index;
+    }
+
+}
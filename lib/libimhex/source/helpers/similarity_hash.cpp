@@ -0,0 +1,506 @@
+#include <hex/helpers/similarity_hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace hex::crypt {
+
+    namespace {
+
+        /* ssdeep */
+
+        constexpr u32 RollingWindow   = 7;
+        constexpr u32 MinBlockSize    = 3;
+        constexpr u32 HashPrime       = 0x0100'0193;
+        constexpr u8  HashInit        = 0x28021967 & 0x3F;
+        constexpr u32 SpamSumLength   = 64;
+        constexpr u32 BlockHashCount  = 31;
+
+        constexpr std::string_view Base64Characters = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        constexpr u64 getSsdeepBlockSize(u32 index) {
+            return u64(MinBlockSize) << index;
+        }
+
+        // Only the lowest six bits of the piecewise hash end up in the digest, so there's no need to keep the others
+        constexpr u8 sumHash(u8 byte, u8 hash) {
+            return ((hash * HashPrime) ^ byte) & 0x3F;
+        }
+
+        class RollingHash {
+        public:
+            void update(u8 byte) {
+                this->m_h2 -= this->m_h1;
+                this->m_h2 += RollingWindow * byte;
+
+                this->m_h1 += byte;
+                this->m_h1 -= this->m_window[this->m_position % RollingWindow];
+
+                this->m_window[this->m_position % RollingWindow] = byte;
+                this->m_position++;
+
+                this->m_h3 <<= 5;
+                this->m_h3 ^= byte;
+            }
+
+            [[nodiscard]] u32 getSum() const {
+                return this->m_h1 + this->m_h2 + this->m_h3;
+            }
+
+        private:
+            std::array<u8, RollingWindow> m_window = { };
+            u32 m_h1 = 0, m_h2 = 0, m_h3 = 0;
+            u32 m_position = 0;
+        };
+
+        class SsdeepContext : public HashContext {
+        public:
+            void update(std::span<const u8> data) override {
+                this->m_totalSize += data.size();
+
+                for (u8 byte : data)
+                    this->process(byte);
+            }
+
+            std::vector<u8> finish() override {
+                // Pick the smallest block size the data would have been split into at most SpamSumLength pieces with and go back
+                // to smaller ones as long as the digest is too short to be meaningful
+                u32 index = this->m_start;
+                while (getSsdeepBlockSize(index) * SpamSumLength < this->m_totalSize && index < BlockHashCount - 1)
+                    index++;
+                while (index >= this->m_end)
+                    index--;
+                while (index > this->m_start && this->m_blockHashes[index].length < SpamSumLength / 2)
+                    index--;
+
+                const bool hasTail = this->m_rollingHash.getSum() != 0;
+                const auto &first = this->m_blockHashes[index];
+
+                std::string result = std::to_string(getSsdeepBlockSize(index)) + ":";
+
+                result.append(first.digest.data(), first.length);
+                if (hasTail)
+                    result += Base64Characters[first.hash];
+                else if (first.digest[first.length] != '\x00')
+                    result += first.digest[first.length];
+
+                result += ':';
+
+                // The second part is the digest for the doubled block size, cut to half the length
+                if (index + 1 < this->m_end) {
+                    const auto &second = this->m_blockHashes[index + 1];
+
+                    result.append(second.digest.data(), std::min(second.length, SpamSumLength / 2 - 1));
+                    if (hasTail)
+                        result += Base64Characters[second.halfHash];
+                    else if (second.halfDigest != '\x00')
+                        result += second.halfDigest;
+                } else if (hasTail) {
+                    result += Base64Characters[first.hash];
+                }
+
+                return { result.begin(), result.end() };
+            }
+
+        private:
+            struct BlockHash {
+                std::array<char, SpamSumLength> digest = { };
+                u32 length = 0;
+                char halfDigest = '\x00';
+                u8 hash = HashInit, halfHash = HashInit;
+            };
+
+            void process(u8 byte) {
+                this->m_rollingHash.update(byte);
+                const u32 rollingSum = this->m_rollingHash.getSum();
+
+                for (u32 i = this->m_start; i < this->m_end; i++) {
+                    auto &blockHash = this->m_blockHashes[i];
+
+                    blockHash.hash     = sumHash(byte, blockHash.hash);
+                    blockHash.halfHash = sumHash(byte, blockHash.halfHash);
+                }
+
+                for (u32 i = this->m_start; i < this->m_end; i++) {
+                    // Block sizes double every step, a position that's not a boundary for one block size can't be one for the larger ones
+                    if (rollingSum % getSsdeepBlockSize(i) != getSsdeepBlockSize(i) - 1)
+                        break;
+
+                    // Up to the first boundary of a block size, the next larger one has seen exactly the same pieces
+                    if (this->m_blockHashes[i].length == 0)
+                        this->forkBlockHash();
+
+                    auto &blockHash = this->m_blockHashes[i];
+                    blockHash.digest[blockHash.length] = Base64Characters[blockHash.hash];
+                    blockHash.halfDigest = Base64Characters[blockHash.halfHash];
+
+                    // Once the digest is full, all remaining pieces are combined into its last character
+                    if (blockHash.length < SpamSumLength - 1) {
+                        blockHash.length++;
+                        blockHash.digest[blockHash.length] = '\x00';
+                        blockHash.hash = HashInit;
+
+                        if (blockHash.length < SpamSumLength / 2) {
+                            blockHash.halfHash   = HashInit;
+                            blockHash.halfDigest = '\x00';
+                        }
+                    } else {
+                        this->reduceBlockHashes();
+                    }
+                }
+            }
+
+            void forkBlockHash() {
+                if (this->m_end >= BlockHashCount)
+                    return;
+
+                const auto &previous = this->m_blockHashes[this->m_end - 1];
+                auto &next = this->m_blockHashes[this->m_end];
+
+                next = { };
+                next.hash     = previous.hash;
+                next.halfHash = previous.halfHash;
+
+                this->m_end++;
+            }
+
+            // Drops the smallest block size once the amount of data rules it out and the next larger one has a long enough digest
+            void reduceBlockHashes() {
+                if (this->m_end - this->m_start < 2)
+                    return;
+                if (this->m_totalSize <= getSsdeepBlockSize(this->m_start) * SpamSumLength)
+                    return;
+                if (this->m_blockHashes[this->m_start + 1].length < SpamSumLength / 2)
+                    return;
+
+                this->m_start++;
+            }
+
+        private:
+            RollingHash m_rollingHash;
+            std::array<BlockHash, BlockHashCount> m_blockHashes;
+            u32 m_start = 0, m_end = 1;
+            u64 m_totalSize = 0;
+        };
+
+        struct SsdeepDigest {
+            u64 blockSize;
+            std::string first, second;
+        };
+
+        // Runs of more than three identical characters carry hardly any information and are shortened before comparing
+        std::string eliminateSequences(std::string_view string) {
+            std::string result;
+            for (size_t i = 0; i < string.size(); i++) {
+                if (i < 3 || string[i] != string[i - 1] || string[i] != string[i - 2] || string[i] != string[i - 3])
+                    result += string[i];
+            }
+
+            return result;
+        }
+
+        std::optional<SsdeepDigest> parseSsdeep(std::string_view digest) {
+            SsdeepDigest result = { };
+
+            auto [end, error] = std::from_chars(digest.data(), digest.data() + digest.size(), result.blockSize);
+            if (error != std::errc() || end == digest.data() + digest.size() || *end != ':')
+                return std::nullopt;
+            digest.remove_prefix(end - digest.data() + 1);
+
+            const auto separator = digest.find(':');
+            if (separator == std::string_view::npos)
+                return std::nullopt;
+
+            // Digests written by ssdeep can be followed by the name of the file
+            result.first  = eliminateSequences(digest.substr(0, separator));
+            result.second = eliminateSequences(digest.substr(separator + 1, digest.find(',', separator + 1) - separator - 1));
+
+            return result;
+        }
+
+        bool hasCommonSubstring(const std::string &left, const std::string &right) {
+            if (left.size() < RollingWindow || right.size() < RollingWindow)
+                return false;
+
+            for (size_t i = 0; i + RollingWindow <= left.size(); i++) {
+                if (right.find(std::string_view(left).substr(i, RollingWindow)) != std::string::npos)
+                    return true;
+            }
+
+            return false;
+        }
+
+        // Edit distance where replacing a character costs as much as removing it and inserting another one
+        u32 editDistance(const std::string &left, const std::string &right) {
+            std::vector<u32> previous(right.size() + 1), current(right.size() + 1);
+            for (size_t j = 0; j <= right.size(); j++)
+                previous[j] = j;
+
+            for (size_t i = 1; i <= left.size(); i++) {
+                current[0] = i;
+                for (size_t j = 1; j <= right.size(); j++) {
+                    const u32 replaceCost = left[i - 1] == right[j - 1] ? 0 : 2;
+                    current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, previous[j - 1] + replaceCost });
+                }
+
+                std::swap(previous, current);
+            }
+
+            return previous[right.size()];
+        }
+
+        u32 scoreStrings(const std::string &left, const std::string &right, u64 blockSize) {
+            if (left.size() > SpamSumLength || right.size() > SpamSumLength)
+                return 0;
+            if (!hasCommonSubstring(left, right))
+                return 0;
+
+            u32 score = editDistance(left, right);
+            score = (score * SpamSumLength) / (left.size() + right.size());
+            score = (100 * score) / SpamSumLength;
+            if (score >= 100)
+                return 0;
+
+            score = 100 - score;
+
+            // Small block sizes can't produce long matching digests by chance, so short matches aren't trusted as much
+            if (blockSize >= (99 + RollingWindow) / RollingWindow * MinBlockSize)
+                return score;
+            else
+                return std::min<u64>(score, blockSize / MinBlockSize * std::min(left.size(), right.size()));
+        }
+
+
+        /* TLSH */
+
+        constexpr u32 BucketCount    = 128;
+        constexpr u32 CodeSize       = BucketCount / 4;
+        constexpr u32 MinTlshLength  = 50;
+        constexpr u32 TlshDigestSize = 3 + CodeSize;
+
+        // Pearson hashing permutation
+        constexpr std::array<u8, 256> PearsonTable = {
+            1, 87, 49, 12, 176, 178, 102, 166, 121, 193, 6, 84, 249, 230, 44, 163,
+            14, 197, 213, 181, 161, 85, 218, 80, 64, 239, 24, 226, 236, 142, 38, 200,
+            110, 177, 104, 103, 141, 253, 255, 50, 77, 101, 81, 18, 45, 96, 31, 222,
+            25, 107, 190, 70, 86, 237, 240, 34, 72, 242, 20, 214, 244, 227, 149, 235,
+            97, 234, 57, 22, 60, 250, 82, 175, 208, 5, 127, 199, 111, 62, 135, 248,
+            174, 169, 211, 58, 66, 154, 106, 195, 245, 171, 17, 187, 182, 179, 0, 243,
+            132, 56, 148, 75, 128, 133, 158, 100, 130, 126, 91, 13, 153, 246, 216, 219,
+            119, 68, 223, 78, 83, 88, 201, 99, 122, 11, 92, 32, 136, 114, 52, 10,
+            138, 30, 48, 183, 156, 35, 61, 26, 143, 74, 251, 94, 129, 162, 63, 152,
+            170, 7, 115, 167, 241, 206, 3, 150, 55, 59, 151, 220, 90, 53, 23, 131,
+            125, 173, 15, 238, 79, 95, 89, 16, 105, 137, 225, 224, 217, 160, 37, 123,
+            118, 73, 2, 157, 46, 116, 9, 145, 134, 228, 207, 212, 202, 215, 69, 229,
+            27, 188, 67, 124, 168, 252, 42, 4, 29, 108, 21, 247, 19, 205, 39, 203,
+            233, 40, 186, 147, 198, 192, 155, 33, 164, 191, 98, 204, 165, 180, 117, 76,
+            140, 36, 210, 172, 41, 54, 159, 8, 185, 232, 113, 196, 231, 47, 146, 120,
+            51, 65, 28, 144, 254, 221, 93, 189, 194, 139, 112, 43, 71, 109, 184, 209
+        };
+
+        constexpr u8 pearsonHash(u8 salt, u8 a, u8 b, u8 c) {
+            u8 hash = PearsonTable[salt];
+            hash = PearsonTable[hash ^ a];
+            hash = PearsonTable[hash ^ b];
+            hash = PearsonTable[hash ^ c];
+
+            return hash;
+        }
+
+        // Logarithmic length bucket, finer for short data
+        u8 captureLength(u64 length) {
+            i64 value;
+            if (length <= 656)
+                value = i64(std::floor(std::log(float(length)) / 0.4054651));
+            else if (length <= 3199)
+                value = i64(std::floor(std::log(float(length)) / 0.26236426 - 8.72777));
+            else
+                value = i64(std::floor(std::log(float(length)) / 0.095310180 - 62.5472));
+
+            return u8(value & 0xFF);
+        }
+
+        constexpr u8 swapNibbles(u8 value) {
+            return u8((value << 4) | (value >> 4));
+        }
+
+        class TlshContext : public HashContext {
+        public:
+            void update(std::span<const u8> data) override {
+                auto &window = this->m_window;
+
+                for (u8 byte : data) {
+                    // The window holds the current byte and the four before it
+                    const auto position = this->m_length % window.size();
+                    window[position] = byte;
+
+                    if (this->m_length >= window.size() - 1) {
+                        auto previous = [&](u32 distance) { return window[(position + window.size() - distance) % window.size()]; };
+                        const u8 b0 = byte, b1 = previous(1), b2 = previous(2), b3 = previous(3), b4 = previous(4);
+
+                        this->m_checksum = pearsonHash(0, b0, b1, this->m_checksum);
+
+                        this->m_buckets[pearsonHash(2,  b0, b1, b2)]++;
+                        this->m_buckets[pearsonHash(3,  b0, b1, b3)]++;
+                        this->m_buckets[pearsonHash(5,  b0, b2, b3)]++;
+                        this->m_buckets[pearsonHash(7,  b0, b2, b4)]++;
+                        this->m_buckets[pearsonHash(11, b0, b1, b4)]++;
+                        this->m_buckets[pearsonHash(13, b0, b3, b4)]++;
+                    }
+
+                    this->m_length++;
+                }
+            }
+
+            std::vector<u8> finish() override {
+                if (this->m_length < MinTlshLength)
+                    return { };
+
+                // Only the first 128 of the 256 buckets are used
+                std::array<u32, BucketCount> sorted;
+                std::copy_n(this->m_buckets.begin(), BucketCount, sorted.begin());
+                std::sort(sorted.begin(), sorted.end());
+
+                const u32 q1 = sorted[BucketCount / 4 - 1], q2 = sorted[BucketCount / 2 - 1], q3 = sorted[BucketCount * 3 / 4 - 1];
+
+                // Too few distinct triplets to get a meaningful distribution
+                const auto nonZeroBuckets = std::count_if(sorted.begin(), sorted.end(), [](u32 count) { return count > 0; });
+                if (q3 == 0 || nonZeroBuckets <= BucketCount / 2)
+                    return { };
+
+                std::array<u8, TlshDigestSize> digest = { };
+                digest[0] = swapNibbles(this->m_checksum);
+                digest[1] = swapNibbles(captureLength(this->m_length));
+                digest[2] = swapNibbles(u8((u32(float(q1 * 100) / float(q3)) % 16) | ((u32(float(q2 * 100) / float(q3)) % 16) << 4)));
+
+                // Every bucket gets two bits telling which quartile its count falls into. The code is stored back to front
+                for (u32 i = 0; i < CodeSize; i++) {
+                    u8 code = 0;
+                    for (u32 j = 0; j < 4; j++) {
+                        const auto count = this->m_buckets[i * 4 + j];
+                        if (count > q3)
+                            code |= 3 << (j * 2);
+                        else if (count > q2)
+                            code |= 2 << (j * 2);
+                        else if (count > q1)
+                            code |= 1 << (j * 2);
+                    }
+
+                    digest[3 + CodeSize - 1 - i] = code;
+                }
+
+                const auto string = "T1" + encode16({ digest.begin(), digest.end() });
+                return { string.begin(), string.end() };
+            }
+
+        private:
+            std::array<u8, 5> m_window = { };
+            std::array<u32, 256> m_buckets = { };
+            u8 m_checksum = 0;
+            u64 m_length = 0;
+        };
+
+        struct TlshDigest {
+            u8 checksum;
+            u8 lengthCapture;
+            u8 q1Ratio, q2Ratio;
+            std::array<u8, CodeSize> code;
+        };
+
+        std::optional<TlshDigest> parseTlsh(std::string_view digest) {
+            if (digest.starts_with("T1"))
+                digest.remove_prefix(2);
+            if (digest.size() != TlshDigestSize * 2)
+                return std::nullopt;
+
+            std::array<u8, TlshDigestSize> bytes = { };
+            for (u32 i = 0; i < bytes.size(); i++) {
+                auto [end, error] = std::from_chars(digest.data() + i * 2, digest.data() + i * 2 + 2, bytes[i], 16);
+                if (error != std::errc() || end != digest.data() + i * 2 + 2)
+                    return std::nullopt;
+            }
+
+            TlshDigest result = { };
+            result.checksum      = swapNibbles(bytes[0]);
+            result.lengthCapture = swapNibbles(bytes[1]);
+            result.q1Ratio       = bytes[2] >> 4;
+            result.q2Ratio       = bytes[2] & 0x0F;
+            std::reverse_copy(bytes.begin() + 3, bytes.end(), result.code.begin());
+
+            return result;
+        }
+
+        // Distance between two values that wrap around after `range`
+        u32 modularDistance(u32 a, u32 b, u32 range) {
+            const u32 distance = a > b ? a - b : b - a;
+            return std::min(distance, range - distance);
+        }
+
+    }
+
+    std::unique_ptr<HashContext> createSsdeepContext() {
+        return std::make_unique<SsdeepContext>();
+    }
+
+    std::optional<u32> compareSsdeep(std::string_view left, std::string_view right) {
+        auto leftDigest  = parseSsdeep(left);
+        auto rightDigest = parseSsdeep(right);
+        if (!leftDigest.has_value() || !rightDigest.has_value())
+            return std::nullopt;
+
+        // Only digests of the same or neighbouring block sizes share a part that can be compared
+        const auto leftBlockSize = leftDigest->blockSize, rightBlockSize = rightDigest->blockSize;
+        if (leftBlockSize == rightBlockSize) {
+            if (leftDigest->first == rightDigest->first && leftDigest->second == rightDigest->second)
+                return 100;
+
+            return std::max(scoreStrings(leftDigest->first, rightDigest->first, leftBlockSize), scoreStrings(leftDigest->second, rightDigest->second, leftBlockSize * 2));
+        } else if (leftBlockSize == rightBlockSize * 2) {
+            return scoreStrings(leftDigest->first, rightDigest->second, leftBlockSize);
+        } else if (rightBlockSize == leftBlockSize * 2) {
+            return scoreStrings(leftDigest->second, rightDigest->first, rightBlockSize);
+        } else {
+            return 0;
+        }
+    }
+
+    std::unique_ptr<HashContext> createTlshContext() {
+        return std::make_unique<TlshContext>();
+    }
+
+    std::optional<u32> compareTlsh(std::string_view left, std::string_view right) {
+        auto leftDigest  = parseTlsh(left);
+        auto rightDigest = parseTlsh(right);
+        if (!leftDigest.has_value() || !rightDigest.has_value())
+            return std::nullopt;
+
+        // Differences of the length and the quartile ratios up to one step are normal, everything beyond that weighs a lot more
+        auto weigh = [](u32 distance) { return distance <= 1 ? distance : (distance - 1) * 12; };
+
+        const auto lengthDistance = modularDistance(leftDigest->lengthCapture, rightDigest->lengthCapture, 256);
+        u32 distance = lengthDistance <= 1 ? lengthDistance : lengthDistance * 12;
+
+        distance += weigh(modularDistance(leftDigest->q1Ratio, rightDigest->q1Ratio, 16));
+        distance += weigh(modularDistance(leftDigest->q2Ratio, rightDigest->q2Ratio, 16));
+
+        if (leftDigest->checksum != rightDigest->checksum)
+            distance += 1;
+
+        // Buckets that moved from the lowest to the highest quartile or back count extra
+        for (u32 i = 0; i < CodeSize; i++) {
+            for (u32 j = 0; j < 4; j++) {
+                const u32 a = (leftDigest->code[i] >> (j * 2)) & 0b11, b = (rightDigest->code[i] >> (j * 2)) & 0b11;
+                const u32 bucketDistance = a > b ? a - b : b - a;
+
+                distance += bucketDistance == 3 ? 6 : bucketDistance;
+            }
+        }
+
+        return distance;
+    }
+
+}
@@ -2,11 +2,13 @@
 
 #include <hex.hpp>
 #include <hex/api/event.hpp>
+#include <hex/api/task.hpp>
 
 #include <cmath>
 #include <cstring>
 #include <map>
 #include <optional>
+#include <vector>
 
 namespace hex::prv {
 
@@ -29,7 +31,7 @@ namespace hex::prv {
 
     void Provider::write(u64 offset, const void *buffer, size_t size) {
         this->writeRaw(offset - this->getBaseAddress(), buffer, size);
-        this->markDirty();
+        this->markDataChanged(offset, size);
     }
 
     void Provider::save() { }
@@ -43,6 +45,52 @@ namespace hex::prv {
         this->markDirty();
     }
 
+    void Provider::markDataChanged(u64 offset, size_t size) {
+        this->markDirty();
+        this->queueDataChanged(offset, size);
+    }
+
+    void Provider::markOverlayChanged(const Region &region) {
+        this->queueDataChanged(region.getStartAddress(), region.getSize());
+    }
+
+    void Provider::queueDataChanged(u64 offset, size_t size) {
+        std::scoped_lock lock(this->m_dataChangeMutex);
+
+        // Changes can be made from any thread and byte by byte. Subscribers only get notified once per frame, on the main thread
+        if (this->m_pendingDataChange.has_value()) {
+            auto &pending = *this->m_pendingDataChange;
+
+            const auto start = std::min(pending.getStartAddress(), offset);
+            const auto end   = std::max(pending.getStartAddress() + pending.getSize(), offset + size);
+            pending = Region { start, end - start };
+        } else {
+            this->m_pendingDataChange = Region { offset, size };
+
+            TaskManager::doLater([this, alive = std::weak_ptr(this->m_aliveToken)] {
+                // The provider may have been closed in the meantime
+                if (alive.expired())
+                    return;
+
+                this->postDataChanged();
+            });
+        }
+    }
+
+    void Provider::postDataChanged() {
+        std::optional<Region> change;
+        {
+            std::scoped_lock lock(this->m_dataChangeMutex);
+            std::swap(change, this->m_pendingDataChange);
+        }
+
+        if (!change.has_value())
+            return;
+
+        this->m_dataVersion++;
+        EventManager::post<EventDataChanged>(this, *change);
+    }
+
     void Provider::insert(u64 offset, size_t size) {
         auto &patches = getPatches();
 
@@ -58,7 +106,8 @@ namespace hex::prv {
         for (const auto &[address, value] : patchesToMove)
             patches.insert({ address + size, value });
 
-        this->markDirty();
+        // Everything following the inserted bytes moved
+        this->markDataChanged(offset, this->getActualSize() + this->getBaseAddress() - offset);
     }
 
     void Provider::remove(u64 offset, size_t size) {
@@ -76,7 +125,7 @@ namespace hex::prv {
         for (const auto &[address, value] : patchesToMove)
             patches.insert({ address - size, value });
 
-        this->markDirty();
+        this->markDataChanged(offset, this->getActualSize() + this->getBaseAddress() + size - offset);
     }
 
     void Provider::applyOverlays(u64 offset, void *buffer, size_t size) {
@@ -170,7 +219,7 @@ namespace hex::prv {
         return page;
     }
 
-    void Provider::addPatch(u64 offset, const void *buffer, size_t size, bool createUndo) {
+    void Provider::discardRedoHistory() {
         if (this->m_patchTreeOffset > 0) {
             auto iter = this->m_patches.end();
             for (u32 i = 0; i < this->m_patchTreeOffset; i++)
@@ -178,23 +227,175 @@ namespace hex::prv {
 
             this->m_patches.erase(iter, this->m_patches.end());
             this->m_patchTreeOffset = 0;
+
+            std::erase_if(this->m_resizingReplacements, [this](const auto &entry) { return entry.first >= this->m_patches.size(); });
         }
+    }
+
+    size_t Provider::getUndoStateIndex() const {
+        return this->m_patches.size() - 1 - this->m_patchTreeOffset;
+    }
+
+    void Provider::addPatch(u64 offset, const void *buffer, size_t size, bool createUndo) {
+        this->discardRedoHistory();
 
         if (createUndo)
             createUndoPoint();
 
+        std::vector<u8> originalValues(size);
+        this->readRaw(offset - this->getBaseAddress(), originalValues.data(), originalValues.size());
+
+        auto &patches = getPatches();
         for (u64 i = 0; i < size; i++) {
-            u8 patch         = reinterpret_cast<const u8 *>(buffer)[i];
-            u8 originalValue = 0x00;
-            this->readRaw(offset + i, &originalValue, sizeof(u8));
+            u8 patch = reinterpret_cast<const u8 *>(buffer)[i];
 
-            if (patch == originalValue)
-                getPatches().erase(offset + i);
+            if (patch == originalValues[i])
+                patches.erase(offset + i);
             else
-                getPatches()[offset + i] = patch;
+                patches[offset + i] = patch;
         }
 
-        this->markDirty();
+        this->markDataChanged(offset, size);
+    }
+
+    void Provider::addPatches(const std::vector<std::pair<u64, u8>> &patches, bool createUndo) {
+        this->discardRedoHistory();
+
+        if (createUndo)
+            createUndoPoint();
+
+        auto &currPatches = getPatches();
+        auto hint = currPatches.begin();
+
+        // Original values are read in one go for every run of consecutive addresses
+        std::vector<u8> originalValues;
+        for (size_t start = 0; start < patches.size();) {
+            size_t end = start + 1;
+            while (end < patches.size() && patches[end].first == patches[end - 1].first + 1 && end - start < 0x1000)
+                end++;
+
+            originalValues.resize(end - start);
+            this->readRaw(patches[start].first - this->getBaseAddress(), originalValues.data(), originalValues.size());
+
+            for (size_t i = start; i < end; i++) {
+                const auto [address, value] = patches[i];
+
+                if (value == originalValues[i - start]) {
+                    hint = currPatches.lower_bound(address);
+                    if (hint != currPatches.end() && hint->first == address)
+                        hint = currPatches.erase(hint);
+                } else {
+                    hint = currPatches.insert_or_assign(hint, address, value);
+                }
+            }
+
+            start = end;
+        }
+
+        if (!patches.empty())
+            this->markDataChanged(patches.front().first, patches.back().first - patches.front().first + 1);
+    }
+
+    void Provider::replace(const std::vector<u64> &offsets, size_t size, std::span<const u8> data) {
+        if (offsets.empty())
+            return;
+
+        if (data.size() == size) {
+            std::vector<std::pair<u64, u8>> patches;
+            patches.reserve(offsets.size() * size);
+            for (auto offset : offsets) {
+                for (size_t i = 0; i < size; i++)
+                    patches.emplace_back(offset + i, data[i]);
+            }
+
+            this->addPatches(patches);
+            return;
+        }
+
+        this->discardRedoHistory();
+
+        const auto baseAddress = this->getBaseAddress();
+        const i64 difference = i64(data.size()) - i64(size);
+
+        ResizingReplacement replacement = { offsets, size, { data.begin(), data.end() }, std::vector<u8>(offsets.size() * size) };
+        for (size_t i = 0; i < offsets.size(); i++)
+            this->readRaw(offsets[i] - baseAddress, replacement.originalData.data() + i * size, size);
+
+        // Patches move along with the data, the ones inside of replaced regions are overwritten. The previous undo state keeps the
+        // patches as they were before, they apply again once the replacement has been undone
+        std::map<u64, u8> movedPatches;
+        size_t index = 0;
+        for (const auto &[address, value] : getPatches()) {
+            while (index < offsets.size() && offsets[index] + size <= address)
+                index++;
+
+            if (index < offsets.size() && address >= offsets[index])
+                continue;
+
+            movedPatches.emplace_hint(movedPatches.end(), address + difference * i64(index), value);
+        }
+
+        this->replaceData(offsets, size, data.size(), data);
+
+        this->m_patches.push_back(std::move(movedPatches));
+        this->m_resizingReplacements[this->getUndoStateIndex()] = std::move(replacement);
+    }
+
+    void Provider::replaceData(const std::vector<u64> &offsets, size_t size, size_t newSize, std::span<const u8> data) {
+        const auto baseAddress = this->getBaseAddress();
+        const auto oldSize = this->getActualSize();
+        const i64 difference = i64(newSize) - i64(size);
+        const u64 newDataSize = oldSize + difference * i64(offsets.size());
+
+        // Moves data within the provider, copying from the end if it moves backwards so nothing gets overwritten before it's been moved
+        std::vector<u8> buffer(0x10000);
+        auto moveData = [&](u64 from, u64 to, u64 length) {
+            if (to > from) {
+                for (u64 remaining = length; remaining > 0;) {
+                    const auto chunkSize = std::min<u64>(remaining, buffer.size());
+                    remaining -= chunkSize;
+
+                    this->readRaw(from + remaining, buffer.data(), chunkSize);
+                    this->writeRaw(to + remaining, buffer.data(), chunkSize);
+                }
+            } else {
+                for (u64 position = 0; position < length;) {
+                    const auto chunkSize = std::min<u64>(length - position, buffer.size());
+
+                    this->readRaw(from + position, buffer.data(), chunkSize);
+                    this->writeRaw(to + position, buffer.data(), chunkSize);
+
+                    position += chunkSize;
+                }
+            }
+        };
+
+        // Data following the n-th replacement moves by n + 1 times the size difference. Growing data has to be moved
+        // starting at the end, shrinking data starting at the front
+        auto moveSegment = [&](size_t index) {
+            const u64 start = offsets[index] - baseAddress + size;
+            const u64 end = index + 1 < offsets.size() ? offsets[index + 1] - baseAddress : oldSize;
+
+            moveData(start, start + difference * i64(index + 1), end - start);
+        };
+
+        if (difference > 0) {
+            this->resize(newDataSize);
+            for (size_t i = offsets.size(); i > 0; i--)
+                moveSegment(i - 1);
+        } else {
+            for (size_t i = 0; i < offsets.size(); i++)
+                moveSegment(i);
+            this->resize(newDataSize);
+        }
+
+        // Either the same data is written at every offset or every offset gets its own part of it
+        for (size_t i = 0; i < offsets.size(); i++) {
+            const auto replacement = data.size() == newSize ? data : data.subspan(i * newSize, newSize);
+            this->writeRaw(offsets[i] - baseAddress + difference * i64(i), replacement.data(), replacement.size());
+        }
+
+        this->markDataChanged(offsets.front(), std::max<u64>(oldSize, newDataSize) + baseAddress - offsets.front());
     }
 
     void Provider::createUndoPoint() {
@@ -202,13 +403,65 @@ namespace hex::prv {
     }
 
     void Provider::undo() {
-        if (canUndo())
+        if (canUndo()) {
+            const auto &before = getPatches();
+
+            // Resizing replacements moved the data itself, it has to be moved back before the older patches fit it again
+            if (auto replacement = this->m_resizingReplacements.find(this->getUndoStateIndex()); replacement != this->m_resizingReplacements.end()) {
+                const auto &[offsets, size, data, originalData] = replacement->second;
+                const i64 difference = i64(data.size()) - i64(size);
+
+                std::vector<u64> movedOffsets;
+                for (size_t i = 0; i < offsets.size(); i++)
+                    movedOffsets.push_back(offsets[i] + difference * i64(i));
+
+                this->replaceData(movedOffsets, data.size(), size, originalData);
+            }
+
             this->m_patchTreeOffset++;
+            this->markPatchesChanged(before, getPatches());
+        }
     }
 
     void Provider::redo() {
-        if (canRedo())
+        if (canRedo()) {
+            const auto &before = getPatches();
             this->m_patchTreeOffset--;
+
+            if (auto replacement = this->m_resizingReplacements.find(this->getUndoStateIndex()); replacement != this->m_resizingReplacements.end())
+                this->replaceData(replacement->second.offsets, replacement->second.size, replacement->second.data.size(), replacement->second.data);
+
+            this->markPatchesChanged(before, getPatches());
+        }
+    }
+
+    void Provider::markPatchesChanged(const std::map<u64, u8> &before, const std::map<u64, u8> &after) {
+        std::optional<u64> first, last;
+        auto markChanged = [&](u64 address) {
+            if (!first.has_value())
+                first = address;
+            last = address;
+        };
+
+        // Both maps are sorted, walk them at the same time to find the lowest and highest address whose value changed
+        auto beforeIter = before.begin(), afterIter = after.begin();
+        while (beforeIter != before.end() || afterIter != after.end()) {
+            if (afterIter == after.end() || (beforeIter != before.end() && beforeIter->first < afterIter->first)) {
+                markChanged(beforeIter->first);
+                ++beforeIter;
+            } else if (beforeIter == before.end() || afterIter->first < beforeIter->first) {
+                markChanged(afterIter->first);
+                ++afterIter;
+            } else {
+                if (beforeIter->second != afterIter->second)
+                    markChanged(beforeIter->first);
+                ++beforeIter;
+                ++afterIter;
+            }
+        }
+
+        if (first.has_value())
+            this->markDataChanged(*first, *last - *first + 1);
     }
 
     bool Provider::canUndo() const {
@@ -219,6 +472,10 @@ namespace hex::prv {
         return this->m_patchTreeOffset > 0;
     }
 
+    bool Provider::isDataVolatile() const {
+        return false;
+    }
+
     bool Provider::hasFilePicker() const {
         return false;
     }
@@ -66,6 +66,10 @@ namespace hex::plugin::builtin::prv {
 
         std::pair<Region, bool> getRegionValidity(u64 address) const override;
 
+    private:
+        // Changes the size of the file without reporting it, insert() and remove() report their changes once the data has been moved
+        void resizeFile(size_t newSize);
+
     protected:
         #if defined(OS_WINDOWS)
 
@@ -20,6 +20,7 @@ namespace hex::plugin::builtin::prv {
         [[nodiscard]] bool isWritable() const override;
         [[nodiscard]] bool isResizable() const override;
         [[nodiscard]] bool isSavable() const override;
+        [[nodiscard]] bool isDataVolatile() const override { return true; }
 
         void read(u64 offset, void *buffer, size_t size, bool overlays) override;
         void write(u64 offset, const void *buffer, size_t size) override;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/api/content_registry.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/fs.hpp>
+
+#include <hex/ui/view.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace hex::plugin::builtin {
+
+    class ViewBlockHashes : public View {
+    public:
+        ViewBlockHashes();
+        ~ViewBlockHashes() override;
+
+        void drawContent() override;
+
+    private:
+        struct BlockList {
+            std::string hashType;
+            Region region;
+            u64 blockSize;
+            std::vector<std::vector<u8>> hashes;
+        };
+
+        void startHashing(prv::Provider *provider, prv::Provider *reference);
+        void compareBlocks();
+
+        void exportBlocks(const std::fs::path &path) const;
+        void importReference(const std::fs::path &path);
+
+        [[nodiscard]] bool isComparable(const BlockList &reference, prv::Provider *referenceProvider) const;
+        [[nodiscard]] bool isDiffering(u64 address) const;
+        [[nodiscard]] Region getBlockRegion(u64 block) const;
+
+        void drawSettings();
+        void drawBlockList();
+
+    private:
+        ContentRegistry::Hashes::Hash *m_selectedHash = nullptr;
+        u32 m_blockSizeIndex = 0;
+        bool m_onlySelection = false;
+        int m_referenceProviderIndex = -1;
+        bool m_onlyDifferingBlocks = false;
+
+        // Blocks of the provider they were calculated for and the data version they're valid for
+        prv::Provider *m_provider = nullptr;
+        u64 m_dataVersion = 0;
+        std::optional<BlockList> m_blocks;
+
+        // Blocks the calculated ones get compared to. They either come from another provider or from a previously exported file
+        prv::Provider *m_referenceProvider = nullptr;
+        u64 m_referenceDataVersion = 0;
+        std::string m_referenceName;
+        std::optional<BlockList> m_reference;
+
+        // Sorted indices of all blocks whose hashes don't match the reference
+        std::vector<u64> m_differingBlocks;
+
+        u64 m_hashGeneration = 0;
+        TaskHolder m_hashTask;
+    };
+
+}
@@ -28,6 +28,8 @@ namespace hex::plugin::builtin {
 
         void drawContent() override;
 
+        static std::vector<Constant> loadConstants();
+
     private:
         void reloadConstants();
 
@@ -8,7 +8,10 @@
 #include <hex/data_processor/link.hpp>
 
 #include <array>
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace hex::plugin::builtin {
 
@@ -25,9 +28,13 @@ namespace hex::plugin::builtin {
 
         bool m_continuousEvaluation = false;
 
+        // Regions changed by the overlays written while processing the nodes, until the EventDataChanged reporting them arrives
+        std::map<prv::Provider *, Region> m_overlayChanges;
+
         void eraseLink(u32 id);
         void eraseNodes(const std::vector<int> &ids);
         void processNodes();
+        void markOverlaysChanged(const std::vector<std::pair<u64, std::vector<u8>>> &previous, const std::vector<std::pair<u64, std::vector<u8>>> &current);
 
         std::string saveNodes(prv::Provider *provider);
         void loadNodes(prv::Provider *provider, const std::string &data);
@@ -4,19 +4,25 @@
 
 #include <imgui.h>
 #include <hex/ui/view.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/search.hpp>
+#include <hex/helpers/search_index.hpp>
 #include <ui/widgets.hpp>
 
 #include <atomic>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <utility>
 #include <vector>
 
-#include <IntervalTree.h>
-
 namespace hex::plugin::builtin {
 
     class ViewFind : public View {
     public:
         ViewFind();
-        ~ViewFind() override = default;
+        ~ViewFind() override;
 
         void drawContent() override;
 
@@ -24,26 +30,35 @@ namespace hex::plugin::builtin {
 
         struct Occurrence {
             Region region;
-            enum class DecodeType { ASCII, Binary, UTF16LE, UTF16BE } decodeType;
-        };
+            enum class DecodeType { ASCII, Binary, UTF16LE, UTF16BE, UTF8 } decodeType;
 
-        struct BinaryPattern {
-            u8 mask, value;
+            // Index of the needle that was found when searching for multiple sequences at once
+            u32 needle = 0;
+
+            // Number of bytes that differ from the searched sequence for approximate matches
+            u32 distance = 0;
         };
 
+        using BinaryPattern = search::MaskedByte;
+
         struct SearchSettings {
             ui::SelectedRegion range = ui::SelectedRegion::EntireData;
+            bool allProviders = false;
+            int maxResults = 1'000'000;
 
             enum class Mode : int {
                 Strings,
                 Sequence,
                 Regex,
-                BinaryPattern
+                BinaryPattern,
+                MultiSequence,
+                Fuzzy,
+                Values
             } mode = Mode::Strings;
 
             struct Strings {
                 int minLength = 5;
-                enum class Type : int { ASCII = 0, UTF16LE = 1, UTF16BE = 2, ASCII_UTF16LE = 3, ASCII_UTF16BE = 4 } type = Type::ASCII;
+                enum class Type : int { ASCII = 0, UTF16LE = 1, UTF16BE = 2, ASCII_UTF16LE = 3, ASCII_UTF16BE = 4, UTF8 = 5, All = 6 } type = Type::ASCII;
                 bool nullTermination = false;
 
                 bool m_lowerCaseLetters = true;
@@ -57,37 +72,163 @@ namespace hex::plugin::builtin {
 
             struct Bytes {
                 std::string sequence;
+                bool overlapping = true;
             } bytes;
 
             struct Regex {
                 std::string pattern;
+                int maxLength = 4096;
+
+                // Only checked when the pattern changes instead of compiling it every frame
+                bool patternValid = false;
             } regex;
 
             struct BinaryPattern {
                 std::string input;
                 std::vector<ViewFind::BinaryPattern> pattern;
             } binaryPattern;
+
+            struct MultiSequence {
+                struct Needle {
+                    std::string name;
+                    std::vector<u8> bytes;
+                };
+
+                std::string input;
+                std::vector<Needle> needles;
+            } multiSequence;
+
+            struct Fuzzy {
+                std::string sequence;
+                int maxDistance = 1;
+                bool insertionsDeletions = false;
+            } fuzzy;
+
+            struct Values {
+                search::ValueScanner::Type type = search::ValueScanner::Type::U32;
+                std::endian endian = std::endian::little;
+                bool aligned = true;
+
+                search::ValueScanner::Predicate predicate = search::ValueScanner::Predicate::Equal;
+                std::string minimum, maximum;
+            } values;
         } m_searchSettings, m_decodeSettings;
 
-        using OccurrenceTree = interval_tree::IntervalTree<u64, Occurrence>;
+        // Occurrences are published by the search task as soon as they're found and picked up by the main thread every frame
+        struct SearchResults {
+            SearchResults(SearchSettings::Mode mode, search::OccurrenceStore::Layout layout, size_t limit);
+
+            SearchResults(const SearchResults&) = delete;
+            SearchResults& operator=(const SearchResults&) = delete;
+
+            // Only called by the search task. Returns false once the result limit has been reached
+            bool add(const Occurrence &occurrence);
+            [[nodiscard]] bool isFull() const { return this->full; }
+
+            [[nodiscard]] Occurrence get(size_t index) const;
+            [[nodiscard]] size_t getSize() const { return this->occurrences.getSize(); }
+
+            SearchSettings::Mode mode;
+            search::OccurrenceStore occurrences;
+            size_t limit;
+            std::atomic<bool> full = false, finished = false;
+
+            enum class SortColumn { Offset, Size, Value, Distance };
+
+            // Only accessed by the main thread. Both refer to occurrences by their index in the store
+            search::IntervalIndex index;
+            std::vector<u32> filtered;
+            size_t indexedCount = 0, filteredCount = 0;
+            bool sorted = false;
 
-        std::map<prv::Provider*, std::vector<Occurrence>> m_foundOccurrences, m_sortedOccurrences;
-        std::map<prv::Provider*, OccurrenceTree> m_occurrenceTree;
+            // Filtering and sorting need to decode the occurrences, which happens in a task. Its result replaces the filtered list
+            SortColumn sortColumn = SortColumn::Offset;
+            bool sortAscending = true;
+            bool ordering = false;
+            u64 orderGeneration = 0;
+            TaskHolder orderTask;
+        };
+
+        std::map<prv::Provider*, std::shared_ptr<SearchResults>> m_results;
         std::map<prv::Provider*, std::string> m_currFilter;
 
-        TaskHolder m_searchTask;
+        struct SearchIndex {
+            std::shared_ptr<const search::NGramIndex> index;
+
+            // SHA-256 of every block's content at the time it was indexed. Used to verify an index loaded from a project still matches the data
+            std::shared_ptr<const std::vector<std::vector<u8>>> blockHashes;
+
+            // Blocks that have been changed at some point. The index might not reflect their content anymore so they're always searched
+            std::set<u64> dirtyBlocks;
+        };
+
+        // Larger indices aren't stored in projects, building them again is cheaper than bloating the project file. A stored index takes
+        // about 8 KiB per 128 KiB of data so this covers roughly 256 MiB
+        constexpr static size_t MaxStoredIndexSize = 16 * 1024 * 1024;
+
+        std::map<prv::Provider*, SearchIndex> m_searchIndices;
+        TaskHolder m_indexTask;
+
+        // Indices loaded from a project whose blocks are still being compared against the data. Searches don't use them until that's done
+        struct UnverifiedIndex {
+            SearchIndex searchIndex;
+            u64 generation = 0;
+            TaskHolder task;
+        };
+
+        std::map<prv::Provider*, UnverifiedIndex> m_unverifiedIndices;
+        u64 m_verificationGeneration = 0;
+
+        // Blocks changed while their provider's index is being built, they're marked dirty once it's done
+        std::map<prv::Provider*, std::set<u64>> m_blocksChangedWhileIndexing;
+
+        // Candidates of the last value scan of every provider, later scans narrow them down further
+        std::map<prv::Provider*, std::shared_ptr<search::ValueScanner>> m_valueScanners;
+
+        // One task per searched provider
+        std::vector<TaskHolder> m_searchTasks;
+
+        std::string m_replaceInput;
+        TaskHolder m_replaceTask;
         bool m_settingsValid = false;
 
     private:
-        static std::vector<Occurrence> searchStrings(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::Strings settings);
-        static std::vector<Occurrence> searchSequence(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::Bytes settings);
-        static std::vector<Occurrence> searchRegex(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::Regex settings);
-        static std::vector<Occurrence> searchBinaryPattern(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::BinaryPattern settings);
+        static void searchStrings(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::Strings settings, SearchResults &results);
+        static void searchSequence(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::Bytes settings, const std::optional<SearchIndex> &index, SearchResults &results);
+        static void searchRegex(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::Regex settings, SearchResults &results);
+        static void searchBinaryPattern(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::BinaryPattern settings, const std::optional<SearchIndex> &index, SearchResults &results);
+        static void searchMultiSequence(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::MultiSequence settings, SearchResults &results);
+        static void searchFuzzy(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::Fuzzy settings, SearchResults &results);
+        static void searchValues(Task &task, prv::Provider *provider, Region searchRegion, SearchSettings::Values settings, search::ValueScanner &scanner, SearchResults &results);
+        static void rescanValues(Task &task, prv::Provider *provider, SearchSettings::Values settings, search::ValueScanner &scanner, SearchResults &results);
+        static std::optional<search::ValueScanner::Condition> getValueCondition(const SearchSettings::Values &settings);
 
         static std::vector<BinaryPattern> parseBinaryPatternString(std::string string);
+        static std::optional<std::vector<SearchSettings::MultiSequence::Needle>> parseNeedleList(const std::string &string);
+        static std::string loadConstantNeedles();
+
+        static std::vector<Region> getCandidateRegions(prv::Provider *provider, Region searchRegion, const std::vector<search::MaskedByte> &pattern, const std::optional<SearchIndex> &index);
+        static void markPatchedBlocks(prv::Provider *provider, SearchIndex &index);
+        static void markChangedBlocks(prv::Provider *provider, Region region, std::set<u64> &blocks);
+        void buildSearchIndex(prv::Provider *provider);
+        void verifySearchIndex(prv::Provider *provider, SearchIndex searchIndex);
+        std::optional<SearchIndex> getSearchIndex(prv::Provider *provider);
 
         void runSearch();
+        void startSearch(prv::Provider *provider, Region searchRegion);
+        void runValueRescan();
+        void startValueRescan(prv::Provider *provider);
+        [[nodiscard]] bool isSearching() const;
+
+        [[nodiscard]] std::optional<std::vector<search::MaskedByte>> parseReplacement(const std::string &input) const;
+        void replaceAll(prv::Provider *provider, std::vector<search::MaskedByte> replacement);
+        static search::OccurrenceStore::Layout getStoreLayout(const SearchSettings &settings);
+        SearchResults *updateResults(prv::Provider *provider);
+        void startOrdering(prv::Provider *provider, const std::shared_ptr<SearchResults> &results, bool refilter, bool sort);
+        static std::vector<u32> orderResults(Task &task, prv::Provider *provider, const SearchSettings &decodeSettings, const SearchResults &results, std::vector<u32> ids, size_t from, size_t to, const std::string &filter, std::optional<std::pair<SearchResults::SortColumn, bool>> sort);
+
         std::string decodeValue(prv::Provider *provider, Occurrence occurrence) const;
+        static std::string decodeValue(prv::Provider *provider, const SearchSettings &decodeSettings, Occurrence occurrence);
     };
 
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <hex/api/content_registry.hpp>
+#include <hex/api/task.hpp>
 
 #include <hex/ui/view.hpp>
 
 #include <array>
+#include <chrono>
+#include <list>
+#include <optional>
 #include <utility>
 #include <cstdio>
 
@@ -18,10 +22,38 @@ namespace hex::plugin::builtin {
         void drawContent() override;
 
     private:
+        struct CachedResults {
+            prv::Provider *provider;
+            Region region;
+            u64 dataVersion;
+            std::vector<std::vector<u8>> results;
+            std::chrono::steady_clock::time_point calculationTime;
+        };
+
+        void startHashing();
+        void invalidateResults();
+        [[nodiscard]] const std::vector<std::vector<u8>> *findResults(prv::Provider *provider, const Region &region) const;
+        [[nodiscard]] static bool isOutdated(const CachedResults &entry);
+        void drawResult(u32 index, bool editable);
+
+    private:
+        constexpr static size_t MaxCachedResults = 32;
+        constexpr static auto VolatileResultsLifetime = std::chrono::seconds(1);
+
         ContentRegistry::Hashes::Hash *m_selectedHash = nullptr;
         std::string m_newHashName;
 
         std::vector<ContentRegistry::Hashes::Hash::Function> m_hashFunctions;
+
+        // Results of all hash functions for recently selected regions, most recently used first. An entry is valid as long as
+        // its data version matches the one of the provider. Edits that don't touch the region carry the entry over to the new version.
+        // Results of providers with volatile data are additionally recalculated once they're older than VolatileResultsLifetime
+        std::list<CachedResults> m_cachedResults;
+
+        // Region that's currently being hashed. Results of outdated calculations are discarded using the generation counter
+        std::optional<CachedResults> m_pendingResults;
+        u64 m_hashGeneration = 0;
+        TaskHolder m_hashTask;
     };
 
 }
@@ -2,10 +2,16 @@
 
 #include <hex/ui/view.hpp>
 #include <hex/api/task.hpp>
+#include <hex/helpers/entropy.hpp>
+
+#include <implot.h>
 
 #include <array>
 #include <atomic>
 #include <cstdio>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -19,23 +25,45 @@ namespace hex::plugin::builtin {
         void drawContent() override;
 
     private:
-        bool m_dataValid            = false;
-        u32 m_blockSize             = 0;
-        float m_averageEntropy      = 0;
-        float m_highestBlockEntropy = 0;
-        std::vector<float> m_blockEntropy;
+        struct Analysis {
+            u64 generation = 0;
+            Region region = { 0, 0 };
 
-        double m_entropyHandlePosition;
+            std::string dataDescription;
+            std::string dataMimeType;
 
-        std::array<ImU64, 256> m_valueCounts = { 0 };
-        TaskHolder m_analyzerTask;
+            // Entropy of the data from whole-file down to leaf granularity, the plot picks the level that fits the visible range
+            entropy::Pyramid pyramid;
+            float highestBlockEntropy = 0;
 
-        Region m_analyzedRegion = { 0, 0 };
+            std::array<ImU64, 256> valueCounts = { 0 };
 
-        std::string m_dataDescription;
-        std::string m_dataMimeType;
+            // Changes to the data are collected here while the previous ones are being analyzed in the background
+            std::optional<Region> pendingChange;
+            bool updating = false;
+        };
 
         void analyze();
+        void updateAnalysis(prv::Provider *provider, const std::shared_ptr<Analysis> &analysis);
+        static void updateSummary(Analysis &analysis);
+        void drawEntropyPlot(const Analysis &analysis);
+
+    private:
+        // Results are kept for every provider that has been analyzed, switching between them doesn't require analyzing them again
+        std::map<prv::Provider *, std::shared_ptr<Analysis>> m_analyses;
+
+        prv::Provider *m_analyzedProvider = nullptr;
+        u64 m_analysisGeneration = 0;
+        TaskHolder m_analyzerTask;
+
+        double m_entropyHandlePosition = 0;
+
+        // Analysis shown in the entropy plot and the address range the plot gets zoomed to in the next frame
+        u64 m_plottedGeneration = 0;
+        std::optional<ImPlotRange> m_entropyPlotRange;
+
+        u64 m_displayedNodeSize  = 0;
+        u64 m_displayedNodeCount = 0;
     };
 
-}
\ No newline at end of file
+}
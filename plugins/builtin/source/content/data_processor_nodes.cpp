@@ -678,8 +678,10 @@ namespace hex::plugin::builtin {
 
         void drawNode() override {
             ImGui::PushItemWidth(100);
-            ImGui::Combo("hex.builtin.nodes.crypto.aes.mode"_lang, &this->m_mode, "ECB\0CBC\0CFB128\0CTR\0GCM\0CCM\0OFB\0");
+            ImGui::Combo("hex.builtin.nodes.crypto.aes.mode"_lang, &this->m_mode, "ECB\0CBC\0CFB128\0CTR\0GCM\0CCM\0OFB\0XTS\0");
             ImGui::Combo("hex.builtin.nodes.crypto.aes.key_length"_lang, &this->m_keyLength, "128 Bits\000192 Bits\000256 Bits\000");
+            if (static_cast<crypt::AESMode>(this->m_mode) == crypt::AESMode::XTS)
+                ImGui::InputScalar("hex.builtin.nodes.crypto.aes.data_unit_size"_lang, ImGuiDataType_U64, &this->m_dataUnitSize);
             ImGui::PopItemWidth();
         }
 
@@ -700,7 +702,23 @@ namespace hex::plugin::builtin {
             std::copy(iv.begin(), iv.end(), ivData.begin());
             std::copy(nonce.begin(), nonce.end(), nonceData.begin());
 
-            auto output = crypt::aesDecrypt(static_cast<crypt::AESMode>(this->m_mode), static_cast<crypt::KeyLength>(this->m_keyLength), key, nonceData, ivData, input);
+            const auto mode      = static_cast<crypt::AESMode>(this->m_mode);
+            const auto keyLength = static_cast<crypt::KeyLength>(this->m_keyLength);
+
+            // Modes where blocks don't depend on each other are decrypted straight into the output buffer on all cores
+            std::vector<u8> output;
+            if (mode == crypt::AESMode::ECB || mode == crypt::AESMode::CTR || mode == crypt::AESMode::XTS) {
+                try {
+                    crypt::AESDecryptor decryptor(mode, keyLength, key, nonceData, ivData, this->m_dataUnitSize);
+
+                    output.resize(input.size());
+                    decryptor.decrypt(0, input, output);
+                } catch (const std::invalid_argument &e) {
+                    throwNodeError(e.what());
+                }
+            } else {
+                output = crypt::aesDecrypt(mode, keyLength, key, nonceData, ivData, input);
+            }
 
             this->setBufferOnOutput(4, output);
         }
@@ -708,19 +726,22 @@ namespace hex::plugin::builtin {
         void store(nlohmann::json &j) override {
             j = nlohmann::json::object();
 
-            j["data"]               = nlohmann::json::object();
-            j["data"]["mode"]       = this->m_mode;
-            j["data"]["key_length"] = this->m_keyLength;
+            j["data"]                   = nlohmann::json::object();
+            j["data"]["mode"]           = this->m_mode;
+            j["data"]["key_length"]     = this->m_keyLength;
+            j["data"]["data_unit_size"] = this->m_dataUnitSize;
         }
 
         void load(nlohmann::json &j) override {
-            this->m_mode      = j["data"]["mode"];
-            this->m_keyLength = j["data"]["key_length"];
+            this->m_mode         = j["data"]["mode"];
+            this->m_keyLength    = j["data"]["key_length"];
+            this->m_dataUnitSize = j["data"].value("data_unit_size", 512);
         }
 
     private:
-        int m_mode      = 0;
-        int m_keyLength = 0;
+        int m_mode         = 0;
+        int m_keyLength    = 0;
+        u64 m_dataUnitSize = 512;
     };
 
     class NodeDecodingBase64 : public dp::Node {
@@ -730,7 +751,16 @@ namespace hex::plugin::builtin {
         void process() override {
             auto input = this->getBufferOnInput(0);
 
-            auto output = crypt::decode64(input);
+            // Base64 data is often wrapped into multiple lines, the line breaks aren't part of the encoded data
+            std::string encoded(input.begin(), input.end());
+            std::erase_if(encoded, [](char c) { return std::isspace(u8(c)); });
+
+            std::vector<u8> output(encoded.size() / 4 * 3);
+            try {
+                output.resize(crypt::decode64(encoded, output));
+            } catch (const std::invalid_argument &e) {
+                throwNodeError(e.what());
+            }
 
             this->setBufferOnOutput(1, output);
         }
@@ -743,29 +773,11 @@ namespace hex::plugin::builtin {
         void process() override {
             auto input = this->getBufferOnInput(0);
 
-            if (input.size() % 2 != 0)
-                throwNodeError("Can't decode odd number of hex characters");
-
-            std::vector<u8> output;
-            for (u32 i = 0; i < input.size(); i += 2) {
-                char c1 = static_cast<char>(std::tolower(input[i]));
-                char c2 = static_cast<char>(std::tolower(input[i + 1]));
-
-                if (!std::isxdigit(c1) || !isxdigit(c2))
-                    throwNodeError("Can't decode non-hexadecimal character");
-
-                u8 value;
-                if (std::isdigit(c1))
-                    value = (c1 - '0') << 4;
-                else
-                    value = ((c1 - 'a') + 0x0A) << 4;
-
-                if (std::isdigit(c2))
-                    value |= c2 - '0';
-                else
-                    value |= (c2 - 'a') + 0x0A;
-
-                output.push_back(value);
+            std::vector<u8> output(input.size() / 2);
+            try {
+                crypt::decode16({ reinterpret_cast<const char *>(input.data()), input.size() }, output);
+            } catch (const std::invalid_argument &e) {
+                throwNodeError(e.what());
             }
 
             this->setBufferOnOutput(1, output);
@@ -1,9 +1,20 @@
 #include <hex/api/content_registry.hpp>
+#include <hex/api/event.hpp>
 #include <hex/api/localization.hpp>
 #include <hex/helpers/crypto.hpp>
+#include <hex/helpers/merkle_tree.hpp>
+#include <hex/helpers/similarity_hash.hpp>
+#include <hex/providers/provider.hpp>
 
 #include <hex/ui/imgui_imhex_extensions.h>
 
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <tuple>
+
 namespace hex::plugin::builtin {
 
     class HashMD5 : public ContentRegistry::Hashes::Hash {
@@ -11,11 +22,7 @@ namespace hex::plugin::builtin {
         HashMD5() : Hash("hex.builtin.hash.md5") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::md5(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::createMD5Context);
         }
     };
 
@@ -24,11 +31,7 @@ namespace hex::plugin::builtin {
         HashSHA1() : Hash("hex.builtin.hash.sha1") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::sha1(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::createSHA1Context);
         }
     };
 
@@ -37,11 +40,7 @@ namespace hex::plugin::builtin {
         HashSHA224() : Hash("hex.builtin.hash.sha224") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::sha224(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::createSHA224Context);
         }
     };
 
@@ -50,11 +49,7 @@ namespace hex::plugin::builtin {
         HashSHA256() : Hash("hex.builtin.hash.sha256") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::sha256(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::createSHA256Context);
         }
     };
 
@@ -63,11 +58,7 @@ namespace hex::plugin::builtin {
         HashSHA384() : Hash("hex.builtin.hash.sha384") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::sha384(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::createSHA384Context);
         }
     };
 
@@ -76,18 +67,13 @@ namespace hex::plugin::builtin {
         HashSHA512() : Hash("hex.builtin.hash.sha512") {}
 
         Function create(std::string name) override {
-            return Hash::create(name, [](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto array = crypt::sha512(provider, region.address, region.size);
-
-                return { array.begin(), array.end() };
-            });
+            return Hash::create(name, crypt::createSHA512Context);
         }
     };
 
-    template<typename T>
     class HashCRC : public ContentRegistry::Hashes::Hash {
     public:
-        using CRCFunction = T(*)(prv::Provider*&, u64, size_t, u32, u32, u32, bool, bool);
+        using CRCFunction = std::unique_ptr<crypt::HashContext>(*)(u32, u32, u32, bool, bool);
         HashCRC(const std::string &name, const CRCFunction &crcFunction, u32 polynomial, u32 initialValue, u32 xorOut)
             : Hash(name), m_crcFunction(crcFunction), m_polynomial(polynomial), m_initialValue(initialValue), m_xorOut(xorOut) {}
 
@@ -103,13 +89,8 @@ namespace hex::plugin::builtin {
         }
 
         Function create(std::string name) override {
-            return Hash::create(name, [hash = *this](const Region& region, prv::Provider *provider) -> std::vector<u8> {
-                auto result = hash.m_crcFunction(provider, region.address, region.size, hash.m_polynomial, hash.m_initialValue, hash.m_xorOut, hash.m_reflectIn, hash.m_reflectOut);
-
-                std::vector<u8> bytes(sizeof(result), 0x00);
-                std::memcpy(bytes.data(), &result, bytes.size());
-
-                return bytes;
+            return Hash::create(name, [hash = *this] {
+                return hash.m_crcFunction(hash.m_polynomial, hash.m_initialValue, hash.m_xorOut, hash.m_reflectIn, hash.m_reflectOut);
             });
         }
 
@@ -122,6 +103,189 @@ namespace hex::plugin::builtin {
         bool m_reflectIn = false, m_reflectOut = false;
     };
 
+    class HashSsdeep : public ContentRegistry::Hashes::Hash {
+    public:
+        HashSsdeep() : Hash("hex.builtin.hash.ssdeep") {}
+
+        Function create(std::string name) override {
+            return Hash::create(name, crypt::createSsdeepContext);
+        }
+
+        std::string format(const std::vector<u8> &result) const override {
+            return { result.begin(), result.end() };
+        }
+    };
+
+    class HashTLSH : public ContentRegistry::Hashes::Hash {
+    public:
+        HashTLSH() : Hash("hex.builtin.hash.tlsh") {}
+
+        Function create(std::string name) override {
+            return Hash::create(name, crypt::createTlshContext);
+        }
+
+        std::string format(const std::vector<u8> &result) const override {
+            if (result.empty())
+                return "hex.builtin.hash.tlsh.too_short"_lang;
+            else
+                return { result.begin(), result.end() };
+        }
+    };
+
+    class HashMerkleTree : public ContentRegistry::Hashes::Hash {
+    public:
+        HashMerkleTree() : Hash("hex.builtin.hash.merkle") {}
+
+        void draw() override {
+            ImGui::Combo("hex.builtin.hash.merkle.hash"_lang, &this->m_hashIndex, [](void *, int index, const char **name) {
+                *name = HashTypes[index].name;
+                return true;
+            }, nullptr, HashTypes.size());
+
+            ImGui::Combo("hex.builtin.hash.merkle.block_size"_lang, &this->m_blockSizeIndex, [](void *, int index, const char **name) {
+                *name = BlockSizes[index].name;
+                return true;
+            }, nullptr, BlockSizes.size());
+        }
+
+        Function create(std::string name) override {
+            return Hash::create(name, [hashIndex = this->m_hashIndex, blockSize = BlockSizes[this->m_blockSizeIndex].size, user = std::make_shared<TreeUser>()](const Region &region, prv::Provider *provider) -> std::vector<u8> {
+                auto createContext = HashTypes[hashIndex].createContext;
+                auto read = [provider, address = region.getStartAddress()](u64 offset, std::span<u8> buffer) {
+                    provider->read(address + offset, buffer.data(), buffer.size());
+                };
+
+                // Only trees of whole providers are kept around, a selection gets a tree of its own every time
+                if (region != Region { provider->getBaseAddress(), provider->getActualSize() }) {
+                    crypt::MerkleTree tree(createContext, blockSize);
+                    tree.build(region.getSize(), read);
+
+                    return tree.getRootHash();
+                }
+
+                auto entry = getTree(provider, hashIndex, blockSize, user.get());
+                std::scoped_lock lock(entry->treeMutex);
+
+                std::set<u64> changedBlocks;
+                {
+                    std::scoped_lock changesLock(entry->changesMutex);
+                    std::swap(changedBlocks, entry->changedBlocks);
+                }
+
+                for (const auto block : changedBlocks)
+                    entry->tree.invalidate(block * blockSize, blockSize);
+
+                entry->tree.update(region.getSize(), read);
+
+                return entry->tree.getRootHash();
+            });
+        }
+
+        // Trees are updated from the tasks that calculate the hashes, changes to the data are collected on the main thread in the meantime.
+        // Only the blocks they touch are remembered, so there's never more to keep track of than the tree has leaves
+        static void registerEvents() {
+            EventManager::subscribe<EventDataChanged>([](prv::Provider *provider, Region region) {
+                std::scoped_lock lock(s_treesMutex);
+
+                if (region.getSize() == 0 || region.getEndAddress() < provider->getBaseAddress())
+                    return;
+
+                const auto start = std::max(region.getStartAddress(), provider->getBaseAddress()) - provider->getBaseAddress();
+                const auto end   = region.getEndAddress() - provider->getBaseAddress();
+
+                for (auto &[key, entry] : s_trees) {
+                    if (std::get<0>(key) != provider)
+                        continue;
+
+                    const auto blockSize = std::get<2>(key);
+
+                    std::scoped_lock changesLock(entry->changesMutex);
+                    for (auto block = start / blockSize; block <= end / blockSize; block++)
+                        entry->changedBlocks.insert(block);
+                }
+            });
+
+            EventManager::subscribe<EventProviderDeleted>([](prv::Provider *provider) {
+                std::scoped_lock lock(s_treesMutex);
+
+                std::erase_if(s_trees, [provider](const auto &item) { return std::get<0>(item.first) == provider; });
+            });
+        }
+
+    private:
+        // Every hash function created from this hash owns one of these. Trees are freed once none of the functions that used them exist anymore
+        struct TreeUser {
+            TreeUser() = default;
+            TreeUser(const TreeUser &) = delete;
+            TreeUser &operator=(const TreeUser &) = delete;
+
+            ~TreeUser() {
+                std::scoped_lock lock(s_treesMutex);
+
+                std::erase_if(s_trees, [this](auto &item) {
+                    auto &users = item.second->users;
+                    users.erase(this);
+
+                    return users.empty();
+                });
+            }
+        };
+
+        struct TreeEntry {
+            explicit TreeEntry(crypt::ContextFactory createContext, u64 blockSize) : tree(std::move(createContext), blockSize) { }
+
+            std::mutex treeMutex;
+            crypt::MerkleTree tree;
+
+            std::mutex changesMutex;
+            std::set<u64> changedBlocks;
+
+            // Only accessed while holding s_treesMutex
+            std::set<const TreeUser *> users;
+        };
+
+        static std::shared_ptr<TreeEntry> getTree(prv::Provider *provider, int hashIndex, u64 blockSize, const TreeUser *user) {
+            std::scoped_lock lock(s_treesMutex);
+
+            auto &entry = s_trees[{ provider, hashIndex, blockSize }];
+            if (entry == nullptr)
+                entry = std::make_shared<TreeEntry>(HashTypes[hashIndex].createContext, blockSize);
+
+            entry->users.insert(user);
+
+            return entry;
+        }
+
+    private:
+        struct HashType {
+            const char *name;
+            std::unique_ptr<crypt::HashContext> (*createContext)();
+        };
+
+        struct BlockSize {
+            const char *name;
+            u64 size;
+        };
+
+        constexpr static std::array HashTypes = {
+            HashType { "SHA1",   crypt::createSHA1Context   },
+            HashType { "SHA256", crypt::createSHA256Context },
+            HashType { "SHA512", crypt::createSHA512Context },
+        };
+
+        constexpr static std::array BlockSizes = {
+            BlockSize { "4 KiB",  4 * 1024 },
+            BlockSize { "64 KiB", 64 * 1024 },
+            BlockSize { "1 MiB",  1024 * 1024 },
+        };
+
+        int m_hashIndex = 1;
+        int m_blockSizeIndex = 2;
+
+        static inline std::mutex s_treesMutex;
+        static inline std::map<std::tuple<prv::Provider *, int, u64>, std::shared_ptr<TreeEntry>> s_trees;
+    };
+
     void registerHashes() {
         ContentRegistry::Hashes::add<HashMD5>();
 
@@ -131,9 +295,15 @@ namespace hex::plugin::builtin {
         ContentRegistry::Hashes::add<HashSHA384>();
         ContentRegistry::Hashes::add<HashSHA512>();
 
-        ContentRegistry::Hashes::add<HashCRC<u16>>("hex.builtin.hash.crc8",  crypt::crc8,  0x07,        0x0000,      0x0000);
-        ContentRegistry::Hashes::add<HashCRC<u16>>("hex.builtin.hash.crc16", crypt::crc16, 0x8005,      0x0000,      0x0000);
-        ContentRegistry::Hashes::add<HashCRC<u32>>("hex.builtin.hash.crc32", crypt::crc32, 0x04C1'1DB7, 0xFFFF'FFFF, 0xFFFF'FFFF);
+        ContentRegistry::Hashes::add<HashCRC>("hex.builtin.hash.crc8",  crypt::createCRC8Context,  0x07,        0x0000,      0x0000);
+        ContentRegistry::Hashes::add<HashCRC>("hex.builtin.hash.crc16", crypt::createCRC16Context, 0x8005,      0x0000,      0x0000);
+        ContentRegistry::Hashes::add<HashCRC>("hex.builtin.hash.crc32", crypt::createCRC32Context, 0x04C1'1DB7, 0xFFFF'FFFF, 0xFFFF'FFFF);
+
+        ContentRegistry::Hashes::add<HashSsdeep>();
+        ContentRegistry::Hashes::add<HashTLSH>();
+
+        ContentRegistry::Hashes::add<HashMerkleTree>();
+        HashMerkleTree::registerEvents();
 
     }
 
@@ -125,44 +125,36 @@ namespace hex::plugin::builtin {
                 if (ImGui::MenuItem("hex.builtin.menu.file.import.ips"_lang, nullptr, false)) {
 
                     fs::openFileBrowser(fs::DialogMode::Open, {}, [](const auto &path) {
-                        TaskManager::createTask("hex.builtin.common.processing", TaskManager::NoProgress, [path](auto &task) {
+                        TaskManager::createTask("hex.builtin.common.processing", TaskManager::NoProgress, [path](auto &) {
                             auto patchData = fs::File(path, fs::File::Mode::Read).readBytes();
                             auto patch     = hex::loadIPSPatch(patchData);
 
-                            task.setMaxValue(patch.size());
-
                             auto provider = ImHexApi::Provider::get();
 
-                            u64 progress = 0;
-                            for (auto &[address, value] : patch) {
-                                provider->addPatch(address, &value, 1);
-                                progress++;
-                                task.update(progress);
-                            }
-
-                            provider->createUndoPoint();
+                            // All patches get applied at once on the main thread so they share a single undo point and data change
+                            TaskManager::doLater([provider, patches = std::vector<std::pair<u64, u8>>(patch.begin(), patch.end())] {
+                                const auto &providers = ImHexApi::Provider::getProviders();
+                                if (std::find(providers.begin(), providers.end(), provider) != providers.end())
+                                    provider->addPatches(patches);
+                            });
                         });
                     });
                 }
 
                 if (ImGui::MenuItem("hex.builtin.menu.file.import.ips32"_lang, nullptr, false)) {
                     fs::openFileBrowser(fs::DialogMode::Open, {}, [](const auto &path) {
-                        TaskManager::createTask("hex.builtin.common.processing", TaskManager::NoProgress, [path](auto &task) {
+                        TaskManager::createTask("hex.builtin.common.processing", TaskManager::NoProgress, [path](auto &) {
                             auto patchData = fs::File(path, fs::File::Mode::Read).readBytes();
                             auto patch     = hex::loadIPS32Patch(patchData);
 
-                            task.setMaxValue(patch.size());
-
                             auto provider = ImHexApi::Provider::get();
 
-                            u64 progress = 0;
-                            for (auto &[address, value] : patch) {
-                                provider->addPatch(address, &value, 1);
-                                progress++;
-                                task.update(progress);
-                            }
-
-                            provider->createUndoPoint();
+                            // All patches get applied at once on the main thread so they share a single undo point and data change
+                            TaskManager::doLater([provider, patches = std::vector<std::pair<u64, u8>>(patch.begin(), patch.end())] {
+                                const auto &providers = ImHexApi::Provider::getProviders();
+                                if (std::find(providers.begin(), providers.end(), provider) != providers.end())
+                                    provider->addPatches(patches);
+                            });
                         });
                     });
                 }
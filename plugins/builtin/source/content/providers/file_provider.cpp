@@ -43,9 +43,10 @@ namespace hex::plugin::builtin::prv {
 
         this->readRaw(offset - this->getBaseAddress(), buffer, size);
 
-        for (u64 i = 0; i < size; i++)
-            if (getPatches().contains(offset + i))
-                reinterpret_cast<u8 *>(buffer)[i] = getPatches()[offset + PageSize * this->m_currPage + i];
+        // Only visit the patches inside of the read region instead of looking up every single byte
+        const auto &patches = getPatches();
+        for (auto it = patches.lower_bound(offset); it != patches.end() && it->first < offset + size; ++it)
+            reinterpret_cast<u8 *>(buffer)[it->first - offset] = it->second;
 
         if (overlays)
             this->applyOverlays(offset, buffer, size);
@@ -96,6 +97,15 @@ namespace hex::plugin::builtin::prv {
     }
 
     void FileProvider::resize(size_t newSize) {
+        const auto oldSize = this->getActualSize();
+
+        this->resizeFile(newSize);
+
+        if (oldSize != newSize)
+            this->markDataChanged(this->getBaseAddress() + std::min(oldSize, newSize), std::max(oldSize, newSize) - std::min(oldSize, newSize));
+    }
+
+    void FileProvider::resizeFile(size_t newSize) {
         this->close();
 
         {
@@ -106,11 +116,12 @@ namespace hex::plugin::builtin::prv {
         }
 
         (void)this->open();
+        this->markDirty();
     }
 
     void FileProvider::insert(u64 offset, size_t size) {
         auto oldSize = this->getActualSize();
-        this->resize(oldSize + size);
+        this->resizeFile(oldSize + size);
 
         std::vector<u8> buffer(0x1000);
         const std::vector<u8> zeroBuffer(0x1000);
@@ -131,7 +142,6 @@ namespace hex::plugin::builtin::prv {
 
     void FileProvider::remove(u64 offset, size_t size) {
         auto oldSize = this->getActualSize();
-        this->resize(oldSize + size);
 
         std::vector<u8> buffer(0x1000);
 
@@ -146,9 +156,9 @@ namespace hex::plugin::builtin::prv {
             position += readSize;
         }
 
-        this->resize(newSize);
+        this->resizeFile(newSize);
 
-        Provider::insert(offset, size);
+        Provider::remove(offset, size);
     }
 
     size_t FileProvider::getRealTimeSize() {
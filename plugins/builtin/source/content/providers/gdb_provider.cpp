@@ -47,7 +47,7 @@ namespace hex::plugin::builtin::prv {
                 std::string data     = packet.substr(1, packet.length() - 4);
                 std::string checksum = packet.substr(packet.length() - 2, 2);
 
-                if (checksum.length() != 2 || crypt::decode16(checksum)[0] != calculateChecksum(data))
+                if (checksum.length() != 2 || crypt::decode16(checksum) != std::vector<u8>{ calculateChecksum(data) })
                     return std::nullopt;
 
                 return data;
@@ -76,18 +76,20 @@ namespace hex::plugin::builtin::prv {
             if (receivedData->size() == 3 && receivedData->starts_with("E"))
                 return {};
 
-            auto data = crypt::decode16(receivedData.value());
-
-            data.resize(size);
+            // Decode straight into the result, bytes missing from the response stay zero
+            std::vector<u8> data(size);
+            try {
+                crypt::decode16(std::string_view(receivedData.value()).substr(0, size * 2), data);
+            } catch (const std::invalid_argument &) {
+                return {};
+            }
 
             return data;
         }
 
         void writeMemory(Socket &socket, u64 address, const void *buffer, size_t size) {
-            std::vector<u8> bytes(size);
-            std::memcpy(bytes.data(), buffer, size);
-
-            std::string byteString = crypt::encode16(bytes);
+            std::string byteString(size * 2, '\0');
+            crypt::encode16({ static_cast<const u8 *>(buffer), size }, byteString);
 
             std::string packet = createPacket(hex::format("M{:X},{:X}:{}", address, size, byteString));
 
@@ -178,9 +180,10 @@ namespace hex::plugin::builtin::prv {
             }
         }
 
-        for (u64 i = 0; i < size; i++)
-            if (getPatches().contains(offset + i))
-                reinterpret_cast<u8 *>(buffer)[i] = getPatches()[offset + PageSize * this->m_currPage + i];
+        // Only visit the patches inside of the read region instead of looking up every single byte
+        const auto &patches = getPatches();
+        for (auto it = patches.lower_bound(offset); it != patches.end() && it->first < offset + size; ++it)
+            reinterpret_cast<u8 *>(buffer)[it->first - offset] = it->second;
 
         if (overlays)
             this->applyOverlays(offset, buffer, size);
@@ -190,9 +193,9 @@ namespace hex::plugin::builtin::prv {
         if ((offset - this->getBaseAddress()) > (this->getActualSize() - size) || buffer == nullptr || size == 0)
             return;
 
-        offset -= this->getBaseAddress();
+        gdb::writeMemory(this->m_socket, offset - this->getBaseAddress(), buffer, size);
 
-        gdb::writeMemory(this->m_socket, offset, buffer, size);
+        this->markDataChanged(offset, size);
     }
 
     void GDBProvider::readRaw(u64 offset, void *buffer, size_t size) {
@@ -7,6 +7,7 @@
 #include <hex/helpers/file.hpp>
 #include <hex/helpers/literals.hpp>
 #include <hex/helpers/fs.hpp>
+#include <hex/helpers/similarity_hash.hpp>
 #include <hex/api/localization.hpp>
 
 #include <hex/ui/view.hpp>
@@ -1346,6 +1347,149 @@ namespace hex::plugin::builtin {
             }
         }
 
+        void drawSimilarityHashComparer() {
+            struct Entry {
+                std::string name;
+                std::string digest;
+                std::optional<u32> score;
+            };
+
+            enum class HashType : int { Ssdeep, TLSH };
+
+            static HashType hashType = HashType::Ssdeep;
+            static std::string digestList;
+            static std::string currentDigest;
+            static std::vector<Entry> entries;
+            static TaskHolder hashTask;
+
+            ImGui::TextFormattedWrapped("{}", "hex.builtin.tools.similarity.description"_lang);
+            ImGui::NewLine();
+
+            ImGui::BeginDisabled(hashTask.isRunning());
+            {
+                ImGui::RadioButton("ssdeep", reinterpret_cast<int *>(&hashType), int(HashType::Ssdeep));
+                ImGui::SameLine();
+                ImGui::RadioButton("TLSH", reinterpret_cast<int *>(&hashType), int(HashType::TLSH));
+
+                ImGui::InputTextMultiline("hex.builtin.tools.similarity.digests"_lang, digestList, ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 6));
+                ImGui::InfoTooltip("hex.builtin.tools.similarity.digests.help"_lang);
+
+                ImGui::BeginDisabled(!ImHexApi::Provider::isValid());
+                if (ImGui::Button("hex.builtin.tools.similarity.compare"_lang)) {
+                    auto provider = ImHexApi::Provider::get();
+
+                    // The current provider is compared against all other open ones and all digests from the list
+                    std::vector<prv::Provider *> others;
+                    u64 totalSize = provider->getActualSize();
+                    for (auto other : ImHexApi::Provider::getProviders()) {
+                        if (other != provider && other->isAvailable() && other->isReadable()) {
+                            others.push_back(other);
+                            totalSize += other->getActualSize();
+                        }
+                    }
+
+                    std::vector<Entry> listEntries;
+                    for (auto line : hex::splitString(digestList, "\n")) {
+                        hex::trim(line);
+                        if (line.empty())
+                            continue;
+
+                        // Both ssdeep and the TLSH tools print the name of the file after the digest
+                        const auto separator = line.find_first_of(",\t ");
+                        auto name = separator == std::string::npos ? "" : line.substr(separator + 1);
+                        name.erase(std::remove(name.begin(), name.end(), '"'), name.end());
+                        hex::trim(name);
+
+                        listEntries.push_back({ name, line.substr(0, separator), std::nullopt });
+                    }
+
+                    entries.clear();
+                    currentDigest.clear();
+
+                    hashTask = TaskManager::createTask("hex.builtin.tools.similarity.hashing", totalSize, [provider, others = std::move(others), listEntries = std::move(listEntries), type = hashType](auto &task) mutable {
+                        u64 progress = 0;
+                        auto hashProvider = [&](prv::Provider *hashedProvider) {
+                            auto context = type == HashType::Ssdeep ? crypt::createSsdeepContext() : crypt::createTlshContext();
+
+                            crypt::updateAll({ context.get() }, hashedProvider->getBaseAddress(), hashedProvider->getActualSize(),
+                                [hashedProvider](u64 offset, std::span<u8> buffer) {
+                                    hashedProvider->read(offset, buffer.data(), buffer.size());
+                                },
+                                [&](u64 processedBytes) {
+                                    task.update(progress + processedBytes);
+                                });
+
+                            progress += hashedProvider->getActualSize();
+
+                            auto digest = context->finish();
+                            return std::string(digest.begin(), digest.end());
+                        };
+
+                        auto compare = [type](const std::string &left, const std::string &right) {
+                            return type == HashType::Ssdeep ? crypt::compareSsdeep(left, right) : crypt::compareTlsh(left, right);
+                        };
+
+                        auto digest = hashProvider(provider);
+
+                        std::vector<Entry> results;
+                        for (auto other : others) {
+                            auto otherDigest = hashProvider(other);
+                            results.push_back({ other->getName(), otherDigest, compare(digest, otherDigest) });
+                        }
+
+                        for (auto &entry : listEntries) {
+                            entry.score = compare(digest, entry.digest);
+                            results.push_back(std::move(entry));
+                        }
+
+                        TaskManager::doLater([digest = std::move(digest), results = std::move(results)]() mutable {
+                            currentDigest = std::move(digest);
+                            entries = std::move(results);
+                        });
+                    });
+                }
+                ImGui::EndDisabled();
+            }
+            ImGui::EndDisabled();
+
+            if (hashTask.isRunning()) {
+                ImGui::SameLine();
+                ImGui::TextSpinner("hex.builtin.tools.similarity.hashing"_lang);
+            }
+
+            if (currentDigest.empty() && entries.empty())
+                return;
+
+            ImGui::NewLine();
+            ImGui::TextUnformatted("hex.builtin.tools.similarity.current"_lang);
+            ImGui::SameLine();
+            ImGui::TextFormatted("{}", currentDigest.empty() ? "hex.builtin.hash.tlsh.too_short"_lang.get() : currentDigest);
+
+            if (ImGui::BeginTable("##similarity", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 10))) {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("hex.builtin.tools.similarity.name"_lang);
+                ImGui::TableSetupColumn("hex.builtin.tools.similarity.digest"_lang);
+                ImGui::TableSetupColumn(hashType == HashType::Ssdeep ? "hex.builtin.tools.similarity.score"_lang : "hex.builtin.tools.similarity.distance"_lang);
+
+                ImGui::TableHeadersRow();
+
+                for (const auto &entry : entries) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextFormatted("{}", entry.name);
+                    ImGui::TableNextColumn();
+                    ImGui::TextFormatted("{}", entry.digest);
+                    ImGui::TableNextColumn();
+                    if (entry.score.has_value())
+                        ImGui::TextFormatted("{}", *entry.score);
+                    else
+                        ImGui::TextUnformatted("hex.builtin.tools.similarity.invalid"_lang);
+                }
+
+                ImGui::EndTable();
+            }
+        }
+
     }
 
     void registerToolEntries() {
@@ -1360,6 +1504,7 @@ namespace hex::plugin::builtin {
         ContentRegistry::Tools::add("hex.builtin.tools.wiki_explain", drawWikiExplainer);
         ContentRegistry::Tools::add("hex.builtin.tools.file_tools", drawFileTools);
         ContentRegistry::Tools::add("hex.builtin.tools.ieee756", drawIEEE756Helper);
+        ContentRegistry::Tools::add("hex.builtin.tools.similarity", drawSimilarityHashComparer);
     }
 
 }
\ No newline at end of file
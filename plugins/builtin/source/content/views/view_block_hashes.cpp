@@ -0,0 +1,444 @@
+#include "content/views/view_block_hashes.hpp"
+
+#include <hex/api/imhex_api.hpp>
+#include <hex/providers/provider.hpp>
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/file.hpp>
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/literals.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace hex::plugin::builtin {
+
+    using namespace hex::literals;
+
+    namespace {
+
+        constexpr std::array BlockSizes = { 512_Bytes, 4_KiB, 64_KiB, 1_MiB, 16_MiB };
+
+        color_t getHighlightColor() {
+            return (ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarRed) & 0x00FFFFFF) | 0x50000000;
+        }
+
+        // Block lists only store the name of their hash type since they can also come from a file
+        const ContentRegistry::Hashes::Hash *findHashType(const std::string &unlocalizedName) {
+            for (const auto hash : ContentRegistry::Hashes::impl::getHashes()) {
+                if (hash->getUnlocalizedName() == unlocalizedName)
+                    return hash;
+            }
+
+            return nullptr;
+        }
+
+        // Hashes `size` bytes starting `offset` bytes into the provider
+        std::vector<std::vector<u8>> hashProviderBlocks(Task &task, u64 &progressBase, prv::Provider *provider, const crypt::ContextFactory &createContext, u64 offset, u64 size, u64 blockSize) {
+            const auto result = crypt::hashBlocks(createContext, provider->getBaseAddress() + offset, size, blockSize,
+                [provider](u64 address, std::span<u8> buffer) {
+                    provider->read(address, buffer.data(), buffer.size());
+                },
+                [&task, progressBase](u64 processedBytes) {
+                    task.update(progressBase + processedBytes);
+                });
+
+            progressBase += size;
+
+            return result;
+        }
+
+    }
+
+    ViewBlockHashes::ViewBlockHashes() : View("hex.builtin.view.block_hashes.name") {
+        EventManager::subscribe<EventProviderClosed>(this, [this](prv::Provider *) {
+            this->m_referenceProviderIndex = -1;
+        });
+
+        EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+            if (provider != this->m_provider && provider != this->m_referenceProvider)
+                return;
+
+            this->m_hashTask.interrupt();
+            this->m_hashGeneration++;
+
+            if (provider == this->m_provider) {
+                this->m_provider = nullptr;
+                this->m_blocks.reset();
+            }
+
+            this->m_referenceProvider = nullptr;
+            this->m_reference.reset();
+            this->m_differingBlocks.clear();
+        });
+
+        ImHexApi::HexEditor::addBackgroundHighlightingProvider([this](u64 address, const u8 *data, size_t size) -> std::optional<color_t> {
+            hex::unused(data, size);
+
+            if (this->isDiffering(address))
+                return getHighlightColor();
+            else
+                return std::nullopt;
+        });
+    }
+
+    ViewBlockHashes::~ViewBlockHashes() {
+        EventManager::unsubscribe<EventProviderClosed>(this);
+        EventManager::unsubscribe<EventProviderDeleted>(this);
+    }
+
+    bool ViewBlockHashes::isDiffering(u64 address) const {
+        if (this->m_differingBlocks.empty() || !this->m_blocks.has_value())
+            return false;
+
+        // Differing blocks are highlighted in both the hashed provider and the one it was compared to
+        auto provider = ImHexApi::Provider::get();
+        if (provider == nullptr || (provider != this->m_provider && provider != this->m_referenceProvider))
+            return false;
+
+        const auto offset      = this->m_blocks->region.getStartAddress() - this->m_provider->getBaseAddress();
+        const auto startOffset = provider->getBaseAddress() + offset;
+        if (address < startOffset)
+            return false;
+
+        const auto block = (address - startOffset) / this->m_blocks->blockSize;
+
+        return std::binary_search(this->m_differingBlocks.begin(), this->m_differingBlocks.end(), block);
+    }
+
+    bool ViewBlockHashes::isComparable(const BlockList &reference, prv::Provider *referenceProvider) const {
+        // Blocks loaded from a file are compared at the addresses they were exported from
+        const auto offset          = this->m_blocks->region.getStartAddress() - this->m_provider->getBaseAddress();
+        const auto referenceOffset = reference.region.getStartAddress() - (referenceProvider != nullptr ? referenceProvider : this->m_provider)->getBaseAddress();
+
+        return reference.hashType == this->m_blocks->hashType && reference.blockSize == this->m_blocks->blockSize && referenceOffset == offset;
+    }
+
+    Region ViewBlockHashes::getBlockRegion(u64 block) const {
+        const auto &region = this->m_blocks->region;
+        const auto offset  = block * this->m_blocks->blockSize;
+
+        return { region.getStartAddress() + offset, std::min<u64>(this->m_blocks->blockSize, region.getSize() - offset) };
+    }
+
+    void ViewBlockHashes::startHashing(prv::Provider *provider, prv::Provider *reference) {
+        if (this->m_selectedHash == nullptr)
+            return;
+
+        auto function = this->m_selectedHash->create(this->m_selectedHash->getUnlocalizedName());
+        if (function.createContext() == nullptr) {
+            View::showErrorPopup("hex.builtin.view.block_hashes.error.unsupported"_lang);
+            return;
+        }
+
+        Region region = { provider->getBaseAddress(), provider->getActualSize() };
+        if (auto selection = ImHexApi::HexEditor::getSelection(); this->m_onlySelection && selection.has_value())
+            region = *selection;
+
+        if (region.getSize() == 0)
+            return;
+
+        this->m_hashTask.interrupt();
+        this->m_hashGeneration++;
+
+        this->m_provider    = provider;
+        this->m_dataVersion = provider->getDataVersion();
+        this->m_blocks.reset();
+        this->m_differingBlocks.clear();
+
+        // Blocks loaded from a file stay the reference, they get compared again once the new blocks are done
+        if (reference != nullptr || this->m_referenceProvider != nullptr) {
+            this->m_referenceProvider = reference;
+            this->m_reference.reset();
+            this->m_referenceName.clear();
+        }
+
+        // The reference provider gets hashed over the same offsets, as far as its data reaches
+        const u64 offset = region.getStartAddress() - provider->getBaseAddress();
+        u64 referenceSize = 0;
+        if (reference != nullptr && offset < reference->getActualSize()) {
+            referenceSize = std::min<u64>(region.getSize(), reference->getActualSize() - offset);
+
+            this->m_referenceDataVersion = reference->getDataVersion();
+            this->m_referenceName        = reference->getName();
+        }
+
+        BlockList blocks = { this->m_selectedHash->getUnlocalizedName(), region, BlockSizes[this->m_blockSizeIndex], { } };
+
+        this->m_hashTask = TaskManager::createTask("hex.builtin.view.block_hashes.calculating", region.getSize() + referenceSize, [this, provider, reference, offset, referenceSize, function, blocks = std::move(blocks), generation = this->m_hashGeneration](auto &task) mutable {
+            auto createContext = [&function] { return function.createContext(); };
+
+            u64 progress = 0;
+            blocks.hashes = hashProviderBlocks(task, progress, provider, createContext, offset, blocks.region.getSize(), blocks.blockSize);
+
+            std::optional<BlockList> referenceBlocks;
+            if (reference != nullptr) {
+                referenceBlocks = BlockList { blocks.hashType, { reference->getBaseAddress() + offset, referenceSize }, blocks.blockSize, { } };
+                referenceBlocks->hashes = hashProviderBlocks(task, progress, reference, createContext, offset, referenceSize, blocks.blockSize);
+            }
+
+            TaskManager::doLater([this, generation, blocks = std::move(blocks), referenceBlocks = std::move(referenceBlocks)]() mutable {
+                if (generation != this->m_hashGeneration)
+                    return;
+
+                this->m_blocks = std::move(blocks);
+                if (referenceBlocks.has_value())
+                    this->m_reference = std::move(referenceBlocks);
+
+                this->compareBlocks();
+            });
+        });
+    }
+
+    void ViewBlockHashes::compareBlocks() {
+        this->m_differingBlocks.clear();
+
+        if (!this->m_blocks.has_value() || !this->m_reference.has_value())
+            return;
+
+        // Blocks can only be compared if they were calculated the same way and start at the same address
+        if (!this->isComparable(*this->m_reference, this->m_referenceProvider))
+            return;
+
+        const auto &hashes    = this->m_blocks->hashes;
+        const auto &reference = this->m_reference->hashes;
+
+        // Blocks that only exist on one side count as differing as well
+        for (u64 block = 0; block < std::max(hashes.size(), reference.size()); block++) {
+            if (block >= hashes.size() || block >= reference.size() || hashes[block] != reference[block])
+                this->m_differingBlocks.push_back(block);
+        }
+    }
+
+    void ViewBlockHashes::exportBlocks(const std::fs::path &path) const {
+        nlohmann::json json;
+        json["hash"]       = this->m_blocks->hashType;
+        json["address"]    = this->m_blocks->region.getStartAddress();
+        json["size"]       = this->m_blocks->region.getSize();
+        json["block_size"] = this->m_blocks->blockSize;
+
+        auto &hashes = json["blocks"] = nlohmann::json::array();
+        for (const auto &hash : this->m_blocks->hashes)
+            hashes.push_back(crypt::encode16(hash));
+
+        fs::File(path, fs::File::Mode::Create).write(json.dump(4));
+    }
+
+    void ViewBlockHashes::importReference(const std::fs::path &path) {
+        BlockList blocks;
+
+        try {
+            auto json = nlohmann::json::parse(fs::File(path, fs::File::Mode::Read).readString());
+
+            blocks.hashType  = json["hash"].get<std::string>();
+            blocks.region    = { json["address"].get<u64>(), json["size"].get<u64>() };
+            blocks.blockSize = json["block_size"].get<u64>();
+
+            for (const auto &hash : json["blocks"])
+                blocks.hashes.push_back(crypt::decode16(hash.get<std::string>()));
+        } catch (const nlohmann::json::exception &) {
+            View::showErrorPopup("hex.builtin.view.block_hashes.error.invalid_file"_lang);
+            return;
+        }
+
+        if (!this->isComparable(blocks, nullptr)) {
+            View::showErrorPopup("hex.builtin.view.block_hashes.error.mismatch"_lang);
+            return;
+        }
+
+        this->m_referenceProvider = nullptr;
+        this->m_referenceName     = path.filename().string();
+        this->m_reference         = std::move(blocks);
+
+        this->compareBlocks();
+    }
+
+    void ViewBlockHashes::drawSettings() {
+        const auto &hashes = ContentRegistry::Hashes::impl::getHashes();
+
+        if (this->m_selectedHash == nullptr && !hashes.empty())
+            this->m_selectedHash = hashes.front();
+
+        if (ImGui::BeginCombo("hex.builtin.view.hashes.function"_lang, this->m_selectedHash != nullptr ? LangEntry(this->m_selectedHash->getUnlocalizedName()) : "")) {
+            for (const auto hash : hashes) {
+                if (ImGui::Selectable(LangEntry(hash->getUnlocalizedName()), this->m_selectedHash == hash))
+                    this->m_selectedHash = hash;
+            }
+
+            ImGui::EndCombo();
+        }
+
+        if (ImGui::BeginChild("##settings", ImVec2(ImGui::GetContentRegionAvail().x, 150_scaled), true)) {
+            if (this->m_selectedHash != nullptr) {
+                auto startPos = ImGui::GetCursorPosY();
+                this->m_selectedHash->draw();
+
+                if (startPos == ImGui::GetCursorPosY())
+                    ImGui::TextFormattedCentered("hex.builtin.view.hashes.no_settings"_lang);
+            }
+        }
+        ImGui::EndChild();
+
+        if (ImGui::BeginCombo("hex.builtin.view.block_hashes.block_size"_lang, hex::toByteString(BlockSizes[this->m_blockSizeIndex]).c_str())) {
+            for (u32 i = 0; i < BlockSizes.size(); i++) {
+                if (ImGui::Selectable(hex::toByteString(BlockSizes[i]).c_str(), i == this->m_blockSizeIndex))
+                    this->m_blockSizeIndex = i;
+            }
+
+            ImGui::EndCombo();
+        }
+
+        ImGui::Checkbox("hex.builtin.view.block_hashes.only_selection"_lang, &this->m_onlySelection);
+
+        auto provider = ImHexApi::Provider::get();
+        const auto &providers = ImHexApi::Provider::getProviders();
+
+        ImGui::BeginDisabled(provider == nullptr || this->m_hashTask.isRunning());
+        {
+            if (ImGui::Button("hex.builtin.view.block_hashes.calculate"_lang))
+                this->startHashing(provider, nullptr);
+
+            ImGui::SameLine();
+
+            // Another provider is hashed together with the current one so both use the same settings
+            std::string preview;
+            if (this->m_referenceProviderIndex >= 0 && u32(this->m_referenceProviderIndex) < providers.size())
+                preview = providers[this->m_referenceProviderIndex]->getName();
+
+            ImGui::SetNextItemWidth(200_scaled);
+            if (ImGui::BeginCombo("##reference_provider", preview.c_str())) {
+                for (u32 i = 0; i < providers.size(); i++) {
+                    if (providers[i] == provider)
+                        continue;
+
+                    ImGui::PushID(i);
+                    if (ImGui::Selectable(providers[i]->getName().c_str(), int(i) == this->m_referenceProviderIndex))
+                        this->m_referenceProviderIndex = i;
+                    ImGui::PopID();
+                }
+
+                ImGui::EndCombo();
+            }
+
+            ImGui::SameLine();
+
+            const bool referenceValid = this->m_referenceProviderIndex >= 0 && u32(this->m_referenceProviderIndex) < providers.size() && providers[this->m_referenceProviderIndex] != provider;
+            ImGui::BeginDisabled(!referenceValid);
+            if (ImGui::Button("hex.builtin.view.block_hashes.compare_provider"_lang))
+                this->startHashing(provider, providers[this->m_referenceProviderIndex]);
+            ImGui::EndDisabled();
+        }
+        ImGui::EndDisabled();
+
+        ImGui::BeginDisabled(!this->m_blocks.has_value());
+        {
+            if (ImGui::Button("hex.builtin.view.block_hashes.export"_lang)) {
+                fs::openFileBrowser(fs::DialogMode::Save, { { "Block Hashes", "hexbh" } }, [this](const std::fs::path &path) {
+                    this->exportBlocks(path);
+                });
+            }
+
+            ImGui::SameLine();
+
+            if (ImGui::Button("hex.builtin.view.block_hashes.compare_file"_lang)) {
+                fs::openFileBrowser(fs::DialogMode::Open, { { "Block Hashes", "hexbh" } }, [this](const std::fs::path &path) {
+                    this->importReference(path);
+                });
+            }
+        }
+        ImGui::EndDisabled();
+    }
+
+    void ViewBlockHashes::drawBlockList() {
+        if (this->m_hashTask.isRunning()) {
+            ImGui::TextSpinner("hex.builtin.view.block_hashes.calculating"_lang);
+            return;
+        }
+
+        if (!this->m_blocks.has_value())
+            return;
+
+        if (this->m_provider->getDataVersion() != this->m_dataVersion || (this->m_referenceProvider != nullptr && this->m_referenceProvider->getDataVersion() != this->m_referenceDataVersion))
+            ImGui::TextFormattedColored(ImGui::GetCustomColorVec4(ImGuiCustomCol_ToolbarYellow), "{}", "hex.builtin.view.block_hashes.outdated"_lang);
+
+        if (this->m_reference.has_value()) {
+            ImGui::TextFormatted("hex.builtin.view.block_hashes.differing"_lang, this->m_differingBlocks.size(), std::max(this->m_blocks->hashes.size(), this->m_reference->hashes.size()), this->m_referenceName);
+            ImGui::Checkbox("hex.builtin.view.block_hashes.only_differing"_lang, &this->m_onlyDifferingBlocks);
+        }
+
+        const bool showReference = this->m_reference.has_value();
+        const bool onlyDiffering = showReference && this->m_onlyDifferingBlocks;
+
+        if (ImGui::BeginTable("##blocks", showReference ? 4 : 3, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("hex.builtin.view.block_hashes.block"_lang);
+            ImGui::TableSetupColumn("hex.builtin.common.region"_lang);
+            ImGui::TableSetupColumn("hex.builtin.view.hashes.result"_lang);
+            if (showReference)
+                ImGui::TableSetupColumn("hex.builtin.view.block_hashes.reference"_lang);
+
+            ImGui::TableHeadersRow();
+
+            const auto hashType = findHashType(this->m_blocks->hashType);
+            auto format = [hashType](const std::vector<u8> &hash) {
+                return hashType != nullptr ? hashType->format(hash) : crypt::encode16(hash);
+            };
+
+            const auto &hashes    = this->m_blocks->hashes;
+            const auto blockCount = onlyDiffering ? this->m_differingBlocks.size() : std::max(hashes.size(), showReference ? this->m_reference->hashes.size() : 0);
+
+            ImGuiListClipper clipper;
+            clipper.Begin(blockCount, ImGui::GetTextLineHeightWithSpacing());
+
+            while (clipper.Step()) {
+                for (u64 i = clipper.DisplayStart; i < std::min<u64>(clipper.DisplayEnd, blockCount); i++) {
+                    const auto block = onlyDiffering ? this->m_differingBlocks[i] : i;
+                    const bool differing = showReference && std::binary_search(this->m_differingBlocks.begin(), this->m_differingBlocks.end(), block);
+
+                    ImGui::TableNextRow();
+                    if (differing)
+                        ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, getHighlightColor());
+
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(block);
+                    if (ImGui::Selectable(hex::format("{}", block).c_str(), false, ImGuiSelectableFlags_SpanAllColumns) && block < hashes.size())
+                        ImHexApi::HexEditor::setSelection(this->getBlockRegion(block));
+                    ImGui::PopID();
+
+                    ImGui::TableNextColumn();
+                    if (block < hashes.size()) {
+                        const auto region = this->getBlockRegion(block);
+                        ImGui::TextFormatted("0x{:08X} - 0x{:08X}", region.getStartAddress(), region.getEndAddress());
+                    }
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextFormatted("{}", block < hashes.size() ? format(hashes[block]) : "-");
+
+                    if (showReference) {
+                        const auto &reference = this->m_reference->hashes;
+
+                        ImGui::TableNextColumn();
+                        ImGui::TextFormatted("{}", block < reference.size() ? format(reference[block]) : "-");
+                    }
+                }
+            }
+            clipper.End();
+
+            ImGui::EndTable();
+        }
+    }
+
+    void ViewBlockHashes::drawContent() {
+        if (ImGui::Begin(View::toWindowName("hex.builtin.view.block_hashes.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
+            this->drawSettings();
+
+            ImGui::Separator();
+            ImGui::NewLine();
+
+            this->drawBlockList();
+        }
+        ImGui::End();
+    }
+
+}
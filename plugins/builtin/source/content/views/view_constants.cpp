@@ -17,9 +17,8 @@ namespace hex::plugin::builtin {
         std::memset(this->m_filter.data(), 0x00, this->m_filter.capacity());
     }
 
-    void ViewConstants::reloadConstants() {
-        this->m_constants.clear();
-        this->m_filterIndices.clear();
+    std::vector<Constant> ViewConstants::loadConstants() {
+        std::vector<Constant> constants;
 
         for (const auto &path : fs::getDefaultPaths(fs::ImHexPath::Constants)) {
             if (!fs::exists(path)) continue;
@@ -50,8 +49,7 @@ namespace hex::plugin::builtin {
                         else
                             throw std::runtime_error("Invalid type");
 
-                        this->m_filterIndices.push_back(this->m_constants.size());
-                        this->m_constants.push_back(constant);
+                        constants.push_back(constant);
                     }
                 } catch (...) {
                     log::error("Failed to parse constants file {}", file.path().string());
@@ -59,6 +57,16 @@ namespace hex::plugin::builtin {
                 }
             }
         }
+
+        return constants;
+    }
+
+    void ViewConstants::reloadConstants() {
+        this->m_constants = loadConstants();
+
+        this->m_filterIndices.clear();
+        for (u64 i = 0; i < this->m_constants.size(); i++)
+            this->m_filterIndices.push_back(i);
     }
 
     void ViewConstants::drawContent() {
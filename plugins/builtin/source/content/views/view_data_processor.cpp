@@ -14,6 +14,17 @@
 
 namespace hex::plugin::builtin {
 
+    namespace {
+
+        Region mergeRegions(const Region &a, const Region &b) {
+            const auto start = std::min(a.getStartAddress(), b.getStartAddress());
+            const auto end   = std::max(a.getStartAddress() + a.getSize(), b.getStartAddress() + b.getSize());
+
+            return { start, end - start };
+        }
+
+    }
+
     ViewDataProcessor::ViewDataProcessor() : View("hex.builtin.view.data_processor.name") {
         EventManager::subscribe<RequestChangeTheme>(this, [](u32 theme) {
             switch (theme) {
@@ -56,8 +67,18 @@ namespace hex::plugin::builtin {
             data.dataOverlays.clear();
         });
 
-        EventManager::subscribe<EventDataChanged>(this, [this] {
-            this->processNodes();
+        EventManager::subscribe<EventDataChanged>(this, [this](prv::Provider *provider, Region region) {
+            // Processing the nodes again because of the overlays they've just written would only write the same overlays again
+            auto overlayChange = this->m_overlayChanges.extract(provider);
+            if (!overlayChange.empty() && region.isWithin(overlayChange.mapped()))
+                return;
+
+            if (provider == ImHexApi::Provider::get())
+                this->processNodes();
+        });
+
+        EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+            this->m_overlayChanges.erase(provider);
         });
 
         ContentRegistry::Interface::addMenuItem("hex.builtin.menu.file", 3000, [&, this] {
@@ -99,6 +120,7 @@ namespace hex::plugin::builtin {
         EventManager::unsubscribe<RequestChangeTheme>(this);
         EventManager::unsubscribe<EventFileLoaded>(this);
         EventManager::unsubscribe<EventDataChanged>(this);
+        EventManager::unsubscribe<EventProviderDeleted>(this);
     }
 
 
@@ -153,6 +175,16 @@ namespace hex::plugin::builtin {
     void ViewDataProcessor::processNodes() {
         auto &data = ProviderExtraData::getCurrent().dataProcessor;
 
+        auto getOverlayContents = [&data] {
+            std::vector<std::pair<u64, std::vector<u8>>> contents;
+            for (auto overlay : data.dataOverlays)
+                contents.emplace_back(overlay->getAddress(), overlay->getData());
+
+            return contents;
+        };
+
+        const auto previousOverlays = getOverlayContents();
+
         if (data.dataOverlays.size() != data.endNodes.size()) {
             for (auto overlay : data.dataOverlays)
                 ImHexApi::Provider::get()->deleteOverlay(overlay);
@@ -189,6 +221,41 @@ namespace hex::plugin::builtin {
         } catch (std::runtime_error &e) {
             printf("Node implementation bug! %s\n", e.what());
         }
+
+        this->markOverlaysChanged(previousOverlays, getOverlayContents());
+    }
+
+    void ViewDataProcessor::markOverlaysChanged(const std::vector<std::pair<u64, std::vector<u8>>> &previous, const std::vector<std::pair<u64, std::vector<u8>>> &current) {
+        // Overlays are part of the data everything else reads, so the regions they covered before and cover now have changed
+        std::optional<Region> changedRegion;
+        auto addRegion = [&](u64 address, size_t size) {
+            if (size == 0)
+                return;
+
+            changedRegion = changedRegion.has_value() ? mergeRegions(*changedRegion, { address, size }) : Region { address, size };
+        };
+
+        for (size_t i = 0; i < std::max(previous.size(), current.size()); i++) {
+            if (i < previous.size() && i < current.size() && previous[i] == current[i])
+                continue;
+
+            if (i < previous.size())
+                addRegion(previous[i].first, previous[i].second.size());
+            if (i < current.size())
+                addRegion(current[i].first, current[i].second.size());
+        }
+
+        if (!changedRegion.has_value())
+            return;
+
+        auto provider = ImHexApi::Provider::get();
+        provider->markOverlayChanged(*changedRegion);
+
+        // Remember the change so the resulting EventDataChanged doesn't trigger processing the nodes again
+        if (auto existing = this->m_overlayChanges.find(provider); existing != this->m_overlayChanges.end())
+            existing->second = mergeRegions(existing->second, *changedRegion);
+        else
+            this->m_overlayChanges[provider] = *changedRegion;
     }
 
     void ViewDataProcessor::drawContent() {
@@ -1,26 +1,39 @@
 #include "content/views/view_find.hpp"
+#include "content/views/view_constants.hpp"
 
 #include <hex/api/imhex_api.hpp>
+#include <hex/api/project_file_manager.hpp>
 #include <hex/providers/buffered_reader.hpp>
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/literals.hpp>
+#include <hex/helpers/search.hpp>
+#include <hex/helpers/regex.hpp>
 
+#include <algorithm>
 #include <array>
-#include <regex>
+#include <charconv>
+#include <cstring>
+#include <mutex>
+#include <numeric>
 #include <string>
+#include <thread>
 #include <utility>
 
 #include <llvm/Demangle/Demangle.h>
 
 namespace hex::plugin::builtin {
 
+    using namespace hex::literals;
+
     ViewFind::ViewFind() : View("hex.builtin.view.find.name") {
         const static auto HighlightColor = [] { return (ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarPurple) & 0x00FFFFFF) | 0x70000000; };
 
         ImHexApi::HexEditor::addBackgroundHighlightingProvider([this](u64 address, const u8* data, size_t size) -> std::optional<color_t> {
             hex::unused(data, size);
 
-            auto provider = ImHexApi::Provider::get();
+            auto results = this->updateResults(ImHexApi::Provider::get());
 
-            if (!this->m_occurrenceTree[provider].findOverlapping(address, address).empty())
+            if (results != nullptr && results->index.overlaps(address))
                 return HighlightColor();
             else
                 return std::nullopt;
@@ -29,9 +42,12 @@ namespace hex::plugin::builtin {
         ImHexApi::HexEditor::addTooltipProvider([this](u64 address, const u8* data, size_t size) {
             hex::unused(data, size);
 
-            auto provider = ImHexApi::Provider::get();
+            auto results = this->updateResults(ImHexApi::Provider::get());
+            if (results == nullptr)
+                return;
 
-            auto occurrences = this->m_occurrenceTree[provider].findOverlapping(address, address);
+            std::vector<Occurrence> occurrences;
+            results->index.findOverlapping(address, [&](u32 index) { occurrences.push_back(results->get(index)); });
             if (occurrences.empty())
                 return;
 
@@ -44,7 +60,7 @@ namespace hex::plugin::builtin {
                     ImGui::TableNextColumn();
 
                     {
-                        const auto value = this->decodeValue(ImHexApi::Provider::get(), occurrence.value);
+                        const auto value = this->decodeValue(ImHexApi::Provider::get(), occurrence);
 
                         ImGui::ColorButton("##color", ImColor(HighlightColor()));
                         ImGui::SameLine(0, 10);
@@ -58,7 +74,7 @@ namespace hex::plugin::builtin {
                                 ImGui::TableNextColumn();
                                 ImGui::TextFormatted("{}: ", "hex.builtin.common.region"_lang.get());
                                 ImGui::TableNextColumn();
-                                ImGui::TextFormatted("[ 0x{:08X} - 0x{:08X} ]", occurrence.value.region.getStartAddress(), occurrence.value.region.getEndAddress());
+                                ImGui::TextFormatted("[ 0x{:08X} - 0x{:08X} ]", occurrence.region.getStartAddress(), occurrence.region.getEndAddress());
 
                                 auto demangledValue = llvm::demangle(value);
 
@@ -87,6 +103,308 @@ namespace hex::plugin::builtin {
 
             ImGui::EndTooltip();
         });
+
+        EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+            this->m_results.erase(provider);
+            this->m_searchIndices.erase(provider);
+            this->m_blocksChangedWhileIndexing.erase(provider);
+            if (auto unverified = this->m_unverifiedIndices.find(provider); unverified != this->m_unverifiedIndices.end()) {
+                unverified->second.task.interrupt();
+                this->m_unverifiedIndices.erase(unverified);
+            }
+            this->m_valueScanners.erase(provider);
+        });
+
+        // Blocks have to be remembered as soon as they change, a patch might get saved to the data and undone afterwards
+        EventManager::subscribe<EventDataChanged>(this, [this](prv::Provider *provider, Region region) {
+            if (auto changed = this->m_blocksChangedWhileIndexing.find(provider); changed != this->m_blocksChangedWhileIndexing.end() && this->m_indexTask.isRunning())
+                markChangedBlocks(provider, region, changed->second);
+
+            if (auto unverified = this->m_unverifiedIndices.find(provider); unverified != this->m_unverifiedIndices.end())
+                markChangedBlocks(provider, region, unverified->second.searchIndex.dirtyBlocks);
+
+            auto it = this->m_searchIndices.find(provider);
+            if (it == this->m_searchIndices.end())
+                return;
+
+            // Inserting or removing data moves everything after it, the index can't be used anymore in that case
+            auto &searchIndex = it->second;
+            if (searchIndex.index->getDataSize() != provider->getActualSize()) {
+                this->m_searchIndices.erase(it);
+                return;
+            }
+
+            markChangedBlocks(provider, region, searchIndex.dirtyBlocks);
+        });
+
+        ProjectFile::registerPerProviderHandler({
+            .basePath = "search_index.bin",
+            .load = [this](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) -> bool {
+                auto data = tar.read(basePath);
+                auto remaining = std::span<const u8>(data);
+
+                auto extract = [&remaining](void *value, size_t size) {
+                    if (remaining.size() < size)
+                        return false;
+
+                    std::memcpy(value, remaining.data(), size);
+                    remaining = remaining.subspan(size);
+
+                    return true;
+                };
+
+                // The index is stored after the blocks that were patched since it was built and the SHA-256 hashes of all blocks
+                constexpr static size_t BlockHashSize = 32;
+
+                u64 dirtyBlockCount = 0;
+                if (!extract(&dirtyBlockCount, sizeof(dirtyBlockCount)) || dirtyBlockCount > remaining.size() / sizeof(u64))
+                    return true;
+
+                SearchIndex searchIndex;
+                for (u64 i = 0; i < dirtyBlockCount; i++) {
+                    u64 block = 0;
+                    extract(&block, sizeof(block));
+                    searchIndex.dirtyBlocks.insert(block);
+                }
+
+                u64 blockHashCount = 0;
+                if (!extract(&blockHashCount, sizeof(blockHashCount)) || blockHashCount > remaining.size() / BlockHashSize)
+                    return true;
+
+                std::vector<std::vector<u8>> blockHashes(blockHashCount, std::vector<u8>(BlockHashSize));
+                for (auto &blockHash : blockHashes)
+                    extract(blockHash.data(), blockHash.size());
+
+                // An index that doesn't fit the data anymore is dropped, it can simply be built again
+                auto index = search::NGramIndex::deserialize(remaining);
+                if (!index.has_value() || index->getDataSize() != provider->getActualSize() || index->getBlockCount() != blockHashes.size())
+                    return true;
+
+                searchIndex.index       = std::make_shared<search::NGramIndex>(std::move(*index));
+                searchIndex.blockHashes = std::make_shared<std::vector<std::vector<u8>>>(std::move(blockHashes));
+
+                // The data might have been modified outside of ImHex since the project was saved
+                this->verifySearchIndex(provider, std::move(searchIndex));
+
+                return true;
+            },
+            .store = [this](prv::Provider *provider, const std::fs::path &basePath, Tar &tar) -> bool {
+                auto searchIndex = this->getSearchIndex(provider);
+
+                // An index that's still being verified gets verified again once the project is loaded the next time
+                if (auto unverified = this->m_unverifiedIndices.find(provider); !searchIndex.has_value() && unverified != this->m_unverifiedIndices.end())
+                    searchIndex = unverified->second.searchIndex;
+
+                if (!searchIndex.has_value())
+                    return true;
+
+                auto index = searchIndex->index->serialize();
+                if (index.size() > MaxStoredIndexSize)
+                    return true;
+
+                std::vector<u8> data;
+                auto append = [&data](const void *value, size_t size) {
+                    data.insert(data.end(), reinterpret_cast<const u8 *>(value), reinterpret_cast<const u8 *>(value) + size);
+                };
+
+                const u64 dirtyBlockCount = searchIndex->dirtyBlocks.size();
+                append(&dirtyBlockCount, sizeof(dirtyBlockCount));
+                for (u64 block : searchIndex->dirtyBlocks)
+                    append(&block, sizeof(block));
+
+                const u64 blockHashCount = searchIndex->blockHashes->size();
+                append(&blockHashCount, sizeof(blockHashCount));
+                for (const auto &blockHash : *searchIndex->blockHashes)
+                    append(blockHash.data(), blockHash.size());
+
+                data.insert(data.end(), index.begin(), index.end());
+
+                tar.write(basePath, data);
+
+                return true;
+            }
+        });
+    }
+
+    ViewFind::~ViewFind() {
+        EventManager::unsubscribe<EventProviderDeleted>(this);
+        EventManager::unsubscribe<EventDataChanged>(this);
+    }
+
+    void ViewFind::markPatchedBlocks(prv::Provider *provider, SearchIndex &index) {
+        const auto &patches = provider->getPatches();
+
+        for (const auto &[address, value] : patches) {
+            const auto offset = address - provider->getBaseAddress();
+            index.dirtyBlocks.insert(offset / search::NGramIndex::BlockSize);
+        }
+    }
+
+    void ViewFind::markChangedBlocks(prv::Provider *provider, Region region, std::set<u64> &blocks) {
+        const auto baseAddress = provider->getBaseAddress();
+        if (region.getSize() == 0 || region.getEndAddress() < baseAddress)
+            return;
+
+        const auto firstBlock = (std::max(region.getStartAddress(), baseAddress) - baseAddress) / search::NGramIndex::BlockSize;
+        const auto lastBlock  = (region.getEndAddress() - baseAddress) / search::NGramIndex::BlockSize;
+
+        for (auto block = firstBlock; block <= lastBlock; block++)
+            blocks.insert(block);
+    }
+
+    void ViewFind::buildSearchIndex(prv::Provider *provider) {
+        if (provider->getActualSize() == 0)
+            return;
+
+        // A freshly built index replaces one that's still being verified
+        if (auto unverified = this->m_unverifiedIndices.find(provider); unverified != this->m_unverifiedIndices.end()) {
+            unverified->second.task.interrupt();
+            this->m_unverifiedIndices.erase(unverified);
+        }
+
+        this->m_blocksChangedWhileIndexing[provider].clear();
+
+        this->m_indexTask = TaskManager::createTask("hex.builtin.view.find.index.building", provider->getActualSize(), [this, provider](auto &task) {
+            auto index = std::make_shared<search::NGramIndex>();
+            auto blockHashes = std::make_shared<std::vector<std::vector<u8>>>();
+
+            auto reader = prv::BufferedReader(provider);
+            reader.seek(provider->getBaseAddress());
+            reader.setEndAddress(provider->getBaseAddress() + provider->getActualSize() - 1);
+
+            // Every byte is read anyway, so the hashes of all blocks are calculated along the way
+            auto blockContext = crypt::createSHA256Context();
+            u64 hashedBytes = 0;
+            reader.forEachChunk(0, [&](u64 chunkAddress, std::span<const u8> chunk) {
+                index->process(chunk);
+
+                while (!chunk.empty()) {
+                    const auto size = std::min<u64>(chunk.size(), search::NGramIndex::BlockSize - hashedBytes % search::NGramIndex::BlockSize);
+                    blockContext->update(chunk.first(size));
+                    chunk = chunk.subspan(size);
+                    hashedBytes += size;
+
+                    if (hashedBytes % search::NGramIndex::BlockSize == 0) {
+                        blockHashes->push_back(blockContext->finish());
+                        blockContext = crypt::createSHA256Context();
+                    }
+                }
+
+                task.update(chunkAddress - provider->getBaseAddress());
+            });
+            index->finish();
+
+            if (hashedBytes % search::NGramIndex::BlockSize != 0)
+                blockHashes->push_back(blockContext->finish());
+
+            TaskManager::doLater([this, provider, index, blockHashes] {
+                const auto &providers = ImHexApi::Provider::getProviders();
+                if (std::find(providers.begin(), providers.end(), provider) == providers.end())
+                    return;
+
+                SearchIndex searchIndex;
+                searchIndex.index       = index;
+                searchIndex.blockHashes = blockHashes;
+                markPatchedBlocks(provider, searchIndex);
+
+                searchIndex.dirtyBlocks.merge(this->m_blocksChangedWhileIndexing[provider]);
+                this->m_blocksChangedWhileIndexing.erase(provider);
+
+                this->m_searchIndices[provider] = std::move(searchIndex);
+            });
+        });
+    }
+
+    void ViewFind::verifySearchIndex(prv::Provider *provider, SearchIndex searchIndex) {
+        auto &unverified = this->m_unverifiedIndices[provider];
+        unverified.task.interrupt();
+
+        this->m_verificationGeneration++;
+        unverified.searchIndex = std::move(searchIndex);
+        unverified.generation  = this->m_verificationGeneration;
+
+        // The data is hashed the same way it was read when the index was built. Blocks that don't match anymore are searched without the index
+        unverified.task = TaskManager::createTask("hex.builtin.view.find.index.verifying", provider->getActualSize(), [this, provider, generation = unverified.generation](auto &task) {
+            auto blockHashes = crypt::hashBlocks(crypt::createSHA256Context, 0, provider->getActualSize(), search::NGramIndex::BlockSize,
+                [provider](u64 offset, std::span<u8> buffer) {
+                    provider->read(provider->getBaseAddress() + offset, buffer.data(), buffer.size());
+                },
+                [&task](u64 processedBytes) {
+                    task.update(processedBytes);
+                });
+
+            TaskManager::doLater([this, provider, generation, blockHashes = std::move(blockHashes)] {
+                auto it = this->m_unverifiedIndices.find(provider);
+                if (it == this->m_unverifiedIndices.end() || it->second.generation != generation)
+                    return;
+
+                auto searchIndex = std::move(it->second.searchIndex);
+                this->m_unverifiedIndices.erase(it);
+
+                if (searchIndex.index->getDataSize() != provider->getActualSize() || blockHashes.size() != searchIndex.blockHashes->size())
+                    return;
+
+                for (u64 block = 0; block < blockHashes.size(); block++) {
+                    if (blockHashes[block] != (*searchIndex.blockHashes)[block])
+                        searchIndex.dirtyBlocks.insert(block);
+                }
+                markPatchedBlocks(provider, searchIndex);
+
+                this->m_searchIndices[provider] = std::move(searchIndex);
+            });
+        });
+    }
+
+    std::optional<ViewFind::SearchIndex> ViewFind::getSearchIndex(prv::Provider *provider) {
+        auto it = this->m_searchIndices.find(provider);
+        if (it == this->m_searchIndices.end())
+            return std::nullopt;
+
+        auto &searchIndex = it->second;
+        if (searchIndex.index->getDataSize() != provider->getActualSize()) {
+            this->m_searchIndices.erase(it);
+            return std::nullopt;
+        }
+
+        return searchIndex;
+    }
+
+    std::vector<Region> ViewFind::getCandidateRegions(prv::Provider *provider, Region searchRegion, const std::vector<search::MaskedByte> &pattern, const std::optional<SearchIndex> &index) {
+        if (!index.has_value() || pattern.empty())
+            return { searchRegion };
+
+        constexpr static auto BlockSize = search::NGramIndex::BlockSize;
+
+        auto candidates = index->index->findCandidateBlocks(pattern);
+
+        // A match starting in the block before a patched block can reach into it as well
+        for (auto block : index->dirtyBlocks) {
+            if (block < candidates.size())
+                candidates[block] = true;
+            if (block > 0 && block - 1 < candidates.size())
+                candidates[block - 1] = true;
+        }
+
+        const auto baseAddress = provider->getBaseAddress();
+        const auto firstBlock = (searchRegion.getStartAddress() - baseAddress) / BlockSize;
+        const auto lastBlock = std::min<u64>((searchRegion.getEndAddress() - baseAddress) / BlockSize, candidates.size() - 1);
+
+        // Every region covers the matches starting in a run of candidate blocks plus the bytes these matches can reach into
+        std::vector<Region> regions;
+        for (u64 block = firstBlock; block <= lastBlock; block++) {
+            if (!candidates[block])
+                continue;
+
+            const auto start = std::max<u64>(baseAddress + block * BlockSize, searchRegion.getStartAddress());
+            const auto end = std::min<u64>(baseAddress + (block + 1) * BlockSize - 1 + (pattern.size() - 1), searchRegion.getEndAddress());
+
+            if (!regions.empty() && start <= regions.back().getEndAddress() + 1)
+                regions.back().size = end - regions.back().getStartAddress() + 1;
+            else
+                regions.push_back(Region { start, end - start + 1 });
+        }
+
+        return regions;
     }
 
 
@@ -146,169 +464,439 @@ namespace hex::plugin::builtin {
     }
 
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchStrings(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::Strings settings) {
-        using enum SearchSettings::Strings::Type;
+    std::optional<std::vector<ViewFind::SearchSettings::MultiSequence::Needle>> ViewFind::parseNeedleList(const std::string &string) {
+        std::vector<SearchSettings::MultiSequence::Needle> result;
 
-        std::vector<Occurrence> results;
+        for (auto line : hex::splitString(string, "\n")) {
+            hex::trim(line);
+            if (line.empty() || line.starts_with('#'))
+                continue;
 
-        if (settings.type == ASCII_UTF16BE || settings.type == ASCII_UTF16LE) {
-            auto newSettings = settings;
+            // Lines are either just a byte sequence or a name followed by an equals sign and the byte sequence
+            SearchSettings::MultiSequence::Needle needle;
+            std::string bytes = line;
+            if (auto separator = line.find_last_of('='); separator != std::string::npos) {
+                needle.name = line.substr(0, separator);
+                bytes       = line.substr(separator + 1);
+                hex::trim(needle.name);
+            }
 
-            newSettings.type = ASCII;
-            auto asciiResults = searchStrings(task, provider, searchRegion, newSettings);
-            std::copy(asciiResults.begin(), asciiResults.end(), std::back_inserter(results));
+            std::erase_if(bytes, [](char c) { return std::isspace(u8(c)); });
+            needle.bytes = hex::parseByteString(bytes);
+            if (needle.bytes.empty())
+                return std::nullopt;
+
+            result.push_back(std::move(needle));
+        }
+
+        if (result.empty())
+            return std::nullopt;
+
+        return result;
+    }
+
+    std::string ViewFind::loadConstantNeedles() {
+        std::string result;
 
-            if (settings.type == ASCII_UTF16BE) {
-                newSettings.type = UTF16BE;
-                auto utf16Results = searchStrings(task, provider, searchRegion, newSettings);
-                std::copy(utf16Results.begin(), utf16Results.end(), std::back_inserter(results));
-            } else if (settings.type == ASCII_UTF16LE) {
-                newSettings.type = UTF16LE;
-                auto utf16Results = searchStrings(task, provider, searchRegion, newSettings);
-                std::copy(utf16Results.begin(), utf16Results.end(), std::back_inserter(results));
+        auto addLine = [&](const Constant &constant, const std::vector<u8> &bytes) {
+            result += hex::format("{}: {} =", constant.category, constant.name);
+            for (u8 byte : bytes)
+                result += hex::format(" {:02X}", byte);
+            result += '\n';
+        };
+
+        for (const auto &constant : ViewConstants::loadConstants()) {
+            std::string value = constant.value;
+            std::erase_if(value, [](char c) { return std::isspace(u8(c)); });
+
+            switch (constant.type) {
+                case ConstantType::Int16BigEndian:
+                case ConstantType::Int16LittleEndian: {
+                    if (value.starts_with("0x") || value.starts_with("0X"))
+                        value = value.substr(2);
+                    if (value.length() % 2 != 0)
+                        value.insert(value.begin(), '0');
+
+                    auto bytes = hex::parseByteString(value);
+                    if (bytes.empty())
+                        continue;
+
+                    if (constant.type == ConstantType::Int16LittleEndian)
+                        std::reverse(bytes.begin(), bytes.end());
+
+                    addLine(constant, bytes);
+                    break;
+                }
+                case ConstantType::Int10: {
+                    i64 number = 0;
+                    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+                    if (error != std::errc() || end != value.data() + value.size())
+                        continue;
+
+                    // Decimal constants don't have a defined width or endianness, search for the smallest integer type that can hold them in both byte orders
+                    size_t size = 8;
+                    if (number >= -0x80 && number <= 0xFF)
+                        size = 1;
+                    else if (number >= -0x8000 && number <= 0xFFFF)
+                        size = 2;
+                    else if (number >= -0x8000'0000LL && number <= 0xFFFF'FFFFLL)
+                        size = 4;
+
+                    auto bytes = hex::toBytes(number);
+                    bytes.resize(size);
+                    addLine(constant, bytes);
+
+                    auto reversed = bytes;
+                    std::reverse(reversed.begin(), reversed.end());
+                    if (reversed != bytes)
+                        addLine(constant, reversed);
+                    break;
+                }
             }
+        }
+
+        return result;
+    }
+
+    void ViewFind::searchStrings(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::Strings settings, SearchResults &results) {
+        using enum SearchSettings::Strings::Type;
 
-            return results;
+        // Character classes as defined by the C locale, looked up once per byte instead of calling into the locale dependent functions
+        std::array<bool, 256> validCharacters = { };
+        auto addRange = [&](char start, char end) {
+            for (char c = start; c <= end; c++)
+                validCharacters[u8(c)] = true;
+        };
+
+        if (settings.m_lowerCaseLetters)
+            addRange('a', 'z');
+        if (settings.m_upperCaseLetters)
+            addRange('A', 'Z');
+        if (settings.m_numbers)
+            addRange('0', '9');
+        if (settings.m_spaces) {
+            addRange(' ', ' ');
+            addRange('\t', '\r');
+        }
+        if (settings.m_underscores)
+            addRange('_', '_');
+        if (settings.m_symbols) {
+            addRange('!', '/');
+            addRange(':', '@');
+            addRange('[', '`');
+            addRange('{', '~');
         }
+        if (settings.m_lineFeeds)
+            addRange('\n', '\n');
+
+        search::StringExtractor extractor({
+            .validCharacters = validCharacters,
+            .minLength       = size_t(settings.minLength),
+            .nullTermination = settings.nullTermination,
+            .ascii           = settings.type == ASCII || settings.type == ASCII_UTF16LE || settings.type == ASCII_UTF16BE,
+            .utf8            = settings.type == UTF8 || settings.type == All,
+            .utf16le         = settings.type == UTF16LE || settings.type == ASCII_UTF16LE || settings.type == All,
+            .utf16be         = settings.type == UTF16BE || settings.type == ASCII_UTF16BE || settings.type == All
+        });
+
+        auto addOccurrence = [&](const search::StringExtractor::String &string) {
+            const auto decodeType = [&] {
+                switch (string.encoding) {
+                    using enum search::StringExtractor::Encoding;
+                    case ASCII:   return Occurrence::DecodeType::ASCII;
+                    case UTF8:    return Occurrence::DecodeType::UTF8;
+                    case UTF16LE: return Occurrence::DecodeType::UTF16LE;
+                    case UTF16BE: return Occurrence::DecodeType::UTF16BE;
+                }
+
+                return Occurrence::DecodeType::Binary;
+            }();
+
+            results.add(Occurrence { Region { searchRegion.getStartAddress() + string.offset, string.size }, decodeType });
+        };
 
         auto reader = prv::BufferedReader(provider);
         reader.seek(searchRegion.getStartAddress());
         reader.setEndAddress(searchRegion.getEndAddress());
 
-        const Occurrence::DecodeType decodeType = [&]{
-            if (settings.type == ASCII)
-                return Occurrence::DecodeType::ASCII;
-            else if (settings.type == SearchSettings::Strings::Type::UTF16BE)
-                return Occurrence::DecodeType::UTF16BE;
-            else if (settings.type == SearchSettings::Strings::Type::UTF16LE)
-                return Occurrence::DecodeType::UTF16LE;
-            else
-                return Occurrence::DecodeType::Binary;
-        }();
+        reader.forEachChunk(0, [&](u64 chunkAddress, std::span<const u8> chunk) {
+            extractor.process(chunk, addOccurrence);
+            task.update(chunkAddress - searchRegion.getStartAddress());
 
-        size_t countedCharacters = 0;
-        u64 startAddress = reader.begin().getAddress();
-        for (u8 byte : reader) {
-            bool validChar =
-                (settings.m_lowerCaseLetters    && std::islower(byte))  ||
-                (settings.m_upperCaseLetters    && std::isupper(byte))  ||
-                (settings.m_numbers             && std::isdigit(byte))  ||
-                (settings.m_spaces              && std::isspace(byte))  ||
-                (settings.m_underscores         && byte == '_')             ||
-                (settings.m_symbols             && std::ispunct(byte))  ||
-                (settings.m_lineFeeds           && byte == '\n');
-
-            if (settings.type == UTF16LE) {
-                // Check if second byte of UTF-16 encoded string is 0x00
-                if (countedCharacters % 2 == 1)
-                    validChar =  byte == 0x00;
-            } else if (settings.type == UTF16BE) {
-                // Check if first byte of UTF-16 encoded string is 0x00
-                if (countedCharacters % 2 == 0)
-                    validChar =  byte == 0x00;
-            }
+            return !results.isFull();
+        });
+        extractor.finish(addOccurrence);
+    }
 
-            if (validChar)
-                countedCharacters++;
-            else {
-                if (countedCharacters >= size_t(settings.minLength)) {
-                    if (!(settings.nullTermination && byte != 0x00)) {
-                        results.push_back(Occurrence { Region { startAddress, countedCharacters }, decodeType });
-                    }
+    void ViewFind::searchSequence(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::Bytes settings, const std::optional<SearchIndex> &index, SearchResults &results) {
+        auto sequence = hex::decodeByteString(settings.sequence);
+        if (sequence.empty())
+            return;
+
+        std::vector<search::MaskedByte> pattern;
+        for (u8 byte : sequence)
+            pattern.push_back({ 0xFF, byte });
+
+        auto reader = prv::BufferedReader(provider);
+
+        const search::SequenceSearcher searcher(sequence);
+        const auto sequenceSize = sequence.size();
+
+        // In non-overlapping mode a match close to the end of a chunk can reach into the start of the next one
+        u64 nextAddress = searchRegion.getStartAddress();
+        for (const auto &region : getCandidateRegions(provider, searchRegion, pattern, index)) {
+            reader.seek(region.getStartAddress());
+            reader.setEndAddress(region.getEndAddress());
+
+            reader.forEachChunk(sequenceSize - 1, [&](u64 chunkAddress, std::span<const u8> chunk) {
+                size_t offset = nextAddress > chunkAddress ? nextAddress - chunkAddress : 0;
+
+                while (auto match = searcher.find(chunk, offset)) {
+                    if (!results.add(Occurrence{ Region { chunkAddress + *match, sequenceSize }, Occurrence::DecodeType::Binary }))
+                        return false;
+
+                    offset = *match + (settings.overlapping ? 1 : sequenceSize);
                 }
 
-                startAddress += countedCharacters + 1;
-                countedCharacters = 0;
-                task.update(startAddress - searchRegion.getStartAddress());
-            }
-        }
+                nextAddress = std::max(nextAddress, chunkAddress + offset);
+                task.update(chunkAddress - searchRegion.getStartAddress());
 
-        return results;
+                return true;
+            });
+
+            if (results.isFull())
+                break;
+        }
     }
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchSequence(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::Bytes settings) {
-        std::vector<Occurrence> results;
+    void ViewFind::searchRegex(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::Regex settings, SearchResults &results) {
+        search::Regex regex(settings.pattern, settings.maxLength);
+        auto addOccurrence = [&](const search::Regex::Match &match) {
+            results.add(Occurrence { Region { searchRegion.getStartAddress() + match.offset, match.size }, Occurrence::DecodeType::Binary });
+        };
 
         auto reader = prv::BufferedReader(provider);
         reader.seek(searchRegion.getStartAddress());
         reader.setEndAddress(searchRegion.getEndAddress());
 
-        auto sequence = hex::decodeByteString(settings.sequence);
-        auto occurrence = reader.begin();
-        while (true) {
-            occurrence = std::search(reader.begin(), reader.end(), std::boyer_moore_horspool_searcher(sequence.begin(), sequence.end()));
-            if (occurrence == reader.end())
-                break;
+        reader.forEachChunk(0, [&](u64 chunkAddress, std::span<const u8> chunk) {
+            regex.process(chunk, addOccurrence);
+            task.update(chunkAddress - searchRegion.getStartAddress());
 
-            auto address = occurrence.getAddress();
-            reader.seek(address + 1);
-            results.push_back(Occurrence{ Region { address, sequence.size() }, Occurrence::DecodeType::Binary });
-            task.update(address - searchRegion.getStartAddress());
-        }
+            return !results.isFull();
+        });
+        regex.finish(addOccurrence);
+    }
+
+    void ViewFind::searchBinaryPattern(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::BinaryPattern settings, const std::optional<SearchIndex> &index, SearchResults &results) {
+        auto reader = prv::BufferedReader(provider);
+
+        const size_t patternSize = settings.pattern.size();
+        if (patternSize == 0)
+            return;
 
-        return results;
+        // The matcher keeps its state between chunks so the chunks of a region don't need to overlap
+        search::PatternMatcher matcher(settings.pattern);
+        for (const auto &region : getCandidateRegions(provider, searchRegion, settings.pattern, index)) {
+            reader.seek(region.getStartAddress());
+            reader.setEndAddress(region.getEndAddress());
+            matcher.reset();
+
+            reader.forEachChunk(0, [&](u64 chunkAddress, std::span<const u8> chunk) {
+                matcher.process(chunk, [&](size_t matchEnd) {
+                    const auto occurrenceAddress = (chunkAddress + matchEnd) - (patternSize - 1);
+
+                    results.add(Occurrence { Region { occurrenceAddress, patternSize }, Occurrence::DecodeType::Binary });
+                });
+
+                task.update(chunkAddress - searchRegion.getStartAddress());
+
+                return !results.isFull();
+            });
+
+            if (results.isFull())
+                break;
+        }
     }
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchRegex(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::Regex settings) {
-        auto stringOccurrences = searchStrings(task, provider, searchRegion, SearchSettings::Strings {
-            .minLength          = 1,
-            .type               = SearchSettings::Strings::Type::ASCII,
-            .m_lowerCaseLetters = true,
-            .m_upperCaseLetters = true,
-            .m_numbers          = true,
-            .m_underscores      = true,
-            .m_symbols          = true,
-            .m_spaces           = true,
-            .m_lineFeeds        = true
+    void ViewFind::searchMultiSequence(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::MultiSequence settings, SearchResults &results) {
+        if (settings.needles.empty())
+            return;
+
+        std::vector<std::vector<u8>> needles;
+        for (const auto &needle : settings.needles)
+            needles.push_back(needle.bytes);
+
+        auto reader = prv::BufferedReader(provider);
+        reader.seek(searchRegion.getStartAddress());
+        reader.setEndAddress(searchRegion.getEndAddress());
+
+        // All needles are searched for in a single pass, the searcher keeps its state between chunks so they don't need to overlap
+        search::MultiSequenceSearcher searcher(needles);
+        reader.forEachChunk(0, [&](u64 chunkAddress, std::span<const u8> chunk) {
+            searcher.process(chunk, [&](size_t needle, size_t matchEnd) {
+                const auto size = needles[needle].size();
+
+                results.add(Occurrence { Region { (chunkAddress + matchEnd + 1) - size, size }, Occurrence::DecodeType::Binary, u32(needle) });
+            });
+
+            task.update(chunkAddress - searchRegion.getStartAddress());
+
+            return !results.isFull();
         });
+    }
 
-        std::vector<Occurrence> result;
-        std::regex regex(settings.pattern);
-        for (const auto &occurrence : stringOccurrences) {
-            std::string string(occurrence.region.getSize(), '\x00');
-            provider->read(occurrence.region.getStartAddress(), string.data(), occurrence.region.getSize());
+    void ViewFind::searchFuzzy(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::Fuzzy settings, SearchResults &results) {
+        const auto sequence = hex::decodeByteString(settings.sequence);
+        const auto metric = settings.insertionsDeletions ? search::ApproximateMatcher::Metric::Levenshtein : search::ApproximateMatcher::Metric::Hamming;
+        const auto maxMatchSize = search::ApproximateMatcher(sequence, settings.maxDistance, metric).getMaxMatchSize();
+
+        // The region is split into one part per thread. Every thread starts scanning a bit before its part so it can find matches
+        // that started in the previous one and only keeps the ones that end inside of its part
+        constexpr static u64 MinimumPartSize = 1_MiB;
+        constexpr static u64 ChunkSize = 1_MiB;
+
+        const u64 threadCount = std::clamp<u64>(searchRegion.getSize() / MinimumPartSize, 1, std::max(std::thread::hardware_concurrency(), 1U));
+        const u64 partSize = (searchRegion.getSize() + threadCount - 1) / threadCount;
+
+        std::mutex readMutex, resultMutex;
+        std::atomic<u64> progress = 0, finishedThreads = 0;
+
+        {
+            std::vector<std::jthread> threads;
+            for (u64 part = 0; part < threadCount; part++) {
+                threads.emplace_back([&, part](const std::stop_token &stopToken) {
+                    ON_SCOPE_EXIT { finishedThreads += 1; };
+
+                    const u64 partStart = searchRegion.getStartAddress() + part * partSize;
+                    const u64 partEnd = std::min(partStart + partSize, searchRegion.getEndAddress() + 1);
+                    if (partStart >= partEnd)
+                        return;
+
+                    // Whether a match ending at the first or last byte of a part is the best one around depends on its neighbours, so
+                    // the matcher also needs to see the bytes leading up to the byte before the part and the byte after it
+                    const u64 scanStart = partStart - std::min<u64>(partStart - searchRegion.getStartAddress(), maxMatchSize);
+                    const u64 scanEnd = std::min(partEnd + 1, searchRegion.getEndAddress() + 1);
+
+                    search::ApproximateMatcher matcher(sequence, settings.maxDistance, metric);
+                    auto addOccurrence = [&](const search::ApproximateMatcher::Match &match) {
+                        const auto end = scanStart + match.offset + match.size - 1;
+                        if (end < partStart || end >= partEnd)
+                            return;
+
+                        std::scoped_lock lock(resultMutex);
+                        results.add(Occurrence { Region { scanStart + match.offset, match.size }, Occurrence::DecodeType::Binary, 0, match.distance });
+                    };
+
+                    std::vector<u8> buffer(ChunkSize);
+                    for (u64 address = scanStart; address < scanEnd; address += ChunkSize) {
+                        if (stopToken.stop_requested() || results.isFull())
+                            return;
+
+                        const auto size = std::min<u64>(ChunkSize, scanEnd - address);
+
+                        // Not every provider can be read from multiple threads at once
+                        {
+                            std::scoped_lock lock(readMutex);
+                            provider->read(address, buffer.data(), size);
+                        }
+
+                        matcher.process(std::span(buffer).first(size), addOccurrence);
+                        progress += size;
+                    }
 
-            if (std::regex_match(string, regex))
-                result.push_back(occurrence);
+                    matcher.finish(addOccurrence);
+                });
+            }
+
+            // Task updates can only happen on the task's own thread. If the task gets interrupted, the threads are stopped and joined when they go out of scope
+            while (finishedThreads < threadCount) {
+                task.update(std::min<u64>(progress, searchRegion.getSize()));
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
         }
+    }
 
-        return result;
+    std::optional<search::ValueScanner::Condition> ViewFind::getValueCondition(const SearchSettings::Values &settings) {
+        using enum search::ValueScanner::Predicate;
+
+        search::ValueScanner::Condition condition = { .predicate = settings.predicate, .minimum = 0, .maximum = 0 };
+        if (settings.predicate == Equal || settings.predicate == Range) {
+            auto minimum = search::ValueScanner::parseValue(settings.type, settings.minimum);
+            if (!minimum.has_value())
+                return std::nullopt;
+            condition.minimum = *minimum;
+        }
+
+        if (settings.predicate == Range) {
+            auto maximum = search::ValueScanner::parseValue(settings.type, settings.maximum);
+            if (!maximum.has_value())
+                return std::nullopt;
+            condition.maximum = *maximum;
+        }
+
+        return condition;
     }
 
-    std::vector<ViewFind::Occurrence> ViewFind::searchBinaryPattern(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::BinaryPattern settings) {
-        std::vector<Occurrence> results;
+    void ViewFind::searchValues(Task &task, prv::Provider *provider, hex::Region searchRegion, SearchSettings::Values settings, search::ValueScanner &scanner, SearchResults &results) {
+        const auto condition = getValueCondition(settings);
+        if (!condition.has_value())
+            return;
+
+        const auto valueSize = search::ValueScanner::getTypeSize(settings.type);
 
         auto reader = prv::BufferedReader(provider);
         reader.seek(searchRegion.getStartAddress());
         reader.setEndAddress(searchRegion.getEndAddress());
 
-        u32 matchedBytes = 0;
-        const size_t patternSize = settings.pattern.size();
+        // Candidates are published after every chunk so they show up while the scan is still running
+        size_t publishedCount = 0;
+        reader.forEachChunk(valueSize - 1, [&](u64 chunkAddress, std::span<const u8> chunk) {
+            const bool notFull = scanner.scan(chunk, chunkAddress, *condition);
 
-        for (auto it = reader.begin(); it != reader.end(); ++it) {
-            auto byte = *it;
+            const auto &candidates = scanner.getCandidates();
+            for (; publishedCount < candidates.size(); publishedCount++)
+                results.add(Occurrence { Region { candidates[publishedCount].address, valueSize }, Occurrence::DecodeType::Binary });
 
-            if ((byte & settings.pattern[matchedBytes].mask) == settings.pattern[matchedBytes].value) {
-                matchedBytes++;
-                if (matchedBytes == settings.pattern.size()) {
-                    auto occurrenceAddress = it.getAddress() - (patternSize - 1);
+            task.update(chunkAddress - searchRegion.getStartAddress());
 
-                    results.push_back(Occurrence { Region { occurrenceAddress, patternSize }, Occurrence::DecodeType::Binary });
-                    task.update(occurrenceAddress);
-                    it.setAddress(occurrenceAddress);
-                    matchedBytes = 0;
-                }
-            } else {
-                if (matchedBytes > 0)
-                    it -= matchedBytes;
-                matchedBytes = 0;
-            }
-        }
+            return notFull;
+        });
 
-        return results;
+        if (scanner.isFull())
+            results.full = true;
+    }
+
+    void ViewFind::rescanValues(Task &task, prv::Provider *provider, SearchSettings::Values settings, search::ValueScanner &scanner, SearchResults &results) {
+        const auto condition = getValueCondition(settings);
+        if (!condition.has_value())
+            return;
+
+        scanner.rescan(*condition, [provider](u64 address, std::span<u8> buffer) {
+            provider->read(address, buffer.data(), buffer.size());
+        }, [&task](size_t checkedCandidates) {
+            task.update(checkedCandidates);
+        });
+
+        const auto valueSize = search::ValueScanner::getTypeSize(scanner.getSettings().type);
+        for (const auto &candidate : scanner.getCandidates())
+            results.add(Occurrence { Region { candidate.address, valueSize }, Occurrence::DecodeType::Binary });
     }
 
     void ViewFind::runSearch() {
+        this->m_searchTasks.clear();
+
+        // Every provider is searched in a task of its own so they all run in parallel. Only the current provider
+        // has a selection, the others are always searched entirely
+        if (this->m_searchSettings.allProviders) {
+            for (auto provider : ImHexApi::Provider::getProviders()) {
+                if (provider->isAvailable() && provider->isReadable())
+                    this->startSearch(provider, Region { provider->getBaseAddress(), provider->getActualSize() });
+            }
+
+            return;
+        }
+
         Region searchRegion = [this]{
             if (this->m_searchSettings.range == ui::SelectedRegion::EntireData || !ImHexApi::HexEditor::isSelectionValid()) {
                 auto provider = ImHexApi::Provider::get();
@@ -318,40 +906,463 @@ namespace hex::plugin::builtin {
             }
         }();
 
-        this->m_searchTask = TaskManager::createTask("hex.builtin.view.find.searching", searchRegion.getSize(), [this, settings = this->m_searchSettings, searchRegion](auto &task) {
-            auto provider = ImHexApi::Provider::get();
+        this->startSearch(ImHexApi::Provider::get(), searchRegion);
+    }
+
+    void ViewFind::startSearch(prv::Provider *provider, Region searchRegion) {
+        auto results = std::make_shared<SearchResults>(this->m_searchSettings.mode, getStoreLayout(this->m_searchSettings), this->m_searchSettings.maxResults);
+        this->m_results[provider] = results;
+
+        // A new value scan throws away the candidates of the previous one
+        std::shared_ptr<search::ValueScanner> valueScanner;
+        if (this->m_searchSettings.mode == SearchSettings::Mode::Values) {
+            const auto &values = this->m_searchSettings.values;
+            valueScanner = std::make_shared<search::ValueScanner>(search::ValueScanner::Settings { .type = values.type, .endian = values.endian, .aligned = values.aligned }, this->m_searchSettings.maxResults);
+            this->m_valueScanners[provider] = valueScanner;
+        }
+
+        this->m_searchTasks.push_back(TaskManager::createTask("hex.builtin.view.find.searching", searchRegion.getSize(), [provider, results, valueScanner, settings = this->m_searchSettings, searchRegion, index = this->getSearchIndex(provider)](auto &task) {
+            ON_SCOPE_EXIT { results->finished = true; };
 
             switch (settings.mode) {
                 using enum SearchSettings::Mode;
                 case Strings:
-                    this->m_foundOccurrences[provider] = searchStrings(task, provider, searchRegion, settings.strings);
+                    searchStrings(task, provider, searchRegion, settings.strings, *results);
                     break;
                 case Sequence:
-                    this->m_foundOccurrences[provider] = searchSequence(task, provider, searchRegion, settings.bytes);
+                    searchSequence(task, provider, searchRegion, settings.bytes, index, *results);
                     break;
                 case Regex:
-                    this->m_foundOccurrences[provider] = searchRegex(task, provider, searchRegion, settings.regex);
+                    searchRegex(task, provider, searchRegion, settings.regex, *results);
                     break;
                 case BinaryPattern:
-                    this->m_foundOccurrences[provider] = searchBinaryPattern(task, provider, searchRegion, settings.binaryPattern);
+                    searchBinaryPattern(task, provider, searchRegion, settings.binaryPattern, index, *results);
+                    break;
+                case MultiSequence:
+                    searchMultiSequence(task, provider, searchRegion, settings.multiSequence, *results);
+                    break;
+                case Fuzzy:
+                    searchFuzzy(task, provider, searchRegion, settings.fuzzy, *results);
+                    break;
+                case Values:
+                    searchValues(task, provider, searchRegion, settings.values, *valueScanner, *results);
                     break;
             }
+        }));
+    }
 
-            this->m_sortedOccurrences[provider] = this->m_foundOccurrences[provider];
+    void ViewFind::runValueRescan() {
+        this->m_searchTasks.clear();
 
-            OccurrenceTree::interval_vector intervals;
-            for (const auto &occurrence : this->m_foundOccurrences[provider])
-                intervals.push_back(OccurrenceTree::interval(occurrence.region.getStartAddress(), occurrence.region.getEndAddress(), occurrence));
-            this->m_occurrenceTree[provider] = std::move(intervals);
+        if (this->m_searchSettings.allProviders) {
+            for (auto provider : ImHexApi::Provider::getProviders())
+                this->startValueRescan(provider);
+        } else {
+            this->startValueRescan(ImHexApi::Provider::get());
+        }
+    }
+
+    void ViewFind::startValueRescan(prv::Provider *provider) {
+        auto it = this->m_valueScanners.find(provider);
+        if (it == this->m_valueScanners.end())
+            return;
+
+        auto valueScanner = it->second;
+        auto results = std::make_shared<SearchResults>(SearchSettings::Mode::Values, getStoreLayout(this->m_searchSettings), this->m_searchSettings.maxResults);
+        this->m_results[provider] = results;
+
+        this->m_searchTasks.push_back(TaskManager::createTask("hex.builtin.view.find.searching", valueScanner->getCandidates().size(), [provider, results, valueScanner, settings = this->m_searchSettings.values](auto &task) {
+            ON_SCOPE_EXIT { results->finished = true; };
+
+            rescanValues(task, provider, settings, *valueScanner, *results);
+        }));
+    }
+
+    bool ViewFind::isSearching() const {
+        return std::any_of(this->m_searchTasks.begin(), this->m_searchTasks.end(), [](const auto &task) { return task.isRunning(); });
+    }
+
+    std::optional<std::vector<search::MaskedByte>> ViewFind::parseReplacement(const std::string &input) const {
+        std::vector<search::MaskedByte> result;
+
+        switch (this->m_decodeSettings.mode) {
+            using enum SearchSettings::Mode;
+            case Sequence:
+                for (u8 byte : hex::decodeByteString(input))
+                    result.push_back({ 0xFF, byte });
+                break;
+            case BinaryPattern:
+                // Wildcards keep the bits of the data that was found
+                result = parseBinaryPatternString(input);
+                if (result.size() != this->m_decodeSettings.binaryPattern.pattern.size())
+                    return std::nullopt;
+                break;
+            case Values: {
+                const auto &settings = this->m_decodeSettings.values;
+                const auto value = search::ValueScanner::parseValue(settings.type, input);
+                if (!value.has_value())
+                    return std::nullopt;
+
+                const auto size = search::ValueScanner::getTypeSize(settings.type);
+                const auto bytes = hex::changeEndianess(*value, size, settings.endian);
+                for (size_t i = 0; i < size; i++)
+                    result.push_back({ 0xFF, u8(bytes >> (i * 8)) });
+                break;
+            }
+            default:
+                return std::nullopt;
+        }
+
+        if (result.empty())
+            return std::nullopt;
+
+        return result;
+    }
+
+    void ViewFind::replaceAll(prv::Provider *provider, std::vector<search::MaskedByte> replacement) {
+        auto it = this->m_results.find(provider);
+        if (it == this->m_results.end())
+            return;
+
+        // The data might have changed since it was searched. Occurrences are only replaced if they still contain what was found
+        std::vector<search::MaskedByte> pattern;
+        std::shared_ptr<search::ValueScanner> scanner;
+        switch (this->m_decodeSettings.mode) {
+            case SearchSettings::Mode::Sequence:
+                for (u8 byte : hex::decodeByteString(this->m_decodeSettings.bytes.sequence))
+                    pattern.push_back({ 0xFF, byte });
+                break;
+            case SearchSettings::Mode::BinaryPattern:
+                pattern = this->m_decodeSettings.binaryPattern.pattern;
+                break;
+            case SearchSettings::Mode::Values:
+                if (auto valueScanner = this->m_valueScanners.find(provider); valueScanner != this->m_valueScanners.end())
+                    scanner = valueScanner->second;
+                break;
+            default:
+                return;
+        }
+
+        auto results = it->second;
+        this->m_replaceTask = TaskManager::createTask("hex.builtin.view.find.replacing", results->filtered.size(), [this, provider, results, ids = results->filtered, replacement = std::move(replacement), pattern = std::move(pattern), scanner, dataVersion = provider->getDataVersion()](auto &task) {
+            std::vector<u64> offsets;
+            offsets.reserve(ids.size());
+
+            size_t size = 0;
+            for (auto id : ids) {
+                const auto entry = results->occurrences[id];
+                offsets.push_back(entry.address);
+                size = entry.size;
+            }
+
+            // Values have to be unchanged since the last scan, all other occurrences have to still match the searched pattern
+            std::map<u64, u64> scannedValues;
+            if (scanner != nullptr) {
+                for (const auto &candidate : scanner->getCandidates())
+                    scannedValues[candidate.address] = candidate.value;
+            }
+
+            std::vector<u8> currentData(size);
+            size_t checkedCount = 0;
+            std::erase_if(offsets, [&](u64 offset) {
+                task.update(checkedCount++);
+                provider->read(offset, currentData.data(), currentData.size());
+
+                if (scanner != nullptr) {
+                    auto scannedValue = scannedValues.find(offset);
+
+                    return scannedValue == scannedValues.end() || search::ValueScanner::loadValue(currentData, scanner->getSettings().endian) != scannedValue->second;
+                } else {
+                    if (pattern.size() != currentData.size())
+                        return true;
+
+                    for (size_t i = 0; i < pattern.size(); i++) {
+                        if ((currentData[i] & pattern[i].mask) != (pattern[i].value & pattern[i].mask))
+                            return true;
+                    }
+
+                    return false;
+                }
+            });
+
+            // Overlapping occurrences can't all be replaced, only the first one of them is
+            std::sort(offsets.begin(), offsets.end());
+            u64 nextFree = 0;
+            std::erase_if(offsets, [&](u64 offset) {
+                if (offset < nextFree)
+                    return true;
+
+                nextFree = offset + size;
+                return false;
+            });
+
+            // Everything is prepared here, only applying the changes is left to the main thread so the
+            // data doesn't change while it's being drawn
+            if (replacement.size() == size) {
+                const bool hasWildcards = std::any_of(replacement.begin(), replacement.end(), [](const auto &byte) { return byte.mask != 0xFF; });
+
+                std::vector<std::pair<u64, u8>> patches;
+                patches.reserve(offsets.size() * size);
+
+                std::vector<u8> originalData(size);
+                for (size_t i = 0; i < offsets.size(); i++) {
+                    if (hasWildcards)
+                        provider->read(offsets[i], originalData.data(), originalData.size(), false);
+
+                    for (size_t j = 0; j < size; j++) {
+                        const auto [mask, value] = replacement[j];
+                        patches.emplace_back(offsets[i] + j, (originalData[j] & ~mask) | (value & mask));
+                    }
+
+                    task.update(i);
+                }
+
+                TaskManager::doLater([this, provider, patches = std::move(patches), replacement, dataVersion] {
+                    if (std::ranges::find(ImHexApi::Provider::getProviders(), provider) == ImHexApi::Provider::getProviders().end())
+                        return;
+
+                    // The occurrences have to be checked again if the data changed while they were being checked
+                    if (provider->getDataVersion() != dataVersion) {
+                        this->replaceAll(provider, replacement);
+                        return;
+                    }
+
+                    provider->addPatches(patches);
+                });
+            } else {
+                std::vector<u8> data;
+                for (const auto &byte : replacement)
+                    data.push_back(byte.value);
+
+                // Everything after the first replacement moves, so none of the results are valid anymore afterwards
+                TaskManager::doLater([this, provider, offsets = std::move(offsets), size, data = std::move(data), replacement, dataVersion] {
+                    if (std::ranges::find(ImHexApi::Provider::getProviders(), provider) == ImHexApi::Provider::getProviders().end())
+                        return;
+
+                    if (provider->getDataVersion() != dataVersion) {
+                        this->replaceAll(provider, replacement);
+                        return;
+                    }
+
+                    provider->replace(offsets, size, data);
+                    this->m_results.erase(provider);
+                    this->m_searchIndices.erase(provider);
+                });
+            }
         });
     }
 
+    search::OccurrenceStore::Layout ViewFind::getStoreLayout(const SearchSettings &settings) {
+        search::OccurrenceStore::Layout layout = { .fixedSize = std::nullopt, .tagSizes = { }, .maxTag = 0 };
+
+        switch (settings.mode) {
+            using enum SearchSettings::Mode;
+            case Strings:
+                layout.maxTag = u32(Occurrence::DecodeType::UTF8);
+                break;
+            case Sequence:
+                layout.fixedSize = hex::decodeByteString(settings.bytes.sequence).size();
+                break;
+            case Regex:
+                break;
+            case BinaryPattern:
+                layout.fixedSize = settings.binaryPattern.pattern.size();
+                break;
+            case MultiSequence:
+                for (const auto &needle : settings.multiSequence.needles)
+                    layout.tagSizes.push_back(needle.bytes.size());
+                layout.maxTag = settings.multiSequence.needles.size() - 1;
+                break;
+            case Fuzzy:
+                // Insertions and deletions change the size of a match
+                if (!settings.fuzzy.insertionsDeletions)
+                    layout.fixedSize = hex::decodeByteString(settings.fuzzy.sequence).size();
+                layout.maxTag = settings.fuzzy.maxDistance;
+                break;
+            case Values:
+                layout.fixedSize = search::ValueScanner::getTypeSize(settings.values.type);
+                break;
+        }
+
+        return layout;
+    }
+
+    ViewFind::SearchResults::SearchResults(SearchSettings::Mode mode, search::OccurrenceStore::Layout layout, size_t limit)
+        : mode(mode), occurrences(std::move(layout)), limit(limit), index([this](u32 id) {
+            const auto entry = this->occurrences[id];
+            return search::IntervalIndex::Interval { entry.address, entry.address + entry.size - 1 };
+        }) {
+    }
+
+    bool ViewFind::SearchResults::add(const Occurrence &occurrence) {
+        if (this->occurrences.getSize() >= this->limit) {
+            this->full = true;
+            return false;
+        }
+
+        // Decode types, needles and distances are each only used by one search mode, so they all share the tag of the entry
+        u32 tag = occurrence.needle;
+        if (this->mode == SearchSettings::Mode::Strings)
+            tag = u32(occurrence.decodeType);
+        else if (this->mode == SearchSettings::Mode::Fuzzy)
+            tag = occurrence.distance;
+        this->occurrences.push({ occurrence.region.getStartAddress(), occurrence.region.getSize(), tag });
+
+        return true;
+    }
+
+    ViewFind::Occurrence ViewFind::SearchResults::get(size_t index) const {
+        const auto entry = this->occurrences[index];
+
+        if (this->mode == SearchSettings::Mode::Strings)
+            return Occurrence { Region { entry.address, entry.size }, Occurrence::DecodeType(entry.tag) };
+        else if (this->mode == SearchSettings::Mode::Fuzzy)
+            return Occurrence { Region { entry.address, entry.size }, Occurrence::DecodeType::Binary, 0, entry.tag };
+        else
+            return Occurrence { Region { entry.address, entry.size }, Occurrence::DecodeType::Binary, entry.tag };
+    }
+
+    ViewFind::SearchResults *ViewFind::updateResults(prv::Provider *provider) {
+        auto it = this->m_results.find(provider);
+        if (it == this->m_results.end())
+            return nullptr;
+
+        auto &results = *it->second;
+        const auto count = results.occurrences.getSize();
+
+        // Move everything the search published since the last frame into the index and the filtered list
+        if (results.indexedCount < count) {
+            std::vector<u32> ids(count - results.indexedCount);
+            std::iota(ids.begin(), ids.end(), u32(results.indexedCount));
+
+            results.index.insert(ids);
+            results.indexedCount = count;
+        }
+
+        // Without a filter new occurrences are simply appended. Otherwise they have to be decoded first, which happens in a task
+        if (results.filteredCount < count && !results.ordering) {
+            if (this->m_currFilter[provider].empty()) {
+                for (auto i = results.filteredCount; i < count; i++)
+                    results.filtered.push_back(u32(i));
+
+                results.filteredCount = count;
+                results.sorted = false;
+            } else {
+                this->startOrdering(provider, it->second, false, false);
+            }
+        }
+
+        return &results;
+    }
+
+    void ViewFind::startOrdering(prv::Provider *provider, const std::shared_ptr<SearchResults> &results, bool refilter, bool sort) {
+        results->orderTask.interrupt();
+        results->orderGeneration++;
+        results->ordering = true;
+
+        // Sorting while the search is still running only sorts what has been found so far, the rest gets sorted in once it's done
+        const bool finished = results->finished;
+        const auto count    = results->getSize();
+        const auto from     = refilter ? 0 : results->filteredCount;
+
+        auto ids = refilter ? std::vector<u32>() : results->filtered;
+
+        std::optional<std::pair<SearchResults::SortColumn, bool>> sortOrder;
+        if (sort)
+            sortOrder = { results->sortColumn, results->sortAscending };
+
+        results->orderTask = TaskManager::createTask("hex.builtin.common.processing", count - from, [=, decodeSettings = this->m_decodeSettings, filter = this->m_currFilter[provider], generation = results->orderGeneration, ids = std::move(ids)](auto &task) mutable {
+            auto order = orderResults(task, provider, decodeSettings, *results, std::move(ids), from, count, filter, sortOrder);
+
+            TaskManager::doLater([results, generation, order = std::move(order), count, sorted = sort && finished]() mutable {
+                if (generation != results->orderGeneration)
+                    return;
+
+                results->filtered      = std::move(order);
+                results->filteredCount = count;
+                results->sorted        = sorted;
+                results->ordering      = false;
+            });
+        });
+    }
+
+    std::vector<u32> ViewFind::orderResults(Task &task, prv::Provider *provider, const SearchSettings &decodeSettings, const SearchResults &results, std::vector<u32> ids, size_t from, size_t to, const std::string &filter, std::optional<std::pair<SearchResults::SortColumn, bool>> sort) {
+        for (auto i = from; i < to; i++) {
+            if (filter.empty() || decodeValue(provider, decodeSettings, results.get(i)).contains(filter))
+                ids.push_back(u32(i));
+
+            if ((i - from) % 0x1000 == 0)
+                task.update(i - from);
+        }
+
+        if (!sort.has_value())
+            return ids;
+
+        const auto column    = sort->first;
+        const bool ascending = sort->second;
+
+        // Sort keys are calculated once up front, decoding values in the comparison would read from the provider over and over again
+        using enum SearchResults::SortColumn;
+
+        struct SortKey {
+            u64 primary, secondary;
+            std::string value;
+            u32 id;
+        };
+
+        std::vector<SortKey> keys;
+        keys.reserve(ids.size());
+        for (const auto id : ids) {
+            const auto occurrence = results.get(id);
+            const auto address    = occurrence.region.getStartAddress();
+
+            switch (column) {
+                case Offset:
+                    keys.push_back({ address, 0, { }, id });
+                    break;
+                case Size:
+                    keys.push_back({ occurrence.region.getSize(), 0, { }, id });
+                    break;
+                case Value:
+                    keys.push_back({ 0, 0, decodeValue(provider, decodeSettings, occurrence), id });
+                    break;
+                case Distance:
+                    keys.push_back({ occurrence.distance, address, { }, id });
+                    break;
+            }
+
+            if (keys.size() % 0x1000 == 0)
+                task.update(to - from);
+        }
+
+        std::stable_sort(keys.begin(), keys.end(), [column, ascending](const SortKey &left, const SortKey &right) {
+            // Matches with the same distance stay in the order they appear in the data
+            if (column == Distance && left.primary == right.primary)
+                return left.secondary < right.secondary;
+
+            const auto compare = [&](const SortKey &a, const SortKey &b) {
+                return column == Value ? a.value < b.value : a.primary < b.primary;
+            };
+
+            return ascending ? compare(left, right) : compare(right, left);
+        });
+
+        for (size_t i = 0; i < keys.size(); i++)
+            ids[i] = keys[i].id;
+
+        return ids;
+    }
+
     std::string ViewFind::decodeValue(prv::Provider *provider, Occurrence occurrence) const {
+        return decodeValue(provider, this->m_decodeSettings, occurrence);
+    }
+
+    std::string ViewFind::decodeValue(prv::Provider *provider, const SearchSettings &decodeSettings, Occurrence occurrence) {
         std::vector<u8> bytes(std::min<size_t>(occurrence.region.getSize(), 128));
         provider->read(occurrence.region.getStartAddress(), bytes.data(), bytes.size());
 
         std::string result;
-        switch (this->m_decodeSettings.mode) {
+        switch (decodeSettings.mode) {
             using enum SearchSettings::Mode;
 
             case Strings:
@@ -370,15 +1381,32 @@ namespace hex::plugin::builtin {
                         for (size_t i = 1; i < bytes.size(); i += 2)
                             result += hex::encodeByteString({ bytes[i] });
                         break;
-
+                    case UTF8:
+                        result = std::string(bytes.begin(), bytes.end());
+                        break;
                 }
             }
                 break;
             case Sequence:
             case Regex:
             case BinaryPattern:
+            case Fuzzy:
                 result = hex::encodeByteString(bytes);
                 break;
+            case Values: {
+                const auto &settings = decodeSettings.values;
+                if (bytes.size() == search::ValueScanner::getTypeSize(settings.type))
+                    result = search::ValueScanner::formatValue(settings.type, search::ValueScanner::loadValue(bytes, settings.endian));
+                break;
+            }
+            case MultiSequence: {
+                const auto &needles = decodeSettings.multiSequence.needles;
+                if (occurrence.needle < needles.size() && !needles[occurrence.needle].name.empty())
+                    result = hex::format("{}: {}", needles[occurrence.needle].name, hex::encodeByteString(bytes));
+                else
+                    result = hex::encodeByteString(bytes);
+                break;
+            }
         }
 
         return result;
@@ -403,9 +1431,13 @@ namespace hex::plugin::builtin {
         if (ImGui::Begin(View::toWindowName("hex.builtin.view.find.name").c_str(), &this->getWindowOpenState())) {
             auto provider = ImHexApi::Provider::get();
 
-            ImGui::BeginDisabled(this->m_searchTask.isRunning());
+            ImGui::BeginDisabled(this->isSearching());
             {
+                ImGui::BeginDisabled(this->m_searchSettings.allProviders);
                 ui::regionSelectionPicker(&this->m_searchSettings.range, true, true);
+                ImGui::EndDisabled();
+
+                ImGui::Checkbox("hex.builtin.view.find.all_providers"_lang, &this->m_searchSettings.allProviders);
 
                 ImGui::NewLine();
 
@@ -419,12 +1451,14 @@ namespace hex::plugin::builtin {
                         if (settings.minLength < 1)
                             settings.minLength = 1;
 
-                        const std::array<std::string, 5> StringTypes = {
+                        const std::array<std::string, 7> StringTypes = {
                             "hex.builtin.common.encoding.ascii"_lang,
                             "hex.builtin.common.encoding.utf16le"_lang,
                             "hex.builtin.common.encoding.utf16be"_lang,
                             hex::format("{} + {}", "hex.builtin.common.encoding.ascii"_lang, "hex.builtin.common.encoding.utf16le"_lang),
-                            hex::format("{} + {}", "hex.builtin.common.encoding.ascii"_lang, "hex.builtin.common.encoding.utf16be"_lang)
+                            hex::format("{} + {}", "hex.builtin.common.encoding.ascii"_lang, "hex.builtin.common.encoding.utf16be"_lang),
+                            "hex.builtin.common.encoding.utf8"_lang,
+                            hex::format("{} + {} + {}", "hex.builtin.common.encoding.utf8"_lang, "hex.builtin.common.encoding.utf16le"_lang, "hex.builtin.common.encoding.utf16be"_lang)
                         };
 
                         if (ImGui::BeginCombo("hex.builtin.common.type"_lang, StringTypes[std::to_underlying(settings.type)].c_str())) {
@@ -460,6 +1494,7 @@ namespace hex::plugin::builtin {
                         mode = SearchSettings::Mode::Sequence;
 
                         ImGui::InputText("hex.builtin.common.value"_lang, settings.sequence);
+                        ImGui::Checkbox("hex.builtin.view.find.sequences.overlapping"_lang, &settings.overlapping);
 
                         this->m_settingsValid = !settings.sequence.empty();
 
@@ -470,17 +1505,19 @@ namespace hex::plugin::builtin {
 
                         mode = SearchSettings::Mode::Regex;
 
-                        ImGui::InputText("hex.builtin.view.find.regex"_lang, settings.pattern);
-
-                        try {
-                            std::regex regex(settings.pattern);
-                            this->m_settingsValid = true;
-                        } catch (std::regex_error &e) {
-                            this->m_settingsValid = false;
+                        if (ImGui::InputText("hex.builtin.view.find.regex"_lang, settings.pattern)) {
+                            try {
+                                search::Regex regex(settings.pattern);
+                                settings.patternValid = !settings.pattern.empty();
+                            } catch (std::runtime_error &e) {
+                                settings.patternValid = false;
+                            }
                         }
 
-                        if (settings.pattern.empty())
-                            this->m_settingsValid = false;
+                        ImGui::InputInt("hex.builtin.view.find.regex.max_length"_lang, &settings.maxLength, 1, 16);
+                        settings.maxLength = std::clamp(settings.maxLength, 1, 1024 * 1024);
+
+                        this->m_settingsValid = settings.patternValid;
 
                         ImGui::EndTabItem();
                     }
@@ -496,6 +1533,116 @@ namespace hex::plugin::builtin {
 
                         ImGui::EndTabItem();
                     }
+                    if (ImGui::BeginTabItem("hex.builtin.view.find.multi_sequence"_lang)) {
+                        auto &settings = this->m_searchSettings.multiSequence;
+
+                        mode = SearchSettings::Mode::MultiSequence;
+
+                        ImGui::TextFormattedWrapped("{}", "hex.builtin.view.find.multi_sequence.hint"_lang.get());
+                        ImGui::InputTextMultiline("##needles", settings.input, ImVec2(ImGui::GetContentRegionAvail().x, ImGui::GetTextLineHeightWithSpacing() * 6));
+
+                        if (ImGui::Button("hex.builtin.view.find.multi_sequence.load_constants"_lang)) {
+                            if (!settings.input.empty() && !settings.input.ends_with('\n'))
+                                settings.input += '\n';
+                            settings.input += loadConstantNeedles();
+                        }
+
+                        auto needles = parseNeedleList(settings.input);
+                        this->m_settingsValid = needles.has_value();
+                        settings.needles = std::move(needles).value_or(std::vector<SearchSettings::MultiSequence::Needle>{ });
+
+                        ImGui::EndTabItem();
+                    }
+                    if (ImGui::BeginTabItem("hex.builtin.view.find.fuzzy"_lang)) {
+                        auto &settings = this->m_searchSettings.fuzzy;
+
+                        mode = SearchSettings::Mode::Fuzzy;
+
+                        ImGui::InputText("hex.builtin.common.value"_lang, settings.sequence);
+                        ImGui::InputInt("hex.builtin.view.find.fuzzy.max_distance"_lang, &settings.maxDistance, 1, 1);
+                        ImGui::Checkbox("hex.builtin.view.find.fuzzy.edits"_lang, &settings.insertionsDeletions);
+
+                        const auto size = hex::decodeByteString(settings.sequence).size();
+                        settings.maxDistance = std::clamp<int>(settings.maxDistance, 0, std::max<int>(size, 1) - 1);
+
+                        this->m_settingsValid = size > 0 && size <= search::ApproximateMatcher::MaxPatternSize;
+
+                        ImGui::EndTabItem();
+                    }
+                    if (ImGui::BeginTabItem("hex.builtin.view.find.value"_lang)) {
+                        auto &settings = this->m_searchSettings.values;
+
+                        mode = SearchSettings::Mode::Values;
+
+                        constexpr static std::array TypeNames = { "u8", "s8", "u16", "s16", "u32", "s32", "u64", "s64", "float", "double" };
+                        if (ImGui::BeginCombo("hex.builtin.common.type"_lang, TypeNames[std::to_underlying(settings.type)])) {
+                            for (size_t i = 0; i < TypeNames.size(); i++) {
+                                auto type = static_cast<search::ValueScanner::Type>(i);
+
+                                if (ImGui::Selectable(TypeNames[i], type == settings.type))
+                                    settings.type = type;
+                            }
+                            ImGui::EndCombo();
+                        }
+
+                        {
+                            int selection = settings.endian == std::endian::little ? 0 : 1;
+                            std::array options = { "hex.builtin.common.little"_lang, "hex.builtin.common.big"_lang };
+
+                            if (ImGui::SliderInt("hex.builtin.common.endian"_lang, &selection, 0, options.size() - 1, options[selection], ImGuiSliderFlags_NoInput))
+                                settings.endian = selection == 0 ? std::endian::little : std::endian::big;
+                        }
+
+                        ImGui::Checkbox("hex.builtin.view.find.value.aligned"_lang, &settings.aligned);
+
+                        const std::array<std::string, 6> PredicateNames = {
+                            "hex.builtin.view.find.value.equal"_lang,
+                            "hex.builtin.view.find.value.range"_lang,
+                            "hex.builtin.view.find.value.changed"_lang,
+                            "hex.builtin.view.find.value.unchanged"_lang,
+                            "hex.builtin.view.find.value.increased"_lang,
+                            "hex.builtin.view.find.value.decreased"_lang
+                        };
+
+                        if (ImGui::BeginCombo("hex.builtin.view.find.value.condition"_lang, PredicateNames[std::to_underlying(settings.predicate)].c_str())) {
+                            for (size_t i = 0; i < PredicateNames.size(); i++) {
+                                auto predicate = static_cast<search::ValueScanner::Predicate>(i);
+
+                                if (ImGui::Selectable(PredicateNames[i].c_str(), predicate == settings.predicate))
+                                    settings.predicate = predicate;
+                            }
+                            ImGui::EndCombo();
+                        }
+
+                        using enum search::ValueScanner::Predicate;
+                        if (settings.predicate == Equal) {
+                            ImGui::InputText("hex.builtin.common.value"_lang, settings.minimum);
+                        } else if (settings.predicate == Range) {
+                            ImGui::InputText("hex.builtin.view.find.value.min"_lang, settings.minimum);
+                            ImGui::InputText("hex.builtin.view.find.value.max"_lang, settings.maximum);
+                        }
+
+                        // Changes can only be detected once there's a previous scan to compare against
+                        const bool conditionValid = getValueCondition(settings).has_value();
+                        this->m_settingsValid = conditionValid && (settings.predicate == Equal || settings.predicate == Range);
+
+                        // Rescans keep the type of the scan that found the candidates
+                        auto scanner = this->m_valueScanners.find(provider);
+                        const bool canRescan = conditionValid && scanner != this->m_valueScanners.end() &&
+                                               scanner->second->getSettings().type == settings.type &&
+                                               scanner->second->getSettings().endian == settings.endian &&
+                                               scanner->second->getSettings().aligned == settings.aligned;
+
+                        ImGui::BeginDisabled(!canRescan);
+                        if (ImGui::Button("hex.builtin.view.find.value.rescan"_lang)) {
+                            this->runValueRescan();
+
+                            this->m_decodeSettings = this->m_searchSettings;
+                        }
+                        ImGui::EndDisabled();
+
+                        ImGui::EndTabItem();
+                    }
 
                     ImGui::EndTabBar();
                 }
@@ -513,7 +1660,80 @@ namespace hex::plugin::builtin {
                 ImGui::EndDisabled();
 
                 ImGui::SameLine();
-                ImGui::TextFormatted("hex.builtin.view.find.search.entries"_lang, this->m_foundOccurrences[provider].size());
+                ImGui::BeginDisabled(this->m_indexTask.isRunning());
+                {
+                    if (ImGui::Button("hex.builtin.view.find.index.build"_lang))
+                        this->buildSearchIndex(provider);
+                }
+                ImGui::EndDisabled();
+
+                ImGui::SameLine();
+                ImGui::PushItemWidth(ImGui::GetTextLineHeight() * 8);
+                ImGui::InputInt("hex.builtin.view.find.search.limit"_lang, &this->m_searchSettings.maxResults, 1000, 100000);
+                this->m_searchSettings.maxResults = std::max(this->m_searchSettings.maxResults, 1);
+                ImGui::PopItemWidth();
+
+                auto results = this->updateResults(provider);
+
+                ImGui::SameLine();
+                ImGui::TextFormatted("hex.builtin.view.find.search.entries"_lang, results == nullptr ? 0 : results->getSize());
+                if (results != nullptr && results->isFull()) {
+                    ImGui::SameLine();
+                    ImGui::TextFormatted("({})", "hex.builtin.view.find.search.limit_reached"_lang.get());
+                }
+
+                if (this->m_indexTask.isRunning())
+                    ImGui::TextFormattedWrapped("{}", "hex.builtin.view.find.index.building"_lang.get());
+                else if (auto unverified = this->m_unverifiedIndices.find(provider); unverified != this->m_unverifiedIndices.end() && unverified->second.task.isRunning())
+                    ImGui::TextFormattedWrapped("{}", "hex.builtin.view.find.index.verifying"_lang.get());
+                else if (this->m_searchIndices.contains(provider))
+                    ImGui::TextFormattedWrapped("{}", "hex.builtin.view.find.index.ready"_lang.get());
+
+                // Replacing needs all occurrences to have the same size, which only is the case for these searches
+                const auto replaceableMode = this->m_decodeSettings.mode == SearchSettings::Mode::Sequence ||
+                                             this->m_decodeSettings.mode == SearchSettings::Mode::BinaryPattern ||
+                                             this->m_decodeSettings.mode == SearchSettings::Mode::Values;
+                if (results != nullptr && results->finished && results->getSize() > 0 && replaceableMode && provider->isWritable()) {
+                    ImGui::PushItemWidth(ImGui::GetTextLineHeight() * 16);
+                    ImGui::InputTextWithHint("##replacement", "hex.builtin.view.find.replace_with"_lang, this->m_replaceInput);
+                    ImGui::PopItemWidth();
+
+                    auto replacement = this->parseReplacement(this->m_replaceInput);
+
+                    // Replacements of a different size move the data around, that's only possible if the provider can be resized
+                    const auto occurrenceSize = results->get(0).region.getSize();
+                    const auto changesSize = replacement.has_value() && replacement->size() != occurrenceSize;
+                    const auto canReplace  = replacement.has_value() && (!changesSize || provider->isResizable());
+
+                    ImGui::SameLine();
+                    ImGui::BeginDisabled(!canReplace || this->m_replaceTask.isRunning());
+                    if (ImGui::Button("hex.builtin.view.find.replace_all"_lang)) {
+                        // These write to the data directly and move everything following the first occurrence, so they have to be confirmed first
+                        if (changesSize)
+                            ImGui::OpenPopup(View::toWindowName("hex.builtin.view.find.replace_resize.name").c_str());
+                        else
+                            this->replaceAll(provider, *replacement);
+                    }
+                    ImGui::EndDisabled();
+
+                    if (ImGui::BeginPopupModal(View::toWindowName("hex.builtin.view.find.replace_resize.name").c_str(), nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+                        ImGui::NewLine();
+                        ImGui::TextUnformatted("hex.builtin.view.find.replace_resize.desc"_lang);
+                        ImGui::NewLine();
+
+                        View::confirmButtons(
+                            "hex.builtin.common.yes"_lang, "hex.builtin.common.no"_lang,
+                            [&, this] {
+                                if (canReplace && !this->m_replaceTask.isRunning())
+                                    this->replaceAll(provider, *replacement);
+                                ImGui::CloseCurrentPopup();
+                            }, [] {
+                                ImGui::CloseCurrentPopup();
+                            });
+
+                        ImGui::EndPopup();
+                    }
+                }
             }
             ImGui::EndDisabled();
 
@@ -521,49 +1741,65 @@ namespace hex::plugin::builtin {
             ImGui::Separator();
             ImGui::NewLine();
 
-            auto &currOccurrences = this->m_sortedOccurrences[provider];
-
-            ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
-            if (ImGui::InputTextWithHint("##filter", "hex.builtin.common.filter"_lang, this->m_currFilter[provider])) {
-                this->m_sortedOccurrences[provider] = this->m_foundOccurrences[provider];
+            // Results of searches over all providers stay with their provider, this lists them so they can be switched to quickly
+            if (this->m_results.size() > 1 && ImGui::CollapsingHeader("hex.builtin.view.find.provider_results"_lang)) {
+                const auto &providers = ImHexApi::Provider::getProviders();
+                for (u32 i = 0; i < providers.size(); i++) {
+                    auto providerResults = this->updateResults(providers[i]);
+                    if (providerResults == nullptr)
+                        continue;
+
+                    ImGui::PushID(i);
+                    const auto label = hex::format("{} ({})", providers[i]->getName(), providerResults->getSize());
+                    if (ImGui::Selectable(label.c_str(), providers[i] == provider))
+                        ImHexApi::Provider::setCurrentProvider(i);
+                    ImGui::PopID();
+                }
 
-                currOccurrences.erase(std::remove_if(currOccurrences.begin(), currOccurrences.end(), [this, provider](const auto &region) {
-                    return !this->decodeValue(provider, region).contains(this->m_currFilter[provider]);
-                }), currOccurrences.end());
+                ImGui::NewLine();
             }
+
+            auto results = this->updateResults(provider);
+
+            ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
+            if (ImGui::InputTextWithHint("##filter", "hex.builtin.common.filter"_lang, this->m_currFilter[provider]) && results != nullptr)
+                this->startOrdering(provider, this->m_results[provider], true, results->sorted);
             ImGui::PopItemWidth();
 
-            if (ImGui::BeginTable("##entries", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+            // Approximate matches get an extra column with their distance and are ranked by it
+            const bool showDistance = results != nullptr && results->mode == SearchSettings::Mode::Fuzzy;
+            if (results != nullptr && ImGui::BeginTable(showDistance ? "##fuzzy_entries" : "##entries", showDistance ? 4 : 3, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
                 ImGui::TableSetupScrollFreeze(0, 1);
                 ImGui::TableSetupColumn("hex.builtin.common.offset"_lang, 0, -1, ImGui::GetID("offset"));
                 ImGui::TableSetupColumn("hex.builtin.common.size"_lang, 0, -1, ImGui::GetID("size"));
                 ImGui::TableSetupColumn("hex.builtin.common.value"_lang, 0, -1, ImGui::GetID("value"));
+                if (showDistance)
+                    ImGui::TableSetupColumn("hex.builtin.view.find.fuzzy.distance"_lang, ImGuiTableColumnFlags_DefaultSort, -1, ImGui::GetID("distance"));
 
-                auto sortSpecs = ImGui::TableGetSortSpecs();
+                const auto &currOccurrences = results->filtered;
 
-                if (sortSpecs->SpecsDirty) {
-                    std::sort(currOccurrences.begin(), currOccurrences.end(), [this, &sortSpecs, provider](Occurrence &left, Occurrence &right) -> bool {
-                        if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("offset")) {
-                            if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                return left.region.getStartAddress() > right.region.getStartAddress();
-                            else
-                                return left.region.getStartAddress() < right.region.getStartAddress();
-                        } else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("size")) {
-                            if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                return left.region.getSize() > right.region.getSize();
-                            else
-                                return left.region.getSize() < right.region.getSize();
-                        } else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("value")) {
-                            if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                return this->decodeValue(provider, left) > this->decodeValue(provider, right);
-                            else
-                                return this->decodeValue(provider, left) < this->decodeValue(provider, right);
-                        }
-
-                        return false;
-                    });
+                auto sortSpecs = ImGui::TableGetSortSpecs();
 
+                // While the search is still running new occurrences are simply appended, they get sorted in once it's done
+                if (sortSpecs->SpecsDirty && sortSpecs->SpecsCount > 0) {
+                    using enum SearchResults::SortColumn;
+
+                    const auto column = sortSpecs->Specs->ColumnUserID;
+                    if (column == ImGui::GetID("size"))
+                        results->sortColumn = Size;
+                    else if (column == ImGui::GetID("value"))
+                        results->sortColumn = Value;
+                    else if (column == ImGui::GetID("distance"))
+                        results->sortColumn = Distance;
+                    else
+                        results->sortColumn = Offset;
+
+                    results->sortAscending = sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending;
                     sortSpecs->SpecsDirty = false;
+
+                    this->startOrdering(provider, this->m_results[provider], false, true);
+                } else if (!results->sorted && !results->ordering && results->finished) {
+                    this->startOrdering(provider, this->m_results[provider], false, true);
                 }
 
                 ImGui::TableHeadersRow();
@@ -573,7 +1809,7 @@ namespace hex::plugin::builtin {
 
                 while (clipper.Step()) {
                     for (size_t i = clipper.DisplayStart; i < std::min<size_t>(clipper.DisplayEnd, currOccurrences.size()); i++) {
-                        auto &foundItem = currOccurrences[i];
+                        const auto foundItem = results->get(currOccurrences[i]);
 
                         ImGui::TableNextRow();
                         ImGui::TableNextColumn();
@@ -593,6 +1829,11 @@ namespace hex::plugin::builtin {
                         drawContextMenu(value);
 
                         ImGui::PopID();
+
+                        if (showDistance) {
+                            ImGui::TableNextColumn();
+                            ImGui::TextFormatted("{}", foundItem.distance);
+                        }
                     }
                 }
                 clipper.End();
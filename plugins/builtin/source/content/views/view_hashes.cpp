@@ -8,8 +8,50 @@ namespace hex::plugin::builtin {
 
     ViewHashes::ViewHashes() : View("hex.builtin.view.hashes.name") {
         EventManager::subscribe<EventRegionSelected>(this, [this](const Region &) {
-            for (auto &function : this->m_hashFunctions)
-                function.reset();
+            this->startHashing();
+        });
+
+        EventManager::subscribe<EventProviderChanged>(this, [this](prv::Provider *, prv::Provider *) {
+            this->startHashing();
+        });
+
+        EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+            this->m_cachedResults.remove_if([provider](const auto &entry) { return entry.provider == provider; });
+
+            if (this->m_pendingResults.has_value() && this->m_pendingResults->provider == provider) {
+                this->m_hashTask.interrupt();
+                this->m_pendingResults.reset();
+            }
+        });
+
+        EventManager::subscribe<EventDataChanged>(this, [this](prv::Provider *provider, Region changedRegion) {
+            // Every change increments the data version by one. Results that were up-to-date before this change stay valid if the change doesn't touch them
+            const auto previousVersion = provider->getDataVersion() - 1;
+
+            auto updateEntry = [&](CachedResults &entry) {
+                if (entry.provider != provider)
+                    return true;
+                if (entry.region.overlaps(changedRegion))
+                    return false;
+
+                if (entry.dataVersion == previousVersion)
+                    entry.dataVersion = provider->getDataVersion();
+
+                return true;
+            };
+
+            this->m_cachedResults.remove_if([&](auto &entry) { return !updateEntry(entry); });
+
+            if (provider != ImHexApi::Provider::get())
+                return;
+
+            if (this->m_pendingResults.has_value() && !updateEntry(*this->m_pendingResults))
+                this->startHashing();
+            else if (!this->m_pendingResults.has_value() && !this->m_hashFunctions.empty()) {
+                auto selection = ImHexApi::HexEditor::getSelection();
+                if (selection.has_value() && this->findResults(provider, *selection) == nullptr)
+                    this->startHashing();
+            }
         });
 
         ImHexApi::HexEditor::addTooltipProvider([this](u64 address, const u8 *data, size_t size) {
@@ -30,18 +72,16 @@ namespace hex::plugin::builtin {
 
                         ImGui::Indent();
                         if (ImGui::BeginTable("##hashes_tooltip", 3, ImGuiTableFlags_NoHostExtendX | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
-                            auto provider  = ImHexApi::Provider::get();
-                            for (auto &function : this->m_hashFunctions) {
+                            for (u32 i = 0; i < this->m_hashFunctions.size(); i++) {
                                 ImGui::TableNextRow();
                                 ImGui::TableNextColumn();
-                                ImGui::TextFormatted("{}", function.getName());
+                                ImGui::TextFormatted("{}", this->m_hashFunctions[i].getName());
 
                                 ImGui::TableNextColumn();
                                 ImGui::TextFormatted("    ");
 
                                 ImGui::TableNextColumn();
-                                if (provider != nullptr)
-                                    ImGui::TextFormatted("{}", crypt::encode16(function.get(*selection, provider)));
+                                this->drawResult(i, false);
                             }
 
                             ImGui::EndTable();
@@ -59,6 +99,128 @@ namespace hex::plugin::builtin {
 
     ViewHashes::~ViewHashes() {
         EventManager::unsubscribe<EventRegionSelected>(this);
+        EventManager::unsubscribe<EventProviderChanged>(this);
+        EventManager::unsubscribe<EventProviderDeleted>(this);
+        EventManager::unsubscribe<EventDataChanged>(this);
+    }
+
+    const std::vector<std::vector<u8>> *ViewHashes::findResults(prv::Provider *provider, const Region &region) const {
+        for (const auto &entry : this->m_cachedResults) {
+            if (entry.provider == provider && entry.region == region && entry.dataVersion == provider->getDataVersion())
+                return &entry.results;
+        }
+
+        return nullptr;
+    }
+
+    bool ViewHashes::isOutdated(const CachedResults &entry) {
+        if (entry.dataVersion != entry.provider->getDataVersion())
+            return true;
+
+        // Volatile data may have changed without the provider noticing it
+        return entry.provider->isDataVolatile() && (std::chrono::steady_clock::now() - entry.calculationTime) > VolatileResultsLifetime;
+    }
+
+    void ViewHashes::invalidateResults() {
+        this->m_cachedResults.clear();
+        this->startHashing();
+    }
+
+    void ViewHashes::startHashing() {
+        this->m_hashTask.interrupt();
+        this->m_hashGeneration++;
+        this->m_pendingResults.reset();
+
+        auto provider  = ImHexApi::Provider::get();
+        auto selection = ImHexApi::HexEditor::getSelection();
+        if (provider == nullptr || !selection.has_value() || this->m_hashFunctions.empty())
+            return;
+
+        // Move already calculated results to the front so they're the last ones to get evicted
+        auto cached = std::find_if(this->m_cachedResults.begin(), this->m_cachedResults.end(), [&](const auto &entry) {
+            return entry.provider == provider && entry.region == *selection && !isOutdated(entry);
+        });
+        if (cached != this->m_cachedResults.end()) {
+            this->m_cachedResults.splice(this->m_cachedResults.begin(), this->m_cachedResults, cached);
+            return;
+        }
+
+        this->m_pendingResults = CachedResults { provider, *selection, provider->getDataVersion(), { }, { } };
+
+        // The selection is read only once and fed into all hash functions at the same time. Functions that can't be calculated incrementally
+        // get the whole region afterwards
+        this->m_hashTask = TaskManager::createTask("hex.builtin.view.hashes.calculating", selection->getSize(), [this, provider, region = *selection, functions = this->m_hashFunctions, generation = this->m_hashGeneration](auto &task) mutable {
+            std::vector<std::unique_ptr<crypt::HashContext>> contexts;
+            std::vector<crypt::HashContext *> streamedContexts;
+            for (const auto &function : functions) {
+                auto &context = contexts.emplace_back(function.createContext());
+                if (context != nullptr)
+                    streamedContexts.push_back(context.get());
+            }
+
+            crypt::updateAll(streamedContexts, region.getStartAddress(), region.getSize(),
+                [provider](u64 offset, std::span<u8> buffer) {
+                    provider->read(offset, buffer.data(), buffer.size());
+                },
+                [&task](u64 processedBytes) {
+                    task.update(processedBytes);
+                });
+
+            std::vector<std::vector<u8>> results;
+            for (u32 i = 0; i < functions.size(); i++) {
+                if (contexts[i] != nullptr)
+                    results.push_back(contexts[i]->finish());
+                else
+                    results.push_back(functions[i].get(region, provider));
+            }
+
+            TaskManager::doLater([this, generation, results = std::move(results)]() mutable {
+                if (generation != this->m_hashGeneration || !this->m_pendingResults.has_value())
+                    return;
+
+                auto entry = std::move(*this->m_pendingResults);
+                this->m_pendingResults.reset();
+
+                // The data has been modified inside of the hashed region while hashing. The calculation has already been restarted in this case
+                if (entry.dataVersion != entry.provider->getDataVersion())
+                    return;
+
+                entry.results         = std::move(results);
+                entry.calculationTime = std::chrono::steady_clock::now();
+
+                // Replace the results of a previous calculation of the same region. These are kept around until now so results of volatile data
+                // can still be displayed while they're being recalculated
+                this->m_cachedResults.remove_if([&](const auto &cachedEntry) { return cachedEntry.provider == entry.provider && cachedEntry.region == entry.region; });
+                this->m_cachedResults.push_front(std::move(entry));
+                if (this->m_cachedResults.size() > MaxCachedResults)
+                    this->m_cachedResults.pop_back();
+            });
+        });
+    }
+
+    void ViewHashes::drawResult(u32 index, bool editable) {
+        const std::vector<std::vector<u8>> *results = nullptr;
+
+        auto provider  = ImHexApi::Provider::get();
+        auto selection = ImHexApi::HexEditor::getSelection();
+        if (provider != nullptr && selection.has_value())
+            results = this->findResults(provider, *selection);
+
+        if (results != nullptr && index < results->size()) {
+            auto result = this->m_hashFunctions[index].getType()->format((*results)[index]);
+
+            if (editable) {
+                ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
+                ImGui::InputText("##result", result, ImGuiInputTextFlags_ReadOnly);
+                ImGui::PopItemWidth();
+            } else {
+                ImGui::TextFormatted("{}", result);
+            }
+        } else if (this->m_pendingResults.has_value()) {
+            ImGui::TextSpinner("hex.builtin.view.hashes.calculating"_lang);
+        } else {
+            ImGui::TextUnformatted("???");
+        }
     }
 
 
@@ -69,6 +231,20 @@ namespace hex::plugin::builtin {
             this->m_selectedHash = hashes.front();
         }
 
+        // No EventDataChanged is posted when volatile data changes on its own, so the results of the selection are recalculated periodically instead
+        if (!this->m_pendingResults.has_value()) {
+            auto provider  = ImHexApi::Provider::get();
+            auto selection = ImHexApi::HexEditor::getSelection();
+            if (provider != nullptr && provider->isDataVolatile() && selection.has_value()) {
+                auto cached = std::find_if(this->m_cachedResults.begin(), this->m_cachedResults.end(), [&](const auto &entry) {
+                    return entry.provider == provider && entry.region == *selection;
+                });
+
+                if (cached != this->m_cachedResults.end() && isOutdated(*cached))
+                    this->startHashing();
+            }
+        }
+
         if (ImGui::Begin(View::toWindowName("hex.builtin.view.hashes.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
             if (ImGui::BeginCombo("hex.builtin.view.hashes.function"_lang, this->m_selectedHash != nullptr ? LangEntry(this->m_selectedHash->getUnlocalizedName()) : "")) {
 
@@ -105,8 +281,10 @@ namespace hex::plugin::builtin {
 
             ImGui::BeginDisabled(this->m_newHashName.empty() || this->m_selectedHash == nullptr);
             if (ImGui::IconButton(ICON_VS_ADD, ImGui::GetStyleColorVec4(ImGuiCol_Text))) {
-                if (this->m_selectedHash != nullptr)
+                if (this->m_selectedHash != nullptr) {
                     this->m_hashFunctions.push_back(this->m_selectedHash->create(this->m_newHashName));
+                    this->invalidateResults();
+                }
             }
             ImGui::EndDisabled();
 
@@ -117,9 +295,6 @@ namespace hex::plugin::builtin {
 
                 ImGui::TableHeadersRow();
 
-                auto provider  = ImHexApi::Provider::get();
-                auto selection = ImHexApi::HexEditor::getSelection();
-
                 std::optional<u32> indexToRemove;
                 for (u32 i = 0; i < this->m_hashFunctions.size(); i++) {
                     auto &function = this->m_hashFunctions[i];
@@ -153,21 +328,14 @@ namespace hex::plugin::builtin {
                     ImGui::TextFormatted("{}", LangEntry(function.getType()->getUnlocalizedName()));
 
                     ImGui::TableNextColumn();
-                    std::string result;
-                    if (provider != nullptr && selection.has_value())
-                        result = crypt::encode16(function.get(*selection, provider));
-                    else
-                        result = "???";
-
-                    ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
-                    ImGui::InputText("##result", result, ImGuiInputTextFlags_ReadOnly);
-                    ImGui::PopItemWidth();
+                    this->drawResult(i, true);
 
                     ImGui::PopID();
                 }
 
                 if (indexToRemove.has_value()) {
                     this->m_hashFunctions.erase(this->m_hashFunctions.begin() + indexToRemove.value());
+                    this->invalidateResults();
                 }
 
                 ImGui::EndTable();
@@ -1180,10 +1180,17 @@ namespace hex::plugin::builtin {
         std::vector<u8> buffer(selection.size, 0x00);
         provider->read(selection.getStartAddress() + provider->getBaseAddress() + provider->getCurrentPageAddress(), buffer.data(), buffer.size());
 
-        std::string str;
-        for (const auto &byte : buffer)
-            str += hex::format("{0:02X} ", byte);
-        str.pop_back();
+        if (buffer.empty())
+            return;
+
+        // Encode everything at once and spread the digits out to make room for the separating spaces
+        std::string str(buffer.size() * 3 - 1, ' ');
+        crypt::encode16(buffer, str);
+        for (size_t i = buffer.size() - 1; i > 0; i--) {
+            str[i * 3 + 1] = str[i * 2 + 1];
+            str[i * 3 + 0] = str[i * 2 + 0];
+            str[i * 3 - 1] = ' ';
+        }
 
         ImGui::SetClipboardText(str.c_str());
     }
@@ -3,16 +3,20 @@
 #include <hex/api/content_registry.hpp>
 
 #include <hex/providers/provider.hpp>
-#include <hex/providers/buffered_reader.hpp>
 
+#include <hex/helpers/entropy.hpp>
 #include <hex/helpers/fs.hpp>
+#include <hex/helpers/literals.hpp>
 #include <hex/helpers/magic.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include <filesystem>
 #include <numeric>
 #include <span>
+#include <utility>
+#include <vector>
 
 #include <implot.h>
 
@@ -20,26 +24,55 @@ namespace hex::plugin::builtin {
 
     using namespace hex::literals;
 
+    namespace {
+
+        constexpr u64 MaximumUpdateSize = 16_MiB;
+
+    }
+
     ViewInformation::ViewInformation() : View("hex.builtin.view.information.name") {
-        EventManager::subscribe<EventDataChanged>(this, [this]() {
-            this->m_dataValid = false;
-            this->m_highestBlockEntropy = 0;
-            this->m_blockEntropy.clear();
-            this->m_averageEntropy = 0;
-            this->m_blockSize = 0;
-            this->m_valueCounts.fill(0x00);
-            this->m_dataMimeType.clear();
-            this->m_dataDescription.clear();
-            this->m_analyzedRegion  = { 0, 0 };
+        EventManager::subscribe<EventDataChanged>(this, [this](prv::Provider *provider, Region region) {
+            // A running analysis of the changed provider would show outdated data once it's done
+            if (provider == this->m_analyzedProvider && this->m_analyzerTask.isRunning()) {
+                this->m_analyzerTask.interrupt();
+                this->m_analysisGeneration++;
+            }
+
+            auto it = this->m_analyses.find(provider);
+            if (it == this->m_analyses.end())
+                return;
+
+            // Small changes only get the blocks they touch analyzed again. Changes to the size of the data or very large changes require a full analysis
+            auto &analysis = *it->second;
+            if (analysis.pendingChange.has_value()) {
+                const auto start = std::min(region.getStartAddress(), analysis.pendingChange->getStartAddress());
+                const auto end   = std::max(region.getEndAddress(), analysis.pendingChange->getEndAddress());
+
+                region = { start, end - start + 1 };
+            }
+
+            if (provider->getActualSize() != analysis.pyramid.getDataSize() || region.getSize() > MaximumUpdateSize) {
+                this->m_analyses.erase(it);
+                return;
+            }
+
+            analysis.pendingChange = region;
+            if (!analysis.updating)
+                this->updateAnalysis(provider, it->second);
         });
 
         EventManager::subscribe<EventRegionSelected>(this, [this](Region region) {
-            if (this->m_blockSize != 0)
-                this->m_entropyHandlePosition = region.getStartAddress() / this->m_blockSize;
+            this->m_entropyHandlePosition = region.getStartAddress();
         });
 
-        EventManager::subscribe<EventProviderDeleted>(this, [this](const auto*) {
-            this->m_dataValid = false;
+        EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+            this->m_analyses.erase(provider);
+
+            if (provider == this->m_analyzedProvider) {
+                this->m_analyzerTask.interrupt();
+                this->m_analysisGeneration++;
+                this->m_analyzedProvider = nullptr;
+            }
         });
 
         ContentRegistry::FileHandler::add({ ".mgc" }, [](const auto &path) {
@@ -60,67 +93,152 @@ namespace hex::plugin::builtin {
         EventManager::unsubscribe<EventProviderDeleted>(this);
     }
 
-    static float calculateEntropy(std::array<ImU64, 256> &valueCounts, size_t blockSize) {
-        float entropy = 0;
+    void ViewInformation::analyze() {
+        auto provider = ImHexApi::Provider::get();
 
-        for (auto count : valueCounts) {
-            if (count == 0) continue;
+        this->m_analyzerTask.interrupt();
+        this->m_analysisGeneration++;
+        this->m_analyzedProvider = provider;
 
-            float probability = static_cast<float>(count) / blockSize;
+        this->m_analyzerTask = TaskManager::createTask("hex.builtin.view.information.analyzing", provider->getActualSize(), [this, provider, generation = this->m_analysisGeneration](auto &task) {
+            Analysis analysis;
+            analysis.generation = generation;
+            analysis.region     = { provider->getBaseAddress(), provider->getActualSize() };
 
-            entropy += probability * std::log2(probability);
-        }
+            {
+                magic::compile();
+
+                analysis.dataDescription = magic::getDescription(provider);
+                analysis.dataMimeType    = magic::getMIMEType(provider);
+            }
+
+            analysis.pyramid.build(provider->getBaseAddress(), provider->getActualSize(),
+                [provider](u64 offset, std::span<u8> buffer) { provider->read(offset, buffer.data(), buffer.size()); },
+                [&task](u64 processedBytes) { task.update(processedBytes); });
 
-        return (-entropy) / 8;    // log2(256) = 8
+            updateSummary(analysis);
+
+            TaskManager::doLater([this, provider, analysis = std::move(analysis)]() mutable {
+                if (analysis.generation != this->m_analysisGeneration)
+                    return;
+
+                this->m_analyses[provider] = std::make_shared<Analysis>(std::move(analysis));
+            });
+        });
     }
 
-    void ViewInformation::analyze() {
-        this->m_analyzerTask = TaskManager::createTask("hex.builtin.view.information.analyzing", 0, [this](auto &task) {
-            auto provider = ImHexApi::Provider::get();
+    void ViewInformation::updateAnalysis(prv::Provider *provider, const std::shared_ptr<Analysis> &analysis) {
+        const auto change = *std::exchange(analysis->pendingChange, std::nullopt);
+        analysis->updating = true;
 
-            task.setMaxValue(provider->getActualSize());
+        // The layout of the pyramid never changes once it's built, so the changed blocks can be analyzed while the old values are still being drawn
+        TaskManager::createTask("hex.builtin.view.information.analyzing", TaskManager::NoProgress, [this, provider, analysis, change](auto &) {
+            auto changes = analysis->pyramid.analyzeChanges(change.getStartAddress(), change.getSize(), [provider](u64 offset, std::span<u8> buffer) {
+                provider->read(offset, buffer.data(), buffer.size());
+            });
 
-            this->m_analyzedRegion = { provider->getBaseAddress(), provider->getBaseAddress() + provider->getSize() };
+            TaskManager::doLater([this, provider, analysis, changes = std::move(changes)] {
+                analysis->updating = false;
 
+                // The analysis might have been replaced or discarded in the meantime
+                auto it = this->m_analyses.find(provider);
+                if (it == this->m_analyses.end() || it->second != analysis)
+                    return;
+
+                analysis->pyramid.apply(changes);
+                updateSummary(*analysis);
+
+                if (analysis->pendingChange.has_value())
+                    this->updateAnalysis(provider, analysis);
+            });
+        });
+    }
+
+    void ViewInformation::updateSummary(Analysis &analysis) {
+        const auto &pyramid = analysis.pyramid;
+
+        std::copy(pyramid.getValueCounts().begin(), pyramid.getValueCounts().end(), analysis.valueCounts.begin());
+
+        // The highest block entropy is taken from a fixed level so it doesn't change while zooming the plot
+        analysis.highestBlockEntropy = 0;
+        for (const auto &node : pyramid.getLevel(pyramid.findLevel(pyramid.getDataSize(), 2048)))
+            analysis.highestBlockEntropy = std::max(analysis.highestBlockEntropy, node.getEntropy());
+    }
+
+    void ViewInformation::drawEntropyPlot(const Analysis &analysis) {
+        const auto &pyramid = analysis.pyramid;
+        const double dataStart = pyramid.getDataOffset();
+        const double dataSize  = pyramid.getDataSize();
+
+        // Newly analyzed data is shown in full first
+        if (analysis.generation != this->m_plottedGeneration) {
+            this->m_plottedGeneration = analysis.generation;
+            this->m_entropyPlotRange  = ImPlotRange(dataStart, dataStart + dataSize);
+        }
+
+        const float plotWidth = ImGui::GetContentRegionAvail().x;
+        if (ImPlot::BeginPlot("##entropy", ImVec2(-1, 0), ImPlotFlags_NoChild | ImPlotFlags_NoTitle | ImPlotFlags_NoMenus | ImPlotFlags_NoBoxSelect | ImPlotFlags_NoMouseText)) {
+            ImPlot::SetupAxes("Address", "Entropy", ImPlotAxisFlags_NoInitialFit, ImPlotAxisFlags_Lock);
+            ImPlot::SetupAxisLimits(ImAxis_Y1, -0.1F, 1.1F, ImGuiCond_Always);
+            ImPlot::SetupLegend(ImPlotLocation_NorthEast, ImPlotLegendFlags_Horizontal);
+
+            if (this->m_entropyPlotRange.has_value()) {
+                ImPlot::SetupAxisLimits(ImAxis_X1, this->m_entropyPlotRange->Min, this->m_entropyPlotRange->Max, ImGuiCond_Always);
+                this->m_entropyPlotRange.reset();
+            }
+
+            // Scrolling and zooming is limited to the analyzed data, it gets corrected in the next frame
+            const auto limits = ImPlot::GetPlotLimits().X;
             {
-                magic::compile();
+                const double width = std::clamp(limits.Size(), std::min<double>(16 * pyramid.getLeafSize(), dataSize), dataSize);
+                const double min   = std::clamp((limits.Min + limits.Max - width) / 2, dataStart, dataStart + dataSize - width);
 
-                this->m_dataDescription = magic::getDescription(provider);
-                this->m_dataMimeType    = magic::getMIMEType(provider);
+                if (min != limits.Min || min + width != limits.Max)
+                    this->m_entropyPlotRange = ImPlotRange(min, min + width);
             }
 
-            this->m_dataValid = true;
+            // The finest level that doesn't have more nodes in the visible range than there are pixels gets plotted
+            const u64 visibleStart = u64(std::clamp(limits.Min - dataStart, 0.0, dataSize));
+            const u64 visibleEnd   = u64(std::clamp(limits.Max - dataStart, 0.0, dataSize));
 
-            {
-                this->m_blockSize = std::max<u32>(std::ceil(provider->getActualSize() / 2048.0F), 256);
+            const auto level    = pyramid.findLevel(std::max<u64>(visibleEnd - visibleStart, 1), std::max<u64>(plotWidth, 1));
+            const auto nodeSize = pyramid.getNodeSize(level);
+            const auto nodes    = pyramid.getLevel(level);
 
-                std::array<ImU64, 256> blockValueCounts = { 0 };
+            // One more node on either side keeps the lines going up to the edges of the plot
+            const u64 firstNode = std::min<u64>(visibleStart / nodeSize, nodes.size());
+            const u64 endNode   = std::min<u64>((visibleEnd + nodeSize - 1) / nodeSize, nodes.size());
 
-                this->m_blockEntropy.clear();
-                this->m_valueCounts.fill(0);
+            this->m_displayedNodeSize  = nodeSize;
+            this->m_displayedNodeCount = endNode - firstNode;
 
-                auto reader = prv::BufferedReader(provider);
+            std::vector<double> addresses, entropy, zeros, printable;
+            for (u64 node = firstNode > 0 ? firstNode - 1 : 0; node < std::min<u64>(endNode + 1, nodes.size()); node++) {
+                addresses.push_back(dataStart + node * nodeSize);
+                entropy.push_back(nodes[node].getEntropy());
+                zeros.push_back(nodes[node].getZeros());
+                printable.push_back(nodes[node].getPrintable());
+            }
 
-                u64 count = 0;
-                for (u8 byte : reader) {
-                    this->m_valueCounts[byte]++;
-                    blockValueCounts[byte]++;
+            // Every node is drawn as a step, the last one gets repeated where it ends
+            if (!addresses.empty()) {
+                addresses.push_back(std::min<double>(addresses.back() + nodeSize, dataStart + dataSize));
+                entropy.push_back(entropy.back());
+                zeros.push_back(zeros.back());
+                printable.push_back(printable.back());
+            }
 
-                    count++;
-                    if ((count % this->m_blockSize) == 0) [[unlikely]] {
-                        this->m_blockEntropy.push_back(calculateEntropy(blockValueCounts, this->m_blockSize));
-                        blockValueCounts = { 0 };
-                        task.update(count);
-                    }
-                }
+            ImPlot::PlotStairs<double>("hex.builtin.view.information.zeros"_lang, addresses.data(), zeros.data(), addresses.size());
+            ImPlot::PlotStairs<double>("hex.builtin.view.information.printable"_lang, addresses.data(), printable.data(), addresses.size());
+            ImPlot::PlotStairs<double>("hex.builtin.view.information.entropy"_lang, addresses.data(), entropy.data(), addresses.size());
 
-                this->m_averageEntropy = calculateEntropy(this->m_valueCounts, provider->getSize());
-                if (!this->m_blockEntropy.empty())
-                    this->m_highestBlockEntropy = *std::max_element(this->m_blockEntropy.begin(), this->m_blockEntropy.end());
-                else
-                    this->m_highestBlockEntropy = 0;
+            if (ImPlot::DragLineX(1, &this->m_entropyHandlePosition, ImGui::GetStyleColorVec4(ImGuiCol_Text))) {
+                const u64 address = u64(std::clamp<double>(this->m_entropyHandlePosition, dataStart, dataStart + dataSize - 1));
+                ImHexApi::HexEditor::setSelection(address, 1);
             }
-        });
+
+            ImPlot::EndPlot();
+        }
     }
 
     void ViewInformation::drawContent() {
@@ -142,7 +260,8 @@ namespace hex::plugin::builtin {
                         ImGui::NewLine();
                     }
 
-                    if (this->m_dataValid) {
+                    if (auto it = this->m_analyses.find(provider); it != this->m_analyses.end()) {
+                        const auto &analysis = *it->second;
 
                         // Analyzed region
                         ImGui::Header("hex.builtin.view.information.region"_lang, true);
@@ -163,7 +282,7 @@ namespace hex::plugin::builtin {
                             ImGui::TableNextColumn();
                             ImGui::TextFormatted("{}", "hex.builtin.view.information.region"_lang);
                             ImGui::TableNextColumn();
-                            ImGui::TextFormatted("0x{:X} - 0x{:X}", this->m_analyzedRegion.getStartAddress(), this->m_analyzedRegion.getEndAddress());
+                            ImGui::TextFormatted("0x{:X} - 0x{:X}", analysis.region.getStartAddress(), analysis.region.getEndAddress());
 
                             ImGui::EndTable();
                         }
@@ -171,7 +290,7 @@ namespace hex::plugin::builtin {
                         ImGui::NewLine();
 
                         // Magic information
-                        if (!(this->m_dataDescription.empty() && this->m_dataMimeType.empty())) {
+                        if (!(analysis.dataDescription.empty() && analysis.dataMimeType.empty())) {
                             ImGui::Header("hex.builtin.view.information.magic"_lang);
 
                             if (ImGui::BeginTable("magic", 2, ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg)) {
@@ -180,18 +299,18 @@ namespace hex::plugin::builtin {
 
                                 ImGui::TableNextRow();
 
-                                if (!this->m_dataDescription.empty()) {
+                                if (!analysis.dataDescription.empty()) {
                                     ImGui::TableNextColumn();
                                     ImGui::TextUnformatted("hex.builtin.view.information.description"_lang);
                                     ImGui::TableNextColumn();
-                                    ImGui::TextFormattedWrapped("{}", this->m_dataDescription.c_str());
+                                    ImGui::TextFormattedWrapped("{}", analysis.dataDescription.c_str());
                                 }
 
-                                if (!this->m_dataMimeType.empty()) {
+                                if (!analysis.dataMimeType.empty()) {
                                     ImGui::TableNextColumn();
                                     ImGui::TextUnformatted("hex.builtin.view.information.mime"_lang);
                                     ImGui::TableNextColumn();
-                                    ImGui::TextFormattedWrapped("{}", this->m_dataMimeType.c_str());
+                                    ImGui::TextFormattedWrapped("{}", analysis.dataMimeType.c_str());
                                 }
 
                                 ImGui::EndTable();
@@ -209,7 +328,7 @@ namespace hex::plugin::builtin {
                             ImGui::TextUnformatted("hex.builtin.view.information.distribution"_lang);
                             if (ImPlot::BeginPlot("##distribution", ImVec2(-1, 0), ImPlotFlags_NoChild | ImPlotFlags_NoLegend | ImPlotFlags_NoMenus | ImPlotFlags_NoBoxSelect)) {
                                 ImPlot::SetupAxes("Address", "Count", ImPlotAxisFlags_Lock, ImPlotAxisFlags_Lock | ImPlotAxisFlags_LogScale);
-                                ImPlot::SetupAxesLimits(0, 256, 1, double(*std::max_element(this->m_valueCounts.begin(), this->m_valueCounts.end())) * 1.1F, ImGuiCond_Always);
+                                ImPlot::SetupAxesLimits(0, 256, 1, double(*std::max_element(analysis.valueCounts.begin(), analysis.valueCounts.end())) * 1.1F, ImGuiCond_Always);
 
                                 static auto x = [] {
                                     std::array<ImU64, 256> result { 0 };
@@ -217,7 +336,7 @@ namespace hex::plugin::builtin {
                                     return result;
                                 }();
 
-                                ImPlot::PlotBars<ImU64>("##bytes", x.data(), this->m_valueCounts.data(), x.size(), 1.0);
+                                ImPlot::PlotBars<ImU64>("##bytes", x.data(), analysis.valueCounts.data(), x.size(), 1.0);
 
                                 ImPlot::EndPlot();
                             }
@@ -226,20 +345,8 @@ namespace hex::plugin::builtin {
 
                             ImGui::TextUnformatted("hex.builtin.view.information.entropy"_lang);
 
-                            if (ImPlot::BeginPlot("##entropy", ImVec2(-1, 0), ImPlotFlags_NoChild | ImPlotFlags_CanvasOnly)) {
-                                ImPlot::SetupAxes("Address", "Entropy", ImPlotAxisFlags_Lock, ImPlotAxisFlags_Lock);
-                                ImPlot::SetupAxesLimits(0, this->m_blockEntropy.size(), -0.1F, 1.1F, ImGuiCond_Always);
-
-                                ImPlot::PlotLine("##entropy_line", this->m_blockEntropy.data(), this->m_blockEntropy.size());
-
-                                if (ImPlot::DragLineX(1, &this->m_entropyHandlePosition, ImGui::GetStyleColorVec4(ImGuiCol_Text))) {
-                                    u64 address = u64(std::max<double>(this->m_entropyHandlePosition, 0) * this->m_blockSize) + provider->getBaseAddress();
-                                    address     = std::min(address, provider->getBaseAddress() + provider->getSize() - 1);
-                                    ImHexApi::HexEditor::setSelection(address, 1);
-                                }
-
-                                ImPlot::EndPlot();
-                            }
+                            if (analysis.pyramid.getDataSize() > 0)
+                                this->drawEntropyPlot(analysis);
 
                             ImPlot::PopStyleColor();
                             ImGui::PopStyleColor();
@@ -257,22 +364,22 @@ namespace hex::plugin::builtin {
                             ImGui::TableNextColumn();
                             ImGui::TextFormatted("{}", "hex.builtin.view.information.block_size"_lang);
                             ImGui::TableNextColumn();
-                            ImGui::TextFormatted("hex.builtin.view.information.block_size.desc"_lang, this->m_blockEntropy.size(), this->m_blockSize);
+                            ImGui::TextFormatted("hex.builtin.view.information.block_size.desc"_lang, this->m_displayedNodeCount, this->m_displayedNodeSize);
 
                             ImGui::TableNextColumn();
                             ImGui::TextFormatted("{}", "hex.builtin.view.information.file_entropy"_lang);
                             ImGui::TableNextColumn();
-                            ImGui::TextFormatted("{:.8f}", this->m_averageEntropy);
+                            ImGui::TextFormatted("{:.8f}", analysis.pyramid.getEntropy());
 
                             ImGui::TableNextColumn();
                             ImGui::TextFormatted("{}", "hex.builtin.view.information.highest_entropy"_lang);
                             ImGui::TableNextColumn();
-                            ImGui::TextFormatted("{:.8f}", this->m_highestBlockEntropy);
+                            ImGui::TextFormatted("{:.8f}", analysis.highestBlockEntropy);
 
                             ImGui::EndTable();
                         }
 
-                        if (this->m_averageEntropy > 0.83 && this->m_highestBlockEntropy > 0.9) {
+                        if (analysis.pyramid.getEntropy() > 0.83 && analysis.highestBlockEntropy > 0.9) {
                             ImGui::NewLine();
                             ImGui::TextFormattedColored(ImVec4(0.92F, 0.25F, 0.2F, 1.0F), "{}", "hex.builtin.view.information.encrypted"_lang);
                         }
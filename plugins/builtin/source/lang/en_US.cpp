@@ -244,8 +244,26 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.view.hashes.type", "Type" },
                     { "hex.builtin.view.hashes.result", "Result" },
                     { "hex.builtin.view.hashes.remove", "Remove hash" },
+                    { "hex.builtin.view.hashes.calculating", "Calculating..." },
                     { "hex.builtin.view.hashes.hover_info", "Hover over the Hex Editor selection and hold down SHIFT to view the hashes of that region." },
 
+                { "hex.builtin.view.block_hashes.name", "Block Hashes" },
+                    { "hex.builtin.view.block_hashes.block_size", "Block size" },
+                    { "hex.builtin.view.block_hashes.only_selection", "Only hash the selection" },
+                    { "hex.builtin.view.block_hashes.calculate", "Calculate" },
+                    { "hex.builtin.view.block_hashes.compare_provider", "Compare with provider" },
+                    { "hex.builtin.view.block_hashes.compare_file", "Compare with file..." },
+                    { "hex.builtin.view.block_hashes.export", "Export..." },
+                    { "hex.builtin.view.block_hashes.calculating", "Calculating block hashes..." },
+                    { "hex.builtin.view.block_hashes.outdated", "The data has changed since the hashes were calculated" },
+                    { "hex.builtin.view.block_hashes.differing", "{} of {} blocks differ from {}" },
+                    { "hex.builtin.view.block_hashes.only_differing", "Only show differing blocks" },
+                    { "hex.builtin.view.block_hashes.block", "Block" },
+                    { "hex.builtin.view.block_hashes.reference", "Reference" },
+                    { "hex.builtin.view.block_hashes.error.unsupported", "This hash can't be calculated for individual blocks" },
+                    { "hex.builtin.view.block_hashes.error.invalid_file", "Invalid block hash file" },
+                    { "hex.builtin.view.block_hashes.error.mismatch", "The loaded blocks were calculated with a different hash, block size or start address" },
+
                 { "hex.builtin.view.help.name", "Help" },
                     { "hex.builtin.view.help.about.name", "About" },
                         { "hex.builtin.view.help.about.translator", "Translated by WerWolv" },
@@ -317,6 +335,8 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.view.information.info_analysis", "Information analysis" },
                     { "hex.builtin.view.information.distribution", "Byte distribution" },
                     { "hex.builtin.view.information.entropy", "Entropy" },
+                    { "hex.builtin.view.information.zeros", "Zero bytes" },
+                    { "hex.builtin.view.information.printable", "Printable characters" },
                     { "hex.builtin.view.information.block_size", "Block size" },
                     { "hex.builtin.view.information.block_size.desc", "{0} blocks of {1} bytes" },
                     { "hex.builtin.view.information.file_entropy", "File entropy" },
@@ -405,6 +425,7 @@ namespace hex::plugin::builtin {
 
                 { "hex.builtin.view.find.name", "Find" },
                     { "hex.builtin.view.find.searching", "Searching..." },
+                    { "hex.builtin.view.find.replacing", "Replacing..." },
                     { "hex.builtin.view.find.demangled", "Demangled" },
                     { "hex.builtin.view.find.strings", "Strings" },
                         { "hex.builtin.view.find.strings.min_length", "Minimum length" },
@@ -419,12 +440,45 @@ namespace hex::plugin::builtin {
                         { "hex.builtin.view.find.strings.spaces", "Spaces" },
                         { "hex.builtin.view.find.strings.line_feeds", "Line Feeds" },
                     { "hex.builtin.view.find.sequences", "Sequences" },
+                        { "hex.builtin.view.find.sequences.overlapping", "Report overlapping matches" },
                     { "hex.builtin.view.find.regex", "Regex" },
+                        { "hex.builtin.view.find.regex.max_length", "Maximum match length" },
                     { "hex.builtin.view.find.binary_pattern", "Binary Pattern" },
+                    { "hex.builtin.view.find.multi_sequence", "Multiple Sequences" },
+                    { "hex.builtin.view.find.multi_sequence.hint", "One sequence per line, optionally named: Name = 4D 5A 90 00" },
+                    { "hex.builtin.view.find.multi_sequence.load_constants", "Load constants" },
+                    { "hex.builtin.view.find.fuzzy", "Fuzzy Sequence" },
+                    { "hex.builtin.view.find.fuzzy.max_distance", "Maximum distance" },
+                    { "hex.builtin.view.find.fuzzy.edits", "Allow insertions and deletions" },
+                    { "hex.builtin.view.find.fuzzy.distance", "Distance" },
+                    { "hex.builtin.view.find.value", "Values" },
+                    { "hex.builtin.view.find.value.aligned", "Aligned" },
+                    { "hex.builtin.view.find.value.condition", "Condition" },
+                    { "hex.builtin.view.find.value.equal", "Equal to" },
+                    { "hex.builtin.view.find.value.range", "Between" },
+                    { "hex.builtin.view.find.value.changed", "Changed" },
+                    { "hex.builtin.view.find.value.unchanged", "Unchanged" },
+                    { "hex.builtin.view.find.value.increased", "Increased" },
+                    { "hex.builtin.view.find.value.decreased", "Decreased" },
+                    { "hex.builtin.view.find.value.min", "Minimum" },
+                    { "hex.builtin.view.find.value.max", "Maximum" },
+                    { "hex.builtin.view.find.value.rescan", "Rescan" },
                     { "hex.builtin.view.find.search", "Search" },
                     { "hex.builtin.view.find.context.copy", "Copy Value" },
                     { "hex.builtin.view.find.context.copy_demangle", "Copy Demangled Value" },
                     { "hex.builtin.view.find.search.entries", "{} entries found" },
+                    { "hex.builtin.view.find.search.limit", "Result limit" },
+                    { "hex.builtin.view.find.search.limit_reached", "limit reached" },
+                    { "hex.builtin.view.find.all_providers", "Search all open providers" },
+                    { "hex.builtin.view.find.provider_results", "Results per provider" },
+                    { "hex.builtin.view.find.replace_with", "Replace with" },
+                    { "hex.builtin.view.find.replace_all", "Replace all" },
+                    { "hex.builtin.view.find.replace_resize.name", "Replace with different size" },
+                    { "hex.builtin.view.find.replace_resize.desc", "Replacing with data of a different size writes to the data directly and moves everything following the first occurrence.\nDo you want to continue?" },
+                    { "hex.builtin.view.find.index.build", "Build index" },
+                    { "hex.builtin.view.find.index.building", "Building search index..." },
+                    { "hex.builtin.view.find.index.verifying", "Verifying the stored search index..." },
+                    { "hex.builtin.view.find.index.ready", "Sequence and binary pattern searches only scan the parts of the data the search index considers" },
 
 
                 { "hex.builtin.command.calc.desc", "Calculator" },
@@ -591,6 +645,7 @@ namespace hex::plugin::builtin {
                         { "hex.builtin.nodes.crypto.aes.nonce", "Nonce" },
                         { "hex.builtin.nodes.crypto.aes.mode", "Mode" },
                         { "hex.builtin.nodes.crypto.aes.key_length", "Key length" },
+                        { "hex.builtin.nodes.crypto.aes.data_unit_size", "Data unit size" },
 
                 { "hex.builtin.nodes.visualizer", "Visualizers" },
                     { "hex.builtin.nodes.visualizer.digram", "Digram" },
@@ -703,6 +758,18 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.tools.ieee756.result.title", "Result" },
                     { "hex.builtin.tools.ieee756.result.float", "Floating Point Result" },
                     { "hex.builtin.tools.ieee756.result.hex", "Hexadecimal Result" },
+                { "hex.builtin.tools.similarity", "Similarity Hashes" },
+                    { "hex.builtin.tools.similarity.description", "Calculates a similarity hash of the current provider and compares it to the other open providers and a list of digests. ssdeep scores go from 0 for nothing in common to 100 for identical data. TLSH distances are 0 for identical data and grow the more the data differs." },
+                    { "hex.builtin.tools.similarity.digests", "Digests" },
+                    { "hex.builtin.tools.similarity.digests.help", "One digest per line, optionally followed by a name" },
+                    { "hex.builtin.tools.similarity.compare", "Compare" },
+                    { "hex.builtin.tools.similarity.hashing", "Hashing..." },
+                    { "hex.builtin.tools.similarity.current", "Current provider:" },
+                    { "hex.builtin.tools.similarity.name", "Name" },
+                    { "hex.builtin.tools.similarity.digest", "Digest" },
+                    { "hex.builtin.tools.similarity.score", "Similarity" },
+                    { "hex.builtin.tools.similarity.distance", "Distance" },
+                    { "hex.builtin.tools.similarity.invalid", "Invalid digest" },
 
                 { "hex.builtin.setting.imhex", "ImHex" },
                     { "hex.builtin.setting.imhex.recent_files", "Recent Files" },
@@ -803,6 +870,12 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.hash.crc.xor_out", "XOR Out" },
                     { "hex.builtin.hash.crc.refl_in", "Reflect In" },
                     { "hex.builtin.hash.crc.refl_out", "Reflect Out" },
+                { "hex.builtin.hash.ssdeep", "ssdeep" },
+                { "hex.builtin.hash.tlsh", "TLSH" },
+                    { "hex.builtin.hash.tlsh.too_short", "Not enough data or too uniform for a TLSH digest" },
+                { "hex.builtin.hash.merkle", "Merkle Tree" },
+                    { "hex.builtin.hash.merkle.hash", "Hash" },
+                    { "hex.builtin.hash.merkle.block_size", "Block size" },
         });
     }
 
@@ -242,8 +242,26 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.view.hashes.type", "类型" },
                     { "hex.builtin.view.hashes.result", "结果" },
                     { "hex.builtin.view.hashes.remove", "移除哈希" },
+                //    { "hex.builtin.view.hashes.calculating", "Calculating..." },
                     { "hex.builtin.view.hashes.hover_info", "将鼠标放在 Hex 编辑器的选区上，按住 SHIFT 来查看其哈希。" },
 
+                //{ "hex.builtin.view.block_hashes.name", "Block Hashes" },
+                //    { "hex.builtin.view.block_hashes.block_size", "Block size" },
+                //    { "hex.builtin.view.block_hashes.only_selection", "Only hash the selection" },
+                //    { "hex.builtin.view.block_hashes.calculate", "Calculate" },
+                //    { "hex.builtin.view.block_hashes.compare_provider", "Compare with provider" },
+                //    { "hex.builtin.view.block_hashes.compare_file", "Compare with file..." },
+                //    { "hex.builtin.view.block_hashes.export", "Export..." },
+                //    { "hex.builtin.view.block_hashes.calculating", "Calculating block hashes..." },
+                //    { "hex.builtin.view.block_hashes.outdated", "The data has changed since the hashes were calculated" },
+                //    { "hex.builtin.view.block_hashes.differing", "{} of {} blocks differ from {}" },
+                //    { "hex.builtin.view.block_hashes.only_differing", "Only show differing blocks" },
+                //    { "hex.builtin.view.block_hashes.block", "Block" },
+                //    { "hex.builtin.view.block_hashes.reference", "Reference" },
+                //    { "hex.builtin.view.block_hashes.error.unsupported", "This hash can't be calculated for individual blocks" },
+                //    { "hex.builtin.view.block_hashes.error.invalid_file", "Invalid block hash file" },
+                //    { "hex.builtin.view.block_hashes.error.mismatch", "The loaded blocks were calculated with a different hash, block size or start address" },
+
 
                 { "hex.builtin.view.help.name", "帮助" },
                     { "hex.builtin.view.help.about.name", "关于" },
@@ -318,6 +336,8 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.view.information.info_analysis", "信息分析" },
                     { "hex.builtin.view.information.distribution", "字节分布" },
                     { "hex.builtin.view.information.entropy", "熵" },
+                    //{ "hex.builtin.view.information.zeros", "Zero bytes" },
+                    //{ "hex.builtin.view.information.printable", "Printable characters" },
                     { "hex.builtin.view.information.block_size", "块大小" },
                     { "hex.builtin.view.information.block_size.desc", "{0} 块 × {1} 字节" },
                     { "hex.builtin.view.information.file_entropy", "文件熵" },
@@ -405,6 +425,7 @@ namespace hex::plugin::builtin {
 
                 //{ "hex.builtin.view.find.name", "Find" },
                 //    { "hex.builtin.view.find.searching", "Searching..." },
+                //    { "hex.builtin.view.find.replacing", "Replacing..." },
                 //    { "hex.builtin.view.find.demangled", "Demangled" },
                 //    { "hex.builtin.view.find.strings", "Strings" },
                 //        { "hex.builtin.view.find.strings.min_length", "Minimum length" },
@@ -419,12 +440,45 @@ namespace hex::plugin::builtin {
                 //        { "hex.builtin.view.find.strings.spaces", "Spaces" },
                 //        { "hex.builtin.view.find.strings.line_feeds", "Line Feeds" },
                 //    { "hex.builtin.view.find.sequences", "Sequences" },
+                //        { "hex.builtin.view.find.sequences.overlapping", "Report overlapping matches" },
                 //    { "hex.builtin.view.find.regex", "Regex" },
+                //        { "hex.builtin.view.find.regex.max_length", "Maximum match length" },
                 //    { "hex.builtin.view.find.binary_pattern", "Binary Pattern" },
+                //    { "hex.builtin.view.find.multi_sequence", "Multiple Sequences" },
+                //    { "hex.builtin.view.find.multi_sequence.hint", "One sequence per line, optionally named: Name = 4D 5A 90 00" },
+                //    { "hex.builtin.view.find.multi_sequence.load_constants", "Load constants" },
+                //    { "hex.builtin.view.find.fuzzy", "Fuzzy Sequence" },
+                //    { "hex.builtin.view.find.fuzzy.max_distance", "Maximum distance" },
+                //    { "hex.builtin.view.find.fuzzy.edits", "Allow insertions and deletions" },
+                //    { "hex.builtin.view.find.fuzzy.distance", "Distance" },
+                //    { "hex.builtin.view.find.value", "Values" },
+                //    { "hex.builtin.view.find.value.aligned", "Aligned" },
+                //    { "hex.builtin.view.find.value.condition", "Condition" },
+                //    { "hex.builtin.view.find.value.equal", "Equal to" },
+                //    { "hex.builtin.view.find.value.range", "Between" },
+                //    { "hex.builtin.view.find.value.changed", "Changed" },
+                //    { "hex.builtin.view.find.value.unchanged", "Unchanged" },
+                //    { "hex.builtin.view.find.value.increased", "Increased" },
+                //    { "hex.builtin.view.find.value.decreased", "Decreased" },
+                //    { "hex.builtin.view.find.value.min", "Minimum" },
+                //    { "hex.builtin.view.find.value.max", "Maximum" },
+                //    { "hex.builtin.view.find.value.rescan", "Rescan" },
                 //    { "hex.builtin.view.find.search", "Search" },
                 //    { "hex.builtin.view.find.context.copy", "Copy Value" },
                 //    { "hex.builtin.view.find.context.copy_demangle", "Copy Demangled Value" },
                 //    { "hex.builtin.view.find.search.entries", "{} entries found" },
+                //    { "hex.builtin.view.find.search.limit", "Result limit" },
+                //    { "hex.builtin.view.find.search.limit_reached", "limit reached" },
+                //    { "hex.builtin.view.find.all_providers", "Search all open providers" },
+                //    { "hex.builtin.view.find.provider_results", "Results per provider" },
+                //    { "hex.builtin.view.find.replace_with", "Replace with" },
+                //    { "hex.builtin.view.find.replace_all", "Replace all" },
+                //    { "hex.builtin.view.find.replace_resize.name", "Replace with different size" },
+                //    { "hex.builtin.view.find.replace_resize.desc", "Replacing with data of a different size writes to the data directly and moves everything following the first occurrence.\nDo you want to continue?" },
+                //    { "hex.builtin.view.find.index.build", "Build index" },
+                //    { "hex.builtin.view.find.index.building", "Building search index..." },
+                //    { "hex.builtin.view.find.index.verifying", "Verifying the stored search index..." },
+                //    { "hex.builtin.view.find.index.ready", "Sequence and binary pattern searches only scan the parts of the data the search index considers" },
 
                 { "hex.builtin.command.calc.desc", "计算器" },
                 { "hex.builtin.command.cmd.desc", "指令" },
@@ -592,6 +646,7 @@ namespace hex::plugin::builtin {
                         { "hex.builtin.nodes.crypto.aes.nonce", "Nonce" },
                         { "hex.builtin.nodes.crypto.aes.mode", "模式" },
                         { "hex.builtin.nodes.crypto.aes.key_length", "密钥长度" },
+                //        { "hex.builtin.nodes.crypto.aes.data_unit_size", "Data unit size" },
 
                 { "hex.builtin.nodes.visualizer", "可视化" },
                     { "hex.builtin.nodes.visualizer.digram", "图表" },
@@ -704,6 +759,18 @@ namespace hex::plugin::builtin {
                         { "hex.builtin.tools.ieee756.result.title", "结果" },
                         { "hex.builtin.tools.ieee756.result.float", "十进制小数表示" },
                         { "hex.builtin.tools.ieee756.result.hex", "十六进制小数表示" },
+                //    { "hex.builtin.tools.similarity", "Similarity Hashes" },
+                //        { "hex.builtin.tools.similarity.description", "Calculates a similarity hash of the current provider and compares it to the other open providers and a list of digests. ssdeep scores go from 0 for nothing in common to 100 for identical data. TLSH distances are 0 for identical data and grow the more the data differs." },
+                //        { "hex.builtin.tools.similarity.digests", "Digests" },
+                //        { "hex.builtin.tools.similarity.digests.help", "One digest per line, optionally followed by a name" },
+                //        { "hex.builtin.tools.similarity.compare", "Compare" },
+                //        { "hex.builtin.tools.similarity.hashing", "Hashing..." },
+                //        { "hex.builtin.tools.similarity.current", "Current provider:" },
+                //        { "hex.builtin.tools.similarity.name", "Name" },
+                //        { "hex.builtin.tools.similarity.digest", "Digest" },
+                //        { "hex.builtin.tools.similarity.score", "Similarity" },
+                //        { "hex.builtin.tools.similarity.distance", "Distance" },
+                //        { "hex.builtin.tools.similarity.invalid", "Invalid digest" },
 
                 { "hex.builtin.setting.imhex", "ImHex" },
                     { "hex.builtin.setting.imhex.recent_files", "最近文件" },
@@ -804,6 +871,12 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.hash.crc.xor_out", "结果异或值" },
                     { "hex.builtin.hash.crc.refl_in", "输入值取反" },
                     { "hex.builtin.hash.crc.refl_out", "输出值取反" },
+                //{ "hex.builtin.hash.ssdeep", "ssdeep" },
+                //{ "hex.builtin.hash.tlsh", "TLSH" },
+                //    { "hex.builtin.hash.tlsh.too_short", "Not enough data or too uniform for a TLSH digest" },
+                //{ "hex.builtin.hash.merkle", "Merkle Tree" },
+                //    { "hex.builtin.hash.merkle.hash", "Hash" },
+                //    { "hex.builtin.hash.merkle.block_size", "Block size" },
         });
     }
 
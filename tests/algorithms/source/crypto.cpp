@@ -1,4 +1,6 @@
 #include <hex/helpers/crypto.hpp>
+#include <hex/helpers/merkle_tree.hpp>
+#include <hex/helpers/similarity_hash.hpp>
 #include <hex/helpers/logger.hpp>
 #include <hex/test/test_provider.hpp>
 #include <hex/test/tests.hpp>
@@ -7,6 +9,12 @@
 #include <vector>
 #include <array>
 #include <algorithm>
+#include <bit>
+#include <functional>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
 #include <fmt/ranges.h>
 
 struct EncodeChek {
@@ -100,6 +108,87 @@ TEST_SEQUENCE("EncodeDecode64") {
     TEST_SUCCESS();
 };
 
+static bool isInvalid16(std::string_view input, std::span<u8> output) {
+    try {
+        hex::crypt::decode16(input, output);
+        return false;
+    } catch (const std::invalid_argument &) {
+        return true;
+    }
+}
+
+static bool isInvalid64(std::string_view input, std::span<u8> output) {
+    try {
+        hex::crypt::decode64(input, output);
+        return false;
+    } catch (const std::invalid_argument &) {
+        return true;
+    }
+}
+
+TEST_SEQUENCE("EncodeDecodeSpans") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u8> byte;
+
+    // Lengths around the vector sizes, checked against a plain implementation
+    for (u32 size = 0; size < 200; size++) {
+        std::vector<u8> original(size);
+        std::generate(original.begin(), original.end(), [&] { return byte(gen); });
+
+        std::string expected16, expected64;
+        for (auto value : original)
+            expected16 += hex::format("{:02X}", value);
+        for (u32 i = 0; i < size; i += 3) {
+            constexpr static std::string_view Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+            const u32 group = (original[i] << 16) | (i + 1 < size ? original[i + 1] << 8 : 0) | (i + 2 < size ? original[i + 2] : 0);
+            expected64 += Alphabet[(group >> 18) & 0x3F];
+            expected64 += Alphabet[(group >> 12) & 0x3F];
+            expected64 += i + 1 < size ? Alphabet[(group >> 6) & 0x3F] : '=';
+            expected64 += i + 2 < size ? Alphabet[group & 0x3F] : '=';
+        }
+
+        std::string encoded16(size * 2, '\0'), encoded64(expected64.size(), '\0');
+        TEST_ASSERT(hex::crypt::encode16(original, encoded16) == encoded16.size());
+        TEST_ASSERT(hex::crypt::encode64(original, encoded64) == encoded64.size());
+        TEST_ASSERT(encoded16 == expected16, "{} / {}", encoded16, expected16);
+        TEST_ASSERT(encoded64 == expected64, "{} / {}", encoded64, expected64);
+
+        std::vector<u8> decoded16(size), decoded64(size + 2);
+        std::transform(encoded16.begin(), encoded16.end(), encoded16.begin(), [](char c) { return char(std::tolower(c)); });
+        TEST_ASSERT(hex::crypt::decode16(encoded16, decoded16) == size);
+        TEST_ASSERT(hex::crypt::decode64(encoded64, decoded64) == size);
+        TEST_ASSERT(decoded16 == original);
+        TEST_ASSERT(std::equal(original.begin(), original.end(), decoded64.begin()));
+
+        // Invalid characters are found at every position
+        if (size > 0) {
+            auto invalid16 = encoded16;
+            invalid16[std::uniform_int_distribution<size_t>(0, invalid16.size() - 1)(gen)] = 'g';
+            TEST_ASSERT(isInvalid16(invalid16, decoded16), "{}", invalid16);
+
+            auto invalid64 = encoded64;
+            invalid64[std::uniform_int_distribution<size_t>(0, invalid64.size() - 1)(gen)] = '.';
+            TEST_ASSERT(isInvalid64(invalid64, decoded64), "{}", invalid64);
+        }
+    }
+
+    std::vector<u8> output(16);
+    TEST_ASSERT(isInvalid16("ABC", output));
+    TEST_ASSERT(isInvalid16("AB CD", output));
+    TEST_ASSERT(isInvalid16(std::string(34, 'A'), output));
+    TEST_ASSERT(!isInvalid16(std::string(32, 'A'), output));
+    TEST_ASSERT(isInvalid64("Kg=", output));
+    TEST_ASSERT(isInvalid64("K===", output));
+    TEST_ASSERT(isInvalid64("Kg==Kg==", output));
+    TEST_ASSERT(isInvalid64("Qv9V\n", output));
+    TEST_ASSERT(!isInvalid64("Qv9VKg==", output));
+    TEST_ASSERT(hex::crypt::decode64(stringToVector("Qv9V\r\nKg==\n")) == (std::vector<u8>{ 0x42, 0xFF, 0x55, 0x2A }));
+
+    TEST_SUCCESS();
+};
+
 TEST_SEQUENCE("EncodeDecodeLEB128") {
     TEST_ASSERT(hex::crypt::encodeUleb128(0) == (std::vector<u8>{ 0 }));
     TEST_ASSERT(hex::crypt::encodeUleb128(0x7F) == (std::vector<u8>{ 0x7F }));
@@ -175,8 +264,8 @@ struct CrcCheck {
     std::vector<u8> data;
 };
 
-template<std::invocable<hex::prv::Provider *&, u64, size_t, u32, u32, u32, bool, bool> Func, typename Range>
-int checkCrcAgainstGondenSamples(Func func, Range golden_samples) {
+template<typename Ret, typename Range>
+int checkCrcAgainstGondenSamples(Ret (*func)(hex::prv::Provider *&, u64, size_t, u32, u32, u32, bool, bool), Range golden_samples) {
     for (auto &i : golden_samples) {
         hex::test::TestProvider provider(&i.data);
         hex::prv::Provider *provider2 = &provider;
@@ -186,8 +275,8 @@ int checkCrcAgainstGondenSamples(Func func, Range golden_samples) {
     TEST_SUCCESS();
 }
 
-template<std::invocable<hex::prv::Provider *&, u64, size_t, u32, u32, u32, bool, bool> Func>
-int checkCrcAgainstRandomData(Func func, int width) {
+template<typename Ret>
+int checkCrcAgainstRandomData(Ret (*func)(hex::prv::Provider *&, u64, size_t, u32, u32, u32, bool, bool), int width) {
     // crc( message + crc(message) ) should be 0
 
     std::random_device rd;
@@ -338,6 +427,95 @@ TEST_SEQUENCE("CRC8Random") {
     TEST_SUCCESS();
 };
 
+// Bitwise implementation of the Rocksoft CRC model
+u32 referenceCrc(u32 numBits, u32 polynomial, u32 init, u32 xorOut, bool reflectIn, bool reflectOut, const std::vector<u8> &data) {
+    auto reflect = [](u64 value, u32 bits) {
+        u64 result = 0;
+        for (u32 i = 0; i < bits; i++)
+            result |= ((value >> i) & 1) << (bits - 1 - i);
+        return result;
+    };
+
+    const u64 mask = (u64(1) << numBits) - 1;
+    u64 crc = init & mask;
+    for (u8 byte : data) {
+        crc ^= (reflectIn ? reflect(byte, 8) : byte) << (numBits - 8);
+        for (u32 i = 0; i < 8; i++)
+            crc = ((crc & (u64(1) << (numBits - 1))) ? (crc << 1) ^ polynomial : crc << 1) & mask;
+    }
+
+    if (reflectOut)
+        crc = reflect(crc, numBits);
+
+    return u32((crc ^ xorOut) & mask);
+}
+
+TEST_SEQUENCE("CRCReference") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u32> value;
+    std::uniform_int_distribution<u8> byte;
+    std::uniform_int_distribution<size_t> length(0, 1024);
+
+    for (int i = 0; i < 3000; i++) {
+        const u32 numBits = 8 << (i % 3);
+        const u32 mask    = u32((u64(1) << numBits) - 1);
+
+        // Also check the well known CRC32 polynomials since some implementations have special code paths for them
+        u32 polynomial = value(gen) & mask;
+        if (i % 30 == 2)
+            polynomial = 0x04C11DB7;
+        else if (i % 30 == 5)
+            polynomial = 0x1EDC6F41;
+
+        const u32 init = value(gen) & mask, xorOut = value(gen) & mask;
+        const bool reflectIn = value(gen) & 1, reflectOut = value(gen) & 1;
+
+        // Some larger inputs so SIMD code paths get used as well
+        std::vector<u8> data(i % 50 == 0 ? 100'000 + length(gen) : length(gen));
+        std::generate(data.begin(), data.end(), [&] { return byte(gen); });
+
+        hex::test::TestProvider provider(&data);
+        hex::prv::Provider *provider2 = &provider;
+
+        const u32 expected = referenceCrc(numBits, polynomial, init, xorOut, reflectIn, reflectOut, data);
+
+        u32 result = 0;
+        std::unique_ptr<hex::crypt::HashContext> context;
+        switch (numBits) {
+            case 8:
+                result  = hex::crypt::crc8(provider2, 0, data.size(), polynomial, init, xorOut, reflectIn, reflectOut);
+                context = hex::crypt::createCRC8Context(polynomial, init, xorOut, reflectIn, reflectOut);
+                break;
+            case 16:
+                result  = hex::crypt::crc16(provider2, 0, data.size(), polynomial, init, xorOut, reflectIn, reflectOut);
+                context = hex::crypt::createCRC16Context(polynomial, init, xorOut, reflectIn, reflectOut);
+                break;
+            default:
+                result  = hex::crypt::crc32(provider2, 0, data.size(), polynomial, init, xorOut, reflectIn, reflectOut);
+                context = hex::crypt::createCRC32Context(polynomial, init, xorOut, reflectIn, reflectOut);
+                break;
+        }
+
+        TEST_ASSERT(result == expected, "width: {} poly: {:#x} init: {:#x} xor: {:#x} refIn: {} refOut: {} size: {} got: {:#x} expected: {:#x}",
+                    numBits, polynomial, init, xorOut, reflectIn, reflectOut, data.size(), result, expected);
+
+        // Feeding the data in randomly sized parts has to give the same result
+        for (size_t offset = 0; offset < data.size();) {
+            const auto partSize = std::min(data.size() - offset, length(gen) * (i % 7 + 1));
+            context->update(std::span(data).subspan(offset, partSize));
+            offset += partSize;
+        }
+
+        const auto contextResult = context->finish();
+        u32 streamed = 0;
+        std::memcpy(&streamed, contextResult.data(), std::min(contextResult.size(), sizeof(streamed)));
+        TEST_ASSERT(streamed == expected, "width: {} poly: {:#x} size: {} got: {:#x} expected: {:#x}", numBits, polynomial, data.size(), streamed, expected);
+    }
+
+    TEST_SUCCESS();
+};
+
 struct HashCheck {
     std::string data;
     std::string result;
@@ -473,3 +651,538 @@ TEST_SEQUENCE("sha512") {
 
     TEST_SUCCESS();
 };
+
+TEST_SEQUENCE("MultiHash") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u8> byte;
+
+    // Larger than a single chunk so the buffer ring gets reused
+    std::vector<u8> data(9 * 1024 * 1024 + 123);
+    std::generate(data.begin(), data.end(), [&] { return byte(gen); });
+
+    hex::test::TestProvider provider(&data);
+    hex::prv::Provider *provider2 = &provider;
+
+    auto md5    = hex::crypt::createMD5Context();
+    auto sha256 = hex::crypt::createSHA256Context();
+    auto crc32  = hex::crypt::createCRC32Context(0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true);
+    auto crc16  = hex::crypt::createCRC16Context(0x8005, 0x0000, 0x0000, true, true);
+
+    const std::vector<hex::crypt::HashContext *> contexts = { md5.get(), sha256.get(), crc32.get(), crc16.get() };
+
+    u64 lastProgress = 0;
+    bool progressIncreasing = true;
+    hex::crypt::updateAll(contexts, 123, data.size() - 123,
+        [&](u64 offset, std::span<u8> buffer) { provider.read(offset, buffer.data(), buffer.size()); },
+        [&](u64 processed) { progressIncreasing = progressIncreasing && processed > lastProgress; lastProgress = processed; });
+
+    TEST_ASSERT(progressIncreasing);
+    TEST_ASSERT(lastProgress == data.size() - 123);
+
+    auto expectedMd5    = hex::crypt::md5(provider2, 123, data.size() - 123);
+    auto expectedSha256 = hex::crypt::sha256(provider2, 123, data.size() - 123);
+    u32 expectedCrc32   = hex::crypt::crc32(provider2, 123, data.size() - 123, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true);
+    u16 expectedCrc16   = hex::crypt::crc16(provider2, 123, data.size() - 123, 0x8005, 0x0000, 0x0000, true, true);
+
+    auto md5Result    = md5->finish();
+    auto sha256Result = sha256->finish();
+    auto crc32Result  = crc32->finish();
+    auto crc16Result  = crc16->finish();
+
+    TEST_ASSERT(std::equal(md5Result.begin(), md5Result.end(), expectedMd5.begin(), expectedMd5.end()));
+    TEST_ASSERT(std::equal(sha256Result.begin(), sha256Result.end(), expectedSha256.begin(), expectedSha256.end()));
+    TEST_ASSERT(std::memcmp(crc32Result.data(), &expectedCrc32, sizeof(u32)) == 0);
+    TEST_ASSERT(std::memcmp(crc16Result.data(), &expectedCrc16, sizeof(u16)) == 0);
+
+    // A single context is fed without any worker threads
+    auto single = hex::crypt::createSHA256Context();
+    hex::crypt::updateAll({ single.get() }, 123, data.size() - 123, [&](u64 offset, std::span<u8> buffer) { provider.read(offset, buffer.data(), buffer.size()); });
+
+    auto singleResult = single->finish();
+    TEST_ASSERT(std::equal(singleResult.begin(), singleResult.end(), expectedSha256.begin(), expectedSha256.end()));
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("BlockHashes") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u8> byte;
+
+    std::vector<u8> data(70 * 1024 * 1024 + 321);
+    std::generate(data.begin(), data.end(), [&] { return byte(gen); });
+
+    hex::test::TestProvider provider(&data);
+    hex::prv::Provider *provider2 = &provider;
+
+    auto read = [&](u64 offset, std::span<u8> buffer) { provider.read(offset, buffer.data(), buffer.size()); };
+    auto createContext = [] { return hex::crypt::createCRC32Context(0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true); };
+
+    // Block sizes that split the data into batches, don't divide the batch size and are larger than a batch
+    for (u64 blockSize : { 4096ULL, 1000ULL * 1000ULL, 33ULL * 1024ULL * 1024ULL }) {
+        const u64 offset = 77, size = data.size() - offset;
+
+        u64 lastProgress = 0;
+        bool progressIncreasing = true;
+        auto results = hex::crypt::hashBlocks(createContext, offset, size, blockSize, read,
+            [&](u64 processed) { progressIncreasing = progressIncreasing && processed > lastProgress; lastProgress = processed; });
+
+        TEST_ASSERT(progressIncreasing);
+        TEST_ASSERT(lastProgress == size);
+        TEST_ASSERT(results.size() == (size + blockSize - 1) / blockSize, "{} blocks of {} bytes", results.size(), blockSize);
+
+        for (u64 block = 0; block < results.size(); block++) {
+            const auto blockOffset = offset + block * blockSize;
+            u32 expected = hex::crypt::crc32(provider2, blockOffset, std::min(blockSize, offset + size - blockOffset), 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true);
+
+            TEST_ASSERT(results[block].size() == sizeof(u32));
+            TEST_ASSERT(std::memcmp(results[block].data(), &expected, sizeof(u32)) == 0, "block {} of {} bytes", block, blockSize);
+        }
+    }
+
+    TEST_ASSERT(hex::crypt::hashBlocks(createContext, 0, 0, 4096, read).empty());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("MerkleTree") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u8> byte;
+
+    constexpr u64 BlockSize = 64 * 1024;
+
+    std::vector<u8> data(5 * 1024 * 1024 + 17);
+    std::generate(data.begin(), data.end(), [&] { return byte(gen); });
+
+    u64 bytesRead = 0;
+    auto read = [&](u64 offset, std::span<u8> buffer) {
+        std::copy_n(data.begin() + offset, buffer.size(), buffer.begin());
+        bytesRead += buffer.size();
+    };
+
+    auto hash = [](std::initializer_list<std::span<const u8>> parts) {
+        auto context = hex::crypt::createSHA256Context();
+        for (auto part : parts)
+            context->update(part);
+
+        return context->finish();
+    };
+
+    // Straightforward recursive definition of the tree to check against
+    const std::array<u8, 1> leafPrefix = { 0x00 }, nodePrefix = { 0x01 };
+    std::function<std::vector<u8>(u64, u64)> expectedRoot = [&](u64 firstBlock, u64 blockCount) {
+        if (blockCount == 1) {
+            const auto offset = firstBlock * BlockSize;
+            return hash({ leafPrefix, std::span(data).subspan(offset, std::min<u64>(BlockSize, data.size() - offset)) });
+        }
+
+        // The left subtree is always complete, only the rightmost nodes of each level can be without a sibling
+        const auto leftCount = std::bit_floor(blockCount - 1);
+        const auto left  = expectedRoot(firstBlock, leftCount);
+        const auto right = expectedRoot(firstBlock + leftCount, blockCount - leftCount);
+
+        return hash({ nodePrefix, left, right });
+    };
+    auto blockCount = [&] { return (data.size() + BlockSize - 1) / BlockSize; };
+
+    hex::crypt::MerkleTree tree(hex::crypt::createSHA256Context, BlockSize);
+    tree.build(data.size(), read);
+
+    TEST_ASSERT(tree.isBuilt());
+    TEST_ASSERT(tree.getLeafCount() == blockCount());
+    TEST_ASSERT(tree.getRootHash() == expectedRoot(0, blockCount()));
+
+    // Small edits only read the blocks they touch
+    for (u32 i = 0; i < 50; i++) {
+        const auto offset = std::uniform_int_distribution<u64>(0, data.size() - 1)(gen);
+        const auto size   = std::min<u64>(std::uniform_int_distribution<u64>(1, 100)(gen), data.size() - offset);
+        for (u64 j = 0; j < size; j++)
+            data[offset + j] = byte(gen);
+
+        tree.invalidate(offset, size);
+        TEST_ASSERT(tree.isOutdated());
+
+        bytesRead = 0;
+        tree.update(data.size(), read);
+
+        TEST_ASSERT(!tree.isOutdated());
+        TEST_ASSERT(bytesRead <= 2 * BlockSize, "{} bytes read for an edit of {} bytes", bytesRead, size);
+        TEST_ASSERT(tree.getRootHash() == expectedRoot(0, blockCount()), "edit at 0x{:X}", offset);
+    }
+
+    // Resizing rehashes the blocks at the end and changes the shape of the tree
+    for (u64 newSize : { data.size() + 1, data.size() + 3 * BlockSize + 5, data.size() - 5 * BlockSize, 4 * BlockSize, BlockSize + 1 }) {
+        const auto oldSize = data.size();
+        data.resize(newSize);
+        for (u64 j = oldSize; j < newSize; j++)
+            data[j] = byte(gen);
+
+        tree.update(data.size(), read);
+
+        TEST_ASSERT(tree.getDataSize() == data.size());
+        TEST_ASSERT(tree.getLeafCount() == blockCount());
+        TEST_ASSERT(tree.getRootHash() == expectedRoot(0, blockCount()), "resize to 0x{:X}", newSize);
+    }
+
+    tree.build(0, read);
+    TEST_ASSERT(tree.getRootHash() == hash({ }));
+
+    TEST_SUCCESS();
+};
+
+namespace {
+
+    std::string toString(const std::vector<u8> &digest) {
+        return { digest.begin(), digest.end() };
+    }
+
+    std::string hashInChunks(std::unique_ptr<hex::crypt::HashContext> context, const std::vector<u8> &data, std::mt19937 &gen) {
+        for (size_t position = 0; position < data.size();) {
+            const auto size = std::min<size_t>(std::uniform_int_distribution<size_t>(0, 100'000)(gen), data.size() - position);
+            context->update(std::span(data).subspan(position, size));
+            position += size;
+        }
+
+        return toString(context->finish());
+    }
+
+    std::string hashString(std::unique_ptr<hex::crypt::HashContext> context, std::string_view string) {
+        context->update({ reinterpret_cast<const u8 *>(string.data()), string.size() });
+
+        return toString(context->finish());
+    }
+
+    // Straightforward spamsum that picks the block size up front and starts over with a smaller one if the digest is too short
+    std::string referenceSsdeep(const std::vector<u8> &data) {
+        constexpr std::string_view Base64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        u64 blockSize = 3;
+        while (blockSize * 64 < data.size())
+            blockSize *= 2;
+
+        while (true) {
+            std::array<u8, 7> window = { };
+            u32 h1 = 0, h2 = 0, h3 = 0, rollingSum = 0;
+            u8 hash1 = 0x27, hash2 = 0x27;
+            std::array<char, 64> digest1 = { }, digest2 = { };
+            u32 length1 = 0, length2 = 0;
+
+            for (size_t i = 0; i < data.size(); i++) {
+                const u8 byte = data[i];
+                h2 = h2 - h1 + 7 * byte;
+                h1 = h1 + byte - window[i % 7];
+                window[i % 7] = byte;
+                h3 = (h3 << 5) ^ byte;
+                rollingSum = h1 + h2 + h3;
+
+                hash1 = ((hash1 * 0x01000193) ^ byte) & 0x3F;
+                hash2 = ((hash2 * 0x01000193) ^ byte) & 0x3F;
+
+                if (rollingSum % blockSize == blockSize - 1) {
+                    digest1[length1] = Base64[hash1];
+                    if (length1 < 63) {
+                        digest1[++length1] = 0;
+                        hash1 = 0x27;
+                    }
+                }
+
+                if (rollingSum % (blockSize * 2) == blockSize * 2 - 1) {
+                    digest2[length2] = Base64[hash2];
+                    if (length2 < 31) {
+                        digest2[++length2] = 0;
+                        hash2 = 0x27;
+                    }
+                }
+            }
+
+            if (blockSize > 3 && length1 < 32) {
+                blockSize /= 2;
+                continue;
+            }
+
+            std::string first(digest1.data(), length1), second(digest2.data(), length2);
+            if (rollingSum != 0) {
+                first += Base64[hash1];
+                second += Base64[hash2];
+            } else {
+                if (digest1[length1] != 0)
+                    first += digest1[length1];
+                if (digest2[length2] != 0)
+                    second += digest2[length2];
+            }
+
+            return std::to_string(blockSize) + ":" + first + ":" + second;
+        }
+    }
+
+}
+
+TEST_SEQUENCE("Ssdeep") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u8> byte;
+
+    std::array golden_samples = {
+  // source: ssdeep's reference algorithm (fuzzy.c, fuzzy_hash_buf), the pangram digest is the one published for ssdeep itself
+        HashCheck { "",
+                    "3::" },
+        HashCheck { "a",
+                    "3:E:E" },
+        HashCheck { "abc",
+                    "3:uG:uG" },
+        HashCheck { "The quick brown fox jumps over the lazy dog",
+                    "3:FJKKIUKact:FHIGi" },
+        HashCheck { "Also called fuzzy hashes, Context Triggered Piecewise Hashes (CTPH) are based on a rolling hash.",
+                    "3:AXGBicFl7Lmf8Y8HUKA/ntQFHEc+4JNrL:AXGHvE8GztQFkCp" },
+        HashCheck { "Also called fuzzy hashes, CTPH are based on a rolling hash.",
+                    "3:AXGBicFlIVEc+4JNrL:AXGHZCp" },
+    };
+
+    for (const auto &sample : golden_samples) {
+        const auto result = hashString(hex::crypt::createSsdeepContext(), sample.data);
+        TEST_ASSERT(result == sample.result, "\"{}\": {} != {}", sample.data, result, sample.result);
+    }
+
+    for (size_t size : { 1, 6, 7, 100, 1000, 10'000, 100'000, 1'000'000, 3'000'000 }) {
+        for (u32 variant = 0; variant < 3; variant++) {
+            // Random data, data with a small alphabet so boundaries are rare and data ending in zeros so the rolling hash ends at zero
+            std::vector<u8> data(size);
+            std::generate(data.begin(), data.end(), [&] { return variant == 1 ? byte(gen) % 4 : byte(gen); });
+            if (variant == 2)
+                std::fill(data.end() - std::min<size_t>(size, 8), data.end(), 0x00);
+
+            const auto expected = referenceSsdeep(data);
+            const auto result   = hashInChunks(hex::crypt::createSsdeepContext(), data, gen);
+
+            TEST_ASSERT(result == expected, "{} bytes: {} != {}", size, result, expected);
+        }
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("SsdeepCompare") {
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<u8> byte;
+
+    std::vector<u8> data(500'000);
+    std::generate(data.begin(), data.end(), [&] { return byte(gen); });
+
+    auto modified = data;
+    for (size_t i = 0; i < 2000; i++)
+        modified[250'000 + i] = byte(gen);
+
+    std::vector<u8> unrelated(data.size());
+    std::generate(unrelated.begin(), unrelated.end(), [&] { return byte(gen); });
+
+    const auto digest          = hashInChunks(hex::crypt::createSsdeepContext(), data, gen);
+    const auto modifiedDigest  = hashInChunks(hex::crypt::createSsdeepContext(), modified, gen);
+    const auto unrelatedDigest = hashInChunks(hex::crypt::createSsdeepContext(), unrelated, gen);
+
+    TEST_ASSERT(hex::crypt::compareSsdeep(digest, digest) == 100u);
+    TEST_ASSERT(hex::crypt::compareSsdeep(digest, digest + ",\"file.bin\"") == 100u);
+    TEST_ASSERT(hex::crypt::compareSsdeep(digest, modifiedDigest).value_or(0) >= 80, "{} / {}", digest, modifiedDigest);
+    TEST_ASSERT(hex::crypt::compareSsdeep(digest, unrelatedDigest) == 0u);
+
+    // Digests of neighbouring block sizes are compared through their common part
+    TEST_ASSERT(hex::crypt::compareSsdeep("96:abcdefghijkl:ABCDEFGHIJKL", "192:ABCDEFGHIJKL:xyz") == 100u);
+    TEST_ASSERT(hex::crypt::compareSsdeep("48:abcdefghijkl:ABCDEFGHIJKL", "192:ABCDEFGHIJKL:xyz") == 0u);
+
+    TEST_ASSERT(!hex::crypt::compareSsdeep("invalid", digest).has_value());
+    TEST_ASSERT(!hex::crypt::compareSsdeep("12abc:def", digest).has_value());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("Tlsh") {
+    std::array golden_samples = {
+  // source: TLSH reference algorithm (tlsh_impl.cpp) with 128 buckets and a 1 byte checksum
+        HashCheck { "The quick brown fox jumps over the lazy dog",
+                    "" },
+        HashCheck { "Also called fuzzy hashes, Context Triggered Piecewise Hashes (CTPH) are based on a rolling hash.",
+                    "T129B012606F5A9E58EB0C7313C0C011200600404E115F9C9699840E4F74F321C11FB074" },
+        HashCheck { "Also called fuzzy hashes, CTPH are based on a rolling hash.",
+                    "T14AA002617E6BAE469640B343D4C0112006249119A15A34A2AF454F5F707771D10A7468" },
+        HashCheck { "Locality sensitive hashes map similar inputs to similar digests, unlike cryptographic hashes which avalanche.",
+                    "T1E3B092A24A9E12080A4882B36F29E4A22119905A2249962C8E1582886445AA902B74B6" },
+    };
+
+    for (const auto &sample : golden_samples) {
+        const auto result = hashString(hex::crypt::createTlshContext(), sample.data);
+        TEST_ASSERT(result == sample.result, "\"{}\": {} != {}", sample.data, result, sample.result);
+    }
+
+    std::mt19937 gen(5678);
+    std::uniform_int_distribution<u8> byte;
+
+    std::vector<u8> data(200'000);
+    std::generate(data.begin(), data.end(), [&] { return byte(gen); });
+
+    auto modified = data;
+    for (size_t i = 0; i < 1000; i++)
+        modified[100'000 + i] = byte(gen);
+
+    std::vector<u8> unrelated(data.size());
+    std::generate(unrelated.begin(), unrelated.end(), [&] { return byte(gen) % 16; });
+
+    auto oneShot = hex::crypt::createTlshContext();
+    oneShot->update(data);
+    const auto digest = toString(oneShot->finish());
+
+    TEST_ASSERT(digest.size() == 72 && digest.starts_with("T1"), "{}", digest);
+    TEST_ASSERT(hashInChunks(hex::crypt::createTlshContext(), data, gen) == digest);
+
+    const auto modifiedDigest  = hashInChunks(hex::crypt::createTlshContext(), modified, gen);
+    const auto unrelatedDigest = hashInChunks(hex::crypt::createTlshContext(), unrelated, gen);
+
+    TEST_ASSERT(hex::crypt::compareTlsh(digest, digest) == 0u);
+    TEST_ASSERT(hex::crypt::compareTlsh(digest, modifiedDigest).value_or(1000) < 50, "{} / {}", digest, modifiedDigest);
+    TEST_ASSERT(hex::crypt::compareTlsh(digest, unrelatedDigest).value_or(0) > 100, "{} / {}", digest, unrelatedDigest);
+    TEST_ASSERT(hex::crypt::compareTlsh(digest.substr(2), modifiedDigest) == hex::crypt::compareTlsh(digest, modifiedDigest));
+
+    // Short or uniform data doesn't get a digest
+    TEST_ASSERT(hashInChunks(hex::crypt::createTlshContext(), std::vector<u8>(49, 0x12), gen).empty());
+    TEST_ASSERT(hashInChunks(hex::crypt::createTlshContext(), std::vector<u8>(10'000, 0x00), gen).empty());
+    TEST_ASSERT(!hex::crypt::compareTlsh("T1XYZ", digest).has_value());
+
+    TEST_SUCCESS();
+};
+
+static std::vector<u8> fromHex(std::string_view string) {
+    std::vector<u8> bytes;
+    for (size_t i = 0; i + 1 < string.size(); i += 2)
+        bytes.push_back(u8(std::stoul(std::string(string.substr(i, 2)), nullptr, 16)));
+
+    return bytes;
+}
+
+static std::vector<u8> aesDecrypt(const hex::crypt::AESDecryptor &decryptor, u64 position, const std::vector<u8> &input) {
+    std::vector<u8> output(input.size());
+    decryptor.decrypt(position, input, output);
+
+    return output;
+}
+
+static bool isInvalidAES(hex::crypt::AESMode mode, hex::crypt::KeyLength keyLength, const std::vector<u8> &key, u64 position = 0, size_t size = 0, u64 dataUnitSize = 512) {
+    try {
+        aesDecrypt(hex::crypt::AESDecryptor(mode, keyLength, key, { }, { }, dataUnitSize), position, std::vector<u8>(size));
+        return false;
+    } catch (const std::invalid_argument &) {
+        return true;
+    }
+}
+
+TEST_SEQUENCE("AESDecrypt") {
+    using hex::crypt::AESDecryptor, hex::crypt::AESMode, hex::crypt::KeyLength;
+
+    // Test vectors from NIST SP 800-38A
+    const auto key128 = fromHex("2b7e151628aed2a6abf7158809cf4f3c");
+    const auto key192 = fromHex("8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b");
+    const auto key256 = fromHex("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4");
+    const auto plain  = fromHex("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51");
+
+    TEST_ASSERT(aesDecrypt(AESDecryptor(AESMode::ECB, KeyLength::Key128Bits, key128, { }, { }), 0, fromHex("3ad77bb40d7a3660a89ecaf32466ef97")) == std::vector(plain.begin(), plain.begin() + 16));
+    TEST_ASSERT(aesDecrypt(AESDecryptor(AESMode::ECB, KeyLength::Key192Bits, key192, { }, { }), 0, fromHex("bd334f1d6e45f25ff712a214571fa5cc")) == std::vector(plain.begin(), plain.begin() + 16));
+    TEST_ASSERT(aesDecrypt(AESDecryptor(AESMode::ECB, KeyLength::Key256Bits, key256, { }, { }), 0, fromHex("f3eed1bdb5d2a03c064b5a7e3db181f8")) == std::vector(plain.begin(), plain.begin() + 16));
+
+    const AESDecryptor ctr(AESMode::CTR, KeyLength::Key128Bits, key128, { 0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7 }, { 0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF });
+    const auto ctrCipher = fromHex("874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff");
+    TEST_ASSERT(aesDecrypt(ctr, 0, ctrCipher) == plain);
+    TEST_ASSERT(aesDecrypt(ctr, 21, std::vector(ctrCipher.begin() + 21, ctrCipher.end())) == std::vector(plain.begin() + 21, plain.end()));
+
+    // The counter carries over into the upper half
+    const AESDecryptor ctrCarry(AESMode::CTR, KeyLength::Key256Bits, key256, { 0, 0, 0, 0, 0, 0, 0, 1 }, { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF });
+    TEST_ASSERT(aesDecrypt(ctrCarry, 0, fromHex("e1c37cbda4ea85ee6157c00634088096a3759e136e635d043011fb7d933c2518d9466bfaff3360d8")) == std::vector<u8>(40, 0x00));
+
+    // Two data units of 48 bytes, the second one is cut short and uses ciphertext stealing. The tweak of the second one carries into the IV
+    std::vector<u8> xtsKey(32);
+    std::iota(xtsKey.begin(), xtsKey.end(), 0x00);
+    const AESDecryptor xts(AESMode::XTS, KeyLength::Key128Bits, xtsKey, { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, { 0x01 }, 48);
+    const auto xtsCipher = fromHex("29b1a0a0038eff0c8634869482c355962c733baf31693259f582b053e67c1927933d63d279b63b6c97c6b6a1e051d792"
+                                   "7a7ce366670bd01ac112b272a1cc61e209ba6560d881d6a5ca39ab81bd6b03a999a7bdf445b81ca5");
+    std::vector<u8> xtsPlain(88);
+    for (u32 i = 0; i < xtsPlain.size(); i++)
+        xtsPlain[i] = u8(i * 7 + 3);
+
+    TEST_ASSERT(aesDecrypt(xts, 0, xtsCipher) == xtsPlain);
+    TEST_ASSERT(aesDecrypt(xts, 48, std::vector(xtsCipher.begin() + 48, xtsCipher.end())) == std::vector(xtsPlain.begin() + 48, xtsPlain.end()));
+
+    TEST_ASSERT(isInvalidAES(AESMode::CBC, KeyLength::Key128Bits, key128));
+    TEST_ASSERT(isInvalidAES(AESMode::ECB, KeyLength::Key256Bits, key128));
+    TEST_ASSERT(isInvalidAES(AESMode::XTS, KeyLength::Key128Bits, key128));
+    TEST_ASSERT(isInvalidAES(AESMode::ECB, KeyLength::Key128Bits, key128, 0, 17));
+    TEST_ASSERT(isInvalidAES(AESMode::XTS, KeyLength::Key128Bits, xtsKey, 16, 32, 48));
+    TEST_ASSERT(isInvalidAES(AESMode::XTS, KeyLength::Key128Bits, xtsKey, 0, 48 + 15, 48));
+    TEST_ASSERT(!isInvalidAES(AESMode::XTS, KeyLength::Key128Bits, xtsKey, 48, 48 + 16, 48));
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("AESDecryptRandom") {
+    using hex::crypt::AESDecryptor, hex::crypt::AESMode, hex::crypt::KeyLength;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u8> byte;
+
+    std::vector<u8> input(5 * 1024 * 1024 + 4096 + 40);
+    std::generate(input.begin(), input.end(), [&] { return byte(gen); });
+
+    std::vector<u8> key(64);
+    std::generate(key.begin(), key.end(), [&] { return byte(gen); });
+
+    const std::array<u8, 8> nonce = { 1, 2, 3, 4, 5, 6, 7, 8 }, iv = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 };
+
+    const std::array decryptors = {
+        AESDecryptor(AESMode::ECB, KeyLength::Key192Bits, std::span(key).first(24), nonce, iv),
+        AESDecryptor(AESMode::CTR, KeyLength::Key128Bits, std::span(key).first(16), nonce, iv),
+        AESDecryptor(AESMode::XTS, KeyLength::Key256Bits, key, nonce, iv, 4096)
+    };
+
+    for (const auto &decryptor : decryptors) {
+        const auto granularity = decryptor.getMode() == AESMode::XTS ? decryptor.getDataUnitSize() : 16;
+        const auto size = decryptor.getMode() == AESMode::ECB ? input.size() / 16 * 16 : input.size();
+        const auto data = std::span(input).first(size);
+
+        std::vector<u8> expected(size);
+        decryptor.decrypt(0, data, expected);
+
+        // Decrypting the data in pieces gives the same result as decrypting all of it at once on multiple threads
+        std::vector<u8> pieces(size);
+        for (u64 offset = 0; offset < size;) {
+            const auto pieceSize = std::min<u64>(std::uniform_int_distribution<u64>(1, 300'000)(gen) / granularity * granularity + granularity, size - offset);
+
+            decryptor.decrypt(offset, data.subspan(offset, pieceSize), std::span(pieces).subspan(offset, pieceSize));
+            offset += pieceSize;
+        }
+        TEST_ASSERT(pieces == expected, "mode {}", u32(decryptor.getMode()));
+
+        if (decryptor.getMode() == AESMode::CTR) {
+            std::vector<u8> unaligned(size - 7);
+            decryptor.decrypt(7, data.subspan(7), unaligned);
+            TEST_ASSERT(std::equal(unaligned.begin(), unaligned.end(), expected.begin() + 7));
+        }
+
+        // Streaming reads from and writes to the same addresses
+        constexpr u64 Offset = 0x1000;
+        std::vector<u8> streamed(size);
+        u64 writtenBytes = 0, lastProgress = 0;
+        bool inOrder = true;
+        decryptor.decrypt(Offset, size, [&](u64 offset, std::span<u8> buffer) {
+            std::copy_n(data.begin() + (offset - Offset), buffer.size(), buffer.begin());
+        }, [&](u64 offset, std::span<const u8> buffer) {
+            inOrder = inOrder && offset == Offset + writtenBytes;
+            std::copy(buffer.begin(), buffer.end(), streamed.begin() + (offset - Offset));
+            writtenBytes += buffer.size();
+        }, [&](u64 processedBytes) {
+            lastProgress = processedBytes;
+        });
+
+        TEST_ASSERT(inOrder && writtenBytes == size && lastProgress == size);
+        TEST_ASSERT(streamed == expected, "mode {}", u32(decryptor.getMode()));
+    }
+
+    TEST_SUCCESS();
+};
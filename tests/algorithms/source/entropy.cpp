@@ -0,0 +1,215 @@
+#include <hex/helpers/entropy.hpp>
+#include <hex/test/tests.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <span>
+#include <vector>
+
+static hex::entropy::Histogram naiveCountValues(std::span<const u8> data) {
+    hex::entropy::Histogram histogram = { };
+    for (u8 byte : data)
+        histogram[byte]++;
+
+    return histogram;
+}
+
+static bool isCloseTo(float value, float expected) {
+    return std::abs(value - expected) < 1E-5F;
+}
+
+static hex::entropy::Histogram countValues(std::span<const u8> data) {
+    hex::entropy::Histogram histogram = { };
+    hex::entropy::countValues(data, histogram);
+
+    return histogram;
+}
+
+static bool matchesNode(const hex::entropy::Node &node, std::span<const u8> data) {
+    const auto counts = naiveCountValues(data);
+
+    u64 printable = counts['\t'] + counts['\n'] + counts['\r'];
+    for (u32 value = 0x20; value < 0x7F; value++)
+        printable += counts[value];
+
+    return std::abs(node.getEntropy() - hex::entropy::calculateEntropy(counts, data.size())) < 2E-5F &&
+           node.zeros == std::lround(counts[0x00] * 255.0 / data.size()) &&
+           node.printable == std::lround(printable * 255.0 / data.size());
+}
+
+TEST_SEQUENCE("EntropyCalculation") {
+    std::vector<u8> data(4096, 0x42);
+    TEST_ASSERT(isCloseTo(hex::entropy::calculateEntropy(countValues(data), data.size()), 0));
+
+    // Two equally common values need a single bit per byte
+    for (size_t i = 0; i < data.size(); i += 2)
+        data[i] = 0x00;
+    TEST_ASSERT(isCloseTo(hex::entropy::calculateEntropy(countValues(data), data.size()), 1.0F / 8));
+
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = u8(i);
+    TEST_ASSERT(isCloseTo(hex::entropy::calculateEntropy(countValues(data), data.size()), 1));
+
+    TEST_ASSERT(hex::entropy::calculateEntropy(hex::entropy::Histogram(), 0) == 0);
+
+    // Unaligned starts and sizes that don't fill the last word
+    for (size_t start = 0; start < 8; start++) {
+        for (size_t size = 0; size < 40; size++) {
+            const auto part = std::span(data).subspan(start, size);
+            TEST_ASSERT(countValues(part) == naiveCountValues(part), "start: {}, size: {}", start, size);
+        }
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("EntropyAnalysisRandom") {
+    std::mt19937_64 gen(std::random_device{}());
+    std::uniform_int_distribution<u16> byte(0x00, 0xFF);
+
+    // Larger than a single batch so both buffers get used and blocks can span multiple batches
+    std::vector<u8> data(70 * 1024 * 1024 + 123);
+    for (size_t i = 0; i < data.size();) {
+        // Alternate between constant runs and random data so the blocks end up with different entropies
+        const auto runSize = std::min<size_t>(std::uniform_int_distribution<size_t>(1, 64 * 1024)(gen), data.size() - i);
+        const auto value = u8(byte(gen));
+        const bool constant = byte(gen) < 0x80;
+
+        for (size_t end = i + runSize; i < end; i++)
+            data[i] = constant ? value : u8(byte(gen));
+    }
+
+    const auto read = [&](u64 offset, std::span<u8> buffer) { std::memcpy(buffer.data(), data.data() + offset, buffer.size()); };
+
+    for (u64 blockSize : { 256, 4096 + 7, 1024 * 1024, 40 * 1024 * 1024 }) {
+        const u64 offset = 77;
+        const u64 size   = data.size() - offset;
+
+        u64 lastProgress = 0;
+        bool progressIncreasing = true;
+        const auto analysis = hex::entropy::analyze(offset, size, blockSize, read,
+            [&](u64 processed) { progressIncreasing = progressIncreasing && processed > lastProgress; lastProgress = processed; });
+
+        TEST_ASSERT(progressIncreasing);
+        TEST_ASSERT(lastProgress == size);
+
+        TEST_ASSERT(analysis.blockSize == blockSize);
+        TEST_ASSERT(analysis.valueCounts == naiveCountValues(std::span(data).subspan(offset)), "block size: {}", blockSize);
+        TEST_ASSERT(analysis.blockEntropy.size() == (size + blockSize - 1) / blockSize, "block size: {}", blockSize);
+
+        for (u64 block = 0; block < analysis.blockEntropy.size(); block++) {
+            const auto blockData = std::span(data).subspan(offset + block * blockSize, std::min(blockSize, size - block * blockSize));
+            const auto expected  = hex::entropy::calculateEntropy(naiveCountValues(blockData), blockData.size());
+
+            TEST_ASSERT(analysis.blockEntropy[block] == expected, "block size: {}, block: {}", blockSize, block);
+        }
+    }
+
+    TEST_ASSERT(hex::entropy::analyze(0, 0, 256, read).blockEntropy.empty());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("EntropyPyramidRandom") {
+    std::mt19937_64 gen(std::random_device{}());
+    std::uniform_int_distribution<u16> byte(0x00, 0xFF);
+
+    std::vector<u8> data(40 * 1024 * 1024 + 123);
+    for (size_t i = 0; i < data.size();) {
+        const auto runSize = std::min<size_t>(std::uniform_int_distribution<size_t>(1, 16 * 1024)(gen), data.size() - i);
+        const auto value = u8(byte(gen));
+        const auto kind = byte(gen) % 3;
+
+        for (size_t end = i + runSize; i < end; i++)
+            data[i] = kind == 0 ? value : kind == 1 ? u8(0x20 + byte(gen) % 0x5F) : u8(byte(gen));
+    }
+
+    const auto read = [&](u64 offset, std::span<u8> buffer) { std::memcpy(buffer.data(), data.data() + offset, buffer.size()); };
+
+    // Smaller than a single leaf, a single unit, a single batch and larger than a batch
+    for (u64 size : { 1, 200, 1000, 64 * 1024, 100 * 1024 + 17, 3 * 1024 * 1024, 40 * 1024 * 1024 }) {
+        const u64 offset = 29;
+
+        u64 lastProgress = 0;
+        bool progressIncreasing = true;
+
+        hex::entropy::Pyramid pyramid;
+        pyramid.build(offset, size, read, [&](u64 processed) { progressIncreasing = progressIncreasing && processed > lastProgress; lastProgress = processed; });
+
+        TEST_ASSERT(progressIncreasing);
+        TEST_ASSERT(lastProgress == size);
+
+        TEST_ASSERT(pyramid.getLeafSize() == hex::entropy::Pyramid::MinimumLeafSize);
+        TEST_ASSERT(pyramid.getLevel(pyramid.getLevelCount() - 1).size() == 1, "size: {}", size);
+        TEST_ASSERT(pyramid.getValueCounts() == naiveCountValues(std::span(data).subspan(offset, size)), "size: {}", size);
+
+        for (u32 level = 0; level < pyramid.getLevelCount(); level++) {
+            const auto nodeSize = pyramid.getNodeSize(level);
+            const auto nodes = pyramid.getLevel(level);
+
+            TEST_ASSERT(nodes.size() == (size + nodeSize - 1) / nodeSize, "size: {}, level: {}", size, level);
+
+            // Checking every node of the lower levels takes too long, the ones at the start and end cover all of the special cases
+            for (u64 index = 0; index < nodes.size(); index++) {
+                if (index == 100 && nodes.size() > 200)
+                    index = nodes.size() - 100;
+
+                const auto nodeData = std::span(data).subspan(offset + index * nodeSize, std::min(nodeSize, size - index * nodeSize));
+                TEST_ASSERT(matchesNode(nodes[index], nodeData), "size: {}, level: {}, index: {}", size, level, index);
+            }
+        }
+
+        TEST_ASSERT(pyramid.findLevel(size, 1) == pyramid.getLevelCount() - 1);
+        TEST_ASSERT(pyramid.findLevel(size, (size + 255) / 256) == 0);
+        if (size >= 1024 * 1024)
+            TEST_ASSERT(pyramid.getNodeSize(pyramid.findLevel(1024 * 1024, 64)) == 16 * 1024);
+    }
+
+    hex::entropy::Pyramid empty;
+    empty.build(0, 0, read);
+    TEST_ASSERT(empty.isBuilt());
+    TEST_ASSERT(empty.getLevel(0).empty());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("EntropyPyramidUpdate") {
+    std::mt19937_64 gen(std::random_device{}());
+    std::uniform_int_distribution<u16> byte(0x00, 0xFF);
+
+    std::vector<u8> data(5 * 1024 * 1024 + 77);
+    for (auto &value : data)
+        value = byte(gen) < 0x80 ? u8(byte(gen)) : 0x00;
+
+    const auto read = [&](u64 offset, std::span<u8> buffer) { std::memcpy(buffer.data(), data.data() + offset, buffer.size()); };
+
+    const u64 offset = 13;
+    const u64 size   = data.size() - offset;
+
+    hex::entropy::Pyramid pyramid;
+    pyramid.build(offset, size, read);
+
+    // Single bytes, a range spanning multiple counted nodes, the very end of the data and a range reaching past it
+    std::vector<std::pair<u64, u64>> changes = { { 100, 1 }, { 70'000, 1 }, { 100'000, 300'000 }, { data.size() - 1, 1 }, { data.size() - 10, 50 } };
+    for (u32 i = 0; i < 20; i++)
+        changes.emplace_back(std::uniform_int_distribution<u64>(offset, data.size() - 1)(gen), 1);
+
+    for (const auto &[address, changeSize] : changes) {
+        for (u64 i = address; i < std::min<u64>(address + changeSize, data.size()); i++)
+            data[i] = u8(byte(gen));
+
+        pyramid.update(address, changeSize, read);
+    }
+
+    hex::entropy::Pyramid expected;
+    expected.build(offset, size, read);
+
+    TEST_ASSERT(pyramid.getValueCounts() == expected.getValueCounts());
+    TEST_ASSERT(pyramid.getLevelCount() == expected.getLevelCount());
+    for (u32 level = 0; level < pyramid.getLevelCount(); level++)
+        TEST_ASSERT(std::ranges::equal(pyramid.getLevel(level), expected.getLevel(level)), "level: {}", level);
+
+    TEST_SUCCESS();
+};
@@ -0,0 +1,129 @@
+#include <hex/helpers/regex.hpp>
+#include <hex/test/tests.hpp>
+
+#include <algorithm>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+using Regex = hex::search::Regex;
+
+static std::vector<std::pair<u64, size_t>> findAll(Regex &regex, std::span<const u8> data, size_t chunkSize) {
+    std::vector<std::pair<u64, size_t>> result;
+    auto callback = [&](const Regex::Match &match) { result.emplace_back(match.offset, match.size); };
+
+    for (size_t offset = 0; offset < data.size(); offset += chunkSize)
+        regex.process(data.subspan(offset, std::min(chunkSize, data.size() - offset)), callback);
+    regex.finish(callback);
+
+    return result;
+}
+
+static std::vector<std::pair<u64, size_t>> findAll(Regex &regex, const std::string &data, size_t chunkSize = 4096) {
+    return findAll(regex, std::span(reinterpret_cast<const u8 *>(data.data()), data.size()), chunkSize);
+}
+
+static bool isInvalid(const std::string &pattern) {
+    try {
+        Regex regex(pattern);
+        return false;
+    } catch (std::runtime_error &) {
+        return true;
+    }
+}
+
+TEST_SEQUENCE("RegexSearch") {
+    using Matches = std::vector<std::pair<u64, size_t>>;
+
+    {
+        Regex regex("[a-z]+[0-9]");
+        TEST_ASSERT(findAll(regex, "xx abc1 de2f3") == Matches({ { 3, 4 }, { 8, 3 }, { 11, 2 } }));
+    }
+
+    {
+        // Raw bytes including zeroes and bytes outside of the ASCII range
+        Regex regex(R"(\x00\xFF+\x01)");
+        TEST_ASSERT(findAll(regex, std::string("\x01\x00\xFF\xFF\x01\x00\x01\x00\xFF\x01", 10)) == Matches({ { 1, 4 }, { 7, 3 } }));
+    }
+
+    {
+        // Leftmost-first alternation and lazy quantifiers
+        Regex alternation("abcd|c");
+        TEST_ASSERT(findAll(alternation, "abcd abc") == Matches({ { 0, 4 }, { 7, 1 } }));
+
+        Regex lazy("a.+?b");
+        TEST_ASSERT(findAll(lazy, "a1b2b a3b") == Matches({ { 0, 3 }, { 6, 3 } }));
+    }
+
+    {
+        // Matches spanning chunk boundaries
+        Regex regex("ab{2,3}c");
+        const std::string data = "abbc.abbbc.abbbbc.abbc";
+        for (size_t chunkSize = 1; chunkSize < data.size(); chunkSize++)
+            TEST_ASSERT(findAll(regex, data, chunkSize) == Matches({ { 0, 4 }, { 5, 5 }, { 18, 4 } }), "chunk size: {}", chunkSize);
+    }
+
+    {
+        // Matches longer than the maximum length are cut off at their start
+        Regex regex("A[^B]*B", 8);
+        TEST_ASSERT(findAll(regex, "xA123B A0123456789B") == Matches({ { 1, 5 }, { 11, 8 } }));
+    }
+
+    {
+        // The maximum length is counted from the start of a match, scanning resumes right after the part that was reported
+        Regex regex("[a-z]+", 4);
+        for (size_t chunkSize = 1; chunkSize <= 16; chunkSize++)
+            TEST_ASSERT(findAll(regex, "abcdefghijklmnop", chunkSize) == Matches({ { 0, 4 }, { 4, 4 }, { 8, 4 }, { 12, 4 } }), "chunk size: {}", chunkSize);
+    }
+
+    TEST_ASSERT(isInvalid("a("));
+    TEST_ASSERT(isInvalid("a)"));
+    TEST_ASSERT(isInvalid("[a-"));
+    TEST_ASSERT(isInvalid("[z-a]"));
+    TEST_ASSERT(isInvalid("*a"));
+    TEST_ASSERT(isInvalid("a**"));
+    TEST_ASSERT(isInvalid(R"(\x4)"));
+    TEST_ASSERT(isInvalid(R"(\q)"));
+    TEST_ASSERT(isInvalid("a{3,1}"));
+    TEST_ASSERT(isInvalid("^a"));
+    TEST_ASSERT(isInvalid("a*"));
+    TEST_ASSERT(isInvalid("a|"));
+    TEST_ASSERT(!isInvalid("a{"));
+    TEST_ASSERT(!isInvalid(R"([\x00-\x1F\]]+)"));
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("RegexSearchRandom") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u32> dataSize(0, 1024);
+    std::uniform_int_distribution<u32> chunkSize(1, 200);
+    std::uniform_int_distribution<u32> character(0, 4);
+
+    // Patterns that behave the same in std::regex's ECMAScript mode
+    const std::vector<std::string> patterns = {
+        "a", "ab", "a+", "a+b", "[ab]+c", "(ab|a)(c|bcd)", "a.*?c", "a.*c", "b{2}", "b{1,3}?c", "(?:ab)+",
+        "a[^c]+c", "(a|b)*c", "\\d", "ca*b|cab+", "a(bc|b)c?", "[^a]{2,}", "(a|ab)(c|bcd)(d*)"
+    };
+
+    for (const auto &pattern : patterns) {
+        Regex regex(pattern, 2048);
+        const std::regex reference(pattern);
+
+        for (int i = 0; i < 50; i++) {
+            std::string data(dataSize(gen), '\x00');
+            std::generate(data.begin(), data.end(), [&] { return "abcd1"[character(gen)]; });
+
+            std::vector<std::pair<u64, size_t>> expected;
+            for (auto it = std::sregex_iterator(data.begin(), data.end(), reference); it != std::sregex_iterator(); ++it)
+                expected.emplace_back(it->position(), it->length());
+
+            const auto size = chunkSize(gen);
+            TEST_ASSERT(findAll(regex, data, size) == expected, "pattern: {} data: {} chunk size: {}", pattern, data, size);
+        }
+    }
+
+    TEST_SUCCESS();
+};
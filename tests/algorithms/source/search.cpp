@@ -0,0 +1,902 @@
+#include <hex/helpers/search.hpp>
+#include <hex/helpers/search_index.hpp>
+#include <hex/test/tests.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <fmt/ranges.h>
+
+static std::vector<size_t> naiveFindAll(const std::vector<u8> &haystack, const std::vector<u8> &needle, bool overlapping) {
+    std::vector<size_t> result;
+
+    auto it = haystack.begin();
+    while (true) {
+        it = std::search(it, haystack.end(), needle.begin(), needle.end());
+        if (it == haystack.end())
+            break;
+
+        result.push_back(it - haystack.begin());
+        it += overlapping ? 1 : needle.size();
+    }
+
+    return result;
+}
+
+TEST_SEQUENCE("SequenceSearch") {
+    const std::vector<u8> haystack = { 0x00, 0xAA, 0xAA, 0xAA, 0xBB, 0x00, 0xAA, 0xAA, 0xBB, 0xCC };
+
+    hex::search::SequenceSearcher searcher({ 0xAA, 0xAA });
+
+    TEST_ASSERT(searcher.find(haystack) == 1);
+    TEST_ASSERT(searcher.find(haystack, 2) == 2);
+    TEST_ASSERT(searcher.find(haystack, 7) == std::nullopt);
+
+    std::vector<size_t> overlapping, nonOverlapping;
+    searcher.findAll(haystack, true, [&](size_t offset) { overlapping.push_back(offset); });
+    searcher.findAll(haystack, false, [&](size_t offset) { nonOverlapping.push_back(offset); });
+
+    TEST_ASSERT(overlapping == std::vector<size_t>({ 1, 2, 6 }));
+    TEST_ASSERT(nonOverlapping == std::vector<size_t>({ 1, 6 }));
+
+    TEST_ASSERT(hex::search::SequenceSearcher({ 0xCC }).find(haystack) == 9);
+    TEST_ASSERT(hex::search::SequenceSearcher({ 0xBB, 0xCC, 0xDD }).find(haystack) == std::nullopt);
+    TEST_ASSERT(hex::search::SequenceSearcher({ }).find(haystack) == std::nullopt);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("SequenceSearchRandom") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u32> haystackSize(0, 4096);
+    std::uniform_int_distribution<u32> needleSize(1, 8);
+    std::uniform_int_distribution<u8> data(0, 3);
+
+    for (int i = 0; i < 500; i++) {
+        std::vector<u8> haystack(haystackSize(gen));
+        std::generate(haystack.begin(), haystack.end(), [&] { return data(gen); });
+
+        std::vector<u8> needle(needleSize(gen));
+        std::generate(needle.begin(), needle.end(), [&] { return data(gen); });
+
+        hex::search::SequenceSearcher searcher(needle);
+
+        for (bool overlapping : { true, false }) {
+            std::vector<size_t> result;
+            searcher.findAll(haystack, overlapping, [&](size_t offset) { result.push_back(offset); });
+
+            TEST_ASSERT(result == naiveFindAll(haystack, needle, overlapping), "needle: {} overlapping: {}", needle, overlapping);
+        }
+    }
+
+    TEST_SUCCESS();
+};
+
+static std::vector<size_t> naiveMatchAll(const std::vector<u8> &haystack, const std::vector<hex::search::MaskedByte> &pattern) {
+    std::vector<size_t> result;
+
+    for (size_t i = 0; i + pattern.size() <= haystack.size(); i++) {
+        bool matches = true;
+        for (size_t j = 0; j < pattern.size() && matches; j++)
+            matches = (haystack[i + j] & pattern[j].mask) == (pattern[j].value & pattern[j].mask);
+
+        if (matches)
+            result.push_back(i + pattern.size() - 1);
+    }
+
+    return result;
+}
+
+TEST_SEQUENCE("BinaryPatternSearch") {
+    const std::vector<u8> haystack = { 0x12, 0x34, 0x56, 0x12, 0x3F, 0x56, 0x12, 0x34, 0x12, 0x34, 0x56 };
+
+    // 12 3? 56
+    hex::search::PatternMatcher matcher({ { 0xFF, 0x12 }, { 0xF0, 0x30 }, { 0xFF, 0x56 } });
+
+    std::vector<size_t> result;
+    matcher.process(haystack, [&](size_t offset) { result.push_back(offset); });
+    TEST_ASSERT(result == std::vector<size_t>({ 2, 5, 10 }), "result: {}", result);
+
+    // Matches crossing the boundary between two calls are still found
+    result.clear();
+    matcher.reset();
+    matcher.process(std::span(haystack).subspan(0, 4), [&](size_t offset) { result.push_back(offset); });
+    matcher.process(std::span(haystack).subspan(4), [&](size_t offset) { result.push_back(offset + 4); });
+    TEST_ASSERT(result == std::vector<size_t>({ 2, 5, 10 }), "result: {}", result);
+
+    // ?? 34
+    result.clear();
+    hex::search::PatternMatcher wildcardMatcher({ { 0x00, 0x00 }, { 0xFF, 0x34 } });
+    wildcardMatcher.process(haystack, [&](size_t offset) { result.push_back(offset); });
+    TEST_ASSERT(result == std::vector<size_t>({ 1, 7, 9 }), "result: {}", result);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("BinaryPatternSearchRandom") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u32> haystackSize(0, 4096);
+    std::uniform_int_distribution<u32> patternSize(1, 300);
+    std::uniform_int_distribution<u32> splitPoint(0, 4096);
+    std::uniform_int_distribution<u8> data(0, 1);
+    std::uniform_int_distribution<u8> mask(0, 3);
+
+    for (int i = 0; i < 300; i++) {
+        std::vector<u8> haystack(haystackSize(gen));
+        std::generate(haystack.begin(), haystack.end(), [&] { return data(gen); });
+
+        // Keep short patterns so there are actually matches to be found, but also test patterns spanning multiple words
+        std::vector<hex::search::MaskedByte> pattern(i % 2 == 0 ? patternSize(gen) % 12 + 1 : patternSize(gen));
+        std::generate(pattern.begin(), pattern.end(), [&] { return hex::search::MaskedByte { u8(mask(gen) == 0 ? 0x00 : 0xFF), data(gen) }; });
+
+        // Make the haystack contain the pattern at least once
+        if (haystack.size() >= pattern.size()) {
+            const auto position = splitPoint(gen) % (haystack.size() - pattern.size() + 1);
+            for (size_t j = 0; j < pattern.size(); j++)
+                haystack[position + j] = pattern[j].value;
+        }
+
+        const auto split = std::min<size_t>(splitPoint(gen), haystack.size());
+
+        std::vector<size_t> result;
+        hex::search::PatternMatcher matcher(pattern);
+        matcher.process(std::span(haystack).subspan(0, split), [&](size_t offset) { result.push_back(offset); });
+        matcher.process(std::span(haystack).subspan(split), [&](size_t offset) { result.push_back(offset + split); });
+
+        TEST_ASSERT(result == naiveMatchAll(haystack, pattern), "pattern size: {}", pattern.size());
+    }
+
+    TEST_SUCCESS();
+};
+
+using StringExtractor = hex::search::StringExtractor;
+
+static std::vector<StringExtractor::String> extractStrings(std::span<const u8> data, const StringExtractor::Settings &settings, size_t chunkSize) {
+    std::vector<StringExtractor::String> result;
+    auto callback = [&](const StringExtractor::String &string) { result.push_back(string); };
+
+    StringExtractor extractor(settings);
+    for (size_t offset = 0; offset < data.size(); offset += chunkSize)
+        extractor.process(data.subspan(offset, std::min(chunkSize, data.size() - offset)), callback);
+    extractor.finish(callback);
+
+    std::sort(result.begin(), result.end(), [](const auto &left, const auto &right) {
+        return std::tuple(left.offset, left.encoding, left.size) < std::tuple(right.offset, right.encoding, right.size);
+    });
+
+    return result;
+}
+
+// Returns the length of the UTF-8 encoded character at the start of the data or 0 if there is no valid character there
+static size_t naiveUtf8CharacterLength(std::span<const u8> data, const StringExtractor::Settings &settings) {
+    if (data[0] < 0x80)
+        return settings.validCharacters[data[0]] ? 1 : 0;
+
+    size_t length;
+    u32 codePoint;
+    if (data[0] >= 0xC2 && data[0] <= 0xDF)
+        length = 2, codePoint = data[0] & 0x1F;
+    else if (data[0] >= 0xE0 && data[0] <= 0xEF)
+        length = 3, codePoint = data[0] & 0x0F;
+    else if (data[0] >= 0xF0 && data[0] <= 0xF4)
+        length = 4, codePoint = data[0] & 0x07;
+    else
+        return 0;
+
+    if (data.size() < length)
+        return 0;
+
+    for (size_t i = 1; i < length; i++) {
+        if ((data[i] & 0xC0) != 0x80)
+            return 0;
+        codePoint = (codePoint << 6) | (data[i] & 0x3F);
+    }
+
+    if (codePoint < (length == 4 ? 0x10000 : length == 3 ? 0x800 : 0xA0) || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+        return 0;
+
+    return length;
+}
+
+static std::vector<StringExtractor::String> naiveExtractStrings(std::span<const u8> data, const StringExtractor::Settings &settings) {
+    using enum StringExtractor::Encoding;
+    std::vector<StringExtractor::String> result;
+
+    auto addString = [&](size_t start, size_t end, size_t characters, StringExtractor::Encoding encoding, size_t terminatorSize) {
+        if (characters < settings.minLength)
+            return;
+
+        if (settings.nullTermination) {
+            if (end + terminatorSize > data.size())
+                return;
+            for (size_t i = 0; i < terminatorSize; i++)
+                if (data[end + i] != 0x00)
+                    return;
+        }
+
+        result.push_back({ start, end - start, encoding });
+    };
+
+    if (settings.ascii || settings.utf8) {
+        for (size_t i = 0; i < data.size();) {
+            size_t end = i, characters = 0;
+            bool multiByte = false;
+            while (end < data.size()) {
+                const auto length = settings.utf8 ? naiveUtf8CharacterLength(data.subspan(end), settings) : (data[end] < 0x80 && settings.validCharacters[data[end]]);
+                if (length == 0)
+                    break;
+
+                multiByte = multiByte || length > 1;
+                end += length;
+                characters++;
+            }
+
+            if (characters > 0) {
+                addString(i, end, characters, multiByte ? UTF8 : ASCII, 1);
+                i = end;
+            } else {
+                i++;
+            }
+        }
+    }
+
+    for (auto encoding : { UTF16LE, UTF16BE }) {
+        if ((encoding == UTF16LE && !settings.utf16le) || (encoding == UTF16BE && !settings.utf16be))
+            continue;
+
+        auto isCharacter = [&](size_t position) {
+            if (position + 1 >= data.size())
+                return false;
+
+            const u8 character = encoding == UTF16LE ? data[position] : data[position + 1];
+            const u8 zero      = encoding == UTF16LE ? data[position + 1] : data[position];
+
+            return zero == 0x00 && character < 0x80 && settings.validCharacters[character];
+        };
+
+        for (size_t i = 0; i < data.size();) {
+            size_t end = i;
+            while (isCharacter(end))
+                end += 2;
+
+            if (end > i) {
+                addString(i, end, (end - i) / 2, encoding, 2);
+                i = end;
+            } else {
+                i++;
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const auto &left, const auto &right) {
+        return std::tuple(left.offset, left.encoding, left.size) < std::tuple(right.offset, right.encoding, right.size);
+    });
+
+    return result;
+}
+
+static std::array<bool, 256> printableCharacters() {
+    std::array<bool, 256> result = { };
+    for (u32 c = 0x20; c < 0x7F; c++)
+        result[c] = true;
+
+    return result;
+}
+
+TEST_SEQUENCE("StringExtraction") {
+    using enum StringExtractor::Encoding;
+
+    const std::string data = std::string("\x01hello\x00world\xFF", 13) + "h\xC3\xA9llo\x02" + std::string("w\x00i\x00n\x00\x00\x00", 8) + "abc";
+    const auto bytes = std::span(reinterpret_cast<const u8 *>(data.data()), data.size());
+
+    StringExtractor::Settings settings = { .validCharacters = printableCharacters(), .minLength = 3, .ascii = true, .utf8 = true, .utf16le = true };
+
+    for (size_t chunkSize : { 1, 3, 64, 1024 }) {
+        auto result = extractStrings(bytes, settings, chunkSize);
+        TEST_ASSERT(result == std::vector<StringExtractor::String>({ { 1, 5, ASCII }, { 7, 5, ASCII }, { 13, 6, UTF8 }, { 20, 6, UTF16LE }, { 28, 3, ASCII } }), "chunk size: {}", chunkSize);
+    }
+
+    settings.nullTermination = true;
+    auto result = extractStrings(bytes, settings, 7);
+    TEST_ASSERT(result == std::vector<StringExtractor::String>({ { 1, 5, ASCII }, { 20, 6, UTF16LE } }));
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("StringExtractionRandom") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u32> dataSize(0, 2048);
+    std::uniform_int_distribution<u32> chunkSize(1, 300);
+    std::uniform_int_distribution<u32> minLength(1, 6);
+    std::uniform_int_distribution<u32> coin(0, 1);
+
+    constexpr static std::array<u8, 16> Alphabet = { 'a', 'Z', '0', ' ', '_', '\n', 0x00, 0x00, 0x01, 0x7F, 0x80, 0xA9, 0xC3, 0xE2, 0xF0, 0x9F };
+    std::uniform_int_distribution<u32> alphabetIndex(0, Alphabet.size() - 1);
+
+    for (int i = 0; i < 500; i++) {
+        std::vector<u8> data(dataSize(gen));
+        std::generate(data.begin(), data.end(), [&] { return Alphabet[alphabetIndex(gen)]; });
+
+        // Alternate between character sets made of a few ranges and ones with lots of gaps
+        StringExtractor::Settings settings;
+        const bool digits = coin(gen);
+        for (u32 c = 0; c < 0x80; c++) {
+            if (i % 2 == 0)
+                settings.validCharacters[c] = std::isalpha(c) || c == ' ' || c == '_' || (digits && std::isdigit(c));
+            else
+                settings.validCharacters[c] = std::isprint(c) && (coin(gen) || c == 'a' || c == ' ');
+        }
+        settings.validCharacters['\n'] = coin(gen);
+        settings.minLength       = minLength(gen);
+        settings.nullTermination = coin(gen);
+        settings.ascii           = coin(gen);
+        settings.utf8            = coin(gen);
+        settings.utf16le         = coin(gen);
+        settings.utf16be         = coin(gen);
+
+        TEST_ASSERT(extractStrings(data, settings, chunkSize(gen)) == naiveExtractStrings(data, settings), "iteration: {}", i);
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("MultiSequenceSearch") {
+    const std::string haystack = "ushers and his hers";
+    const auto data = std::span(reinterpret_cast<const u8 *>(haystack.data()), haystack.size());
+
+    auto toBytes = [](const std::string &string) { return std::vector<u8>(string.begin(), string.end()); };
+    hex::search::MultiSequenceSearcher searcher({ toBytes("he"), toBytes("she"), toBytes("his"), toBytes("hers"), { }, toBytes("he") });
+
+    using Matches = std::vector<std::pair<size_t, size_t>>;
+
+    Matches result;
+    searcher.process(data, [&](size_t needle, size_t end) { result.emplace_back(needle, end); });
+    std::sort(result.begin(), result.end());
+
+    TEST_ASSERT(result == Matches({ { 0, 3 }, { 0, 16 }, { 1, 3 }, { 2, 13 }, { 3, 5 }, { 3, 18 }, { 5, 3 }, { 5, 16 } }), "result: {}", result);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("MultiSequenceSearchRandom") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u32> haystackSize(0, 4096);
+    std::uniform_int_distribution<u32> needleCount(1, 50);
+    std::uniform_int_distribution<u32> needleSize(1, 6);
+    std::uniform_int_distribution<u32> data(0, 3);
+    std::uniform_int_distribution<u32> byteValue(0, 255);
+
+    for (int i = 0; i < 200; i++) {
+        // Use a small alphabet most of the time to get lots of matches, but also test needles using every possible byte value
+        const bool fullRange = i % 4 == 0;
+        auto randomByte = [&] { return u8(fullRange ? byteValue(gen) : data(gen)); };
+
+        std::vector<u8> haystack(haystackSize(gen));
+        std::generate(haystack.begin(), haystack.end(), randomByte);
+
+        std::vector<std::vector<u8>> needles(needleCount(gen));
+        for (auto &needle : needles) {
+            needle.resize(fullRange ? 1 : needleSize(gen));
+            std::generate(needle.begin(), needle.end(), randomByte);
+        }
+
+        std::vector<std::pair<size_t, size_t>> expected;
+        for (size_t needle = 0; needle < needles.size(); needle++) {
+            for (auto offset : naiveFindAll(haystack, needles[needle], true))
+                expected.emplace_back(needle, offset + needles[needle].size() - 1);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        hex::search::MultiSequenceSearcher searcher(needles);
+
+        const auto split = haystack.size() / 2;
+        std::vector<std::pair<size_t, size_t>> result;
+        searcher.process(std::span(haystack).subspan(0, split), [&](size_t needle, size_t end) { result.emplace_back(needle, end); });
+        searcher.process(std::span(haystack).subspan(split), [&](size_t needle, size_t end) { result.emplace_back(needle, end + split); });
+        std::sort(result.begin(), result.end());
+
+        TEST_ASSERT(result == expected, "iteration: {}", i);
+    }
+
+    TEST_SUCCESS();
+};
+
+using ApproximateMatches = std::vector<std::tuple<u64, size_t, u32>>;
+
+static ApproximateMatches findApproximate(const std::vector<u8> &haystack, const std::vector<u8> &pattern, u32 maxDistance, hex::search::ApproximateMatcher::Metric metric, size_t split) {
+    hex::search::ApproximateMatcher matcher(pattern, maxDistance, metric);
+
+    ApproximateMatches result;
+    const auto callback = [&](const auto &match) { result.emplace_back(match.offset, match.size, match.distance); };
+    matcher.process(std::span(haystack).subspan(0, split), callback);
+    matcher.process(std::span(haystack).subspan(split), callback);
+    matcher.finish(callback);
+
+    return result;
+}
+
+static u32 naiveEditDistance(std::span<const u8> a, std::span<const u8> b) {
+    std::vector<u32> column(b.size() + 1);
+    std::iota(column.begin(), column.end(), 0);
+
+    for (size_t i = 1; i <= a.size(); i++) {
+        u32 diagonal = column[0];
+        column[0] = i;
+        for (size_t j = 1; j <= b.size(); j++) {
+            const u32 above = column[j];
+            column[j] = std::min({ column[j] + 1, column[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1] ? 1 : 0) });
+            diagonal = above;
+        }
+    }
+
+    return column[b.size()];
+}
+
+TEST_SEQUENCE("ApproximateSearch") {
+    using enum hex::search::ApproximateMatcher::Metric;
+
+    const std::string text = "xxHELLOxxHELPOxxHELOxxHEXLLOxx";
+    const std::vector<u8> haystack(text.begin(), text.end());
+    const std::vector<u8> pattern = { 'H', 'E', 'L', 'L', 'O' };
+
+    const auto hamming = findApproximate(haystack, pattern, 1, Hamming, 11);
+    const ApproximateMatches expectedHamming = { { 2, 5, 0 }, { 9, 5, 1 } };
+    TEST_ASSERT(hamming == expectedHamming, "result: {}", hamming);
+
+    const auto edits = findApproximate(haystack, pattern, 1, Levenshtein, 11);
+    const ApproximateMatches expectedEdits = { { 2, 5, 0 }, { 9, 5, 1 }, { 16, 4, 1 }, { 22, 6, 1 } };
+    TEST_ASSERT(edits == expectedEdits, "result: {}", edits);
+
+    bool threw = false;
+    try {
+        hex::search::ApproximateMatcher matcher(pattern, 5, Hamming);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    TEST_ASSERT(threw);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ApproximateSearchRandom") {
+    using enum hex::search::ApproximateMatcher::Metric;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u32> haystackSize(0, 2048);
+    std::uniform_int_distribution<u32> patternSize(2, 64);
+    std::uniform_int_distribution<u32> data(0, 3);
+
+    for (int i = 0; i < 200; i++) {
+        std::vector<u8> haystack(haystackSize(gen));
+        std::generate(haystack.begin(), haystack.end(), [&] { return u8(data(gen)); });
+
+        std::vector<u8> pattern(patternSize(gen));
+        std::generate(pattern.begin(), pattern.end(), [&] { return u8(data(gen)); });
+
+        const auto maxDistance = std::uniform_int_distribution<u32>(0, std::min<u32>(pattern.size() - 1, 8))(gen);
+        const auto split = std::uniform_int_distribution<size_t>(0, haystack.size())(gen);
+
+        // Substitutions only: every window with few enough mismatches is a match
+        ApproximateMatches expectedHamming;
+        for (size_t offset = 0; offset + pattern.size() <= haystack.size(); offset++) {
+            u32 distance = 0;
+            for (size_t j = 0; j < pattern.size(); j++)
+                distance += haystack[offset + j] != pattern[j] ? 1 : 0;
+
+            if (distance <= maxDistance)
+                expectedHamming.emplace_back(offset, pattern.size(), distance);
+        }
+
+        const auto hamming = findApproximate(haystack, pattern, maxDistance, Hamming, split);
+        TEST_ASSERT(hamming == expectedHamming, "iteration: {}", i);
+
+        // Edits: the best distance of a match ending at every position, only local minimums are reported
+        std::vector<u32> column(pattern.size() + 1), scores;
+        std::iota(column.begin(), column.end(), 0);
+        for (u8 byte : haystack) {
+            u32 diagonal = column[0];
+            for (size_t j = 1; j <= pattern.size(); j++) {
+                const u32 above = column[j];
+                column[j] = std::min({ column[j] + 1, column[j - 1] + 1, diagonal + (pattern[j - 1] != byte ? 1 : 0) });
+                diagonal = above;
+            }
+            scores.push_back(std::min<u32>(column.back(), maxDistance + 1));
+        }
+
+        std::vector<std::pair<u64, u32>> expectedEdits;
+        for (size_t end = 0; end < scores.size(); end++) {
+            const auto before = end > 0 ? scores[end - 1] : maxDistance + 1;
+            const auto after = end + 1 < scores.size() ? scores[end + 1] : maxDistance + 1;
+            if (scores[end] <= maxDistance && scores[end] < before && scores[end] <= after)
+                expectedEdits.emplace_back(end, scores[end]);
+        }
+
+        const auto edits = findApproximate(haystack, pattern, maxDistance, Levenshtein, split);
+        TEST_ASSERT(edits.size() == expectedEdits.size(), "iteration: {}", i);
+        for (size_t j = 0; j < edits.size(); j++) {
+            const auto [offset, size, distance] = edits[j];
+            const auto end = offset + size - 1;
+            TEST_ASSERT(end == expectedEdits[j].first && distance == expectedEdits[j].second, "iteration: {}", i);
+
+            // The start of the match has to be placed so that the distance is the one reported
+            TEST_ASSERT(naiveEditDistance(pattern, std::span(haystack).subspan(offset, size)) == distance, "iteration: {}", i);
+        }
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ValueScan") {
+    using Scanner = hex::search::ValueScanner;
+    using enum Scanner::Type;
+    using enum Scanner::Predicate;
+
+    TEST_ASSERT(Scanner::parseValue(U8, "255") == 255);
+    TEST_ASSERT(Scanner::parseValue(U8, "256") == std::nullopt);
+    TEST_ASSERT(Scanner::parseValue(U8, "-1") == std::nullopt);
+    TEST_ASSERT(Scanner::parseValue(I8, "-128") == 0x80);
+    TEST_ASSERT(Scanner::parseValue(I16, " 0x7FFF ") == 0x7FFF);
+    TEST_ASSERT(Scanner::parseValue(I64, "-1") == ~u64(0));
+    TEST_ASSERT(Scanner::parseValue(Float, "1.5") == std::bit_cast<u32>(1.5F));
+    TEST_ASSERT(Scanner::parseValue(U32, "12a") == std::nullopt);
+    TEST_ASSERT(Scanner::formatValue(I16, 0xFFFE) == "-2");
+    TEST_ASSERT(Scanner::formatValue(Double, std::bit_cast<u64>(0.25)) == "0.25");
+
+    // 1000 as little endian u16 at offsets 1 and 4, big endian at offset 7
+    std::vector<u8> data = { 0x00, 0xE8, 0x03, 0x00, 0xE8, 0x03, 0x00, 0x03, 0xE8, 0x00 };
+
+    auto read = [&](u64 address, std::span<u8> buffer) { std::copy_n(data.begin() + address, buffer.size(), buffer.begin()); };
+    auto addresses = [](const Scanner &scanner) {
+        std::vector<u64> result;
+        for (const auto &candidate : scanner.getCandidates())
+            result.push_back(candidate.address);
+        return result;
+    };
+
+    Scanner unaligned({ .type = U16, .endian = std::endian::little, .aligned = false }, 100);
+    unaligned.scan(data, 0, { .predicate = Equal, .minimum = 1000, .maximum = 0 });
+    const std::vector<u64> expectedUnaligned = { 1, 4 };
+    TEST_ASSERT(addresses(unaligned) == expectedUnaligned, "result: {}", addresses(unaligned));
+
+    Scanner aligned({ .type = U16, .endian = std::endian::little, .aligned = true }, 100);
+    aligned.scan(data, 0, { .predicate = Equal, .minimum = 1000, .maximum = 0 });
+    const std::vector<u64> expectedAligned = { 4 };
+    TEST_ASSERT(addresses(aligned) == expectedAligned, "result: {}", addresses(aligned));
+
+    Scanner bigEndian({ .type = U16, .endian = std::endian::big, .aligned = false }, 100);
+    bigEndian.scan(data, 0, { .predicate = Range, .minimum = 999, .maximum = 1001 });
+    const std::vector<u64> expectedBigEndian = { 7 };
+    TEST_ASSERT(addresses(bigEndian) == expectedBigEndian, "result: {}", addresses(bigEndian));
+
+    // Rescans only look at the surviving candidates
+    data[4] = 0xE9;
+    unaligned.rescan({ .predicate = Increased, .minimum = 0, .maximum = 0 }, read);
+    const std::vector<u64> expectedIncreased = { 4 };
+    TEST_ASSERT(addresses(unaligned) == expectedIncreased, "result: {}", addresses(unaligned));
+    TEST_ASSERT(unaligned.getCandidates().front().value == 1001);
+
+    unaligned.rescan({ .predicate = Unchanged, .minimum = 0, .maximum = 0 }, read);
+    TEST_ASSERT(addresses(unaligned) == expectedIncreased, "result: {}", addresses(unaligned));
+
+    unaligned.rescan({ .predicate = Decreased, .minimum = 0, .maximum = 0 }, read);
+    TEST_ASSERT(unaligned.getCandidates().empty());
+
+    // The candidate limit stops the scan early
+    Scanner limited({ .type = U8, .endian = std::endian::little, .aligned = false }, 3);
+    TEST_ASSERT(!limited.scan(data, 0, { .predicate = Range, .minimum = 0, .maximum = 255 }));
+    TEST_ASSERT(limited.getCandidates().size() == 3);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ValueScanRandom") {
+    using Scanner = hex::search::ValueScanner;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u32> dataSize(0, 4096);
+    std::uniform_int_distribution<u32> byteValue(0, 3);
+    std::uniform_int_distribution<u32> typeValue(0, u32(Scanner::Type::Double));
+    std::uniform_int_distribution<u32> chunkSize(16, 512);
+    std::uniform_int_distribution<u32> flip(0, 1);
+
+    for (int i = 0; i < 500; i++) {
+        std::vector<u8> data(dataSize(gen));
+        std::generate(data.begin(), data.end(), [&] { return u8(byteValue(gen)); });
+
+        const Scanner::Settings settings = {
+            .type = Scanner::Type(typeValue(gen)),
+            .endian = flip(gen) ? std::endian::big : std::endian::little,
+            .aligned = flip(gen) == 1
+        };
+        const auto size = Scanner::getTypeSize(settings.type);
+        const auto baseAddress = u64(byteValue(gen));
+
+        auto valueAt = [&](const std::vector<u8> &bytes, size_t offset) { return Scanner::loadValue(std::span(bytes).subspan(offset, size), settings.endian); };
+        auto asNumber = [&](u64 value) -> long double {
+            switch (settings.type) {
+                using enum Scanner::Type;
+                case I8:     return i8(value);
+                case I16:    return i16(value);
+                case I32:    return i32(value);
+                case I64:    return i64(value);
+                case Float:  return std::bit_cast<float>(u32(value));
+                case Double: return std::bit_cast<double>(value);
+                default:     return value;
+            }
+        };
+
+        // Search for a value that exists in the data most of the time, or for a range around it
+        const bool range = flip(gen);
+        Scanner::Condition condition = { .predicate = range ? Scanner::Predicate::Range : Scanner::Predicate::Equal, .minimum = 0, .maximum = 0 };
+        if (data.size() >= size) {
+            condition.minimum = condition.maximum = valueAt(data, std::uniform_int_distribution<size_t>(0, data.size() - size)(gen));
+            if (range)
+                condition.minimum = 0;
+        }
+
+        auto naiveMatches = [&](u64 value) {
+            if (settings.type == Scanner::Type::Float || settings.type == Scanner::Type::Double || range)
+                return asNumber(condition.minimum) <= asNumber(value) && asNumber(value) <= asNumber(condition.maximum);
+            else
+                return value == condition.minimum;
+        };
+
+        std::vector<u64> expected;
+        for (size_t offset = 0; offset + size <= data.size(); offset++) {
+            if ((!settings.aligned || (baseAddress + offset) % size == 0) && naiveMatches(valueAt(data, offset)))
+                expected.push_back(baseAddress + offset);
+        }
+
+        // Feed the data in chunks overlapping by one byte less than the size of a value, like the buffered reader does
+        Scanner scanner(settings, std::numeric_limits<size_t>::max());
+        for (size_t offset = 0; offset < data.size();) {
+            const auto chunk = std::min<size_t>(chunkSize(gen), data.size() - offset);
+            scanner.scan(std::span(data).subspan(offset, chunk), baseAddress + offset, condition);
+            if (offset + chunk >= data.size())
+                break;
+            offset += chunk - (size - 1);
+        }
+
+        std::vector<u64> result;
+        for (const auto &candidate : scanner.getCandidates())
+            result.push_back(candidate.address);
+        TEST_ASSERT(result == expected, "iteration: {}", i);
+
+        // Change some bytes and check that rescans pick the right candidates
+        auto previous = data;
+        for (auto &byte : data) {
+            if (byteValue(gen) == 0)
+                byte = u8(byteValue(gen));
+        }
+
+        auto read = [&](u64 address, std::span<u8> buffer) { std::copy_n(data.begin() + (address - baseAddress), buffer.size(), buffer.begin()); };
+        scanner.rescan({ .predicate = Scanner::Predicate::Changed, .minimum = 0, .maximum = 0 }, read);
+
+        std::vector<u64> expectedChanged;
+        for (auto address : expected) {
+            if (valueAt(data, address - baseAddress) != valueAt(previous, address - baseAddress))
+                expectedChanged.push_back(address);
+        }
+
+        result.clear();
+        for (const auto &candidate : scanner.getCandidates()) {
+            result.push_back(candidate.address);
+            TEST_ASSERT(candidate.value == valueAt(data, candidate.address - baseAddress), "iteration: {}", i);
+        }
+        TEST_ASSERT(result == expectedChanged, "iteration: {}", i);
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ResultBuffer") {
+    hex::search::ResultBuffer<u64> buffer;
+    constexpr static size_t Count = 1'000'000;
+
+    // Read the buffer while it's being filled, every published element has to be visible with its final value
+    std::atomic<bool> valid = true;
+    std::thread reader([&] {
+        size_t checked = 0;
+        while (checked < Count) {
+            const auto size = buffer.getSize();
+            for (; checked < size; checked++) {
+                if (buffer[checked] != checked * 3)
+                    valid = false;
+            }
+        }
+    });
+
+    for (size_t i = 0; i < Count; i++)
+        buffer.push(i * 3);
+
+    reader.join();
+
+    TEST_ASSERT(valid.load());
+    TEST_ASSERT(buffer.getSize() == Count);
+    TEST_ASSERT(buffer[0] == 0 && buffer[1023] == 1023 * 3 && buffer[1024] == 1024 * 3 && buffer[Count - 1] == (Count - 1) * 3);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("OccurrenceStore") {
+    using Store = hex::search::OccurrenceStore;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u64> step(0, 100);
+    std::uniform_int_distribution<u64> size(1, 1000);
+    std::uniform_int_distribution<u32> tag(0, 300);
+    std::uniform_int_distribution<u32> outlier(0, 500);
+
+    const std::vector<Store::Layout> layouts = {
+        { .fixedSize = 4,            .tagSizes = { },          .maxTag = 0   },
+        { .fixedSize = std::nullopt, .tagSizes = { 1, 2, 3 },  .maxTag = 2   },
+        { .fixedSize = std::nullopt, .tagSizes = { },          .maxTag = 300 },
+        { .fixedSize = std::nullopt, .tagSizes = { },          .maxTag = 0   }
+    };
+
+    for (const auto &layout : layouts) {
+        Store store(layout);
+        std::vector<Store::Entry> expected;
+
+        u64 address = 0x1000;
+        for (size_t i = 0; i < 100'000; i++) {
+            Store::Entry entry = { };
+            address += step(gen);
+            entry.address = address;
+
+            // Entries that are found out of order, far away from the others or that are huge don't fit into the compact columns
+            switch (outlier(gen)) {
+                case 0: entry.address -= std::min<u64>(entry.address, 50'000); break;
+                case 1: entry.address += 0x1'0000'0000'0000; break;
+                case 2: entry.address = 0; break;
+                default: break;
+            }
+
+            entry.tag  = layout.maxTag == 0 ? 0 : std::min(tag(gen), layout.maxTag);
+            entry.size = layout.fixedSize.value_or(layout.tagSizes.empty() ? size(gen) : layout.tagSizes[entry.tag]);
+            if (outlier(gen) == 0 && !layout.fixedSize.has_value() && layout.tagSizes.empty())
+                entry.size = 0x1'0000'0000 + size(gen);
+
+            store.push(entry);
+            expected.push_back(entry);
+        }
+
+        TEST_ASSERT(store.getSize() == expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            const auto entry = store[i];
+            TEST_ASSERT(entry.address == expected[i].address && entry.size == expected[i].size && entry.tag == expected[i].tag, "index: {}", i);
+        }
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("IntervalIndexRandom") {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u64> address(0, 10'000);
+    std::uniform_int_distribution<u64> size(0, 50);
+    std::uniform_int_distribution<u32> batchSize(1, 300);
+
+    using Interval = hex::search::IntervalIndex::Interval;
+
+    std::vector<Interval> intervals;
+    hex::search::IntervalIndex index([&](u32 id) { return intervals[id]; });
+
+    for (int batch = 0; batch < 50; batch++) {
+        std::vector<u32> newIds(batchSize(gen));
+        for (auto &id : newIds) {
+            Interval interval = { };
+            interval.start = address(gen);
+            interval.end   = interval.start + (batch % 10 == 0 ? size(gen) * 20 : size(gen));
+
+            id = u32(intervals.size());
+            intervals.push_back(interval);
+        }
+
+        index.insert(newIds);
+        TEST_ASSERT(index.getSize() == intervals.size());
+
+        for (int query = 0; query < 200; query++) {
+            const auto queryAddress = address(gen);
+
+            std::vector<u32> expected, result;
+            for (u32 id = 0; id < intervals.size(); id++) {
+                if (intervals[id].start <= queryAddress && queryAddress <= intervals[id].end)
+                    expected.push_back(id);
+            }
+
+            index.findOverlapping(queryAddress, [&](u32 id) { result.push_back(id); });
+            std::sort(result.begin(), result.end());
+
+            TEST_ASSERT(result == expected, "batch: {} address: {}", batch, queryAddress);
+            TEST_ASSERT(index.overlaps(queryAddress) == !expected.empty());
+        }
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("NGramIndex") {
+    using Index = hex::search::NGramIndex;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<u32> letter(0, 25);
+    std::uniform_int_distribution<u32> byteValue(0, 255);
+    std::uniform_int_distribution<u32> chunkSize(1, 100'000);
+
+    // Text-like data in the first blocks, random data that saturates the signatures in the last ones
+    std::vector<u8> data(Index::BlockSize * 6 + 1234);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = i < Index::BlockSize * 4 ? u8('a' + letter(gen) % 8) : u8(byteValue(gen));
+
+    const std::string marker = "MARKER";
+    const auto markerOffset = Index::BlockSize * 2 - 3;
+    std::copy(marker.begin(), marker.end(), data.begin() + markerOffset);
+
+    Index index;
+    for (size_t offset = 0; offset < data.size();) {
+        const auto size = std::min<size_t>(chunkSize(gen), data.size() - offset);
+        index.process(std::span(data).subspan(offset, size));
+        offset += size;
+    }
+    index.finish();
+
+    TEST_ASSERT(index.getBlockCount() == 7);
+    TEST_ASSERT(index.getDataSize() == data.size());
+
+    auto toPattern = [](const std::string &string) {
+        std::vector<hex::search::MaskedByte> pattern;
+        for (char c : string)
+            pattern.push_back({ 0xFF, u8(c) });
+        return pattern;
+    };
+
+    // The marker crosses a block boundary so only the block it starts in is a candidate. The random blocks have no signature
+    // which also makes the block before them a candidate, the short last block isn't saturated
+    const auto candidates = index.findCandidateBlocks(toPattern(marker));
+    const std::vector<bool> expectedCandidates = { false, true, false, true, true, true, false };
+    TEST_ASSERT(candidates == expectedCandidates, "candidates: {}", std::vector<int>(candidates.begin(), candidates.end()));
+
+    // Wildcards break up grams, a pattern without any complete gram can't be filtered
+    const std::vector<hex::search::MaskedByte> wildcardPattern = { { 0xFF, 'M' }, { 0x00, 0x00 }, { 0xFF, 'R' } };
+    TEST_ASSERT(index.findCandidateBlocks(wildcardPattern) == std::vector<bool>(7, true));
+
+    // Every occurrence of random patterns has to start in a candidate block
+    for (int i = 0; i < 200; i++) {
+        const auto offset = std::uniform_int_distribution<size_t>(0, data.size() - 16)(gen);
+        const auto size = std::uniform_int_distribution<size_t>(3, 16)(gen);
+        const std::vector<u8> needle(data.begin() + offset, data.begin() + offset + size);
+
+        std::vector<hex::search::MaskedByte> pattern;
+        for (u8 byte : needle)
+            pattern.push_back({ 0xFF, byte });
+
+        const auto blocks = index.findCandidateBlocks(pattern);
+        for (auto match : naiveFindAll(data, needle, true))
+            TEST_ASSERT(blocks[match / Index::BlockSize], "offset: {} size: {}", match, size);
+    }
+
+    const auto restored = Index::deserialize(index.serialize());
+    TEST_ASSERT(restored.has_value());
+    TEST_ASSERT(restored->getDataSize() == data.size());
+    TEST_ASSERT(restored->findCandidateBlocks(toPattern(marker)) == candidates);
+
+    auto corrupted = index.serialize();
+    corrupted.pop_back();
+    TEST_ASSERT(!Index::deserialize(corrupted).has_value());
+
+    TEST_SUCCESS();
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#define BENCHMARK(name) static auto ANONYMOUS_VARIABLE(BENCHMARK) = ::hex::test::BenchmarkExecutor(name) + [](::hex::test::BenchmarkState &state) -> void
+
+namespace hex::test {
+
+    struct BenchmarkResult {
+        std::string name;
+        u64 bytes;
+        u32 iterations;
+
+        double minTime, medianTime, meanTime, standardDeviation;
+    };
+
+    // Handed to every benchmark. A benchmark prepares its data and then passes the code to measure to run(), possibly multiple times for different variants
+    class BenchmarkState {
+    public:
+        BenchmarkState(std::string name, bool quick) : m_name(std::move(name)), m_quick(quick) { }
+
+        // Quick runs only check that every benchmark still works, inputs are kept small and every measured function only runs once
+        [[nodiscard]] bool isQuick() const { return this->m_quick; }
+
+        [[nodiscard]] size_t scaleSize(size_t size) const {
+            return this->m_quick ? std::min<size_t>(size, 64 * 1024) : size;
+        }
+
+        // Runs `function` once to warm up and then repeatedly until enough time has been measured. `bytes` is the amount of data
+        // processed by a single call and is used to calculate the throughput
+        void run(u64 bytes, const std::function<void()> &function) {
+            this->run({ }, bytes, function);
+        }
+
+        void run(const std::string &variant, u64 bytes, const std::function<void()> &function);
+
+        [[nodiscard]] const std::vector<BenchmarkResult> &getResults() const { return this->m_results; }
+
+    private:
+        std::string m_name;
+        bool m_quick;
+
+        std::vector<BenchmarkResult> m_results;
+    };
+
+    class Benchmarks {
+    public:
+        using Function = std::function<void(BenchmarkState &)>;
+
+        static auto addBenchmark(const std::string &name, const Function &function) noexcept {
+            s_benchmarks.insert({ name, function });
+
+            return 0;
+        }
+
+        static auto &get() noexcept {
+            return s_benchmarks;
+        }
+
+    private:
+        static inline std::map<std::string, Function> s_benchmarks;
+    };
+
+    struct BenchmarkExecutor {
+        explicit BenchmarkExecutor(std::string name) noexcept : m_name(std::move(name)) { }
+
+        [[nodiscard]] const auto &getName() const noexcept {
+            return this->m_name;
+        }
+
+    private:
+        std::string m_name;
+    };
+
+    template<typename F>
+    int operator+(const BenchmarkExecutor &executor, F &&f) noexcept {
+        return Benchmarks::addBenchmark(executor.getName(), std::forward<F>(f));
+    }
+
+    // Keeps the compiler from optimizing away calculations whose results are never used
+    template<typename T>
+    void doNotOptimize(const T &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // Data that looks roughly like a binary file, with runs of zeros, text and code-like bytes between random data.
+    // The same seed always generates the same data on every platform so results of different runs can be compared
+    inline std::vector<u8> generateData(size_t size, u32 seed = 0x1337'5EED) {
+        std::mt19937 random(seed);
+        std::vector<u8> data(size);
+
+        constexpr static std::string_view Text = "The quick brown fox jumps over the lazy dog. ";
+        for (size_t offset = 0; offset < size;) {
+            const auto runSize = std::min<size_t>(16 + random() % 4081, size - offset);
+
+            switch (random() % 4) {
+                case 0:
+                    std::fill_n(data.begin() + offset, runSize, 0x00);
+                    break;
+                case 1:
+                    for (size_t i = 0; i < runSize; i++)
+                        data[offset + i] = Text[(offset + i) % Text.size()];
+                    break;
+                case 2:
+                    for (size_t i = 0; i < runSize; i++)
+                        data[offset + i] = u8(0x40 + random() % 16);
+                    break;
+                default:
+                    for (size_t i = 0; i < runSize; i++)
+                        data[offset + i] = u8(random());
+                    break;
+            }
+
+            offset += runSize;
+        }
+
+        return data;
+    }
+
+}
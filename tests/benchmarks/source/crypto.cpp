@@ -0,0 +1,169 @@
+#include <hex/test/benchmarks.hpp>
+#include <hex/test/test_provider.hpp>
+
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/literals.hpp>
+#include <hex/helpers/merkle_tree.hpp>
+#include <hex/helpers/similarity_hash.hpp>
+
+using namespace hex::literals;
+
+static hex::crypt::ReadFunction readFrom(const std::vector<u8> &data) {
+    return [&data](u64 offset, std::span<u8> buffer) { std::memcpy(buffer.data(), data.data() + offset, buffer.size()); };
+}
+
+static void benchmarkContext(hex::test::BenchmarkState &state, const hex::crypt::ContextFactory &createContext) {
+    const auto data = hex::test::generateData(state.scaleSize(64_MiB));
+
+    state.run(data.size(), [&] {
+        auto context = createContext();
+        context->update(data);
+        hex::test::doNotOptimize(context->finish());
+    });
+}
+
+BENCHMARK("Crypto/MD5") {
+    benchmarkContext(state, hex::crypt::createMD5Context);
+};
+
+BENCHMARK("Crypto/SHA1") {
+    benchmarkContext(state, hex::crypt::createSHA1Context);
+};
+
+BENCHMARK("Crypto/SHA256") {
+    benchmarkContext(state, hex::crypt::createSHA256Context);
+};
+
+BENCHMARK("Crypto/SHA512") {
+    benchmarkContext(state, hex::crypt::createSHA512Context);
+};
+
+BENCHMARK("Crypto/CRC32") {
+    benchmarkContext(state, [] { return hex::crypt::createCRC32Context(0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true); });
+};
+
+BENCHMARK("Crypto/CRC16") {
+    benchmarkContext(state, [] { return hex::crypt::createCRC16Context(0x8005, 0x0000, 0x0000, true, true); });
+};
+
+BENCHMARK("Crypto/Ssdeep") {
+    benchmarkContext(state, hex::crypt::createSsdeepContext);
+};
+
+BENCHMARK("Crypto/Tlsh") {
+    benchmarkContext(state, hex::crypt::createTlshContext);
+};
+
+BENCHMARK("Crypto/ProviderHashes") {
+    auto data = hex::test::generateData(state.scaleSize(64_MiB));
+    hex::test::TestProvider testProvider(&data);
+    hex::prv::Provider *provider = &testProvider;
+
+    state.run("CRC32", data.size(), [&] {
+        hex::test::doNotOptimize(hex::crypt::crc32(provider, 0, data.size(), 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true));
+    });
+
+    state.run("SHA256", data.size(), [&] {
+        hex::test::doNotOptimize(hex::crypt::sha256(provider, 0, data.size()));
+    });
+};
+
+BENCHMARK("Crypto/UpdateAll") {
+    auto data = hex::test::generateData(state.scaleSize(64_MiB));
+    hex::test::TestProvider provider(&data);
+
+    state.run(data.size(), [&] {
+        auto md5    = hex::crypt::createMD5Context();
+        auto sha1   = hex::crypt::createSHA1Context();
+        auto sha256 = hex::crypt::createSHA256Context();
+        auto crc32  = hex::crypt::createCRC32Context(0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true);
+
+        hex::crypt::updateAll({ md5.get(), sha1.get(), sha256.get(), crc32.get() }, 0, data.size(),
+            [&](u64 offset, std::span<u8> buffer) { provider.read(offset, buffer.data(), buffer.size()); });
+
+        hex::test::doNotOptimize(sha256->finish());
+    });
+};
+
+BENCHMARK("Crypto/HashBlocks") {
+    const auto data = hex::test::generateData(state.scaleSize(256_MiB));
+
+    state.run(data.size(), [&] {
+        hex::test::doNotOptimize(hex::crypt::hashBlocks(hex::crypt::createSHA256Context, 0, data.size(), 1_MiB, readFrom(data)));
+    });
+};
+
+BENCHMARK("Crypto/MerkleTree") {
+    auto data = hex::test::generateData(state.scaleSize(256_MiB));
+    const auto blockSize = state.isQuick() ? 4_KiB : 1_MiB;
+
+    state.run("Build", data.size(), [&] {
+        hex::crypt::MerkleTree tree(hex::crypt::createSHA256Context, blockSize);
+        tree.build(data.size(), readFrom(data));
+
+        hex::test::doNotOptimize(tree.getRootHash());
+    });
+
+    hex::crypt::MerkleTree tree(hex::crypt::createSHA256Context, blockSize);
+    tree.build(data.size(), readFrom(data));
+
+    // A small edit only rehashes the affected leaf and its parents
+    state.run("Update", blockSize, [&] {
+        data[data.size() / 2] ^= 0xFF;
+        tree.invalidate(data.size() / 2, 1);
+        tree.update(data.size(), readFrom(data));
+
+        hex::test::doNotOptimize(tree.getRootHash());
+    });
+};
+
+BENCHMARK("Crypto/Base16") {
+    const auto data = hex::test::generateData(state.scaleSize(64_MiB));
+
+    std::string encoded(data.size() * 2, '\x00');
+    std::vector<u8> decoded(data.size());
+
+    state.run("Encode", data.size(), [&] {
+        hex::test::doNotOptimize(hex::crypt::encode16(data, encoded));
+    });
+
+    state.run("Decode", encoded.size(), [&] {
+        hex::test::doNotOptimize(hex::crypt::decode16(encoded, decoded));
+    });
+};
+
+BENCHMARK("Crypto/Base64") {
+    const auto data = hex::test::generateData(state.scaleSize(64_MiB));
+
+    std::string encoded((data.size() + 2) / 3 * 4, '\x00');
+    std::vector<u8> decoded(data.size());
+
+    state.run("Encode", data.size(), [&] {
+        hex::test::doNotOptimize(hex::crypt::encode64(data, encoded));
+    });
+
+    state.run("Decode", encoded.size(), [&] {
+        hex::test::doNotOptimize(hex::crypt::decode64(encoded, decoded));
+    });
+};
+
+BENCHMARK("Crypto/AESDecrypt") {
+    const auto data = hex::test::generateData(state.scaleSize(256_MiB));
+    std::vector<u8> output(data.size());
+
+    const auto key = hex::test::generateData(64, 0xAE5);
+    const std::array<u8, 8> nonce = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77 };
+    const std::array<u8, 8> iv    = { 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF };
+
+    const hex::crypt::AESDecryptor ecb(hex::crypt::AESMode::ECB, hex::crypt::KeyLength::Key128Bits, std::span(key).first(16), nonce, iv);
+    const hex::crypt::AESDecryptor ctr(hex::crypt::AESMode::CTR, hex::crypt::KeyLength::Key256Bits, std::span(key).first(32), nonce, iv);
+    const hex::crypt::AESDecryptor xts(hex::crypt::AESMode::XTS, hex::crypt::KeyLength::Key256Bits, key, nonce, iv, 4_KiB);
+
+    state.run("ECB", data.size(), [&] { ecb.decrypt(0, data, output); });
+    state.run("CTR", data.size(), [&] { ctr.decrypt(0, data, output); });
+    state.run("XTS", data.size(), [&] { xts.decrypt(0, data, output); });
+
+    state.run("CTR-Streaming", data.size(), [&] {
+        ctr.decrypt(0, data.size(), readFrom(data), [&](u64 offset, std::span<const u8> buffer) { std::memcpy(output.data() + offset, buffer.data(), buffer.size()); });
+    });
+};
@@ -0,0 +1,55 @@
+#include <hex/test/benchmarks.hpp>
+#include <hex/test/test_provider.hpp>
+
+#include <hex/helpers/entropy.hpp>
+#include <hex/helpers/literals.hpp>
+
+#include <cmath>
+
+using namespace hex::literals;
+
+BENCHMARK("Entropy/Histogram") {
+    const auto data = hex::test::generateData(state.scaleSize(256_MiB));
+
+    state.run(data.size(), [&] {
+        hex::entropy::Histogram histogram = { };
+        hex::entropy::countValues(data, histogram);
+
+        hex::test::doNotOptimize(histogram);
+    });
+};
+
+BENCHMARK("Entropy/Analysis") {
+    auto data = hex::test::generateData(state.scaleSize(256_MiB));
+    hex::test::TestProvider provider(&data);
+
+    // Same block size the information view uses
+    const auto blockSize = std::max<u64>(std::ceil(data.size() / 2048.0F), 256);
+
+    state.run(data.size(), [&] {
+        const auto analysis = hex::entropy::analyze(0, data.size(), blockSize, [&](u64 offset, std::span<u8> buffer) { provider.read(offset, buffer.data(), buffer.size()); });
+
+        hex::test::doNotOptimize(analysis.blockEntropy.data());
+    });
+};
+
+BENCHMARK("Entropy/Pyramid") {
+    auto data = hex::test::generateData(state.scaleSize(256_MiB));
+    hex::test::TestProvider provider(&data);
+
+    state.run(data.size(), [&] {
+        hex::entropy::Pyramid pyramid;
+        pyramid.build(0, data.size(), [&](u64 offset, std::span<u8> buffer) { provider.read(offset, buffer.data(), buffer.size()); });
+
+        hex::test::doNotOptimize(pyramid.getLevel(0).data());
+    });
+
+    // Zero filled data is the worst case for counting byte values
+    std::fill(data.begin(), data.end(), 0x00);
+    state.run("Zeros", data.size(), [&] {
+        hex::entropy::Pyramid pyramid;
+        pyramid.build(0, data.size(), [&](u64 offset, std::span<u8> buffer) { provider.read(offset, buffer.data(), buffer.size()); });
+
+        hex::test::doNotOptimize(pyramid.getLevel(0).data());
+    });
+};
@@ -0,0 +1,167 @@
+#include <hex.hpp>
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/logger.hpp>
+#include <hex/test/benchmarks.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <numeric>
+#include <thread>
+
+namespace hex::test {
+
+    void BenchmarkState::run(const std::string &variant, u64 bytes, const std::function<void()> &function) {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr static auto MinimumTime       = std::chrono::milliseconds(500);
+        constexpr static u32 MinimumIterations  = 5;
+        constexpr static u32 MaximumIterations  = 10'000;
+
+        const auto name = variant.empty() ? this->m_name : hex::format("{}/{}", this->m_name, variant);
+
+        if (!this->m_quick)
+            function();
+
+        std::vector<double> times;
+        Clock::duration totalTime = { };
+        do {
+            const auto start = Clock::now();
+            function();
+            const auto time = Clock::now() - start;
+
+            times.push_back(std::chrono::duration<double>(time).count());
+            totalTime += time;
+        } while (!this->m_quick && times.size() < MaximumIterations && (times.size() < MinimumIterations || totalTime < MinimumTime));
+
+        std::sort(times.begin(), times.end());
+
+        const auto mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+        const auto variance = std::accumulate(times.begin(), times.end(), 0.0, [mean](double sum, double time) { return sum + (time - mean) * (time - mean); }) / times.size();
+
+        auto &result = this->m_results.emplace_back(BenchmarkResult {
+            name,
+            bytes,
+            u32(times.size()),
+            times.front(),
+            times[times.size() / 2],
+            mean,
+            std::sqrt(variance)
+        });
+
+        if (bytes > 0)
+            hex::log::info("{:<48} {:>12.3f} ms {:>10.1f} MiB/s  ({} iterations)", result.name, result.medianTime * 1000, bytes / result.medianTime / 1024 / 1024, result.iterations);
+        else
+            hex::log::info("{:<48} {:>12.3f} ms  ({} iterations)", result.name, result.medianTime * 1000, result.iterations);
+    }
+
+}
+
+static nlohmann::json resultToJson(const hex::test::BenchmarkResult &result) {
+    nlohmann::json json;
+    json["name"]          = result.name;
+    json["bytes"]         = result.bytes;
+    json["iterations"]    = result.iterations;
+    json["min_ns"]        = result.minTime * 1E9;
+    json["median_ns"]     = result.medianTime * 1E9;
+    json["mean_ns"]       = result.meanTime * 1E9;
+    json["stddev_ns"]     = result.standardDeviation * 1E9;
+    json["bytes_per_sec"] = result.bytes > 0 ? result.bytes / result.medianTime : 0.0;
+
+    return json;
+}
+
+// Prints how much faster or slower every benchmark got compared to a previously written result file
+static void compareToBaseline(const std::vector<hex::test::BenchmarkResult> &results, const std::string &path) {
+    std::ifstream file(path);
+    if (!file.good()) {
+        hex::log::error("Failed to open baseline file {}", path);
+        return;
+    }
+
+    std::map<std::string, double> baseline;
+    try {
+        const auto json = nlohmann::json::parse(file);
+        for (const auto &entry : json.at("benchmarks"))
+            baseline[entry.at("name").get<std::string>()] = entry.at("median_ns").get<double>();
+    } catch (const nlohmann::json::exception &e) {
+        hex::log::error("Invalid baseline file {}: {}", path, e.what());
+        return;
+    }
+
+    hex::log::info("Compared to {}:", path);
+    for (const auto &result : results) {
+        if (auto it = baseline.find(result.name); it != baseline.end() && it->second > 0)
+            hex::log::info("{:<48} {:>+8.1f}%", result.name, (result.medianTime * 1E9 / it->second - 1) * 100);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> filters;
+    std::string jsonPath, baselinePath;
+    bool quick = false, list = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument == "--quick") {
+            quick = true;
+        } else if (argument == "--list") {
+            list = true;
+        } else if ((argument == "--json" || argument == "--baseline") && i + 1 < argc) {
+            (argument == "--json" ? jsonPath : baselinePath) = argv[++i];
+        } else if (argument.starts_with("--")) {
+            hex::log::fatal("Unknown argument {}! Usage: {} [--quick] [--list] [--json <results file>] [--baseline <results file>] [name filters...]", argument, argv[0]);
+            return EXIT_FAILURE;
+        } else {
+            filters.push_back(argument);
+        }
+    }
+
+    const auto matchesFilters = [&](const std::string &name) {
+        return filters.empty() || std::any_of(filters.begin(), filters.end(), [&](const auto &filter) { return name.find(filter) != std::string::npos; });
+    };
+
+    std::vector<hex::test::BenchmarkResult> results;
+    for (const auto &[name, function] : hex::test::Benchmarks::get()) {
+        if (!matchesFilters(name))
+            continue;
+
+        if (list) {
+            hex::log::info("{}", name);
+            continue;
+        }
+
+        hex::test::BenchmarkState state(name, quick);
+        function(state);
+
+        results.insert(results.end(), state.getResults().begin(), state.getResults().end());
+    }
+
+    if (!baselinePath.empty())
+        compareToBaseline(results, baselinePath);
+
+    if (!jsonPath.empty()) {
+        nlohmann::json json;
+        json["context"]["threads"] = std::thread::hardware_concurrency();
+        json["context"]["quick"]   = quick;
+        json["context"]["time"]    = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+        json["benchmarks"] = nlohmann::json::array();
+        for (const auto &result : results)
+            json["benchmarks"].push_back(resultToJson(result));
+
+        std::ofstream file(jsonPath);
+        if (!file.good()) {
+            hex::log::fatal("Failed to write results to {}", jsonPath);
+            return EXIT_FAILURE;
+        }
+
+        file << json.dump(4);
+    }
+
+    return EXIT_SUCCESS;
+}
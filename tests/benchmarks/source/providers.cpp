@@ -0,0 +1,51 @@
+#include <hex/test/benchmarks.hpp>
+#include <hex/test/test_provider.hpp>
+
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/literals.hpp>
+#include <hex/providers/buffered_reader.hpp>
+
+using namespace hex::literals;
+
+BENCHMARK("Provider/Read") {
+    auto data = hex::test::generateData(state.scaleSize(256_MiB));
+    hex::test::TestProvider provider(&data);
+
+    for (size_t chunkSize : { 4_KiB, 1_MiB }) {
+        std::vector<u8> buffer(chunkSize);
+
+        state.run(hex::format("{}KiB", chunkSize / 1_KiB), data.size(), [&] {
+            for (u64 offset = 0; offset < data.size(); offset += chunkSize) {
+                provider.read(offset, buffer.data(), std::min<u64>(chunkSize, data.size() - offset));
+                hex::test::doNotOptimize(buffer.data());
+            }
+        });
+    }
+};
+
+BENCHMARK("Provider/BufferedReader") {
+    auto data = hex::test::generateData(state.scaleSize(256_MiB));
+    hex::test::TestProvider provider(&data);
+
+    state.run("Chunks", data.size(), [&] {
+        u64 sum = 0;
+
+        hex::prv::BufferedReader reader(&provider);
+        reader.forEachChunk(0, [&](u64, std::span<const u8> chunk) { sum += chunk.back(); });
+
+        hex::test::doNotOptimize(sum);
+    });
+
+    // Byte wise iteration as used by most analyses is a lot slower, so less data is used for it
+    const auto iteratedSize = std::min<u64>(data.size(), 16_MiB);
+    state.run("Iterator", iteratedSize, [&] {
+        u64 sum = 0;
+
+        hex::prv::BufferedReader reader(&provider);
+        reader.setEndAddress(iteratedSize - 1);
+        for (u8 byte : reader)
+            sum += byte;
+
+        hex::test::doNotOptimize(sum);
+    });
+};
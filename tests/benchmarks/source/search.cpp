@@ -0,0 +1,106 @@
+#include <hex/test/benchmarks.hpp>
+
+#include <hex/helpers/literals.hpp>
+#include <hex/helpers/search.hpp>
+
+#include <cstring>
+
+using namespace hex::literals;
+
+BENCHMARK("Search/Sequence") {
+    const auto data = hex::test::generateData(state.scaleSize(256_MiB));
+
+    // A needle made of common text bytes and one that only shows up in the random parts of the data
+    const hex::search::SequenceSearcher text({ 'q', 'u', 'i', 'c', 'k', ' ', 'b', 'r', 'o', 'w', 'n' });
+    const hex::search::SequenceSearcher binary({ 0xDE, 0xAD, 0xBE, 0xEF, 0x13, 0x37 });
+
+    state.run("Text", data.size(), [&] {
+        u64 matches = 0;
+        text.findAll(data, false, [&](size_t) { matches++; });
+
+        hex::test::doNotOptimize(matches);
+    });
+
+    state.run("Binary", data.size(), [&] {
+        u64 matches = 0;
+        binary.findAll(data, false, [&](size_t) { matches++; });
+
+        hex::test::doNotOptimize(matches);
+    });
+};
+
+BENCHMARK("Search/Pattern") {
+    const auto data = hex::test::generateData(state.scaleSize(256_MiB));
+
+    // "4? ?? 4?" and a pattern longer than a single state word
+    std::vector<hex::search::MaskedByte> shortPattern = { { 0xF0, 0x40 }, { 0x00, 0x00 }, { 0xF0, 0x40 } };
+    std::vector<hex::search::MaskedByte> longPattern(80, { 0xF0, 0x40 });
+
+    hex::search::PatternMatcher shortMatcher(shortPattern), longMatcher(longPattern);
+
+    state.run("Short", data.size(), [&] {
+        u64 matches = 0;
+        shortMatcher.reset();
+        shortMatcher.process(data, [&](size_t) { matches++; });
+
+        hex::test::doNotOptimize(matches);
+    });
+
+    state.run("Long", data.size(), [&] {
+        u64 matches = 0;
+        longMatcher.reset();
+        longMatcher.process(data, [&](size_t) { matches++; });
+
+        hex::test::doNotOptimize(matches);
+    });
+};
+
+BENCHMARK("Search/MultiSequence") {
+    const auto data = hex::test::generateData(state.scaleSize(256_MiB));
+
+    std::vector<std::vector<u8>> needles;
+    for (const auto &word : { "quick", "brown", "fox", "jumps", "lazy", "dog", "The", "MZ", "PE", "ELF" })
+        needles.emplace_back(word, word + std::strlen(word));
+    for (u32 i = 0; i < 54; i++)
+        needles.push_back(hex::test::generateData(4 + i % 8, i));
+
+    hex::search::MultiSequenceSearcher searcher(needles);
+
+    state.run(data.size(), [&] {
+        u64 matches = 0;
+        searcher.reset();
+        searcher.process(data, [&](size_t, size_t) { matches++; });
+
+        hex::test::doNotOptimize(matches);
+    });
+};
+
+BENCHMARK("Search/Strings") {
+    const auto data = hex::test::generateData(state.scaleSize(256_MiB));
+
+    hex::search::StringExtractor::Settings settings;
+    for (u32 c = 0x20; c < 0x7F; c++)
+        settings.validCharacters[c] = true;
+    settings.minLength = 5;
+
+    state.run("ASCII", data.size(), [&] {
+        u64 strings = 0;
+
+        hex::search::StringExtractor extractor(settings);
+        extractor.process(data, [&](const auto &) { strings++; });
+        extractor.finish([&](const auto &) { strings++; });
+
+        hex::test::doNotOptimize(strings);
+    });
+
+    settings.utf8 = settings.utf16le = settings.utf16be = true;
+    state.run("AllEncodings", data.size(), [&] {
+        u64 strings = 0;
+
+        hex::search::StringExtractor extractor(settings);
+        extractor.process(data, [&](const auto &) { strings++; });
+        extractor.finish([&](const auto &) { strings++; });
+
+        hex::test::doNotOptimize(strings);
+    });
+};
@@ -48,6 +48,10 @@ namespace hex::test {
             return this->m_data->size();
         }
 
+        void resize(size_t newSize) override {
+            this->m_data->resize(newSize);
+        }
+
         [[nodiscard]] virtual std::string getTypeName() const { return "hex.test.provider.test"; }
 
         bool open() override { return true; }
@@ -1,7 +1,10 @@
 #include <hex/test/tests.hpp>
 #include <hex/test/test_provider.hpp>
 
+#include <hex/api/event.hpp>
+#include <hex/api/task.hpp>
 #include <hex/helpers/crypto.hpp>
+#include <hex/helpers/utils.hpp>
 
 #include <algorithm>
 #include <vector>
@@ -81,3 +84,109 @@ TEST_SEQUENCE("TestProvider_write") {
 
     TEST_SUCCESS();
 };
+
+TEST_SEQUENCE("TestProvider_replace") {
+    std::vector<u8> data { 0x00, 0xAA, 0xBB, 0x01, 0x02, 0xAA, 0xBB, 0x03 };
+    hex::test::TestProvider provider(&data);
+
+    const std::vector<u64> offsets = { 1, 5 };
+
+    // Replacements of the same size become patches with a single undo point
+    const std::vector<u8> sameSize = { 0xCC, 0xDD };
+    provider.replace(offsets, 2, sameSize);
+    TEST_ASSERT(provider.getPatches().size() == 4);
+    provider.undo();
+    TEST_ASSERT(provider.getPatches().empty());
+    provider.redo();
+    TEST_ASSERT(provider.getPatches().size() == 4);
+    provider.undo();
+
+    // Patches in between replacements move with the data
+    const u8 patch = 0x11;
+    provider.addPatch(3, &patch, 1, true);
+
+    const std::vector<u8> larger = { 0xCC, 0xDD, 0xEE };
+    provider.replace(offsets, 2, larger);
+    const std::vector<u8> expectedLarger = { 0x00, 0xCC, 0xDD, 0xEE, 0x01, 0x02, 0xCC, 0xDD, 0xEE, 0x03 };
+    TEST_ASSERT(data == expectedLarger);
+    TEST_ASSERT(provider.getPatches().size() == 1 && provider.getPatches().contains(4));
+
+    // Undoing moves the data back and restores the patches as they were before
+    const std::vector<u8> original = { 0x00, 0xAA, 0xBB, 0x01, 0x02, 0xAA, 0xBB, 0x03 };
+    provider.undo();
+    TEST_ASSERT(data == original);
+    TEST_ASSERT(provider.getPatches().size() == 1 && provider.getPatches().contains(3));
+    provider.redo();
+    TEST_ASSERT(data == expectedLarger);
+    TEST_ASSERT(provider.getPatches().size() == 1 && provider.getPatches().contains(4));
+
+    const std::vector<u8> smaller = { 0xFF };
+    provider.replace({ 1, 6 }, 3, smaller);
+    const std::vector<u8> expectedSmaller = { 0x00, 0xFF, 0x01, 0x02, 0xFF, 0x03 };
+    TEST_ASSERT(data == expectedSmaller);
+    TEST_ASSERT(provider.getPatches().size() == 1 && provider.getPatches().contains(2));
+
+    // Every replaced region gets its own original bytes back, even if they differed
+    provider.undo();
+    TEST_ASSERT(data == expectedLarger);
+    provider.undo();
+    TEST_ASSERT(data == original);
+    TEST_ASSERT(provider.getPatches().size() == 1 && provider.getPatches().contains(3));
+
+    // Replacing after undoing discards the redo history including the replacements in it
+    provider.undo();
+    provider.replace({ 1 }, 2, smaller);
+    TEST_ASSERT(!provider.canRedo());
+    provider.undo();
+    TEST_ASSERT(data == original && provider.getPatches().empty());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("TestProvider_dataChanged") {
+    std::vector<u8> data { 0xde, 0xad, 0xbe, 0xef, 0x42, 0x2a, 0x00, 0xff };
+    hex::test::TestProvider provider(&data);
+
+    std::vector<hex::Region> changedRegions;
+    hex::EventManager::subscribe<hex::EventDataChanged>(&provider, [&](hex::prv::Provider *changedProvider, hex::Region region) {
+        if (changedProvider == &provider)
+            changedRegions.push_back(region);
+    });
+    ON_SCOPE_EXIT { hex::EventManager::unsubscribe<hex::EventDataChanged>(&provider); };
+
+    const auto initialVersion = provider.getDataVersion();
+
+    // Changes are only reported once the deferred calls of the frame run
+    const std::vector<u8> patch = { 0x11, 0x22 };
+    provider.addPatch(2, patch.data(), patch.size(), true);
+    TEST_ASSERT(changedRegions.empty());
+    hex::TaskManager::runDeferredCalls();
+    TEST_ASSERT(provider.getDataVersion() == initialVersion + 1);
+    TEST_ASSERT(changedRegions.size() == 1);
+    TEST_ASSERT(changedRegions.back().getStartAddress() == 2 && changedRegions.back().getSize() == 2);
+
+    provider.addPatch(6, patch.data(), 1, true);
+    hex::TaskManager::runDeferredCalls();
+    TEST_ASSERT(changedRegions.back().getStartAddress() == 6 && changedRegions.back().getSize() == 1);
+
+    // Undoing only reports the bytes whose value changed
+    provider.undo();
+    hex::TaskManager::runDeferredCalls();
+    TEST_ASSERT(provider.getDataVersion() == initialVersion + 3);
+    TEST_ASSERT(changedRegions.back().getStartAddress() == 6 && changedRegions.back().getSize() == 1);
+
+    provider.undo();
+    hex::TaskManager::runDeferredCalls();
+    TEST_ASSERT(changedRegions.back().getStartAddress() == 2 && changedRegions.back().getSize() == 2);
+    TEST_ASSERT(changedRegions.size() == 4);
+
+    // All changes made within the same frame are reported as a single one
+    for (u64 offset : { 5, 1, 3 })
+        provider.addPatch(offset, patch.data(), 1);
+    hex::TaskManager::runDeferredCalls();
+    TEST_ASSERT(provider.getDataVersion() == initialVersion + 5);
+    TEST_ASSERT(changedRegions.size() == 5);
+    TEST_ASSERT(changedRegions.back().getStartAddress() == 1 && changedRegions.back().getSize() == 5);
+
+    TEST_SUCCESS();
+};